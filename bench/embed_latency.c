@@ -0,0 +1,108 @@
+// bench/embed_latency.c - 嵌入 API 的重复调用延迟
+//
+// 用法：make examples && ./output/embed-latency [calls]
+//
+// 对比两种宿主用法处理一次请求的耗时：
+//   per-request：每次请求创建虚拟机、加载脚本、调用、释放（相当于每个请求启动一次解释器）
+//   reuse：     虚拟机和函数句柄只创建一次，每次请求只调用 sparrowCall
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sparrow.h"
+
+static const char *SCRIPT =
+    "function handle(var id:int, var name:string):string {\n"
+    "    var total:int = 0;\n"
+    "    for (var i = 0; i < 16; i = i + 1) { total = total + (id + i) % 7; }\n"
+    "    return name + \":\" + total;\n"
+    "}\n";
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, double *samples, int count)
+{
+    qsort(samples, (size_t)count, sizeof(double), compareDoubles);
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        sum += samples[i];
+    }
+    printf("%-12s median %8.0f ns  p99 %8.0f ns  mean %8.0f ns\n", name,
+           samples[count / 2], samples[(int)(count * 0.99)], sum / count);
+}
+
+static bool callOnce(SparrowVM *vm, SparrowHandle *handle, int id)
+{
+    SparrowValue args[2] = {sparrowInt(id), sparrowString("user")};
+    SparrowValue result;
+    return sparrowCall(vm, handle, 2, args, &result) == SPARROW_OK && result.type == SPARROW_STRING;
+}
+
+int main(int argc, char *argv[])
+{
+    int calls = argc > 1 ? atoi(argv[1]) : 20000;
+    if (calls < 1)
+    {
+        printf("Usage: embed-latency [calls]\n");
+        return 1;
+    }
+    double *samples = (double *)malloc(sizeof(double) * (size_t)calls);
+    if (samples == NULL)
+    {
+        return 1;
+    }
+
+    // 每次请求重新创建虚拟机并加载脚本
+    for (int i = 0; i < calls; i++)
+    {
+        double start = now();
+        SparrowVM *vm = sparrowNewVM(NULL);
+        sparrowLoad(vm, SCRIPT);
+        SparrowHandle *handle = sparrowGetGlobal(vm, "handle");
+        bool ok = callOnce(vm, handle, i);
+        sparrowReleaseHandle(handle);
+        sparrowFreeVM(vm);
+        samples[i] = now() - start;
+        if (!ok)
+        {
+            printf("call failed\n");
+            return 1;
+        }
+    }
+    report("per-request", samples, calls);
+
+    // 虚拟机和函数句柄只创建一次
+    SparrowVM *vm = sparrowNewVM(NULL);
+    sparrowLoad(vm, SCRIPT);
+    SparrowHandle *handle = sparrowGetGlobal(vm, "handle");
+    for (int i = 0; i < calls; i++)
+    {
+        double start = now();
+        bool ok = callOnce(vm, handle, i);
+        samples[i] = now() - start;
+        if (!ok)
+        {
+            printf("call failed: %s\n", sparrowError(vm));
+            return 1;
+        }
+    }
+    report("reuse", samples, calls);
+
+    sparrowReleaseHandle(handle);
+    sparrowFreeVM(vm);
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,454 @@
+// bench/expression_parse.c - 表达式解析的语法树黄金检查和吞吐量
+//
+// 用法：make examples && ./output/expression-parse [megabytes] [runs]
+//       默认生成约 8 MB 以表达式为主的脚本，解析 10 次，报告耗时中位数对应的 MB/s 和每秒语句数
+//
+//       ./output/expression-parse --golden bench/expressions.spw bench/expressions.ast
+//       完整解析语料（不延迟函数体），把语法树按 S 表达式逐条转储，与黄金文件逐行比较（make test 运行）；
+//       加 --update 时改为重写黄金文件。运算符文本、字面量文本和调用的行号都计入转储。
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "file_utils.h"
+#include "parser.h"
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// 转储中使用的运算符文本
+static const char *operatorText(TokenType type)
+{
+    static const char *texts[TOKEN_ERROR + 1] = {
+        [TOKEN_PLUS] = "+", [TOKEN_MINUS] = "-", [TOKEN_PLUS_PLUS] = "++", [TOKEN_MINUS_MINUS] = "--",
+        [TOKEN_MULTIPLY] = "*", [TOKEN_DIVIDE] = "/", [TOKEN_MODULO] = "%",
+        [TOKEN_PLUS_ASSIGN] = "+=", [TOKEN_MINUS_ASSIGN] = "-=", [TOKEN_MULTIPLY_ASSIGN] = "*=",
+        [TOKEN_DIVIDE_ASSIGN] = "/=", [TOKEN_MODULO_ASSIGN] = "%=",
+        [TOKEN_EQ] = "==", [TOKEN_NE] = "!=", [TOKEN_LT] = "<", [TOKEN_LE] = "<=", [TOKEN_GT] = ">",
+        [TOKEN_GE] = ">=", [TOKEN_NOT] = "!", [TOKEN_AND] = "&&", [TOKEN_OR] = "||", [TOKEN_IN] = "in"};
+    return type >= 0 && type <= TOKEN_ERROR && texts[type] != NULL ? texts[type] : "?";
+}
+
+static void dumpExpr(FILE *out, const Expr *expr);
+
+static void dumpExprList(FILE *out, Expr *const *exprs, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        fputc(' ', out);
+        dumpExpr(out, exprs[i]);
+    }
+}
+
+static void dumpExpr(FILE *out, const Expr *expr)
+{
+    if (expr == NULL)
+    {
+        fputs("nil", out);
+        return;
+    }
+    switch (expr->type)
+    {
+    case EXPR_BINARY:
+        fprintf(out, "(%s ", operatorText(expr->as.binary.op));
+        dumpExpr(out, expr->as.binary.left);
+        fputc(' ', out);
+        dumpExpr(out, expr->as.binary.right);
+        fputc(')', out);
+        break;
+    case EXPR_UNARY:
+        fprintf(out, "(unary %s ", operatorText(expr->as.unary.op));
+        dumpExpr(out, expr->as.unary.right);
+        fputc(')', out);
+        break;
+    case EXPR_POSTFIX:
+        fprintf(out, "(postfix %s ", operatorText(expr->as.postfix.op));
+        dumpExpr(out, expr->as.postfix.operand);
+        fputc(')', out);
+        break;
+    case EXPR_PREFIX:
+        fprintf(out, "(prefix %s ", operatorText(expr->as.prefix.op));
+        dumpExpr(out, expr->as.prefix.operand);
+        fputc(')', out);
+        break;
+    case EXPR_LITERAL:
+        fputs(expr->as.literal.value.lexeme, out);
+        break;
+    case EXPR_GROUPING:
+        fputs("(group ", out);
+        dumpExpr(out, expr->as.grouping.expression);
+        fputc(')', out);
+        break;
+    case EXPR_VARIABLE:
+        fputs(expr->as.variable.name.lexeme, out);
+        break;
+    case EXPR_ASSIGN:
+        fprintf(out, "(= %s ", expr->as.assign.name.lexeme);
+        dumpExpr(out, expr->as.assign.value);
+        fputc(')', out);
+        break;
+    case EXPR_CALL:
+        fprintf(out, "(call@%d ", expr->as.call.paren.line);
+        dumpExpr(out, expr->as.call.callee);
+        dumpExprList(out, expr->as.call.arguments, expr->as.call.argCount);
+        fputc(')', out);
+        break;
+    case EXPR_ARRAY_LITERAL:
+        fputs("(array", out);
+        dumpExprList(out, expr->as.arrayLiteral.elements, expr->as.arrayLiteral.elementCount);
+        fputc(')', out);
+        break;
+    case EXPR_ARRAY_ACCESS:
+        fputs("(index ", out);
+        dumpExpr(out, expr->as.arrayAccess.array);
+        fputc(' ', out);
+        dumpExpr(out, expr->as.arrayAccess.index);
+        fputc(')', out);
+        break;
+    case EXPR_ARRAY_ASSIGN:
+        fputs("(index= ", out);
+        dumpExpr(out, expr->as.arrayAssign.array);
+        fputc(' ', out);
+        dumpExpr(out, expr->as.arrayAssign.index);
+        fputc(' ', out);
+        dumpExpr(out, expr->as.arrayAssign.value);
+        fputc(')', out);
+        break;
+    case EXPR_CAST:
+        fprintf(out, "(cast %d ", (int)expr->as.cast.targetType);
+        dumpExpr(out, expr->as.cast.expression);
+        fputc(')', out);
+        break;
+    case EXPR_DOT_ACCESS:
+        fputs("(. ", out);
+        dumpExpr(out, expr->as.dotAccess.object);
+        fprintf(out, " %s)", expr->as.dotAccess.member.lexeme);
+        break;
+    case EXPR_STRUCT_LITERAL:
+        fprintf(out, "(struct %s", expr->as.structLiteral.structName.lexeme);
+        for (int i = 0; i < expr->as.structLiteral.fieldCount; i++)
+        {
+            fprintf(out, " (%s ", expr->as.structLiteral.fields[i].name.lexeme);
+            dumpExpr(out, expr->as.structLiteral.fields[i].value);
+            fputc(')', out);
+        }
+        fputc(')', out);
+        break;
+    case EXPR_STRUCT_ASSIGN:
+        fputs("(.= ", out);
+        dumpExpr(out, expr->as.structAssign.object);
+        fprintf(out, " %s ", expr->as.structAssign.field.lexeme);
+        dumpExpr(out, expr->as.structAssign.value);
+        fputc(')', out);
+        break;
+    case EXPR_COMPOUND_ASSIGN:
+        fprintf(out, "(%s ", operatorText(expr->as.compoundAssign.op));
+        dumpExpr(out, expr->as.compoundAssign.target);
+        fputc(' ', out);
+        dumpExpr(out, expr->as.compoundAssign.value);
+        fputc(')', out);
+        break;
+    case EXPR_MAP_LITERAL:
+        fputs("(map", out);
+        for (int i = 0; i < expr->as.mapLiteral.count; i++)
+        {
+            fputs(" (", out);
+            dumpExpr(out, expr->as.mapLiteral.keys[i]);
+            fputc(' ', out);
+            dumpExpr(out, expr->as.mapLiteral.values[i]);
+            fputc(')', out);
+        }
+        fputc(')', out);
+        break;
+    default:
+        fprintf(out, "(expr %d)", (int)expr->type);
+        break;
+    }
+}
+
+// 转储语料中用到的语句；其余语句只记下类型
+static void dumpStmt(FILE *out, const Stmt *stmt)
+{
+    if (stmt == NULL)
+    {
+        fputs("nil", out);
+        return;
+    }
+    switch (stmt->type)
+    {
+    case STMT_EXPRESSION:
+        dumpExpr(out, stmt->as.expression.expression);
+        break;
+    case STMT_VAR:
+        fprintf(out, "(var %s ", stmt->as.var.name.lexeme);
+        dumpExpr(out, stmt->as.var.initializer);
+        fputc(')', out);
+        break;
+    case STMT_RETURN:
+        fputs("(return ", out);
+        dumpExpr(out, stmt->as.returnStmt.value);
+        fputc(')', out);
+        break;
+    case STMT_BLOCK:
+        fputs("(block", out);
+        for (int i = 0; i < stmt->as.block.count; i++)
+        {
+            fputc(' ', out);
+            dumpStmt(out, stmt->as.block.statements[i]);
+        }
+        fputc(')', out);
+        break;
+    case STMT_FUNCTION:
+        fprintf(out, "(function %s (", stmt->as.function.name.lexeme);
+        for (int i = 0; i < stmt->as.function.paramCount; i++)
+        {
+            fprintf(out, i == 0 ? "%s" : " %s", stmt->as.function.params[i].lexeme);
+        }
+        fputs(") ", out);
+        dumpStmt(out, stmt->as.function.body);
+        fputc(')', out);
+        break;
+    case STMT_ENUM:
+        fprintf(out, "(enum %s", stmt->as.enumStmt.name.lexeme);
+        for (int i = 0; i < stmt->as.enumStmt.memberCount; i++)
+        {
+            fprintf(out, " (%s ", stmt->as.enumStmt.members[i].name.lexeme);
+            dumpExpr(out, stmt->as.enumStmt.members[i].value);
+            fputc(')', out);
+        }
+        fputc(')', out);
+        break;
+    case STMT_STRUCT:
+        fprintf(out, "(struct %s", stmt->as.structStmt.name.lexeme);
+        for (int i = 0; i < stmt->as.structStmt.fieldCount; i++)
+        {
+            fprintf(out, " %s", stmt->as.structStmt.fields[i].name.lexeme);
+        }
+        fputc(')', out);
+        break;
+    default:
+        fprintf(out, "(stmt %d)", (int)stmt->type);
+        break;
+    }
+}
+
+// 解析源代码：lazy 为 true 时与 loadProgram 相同（流式、延迟函数体），否则完整解析
+static Stmt **parseSource(const char *source, bool lazy, int *count, LexemeBlock **text, bool *ok)
+{
+    Lexer lexer;
+    initLexer(&lexer, source);
+    Parser parser;
+    if (!initStreamingParser(&parser, &lexer))
+    {
+        *ok = false;
+        *count = 0;
+        *text = NULL;
+        return NULL;
+    }
+    parser.lazyFunctions = lazy;
+    Stmt **statements = parse(&parser, count);
+    *ok = !hadParseError(&parser);
+    if (!*ok)
+    {
+        fprintf(stderr, "Parse error: %s\n", getParseErrorMsg(&parser));
+    }
+    freeParser(&parser);
+    *text = lexer.text;
+    return statements;
+}
+
+static void freeStatements(Stmt **statements, int count, LexemeBlock *text)
+{
+    for (int i = 0; i < count; i++)
+    {
+        freeStmt(statements[i]);
+    }
+    free(statements);
+    freeLexemeBlocks(text);
+}
+
+// 黄金检查：一致返回 0
+static int checkGolden(const char *corpusPath, const char *goldenPath, bool update)
+{
+    char *source = readFile(corpusPath);
+    if (source == NULL)
+    {
+        fprintf(stderr, "could not read %s\n", corpusPath);
+        return 1;
+    }
+    int count = 0;
+    LexemeBlock *text = NULL;
+    bool ok = false;
+    Stmt **statements = parseSource(source, false, &count, &text, &ok);
+
+    char *dump = NULL;
+    size_t dumpSize = 0;
+    FILE *out = open_memstream(&dump, &dumpSize);
+    if (out == NULL)
+    {
+        perror("open_memstream");
+        freeStatements(statements, count, text);
+        free(source);
+        return 1;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        dumpStmt(out, statements[i]);
+        fputc('\n', out);
+    }
+    fclose(out);
+    freeStatements(statements, count, text);
+    free(source);
+
+    int result = ok ? 0 : 1;
+    if (result == 0 && update)
+    {
+        FILE *file = fopen(goldenPath, "w");
+        if (file == NULL || fwrite(dump, 1, dumpSize, file) != dumpSize || fclose(file) != 0)
+        {
+            fprintf(stderr, "could not write %s\n", goldenPath);
+            result = 1;
+        }
+        else
+        {
+            printf("wrote %s (%d statements)\n", goldenPath, count);
+        }
+    }
+    else if (result == 0)
+    {
+        char *golden = readFile(goldenPath);
+        if (golden == NULL)
+        {
+            fprintf(stderr, "could not read %s\n", goldenPath);
+            result = 1;
+        }
+        else if (strcmp(golden, dump) != 0)
+        {
+            // 报告第一处不同的行
+            int line = 1;
+            size_t i = 0;
+            while (golden[i] != '\0' && golden[i] == dump[i])
+            {
+                line += golden[i] == '\n';
+                i++;
+            }
+            fprintf(stderr, "AST dump differs from %s at line %d\n", goldenPath, line);
+            result = 1;
+        }
+        else
+        {
+            printf("AST dump matches %s (%d statements)\n", goldenPath, count);
+        }
+        free(golden);
+    }
+    free(dump);
+    return result;
+}
+
+// 写出一段以表达式为主的脚本，返回写入的字节数；空间不足时返回负数
+static int writeExpressions(char *out, size_t size, int i)
+{
+    return snprintf(out, size,
+                    "var v%d = (a + %d * b - c / 2) %% 7 >= d && !(x[%d] == y.z) || f(g, h[1], -k) != (int)m;\n"
+                    "total = total + v%d * 3 - (w%d[i + 1] + w%d[i - 1]) / 2.5;\n"
+                    "grid[r][c] += scale * (left - right) + bias;\n"
+                    "var label%d = prefix + \"_\" + (string)(%d + offset) + suffix;\n",
+                    i, i, i, i, i, i, i, i);
+}
+
+static char *generateSource(size_t bytes)
+{
+    size_t capacity = bytes + 4096;
+    char *source = (char *)malloc(capacity);
+    if (source == NULL)
+    {
+        return NULL;
+    }
+    size_t length = 0;
+    source[0] = '\0';
+    for (int i = 0; length < bytes; i++)
+    {
+        int written = writeExpressions(source + length, capacity - length, i);
+        if (written < 0 || (size_t)written >= capacity - length)
+        {
+            break;
+        }
+        length += (size_t)written;
+    }
+    return source;
+}
+
+static int measure(int megabytes, int runs)
+{
+    char *source = generateSource((size_t)megabytes * 1048576);
+    double *samples = (double *)malloc(sizeof(double) * (size_t)runs);
+    if (source == NULL || samples == NULL)
+    {
+        fprintf(stderr, "内存分配失败\n");
+        free(source);
+        free(samples);
+        return 1;
+    }
+    size_t length = strlen(source);
+
+    int count = 0;
+    for (int i = 0; i < runs; i++)
+    {
+        LexemeBlock *text = NULL;
+        bool ok = false;
+        double start = now();
+        Stmt **statements = parseSource(source, true, &count, &text, &ok);
+        samples[i] = now() - start;
+        freeStatements(statements, count, text);
+        if (!ok)
+        {
+            free(source);
+            free(samples);
+            return 1;
+        }
+    }
+    qsort(samples, (size_t)runs, sizeof(double), compareDoubles);
+    double median = samples[runs / 2];
+
+    printf("%.1f MB %d statements, median of %d runs: %.2f ms %.1f MB/s %.2f M statements/s\n",
+           length / 1048576.0, count, runs, median / 1e6, length / 1048576.0 / (median / 1e9),
+           count / 1e6 / (median / 1e9));
+    free(source);
+    free(samples);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "--golden") == 0)
+    {
+        if (argc < 4)
+        {
+            fprintf(stderr, "usage: %s --golden corpus.spw golden.ast [--update]\n", argv[0]);
+            return 1;
+        }
+        return checkGolden(argv[2], argv[3], argc > 4 && strcmp(argv[4], "--update") == 0);
+    }
+
+    int megabytes = argc > 1 ? atoi(argv[1]) : 8;
+    int runs = argc > 2 ? atoi(argv[2]) : 10;
+    if (megabytes <= 0 || runs <= 0)
+    {
+        fprintf(stderr, "usage: %s [megabytes] [runs]\n", argv[0]);
+        return 1;
+    }
+    return measure(megabytes, runs);
+}
@@ -0,0 +1,160 @@
+// bench/lexer_throughput.c - 词法分析吞吐量
+//
+// 用法：make examples && ./output/lexer-throughput [megabytes] [runs]
+//       默认各生成约 8 MB 的两种脚本，各分析 10 次
+//
+// 在内存中生成两种脚本，对整段源代码执行词法分析并释放结果，报告耗时中位数对应的 MB/s 和每秒标记数：
+//   code：由函数组成，包含关键字、标识符、数字、带转义和不带转义的字符串以及注释，标记短而密
+//   text：带长文档注释和长字符串字面量的数据表，空白、注释和字符串正文占大部分字节
+// 用 SPARROW_SIMD=scalar|sse2 运行可对比文本扫描核函数各指令集级别的吞吐量。
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lexer.h"
+#include "simd_kernels.h"
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+typedef enum
+{
+    SOURCE_CODE,
+    SOURCE_TEXT
+} SourceKind;
+
+// 写出一段 code 脚本，返回写入的字节数；空间不足时返回负数
+static int writeCode(char *out, size_t size, int i)
+{
+    return snprintf(out, size,
+                    "// helper %d: accumulates weighted values\n"
+                    "function compute%d(var limit:int, var scale:float):float {\n"
+                    "    var total:float = %d.5;\n"
+                    "    var label = \"item_%d\";\n"
+                    "    var path = \"dir\\\\file%d.txt\\n\";\n"
+                    "    /* weights are kept\n"
+                    "       in a small table */\n"
+                    "    var weights = {\"alpha\": %d, \"beta\": 2.25};\n"
+                    "    for (var index = 0; index < limit; index += 1) {\n"
+                    "        if (index %% 7 == 0 && total >= -%d) {\n"
+                    "            total = total + index * scale - weights[\"alpha\"];\n"
+                    "        } else {\n"
+                    "            total -= length(label) / 3;\n"
+                    "        }\n"
+                    "    }\n"
+                    "    return total;\n"
+                    "}\n\n",
+                    i, i, i, i, i, i % 1000, i);
+}
+
+// 写出一段 text 脚本
+static int writeText(char *out, size_t size, int i)
+{
+    return snprintf(out, size,
+                    "/*\n"
+                    " * Record %d of the generated catalogue. Each record keeps a long description\n"
+                    " * together with a template string, so lexing time is dominated by comment bodies,\n"
+                    " * string bodies and indentation rather than by short tokens.\n"
+                    " */\n"
+                    "var record%d = {\n"
+                    "        \"description\": \"This entry describes item number %d in considerable detail, "
+                    "including its origin, its intended use and several remarks about maintenance.\",\n"
+                    "        \"template\": \"Dear customer,\\n\\tyour order %d has been shipped and should "
+                    "arrive within the next few business days.\\n\"\n"
+                    "};\n\n",
+                    i, i, i, i);
+}
+
+// 生成至少 bytes 字节的脚本，返回的字符串由调用方释放
+static char *generateSource(SourceKind kind, size_t bytes)
+{
+    size_t capacity = bytes + 4096;
+    char *source = (char *)malloc(capacity);
+    if (source == NULL)
+    {
+        return NULL;
+    }
+    size_t length = 0;
+    for (int i = 0; length < bytes; i++)
+    {
+        int written = kind == SOURCE_CODE ? writeCode(source + length, capacity - length, i)
+                                          : writeText(source + length, capacity - length, i);
+        if (written < 0 || (size_t)written >= capacity - length)
+        {
+            break;
+        }
+        length += (size_t)written;
+    }
+    return source;
+}
+
+// 生成一种脚本并报告吞吐量；失败时返回 false
+static bool measure(const char *name, SourceKind kind, int megabytes, int runs)
+{
+    char *source = generateSource(kind, (size_t)megabytes * 1048576);
+    double *samples = (double *)malloc(sizeof(double) * (size_t)runs);
+    if (source == NULL || samples == NULL)
+    {
+        fprintf(stderr, "内存分配失败\n");
+        free(source);
+        free(samples);
+        return false;
+    }
+    size_t length = strlen(source);
+
+    int tokenCount = 0;
+    for (int i = 0; i < runs; i++)
+    {
+        double start = now();
+        TokenList list;
+        if (!performLexicalAnalysis(source, &list))
+        {
+            fprintf(stderr, "lexical analysis failed\n");
+            free(source);
+            free(samples);
+            return false;
+        }
+        tokenCount = list.count;
+        freeTokenList(&list);
+        samples[i] = now() - start;
+    }
+    qsort(samples, (size_t)runs, sizeof(double), compareDoubles);
+    double median = samples[runs / 2];
+
+    printf("%-5s %6.1f MB %9d tokens %9.2f ms %8.1f MB/s %6.1f M tokens/s\n", name, length / 1048576.0,
+           tokenCount, median / 1e6, length / 1048576.0 / (median / 1e9), tokenCount / 1e6 / (median / 1e9));
+
+    free(source);
+    free(samples);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int megabytes = argc > 1 ? atoi(argv[1]) : 8;
+    int runs = argc > 2 ? atoi(argv[2]) : 10;
+    if (megabytes <= 0 || runs <= 0)
+    {
+        fprintf(stderr, "usage: %s [megabytes] [runs]\n", argv[0]);
+        return 1;
+    }
+
+    printf("simd  %s, median of %d runs\n", simdLevelName(simdLevel()), runs);
+    if (!measure("code", SOURCE_CODE, megabytes, runs) || !measure("text", SOURCE_TEXT, megabytes, runs))
+    {
+        return 1;
+    }
+    return 0;
+}
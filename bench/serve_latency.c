@@ -0,0 +1,204 @@
+// bench/serve_latency.c - 常驻模式的请求延迟
+//
+// 用法：make && make examples && ./output/serve-latency [runs] [script]
+//       默认运行 bench/hook.spw 各 200 次
+//
+// 对比一次脚本运行的端到端耗时：
+//   spawn： 每次启动 output/sparrow 进程，读取、解析并执行脚本
+//   client：每次启动 output/sparrow-client 进程，由常驻进程执行缓存的语法树
+//   socket：在本进程中直接连接常驻进程发送请求（宿主自带客户端时的耗时）
+#define _XOPEN_SOURCE 700
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "server_protocol.h"
+
+#define SPARROW "output/sparrow"
+#define CLIENT "output/sparrow-client"
+
+extern char **environ;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void report(const char *name, double *samples, int count)
+{
+    qsort(samples, (size_t)count, sizeof(double), compareDoubles);
+    double sum = 0;
+    for (int i = 0; i < count; i++)
+    {
+        sum += samples[i];
+    }
+    printf("%-8s median %8.1f us  p99 %8.1f us  mean %8.1f us\n", name,
+           samples[count / 2] / 1e3, samples[(int)(count * 0.99)] / 1e3, sum / count / 1e3);
+}
+
+// 启动进程，标准输出重定向到 /dev/null；wait 为 true 时等待其退出并返回退出码
+static int spawn(char *const argv[], bool wait, pid_t *child)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+    pid_t pid;
+    int failed = posix_spawn(&pid, argv[0], &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (failed != 0)
+    {
+        return -1;
+    }
+    if (child != NULL)
+    {
+        *child = pid;
+    }
+    if (!wait)
+    {
+        return 0;
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static int connectServer(const char *socketPath)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// 连接常驻进程执行一次脚本，返回退出状态，通信失败时返回 -1
+static int request(const char *socketPath, const char *script, const char *event, const char *payload)
+{
+    int fd = connectServer(socketPath);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    uint32_t status;
+    char *output = NULL;
+    char *error = NULL;
+    bool ok = sendUint32(fd, 3) && sendFrame(fd, script, strlen(script)) &&
+              sendFrame(fd, event, strlen(event)) && sendFrame(fd, payload, strlen(payload)) &&
+              receiveUint32(fd, &status) && (output = receiveFrame(fd, NULL)) != NULL &&
+              (error = receiveFrame(fd, NULL)) != NULL;
+    free(output);
+    free(error);
+    close(fd);
+    return ok ? (int)status : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    int runs = argc > 1 ? atoi(argv[1]) : 200;
+    const char *script = argc > 2 ? argv[2] : "bench/hook.spw";
+    char path[4096];
+    if (runs < 1 || realpath(script, path) == NULL)
+    {
+        printf("Usage: serve-latency [runs] [script]\n");
+        return 1;
+    }
+
+    double *samples = (double *)malloc(sizeof(double) * (size_t)runs);
+    if (samples == NULL)
+    {
+        return 1;
+    }
+
+    // 每次启动一个解释器进程
+    char *spawnArgs[] = {SPARROW, path, "push", "abcdef", NULL};
+    for (int i = 0; i < runs; i++)
+    {
+        double start = now();
+        if (spawn(spawnArgs, true, NULL) != 0)
+        {
+            printf("%s failed\n", SPARROW);
+            return 1;
+        }
+        samples[i] = now() - start;
+    }
+    report("spawn", samples, runs);
+
+    // 启动常驻进程并等待套接字可以连接
+    char socketPath[64];
+    snprintf(socketPath, sizeof(socketPath), "/tmp/sparrow-bench-%d.sock", (int)getpid());
+    char *serveArgs[] = {SPARROW, "--serve", socketPath, NULL};
+    pid_t server;
+    if (spawn(serveArgs, false, &server) != 0)
+    {
+        printf("could not start %s --serve\n", SPARROW);
+        return 1;
+    }
+    int fd = -1;
+    struct timespec pause = {0, 10 * 1000 * 1000};
+    for (int attempt = 0; attempt < 200 && fd < 0; attempt++)
+    {
+        nanosleep(&pause, NULL);
+        fd = connectServer(socketPath);
+    }
+    if (fd < 0)
+    {
+        printf("server did not start\n");
+        kill(server, SIGTERM);
+        return 1;
+    }
+    close(fd);
+
+    // 第一次请求解析并缓存脚本，不计入
+    int failures = request(socketPath, path, "push", "abcdef") == 0 ? 0 : 1;
+
+    char *clientArgs[] = {CLIENT, socketPath, path, "push", "abcdef", NULL};
+    for (int i = 0; i < runs; i++)
+    {
+        double start = now();
+        failures += spawn(clientArgs, true, NULL) != 0;
+        samples[i] = now() - start;
+    }
+    report("client", samples, runs);
+
+    for (int i = 0; i < runs; i++)
+    {
+        double start = now();
+        failures += request(socketPath, path, "push", "abcdef") != 0;
+        samples[i] = now() - start;
+    }
+    report("socket", samples, runs);
+
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+    free(samples);
+    if (failures > 0)
+    {
+        printf("%d requests failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,264 @@
+// bench/startup_cache.c - 延迟解析函数体和预编译程序缓存（.spwc）对启动耗时的影响
+//
+// 用法：make examples && ./output/startup-cache [lines] [runs]
+//       默认生成约 50000 行的脚本，各加载 20 次
+//
+// 在临时目录生成一个由大量函数组成、main 只调用其中几十个的脚本，对比：
+//   eager：读取源文件、词法分析并完整解析每个函数体
+//   lazy： 读取源文件、词法分析，函数体只匹配花括号（--lazy --no-cache）
+//   cache：读取源文件、校验并映射 .spwc，重建语法树（--lazy，函数体仍延迟解析）
+// 耗时包含释放语法树。glibc 下同时报告加载后和执行 main 后占用的堆内存。
+// 最后检查三种方式加载的程序输出相同。
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "interpreter.h"
+#include "program_cache.h"
+
+// main 调用的函数数
+#define CALLED_FUNCTIONS 40
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *samples, int count)
+{
+    qsort(samples, (size_t)count, sizeof(double), compareDoubles);
+    return samples[count / 2];
+}
+
+// 生成脚本：每个函数 13 行，包含循环、分支、字符串、数组和映射字面量；返回实际行数
+static int generateScript(const char *path, int lines)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return -1;
+    }
+    int functions = lines / 13 > 0 ? lines / 13 : 1;
+    int written = 0;
+    for (int i = 0; i < functions; i++)
+    {
+        fprintf(file,
+                "function f%d(var n:int):int {\n"
+                "    var total:int = %d;\n"
+                "    var names = [\"a%d\", \"b%d\", \"c\"];\n"
+                "    var weights = {\"x\": %d, \"y\": 2.5};\n"
+                "    for (var i = 0; i < n; i = i + 1) {\n"
+                "        if (i %% 3 == 0 && total > -%d) {\n"
+                "            total += i * %d;\n"
+                "        } else {\n"
+                "            total = total - length(names);\n"
+                "        }\n"
+                "    }\n"
+                "    return total;\n"
+                "}\n",
+                i, i, i, i, i, i, i % 97 + 1);
+        written += 13;
+    }
+    // 均匀地调用其中 CALLED_FUNCTIONS 个函数
+    int called = functions < CALLED_FUNCTIONS ? functions : CALLED_FUNCTIONS;
+    fprintf(file, "function main():void {\n    var sum = 0;\n");
+    for (int i = 0; i < called; i++)
+    {
+        fprintf(file, "    sum = sum + f%d(20);\n", (int)((long long)i * functions / called));
+    }
+    fprintf(file, "    println(sum);\n}\n");
+    written += called + 4;
+    fclose(file);
+    return written;
+}
+
+typedef enum
+{
+    LOAD_EAGER,
+    LOAD_LAZY,
+    LOAD_CACHE
+} LoadMode;
+
+// 已分配的堆内存字节数；无法取得时为 0
+static size_t heapInUse(void)
+{
+#if defined(__GLIBC__)
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+static ProgramStatus load(LoadedProgram *program, const char *path, LoadMode mode)
+{
+    return loadProgram(program, path, mode == LOAD_CACHE, mode != LOAD_EAGER);
+}
+
+// 加载 runs 次并返回耗时中位数（纳秒）；任意一次失败返回负数
+static double timeLoad(const char *path, LoadMode mode, int runs)
+{
+    double *samples = (double *)malloc(sizeof(double) * (size_t)runs);
+    if (samples == NULL)
+    {
+        return -1;
+    }
+    for (int i = 0; i < runs; i++)
+    {
+        LoadedProgram program;
+        double start = now();
+        ProgramStatus status = load(&program, path, mode);
+        bool fromCache = program.fromCache;
+        freeLoadedProgram(&program);
+        samples[i] = now() - start;
+        if (status != PROGRAM_OK || fromCache != (mode == LOAD_CACHE))
+        {
+            fprintf(stderr, "load failed (status %d, fromCache %d)\n", (int)status, (int)fromCache);
+            free(samples);
+            return -1;
+        }
+    }
+    double result = median(samples, runs);
+    free(samples);
+    return result;
+}
+
+// 执行一次程序，返回捕获的输出（调用方释放）；loaded 和 executed 为加载后和执行后增加的堆内存
+static char *runOnce(const char *path, LoadMode mode, size_t *loaded, size_t *executed)
+{
+    size_t base = heapInUse();
+    LoadedProgram program;
+    if (load(&program, path, mode) != PROGRAM_OK)
+    {
+        freeLoadedProgram(&program);
+        return NULL;
+    }
+    *loaded = heapInUse() - base;
+    Interpreter interpreter;
+    initInterpreter(&interpreter);
+    freeOutputBuffer(&interpreter.output);
+    initOutputCapture(&interpreter.output);
+    interpret(&interpreter, program.statements, program.stmtCount);
+    *executed = heapInUse() - base;
+
+    char *output = (char *)malloc(interpreter.output.length + 1);
+    if (output != NULL)
+    {
+        memcpy(output, interpreter.output.data, interpreter.output.length);
+        output[interpreter.output.length] = '\0';
+    }
+    freeInterpreter(&interpreter);
+    freeLoadedProgram(&program);
+    return output;
+}
+
+int main(int argc, char **argv)
+{
+    int lines = argc > 1 ? atoi(argv[1]) : 50000;
+    int runs = argc > 2 ? atoi(argv[2]) : 20;
+    if (lines <= 0 || runs <= 0)
+    {
+        fprintf(stderr, "usage: %s [lines] [runs]\n", argv[0]);
+        return 1;
+    }
+
+    char directory[] = "/tmp/sparrow-startupXXXXXX";
+    if (mkdtemp(directory) == NULL)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    char scriptPath[64];
+    snprintf(scriptPath, sizeof(scriptPath), "%s/startup.spw", directory);
+
+    int exitCode = 1;
+    char *cachePath = NULL;
+    struct stat sourceInfo;
+    struct stat cacheInfo;
+    int written = generateScript(scriptPath, lines);
+    if (written < 0 || stat(scriptPath, &sourceInfo) != 0)
+    {
+        fprintf(stderr, "could not write %s\n", scriptPath);
+        goto cleanup;
+    }
+    // 缓存路径由脚本的绝对路径决定，脚本写出后才能计算
+    cachePath = programCachePath(scriptPath);
+    if (cachePath == NULL)
+    {
+        fprintf(stderr, "no usable cache directory (set XDG_CACHE_HOME or HOME)\n");
+        goto cleanup;
+    }
+
+    double times[3];
+    times[LOAD_EAGER] = timeLoad(scriptPath, LOAD_EAGER, runs);
+    times[LOAD_LAZY] = timeLoad(scriptPath, LOAD_LAZY, runs);
+    // 首次使用缓存时解析并写入 .spwc
+    LoadedProgram first;
+    if (load(&first, scriptPath, LOAD_CACHE) != PROGRAM_OK)
+    {
+        freeLoadedProgram(&first);
+        goto cleanup;
+    }
+    freeLoadedProgram(&first);
+    times[LOAD_CACHE] = timeLoad(scriptPath, LOAD_CACHE, runs);
+    if (times[LOAD_EAGER] < 0 || times[LOAD_LAZY] < 0 || times[LOAD_CACHE] < 0 ||
+        stat(cachePath, &cacheInfo) != 0)
+    {
+        goto cleanup;
+    }
+
+    static const char *names[3] = {"eager", "lazy", "cache"};
+    char *outputs[3];
+    size_t loaded[3];
+    size_t executed[3];
+    for (int mode = 0; mode < 3; mode++)
+    {
+        outputs[mode] = runOnce(scriptPath, (LoadMode)mode, &loaded[mode], &executed[mode]);
+    }
+    bool same = outputs[0] != NULL && outputs[1] != NULL && outputs[2] != NULL &&
+                strcmp(outputs[0], outputs[1]) == 0 && strcmp(outputs[0], outputs[2]) == 0;
+    for (int mode = 0; mode < 3; mode++)
+    {
+        free(outputs[mode]);
+    }
+    if (!same)
+    {
+        fprintf(stderr, "output differs between eager, lazy and cached program\n");
+        goto cleanup;
+    }
+
+    printf("script  %d lines, %lld bytes, main calls %d functions\n", written, (long long)sourceInfo.st_size,
+           CALLED_FUNCTIONS);
+    printf("cache   %lld bytes\n", (long long)cacheInfo.st_size);
+    printf("        load median    vs eager   heap after load   after main\n");
+    for (int mode = 0; mode < 3; mode++)
+    {
+        printf("%-7s %8.2f ms  %7.1fx   %12.1f MB  %8.1f MB\n", names[mode], times[mode] / 1e6,
+               times[LOAD_EAGER] / times[mode], loaded[mode] / 1048576.0, executed[mode] / 1048576.0);
+    }
+    exitCode = 0;
+
+cleanup:
+    if (cachePath != NULL)
+    {
+        unlink(cachePath);
+    }
+    unlink(scriptPath);
+    rmdir(directory);
+    free(cachePath);
+    return exitCode;
+}
@@ -0,0 +1,218 @@
+// bench/stream_parse.c - 流式解析与完整标记数组的峰值内存
+//
+// 用法：make examples && ./output/stream-parse [megabytes]
+//       默认生成约 100 MB 的脚本
+//
+// 在临时目录生成一个以数据为主的脚本（大量全局变量的数组、映射字面量，夹杂少量函数），
+// 每种方式在单独的子进程中加载一次，报告子进程的峰值常驻内存（getrusage 的 ru_maxrss）和耗时：
+//   source：只读取源文件，作为基线
+//   array： 词法分析得到完整的标记数组后再解析（原先 loadProgram 的做法）
+//   stream：解析器通过环形缓冲区按需从词法分析器取标记（现在 loadProgram 的做法）
+// 两种解析方式都延迟函数体；最后检查二者得到的语句数相同。
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "file_utils.h"
+#include "parser.h"
+
+typedef enum
+{
+    MODE_SOURCE,
+    MODE_ARRAY,
+    MODE_STREAM
+} ParseMode;
+
+// 子进程通过管道报告的结果
+typedef struct
+{
+    double nanoseconds;
+    long maxRssKb;
+    int stmtCount;
+    int ok;
+} ModeResult;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// 生成至少 bytes 字节的脚本，失败时返回 false
+static bool generateScript(const char *path, size_t bytes)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+    size_t length = 0;
+    for (int i = 0; length < bytes; i++)
+    {
+        int written = fprintf(file,
+                              "var row%d = [%d, %d.25, \"name_%d\", {\"id\": %d, \"tags\": [\"a\", \"b\"], \"ok\": true}];\n"
+                              "var total%d = row%d[0] * 3 + row%d[1] - (%d %% 7);\n",
+                              i, i, i, i, i, i, i, i, i);
+        if (i % 100 == 0)
+        {
+            written += fprintf(file,
+                               "function check%d(var values) {\n"
+                               "    var sum = 0;\n"
+                               "    for (var value in values) { sum = sum + value; }\n"
+                               "    return sum;\n"
+                               "}\n",
+                               i);
+        }
+        if (written < 0)
+        {
+            fclose(file);
+            return false;
+        }
+        length += (size_t)written;
+    }
+    return fclose(file) == 0;
+}
+
+// 在子进程中执行：加载一次并测量
+static ModeResult loadOnce(const char *path, ParseMode mode)
+{
+    ModeResult result = {0};
+    double start = now();
+    char *source = readFile(path);
+    if (source == NULL)
+    {
+        return result;
+    }
+
+    Stmt **statements = NULL;
+    Parser parser;
+    if (mode == MODE_ARRAY)
+    {
+        TokenList list;
+        if (!performLexicalAnalysis(source, &list))
+        {
+            return result;
+        }
+        initParser(&parser, list.tokens, list.count);
+        parser.lazyFunctions = true;
+        statements = parse(&parser, &result.stmtCount);
+    }
+    else if (mode == MODE_STREAM)
+    {
+        Lexer lexer;
+        initLexer(&lexer, source);
+        if (!initStreamingParser(&parser, &lexer))
+        {
+            return result;
+        }
+        parser.lazyFunctions = true;
+        statements = parse(&parser, &result.stmtCount);
+        freeParser(&parser);
+    }
+    result.nanoseconds = now() - start;
+    result.ok = mode == MODE_SOURCE || !hadParseError(&parser);
+
+    // 子进程随即退出，语法树和标记不再释放
+    (void)statements;
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    result.maxRssKb = usage.ru_maxrss;
+    return result;
+}
+
+static bool runMode(const char *path, ParseMode mode, ModeResult *result)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        perror("pipe");
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0)
+    {
+        close(fds[0]);
+        ModeResult measured = loadOnce(path, mode);
+        ssize_t written = write(fds[1], &measured, sizeof(measured));
+        _exit(written == (ssize_t)sizeof(measured) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t got = read(fds[0], result, sizeof(*result));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return got == (ssize_t)sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0 && result->ok;
+}
+
+int main(int argc, char **argv)
+{
+    int megabytes = argc > 1 ? atoi(argv[1]) : 100;
+    if (megabytes <= 0)
+    {
+        fprintf(stderr, "usage: %s [megabytes]\n", argv[0]);
+        return 1;
+    }
+
+    char directory[] = "/tmp/sparrow-streamXXXXXX";
+    if (mkdtemp(directory) == NULL)
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+    char scriptPath[64];
+    snprintf(scriptPath, sizeof(scriptPath), "%s/data.spw", directory);
+
+    int exitCode = 1;
+    if (!generateScript(scriptPath, (size_t)megabytes * 1048576))
+    {
+        fprintf(stderr, "could not write %s\n", scriptPath);
+        goto cleanup;
+    }
+
+    static const char *names[3] = {"source", "array", "stream"};
+    ModeResult results[3];
+    for (int mode = 0; mode < 3; mode++)
+    {
+        if (!runMode(scriptPath, (ParseMode)mode, &results[mode]))
+        {
+            fprintf(stderr, "%s: load failed\n", names[mode]);
+            goto cleanup;
+        }
+    }
+    if (results[MODE_ARRAY].stmtCount != results[MODE_STREAM].stmtCount)
+    {
+        fprintf(stderr, "statement count differs between array and stream\n");
+        goto cleanup;
+    }
+
+    printf("script  %d MB, %d statements\n", megabytes, results[MODE_STREAM].stmtCount);
+    for (int mode = 0; mode < 3; mode++)
+    {
+        long extra = results[mode].maxRssKb - results[MODE_SOURCE].maxRssKb;
+        printf("%-7s peak RSS %8.1f MB (+%7.1f MB over source) %9.1f ms\n", names[mode],
+               results[mode].maxRssKb / 1024.0, extra / 1024.0, results[mode].nanoseconds / 1e6);
+    }
+    printf("stream / array peak RSS over source: %.2f\n",
+           (double)(results[MODE_STREAM].maxRssKb - results[MODE_SOURCE].maxRssKb) /
+               (double)(results[MODE_ARRAY].maxRssKb - results[MODE_SOURCE].maxRssKb));
+    exitCode = 0;
+
+cleanup:
+    unlink(scriptPath);
+    rmdir(directory);
+    return exitCode;
+}
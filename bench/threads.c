@@ -0,0 +1,223 @@
+// bench/threads.c
+// 多解释器并发：在一个进程中用 N 个线程同时运行同一个脚本，每个线程各自词法分析、解析并创建解释器，
+// 检查每个线程的输出和错误与单线程运行完全相同，并报告单次运行和并发运行的耗时。
+//
+// 用法：./output/sparrow-threads [--explicit-stack] [threads] script
+//       make test 以 8 个线程运行 bench/threads.spw
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "lexer.h"
+#include "parser.h"
+#include "interpreter.h"
+#include "file_utils.h"
+
+// 工作线程的栈大小；解释器按此设置递归求值可用的 C 栈
+#define THREAD_STACK_SIZE (16 * 1024 * 1024)
+#define THREAD_STACK_MARGIN (512 * 1024)
+
+typedef struct
+{
+    const char *source;
+    bool explicitStack;
+    char *output;            // 脚本的全部输出
+    char error[256];         // 解析或运行时错误，没有错误时为空串
+    double seconds;          // 从词法分析到释放解释器的耗时
+} Run;
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 读出临时文件的全部内容
+static char *readBack(FILE *file)
+{
+    long size = ftell(file);
+    char *text = (char *)malloc((size_t)size + 1);
+    if (text == NULL)
+    {
+        return NULL;
+    }
+    rewind(file);
+    size_t length = fread(text, 1, (size_t)size, file);
+    text[length] = '\0';
+    return text;
+}
+
+static void *runScript(void *arg)
+{
+    Run *run = (Run *)arg;
+    double start = now();
+    run->error[0] = '\0';
+
+    FILE *capture = tmpfile();
+    if (capture == NULL)
+    {
+        snprintf(run->error, sizeof(run->error), "无法创建临时文件");
+        return NULL;
+    }
+
+    TokenList tokens;
+    if (!performLexicalAnalysis(run->source, &tokens))
+    {
+        snprintf(run->error, sizeof(run->error), "Lexical analysis failed");
+        fclose(capture);
+        return NULL;
+    }
+
+    Parser parser;
+    initParser(&parser, tokens.tokens, tokens.count);
+    int stmtCount = 0;
+    Stmt **statements = parse(&parser, &stmtCount);
+
+    if (hadParseError(&parser))
+    {
+        snprintf(run->error, sizeof(run->error), "Parse error: %s", getParseErrorMsg(&parser));
+    }
+    else
+    {
+        Interpreter interpreter;
+        initInterpreter(&interpreter);
+        interpreter.explicitStack = run->explicitStack;
+        interpreter.stackLimit = THREAD_STACK_SIZE - THREAD_STACK_MARGIN;
+
+        // 输出写入本线程的临时文件
+        freeOutputBuffer(&interpreter.output);
+        initOutputBuffer(&interpreter.output, fileno(capture), OUTPUT_FULLY_BUFFERED);
+
+        interpret(&interpreter, statements, stmtCount);
+        if (hadInterpreterError(&interpreter))
+        {
+            snprintf(run->error, sizeof(run->error), "Runtime error: %s", getInterpreterError(&interpreter));
+        }
+        freeInterpreter(&interpreter);
+
+        for (int i = 0; i < stmtCount; i++)
+        {
+            freeStmt(statements[i]);
+        }
+        free(statements);
+    }
+
+    freeTokenList(&tokens);
+
+    fseek(capture, 0, SEEK_END);
+    run->output = readBack(capture);
+    fclose(capture);
+    run->seconds = now() - start;
+    return NULL;
+}
+
+static bool sameRun(const Run *a, const Run *b)
+{
+    return a->output != NULL && b->output != NULL &&
+           strcmp(a->output, b->output) == 0 && strcmp(a->error, b->error) == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    bool explicitStack = false;
+    int threadCount = 8;
+    int argIndex = 1;
+
+    if (argIndex < argc && strcmp(argv[argIndex], "--explicit-stack") == 0)
+    {
+        explicitStack = true;
+        argIndex++;
+    }
+    if (argIndex + 1 < argc)
+    {
+        threadCount = atoi(argv[argIndex++]);
+    }
+    if (argIndex >= argc || threadCount < 1)
+    {
+        printf("Usage: sparrow-threads [--explicit-stack] [threads] script\n");
+        return 1;
+    }
+
+    char *source = readFile(argv[argIndex]);
+    if (source == NULL)
+    {
+        printf("Could not read file '%s'\n", argv[argIndex]);
+        return 1;
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, THREAD_STACK_SIZE);
+
+    // 单线程运行一次作为参照
+    Run reference = {source, explicitStack, NULL, "", 0};
+    pthread_t thread;
+    if (pthread_create(&thread, &attr, runScript, &reference) != 0)
+    {
+        printf("pthread_create failed\n");
+        free(source);
+        return 1;
+    }
+    pthread_join(thread, NULL);
+
+    Run *runs = (Run *)calloc((size_t)threadCount, sizeof(Run));
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * (size_t)threadCount);
+    if (runs == NULL || threads == NULL)
+    {
+        printf("内存分配失败\n");
+        free(runs);
+        free(threads);
+        free(reference.output);
+        free(source);
+        return 1;
+    }
+
+    double start = now();
+    int started = 0;
+    for (; started < threadCount; started++)
+    {
+        runs[started].source = source;
+        runs[started].explicitStack = explicitStack;
+        if (pthread_create(&threads[started], &attr, runScript, &runs[started]) != 0)
+        {
+            printf("pthread_create failed\n");
+            break;
+        }
+    }
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now() - start;
+    pthread_attr_destroy(&attr);
+
+    int mismatches = started == threadCount ? 0 : 1;
+    for (int i = 0; i < started; i++)
+    {
+        if (!sameRun(&reference, &runs[i]))
+        {
+            printf("thread %d: 输出与单线程运行不同\n", i);
+            mismatches++;
+        }
+        free(runs[i].output);
+    }
+
+    if (reference.error[0] != '\0')
+    {
+        printf("%s\n", reference.error);
+    }
+    printf("%d threads: %s, single run %.3f s, %d concurrent runs %.3f s (%.2fx throughput)\n",
+           threadCount, mismatches == 0 ? "identical" : "MISMATCH", reference.seconds,
+           threadCount, elapsed, reference.seconds * threadCount / elapsed);
+
+    free(reference.output);
+    free(runs);
+    free(threads);
+    free(source);
+    return mismatches == 0 ? 0 : 1;
+}
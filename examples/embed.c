@@ -0,0 +1,122 @@
+// examples/embed.c - 在 C 程序中嵌入灵雀
+//
+// 构建并运行：make examples && ./output/embed-example
+//
+// 创建虚拟机并注册宿主原生函数，加载一次脚本，之后反复调用其中的函数，
+// 以 SparrowValue 和数组句柄交换参数与返回值。
+#include <stdio.h>
+#include "sparrow.h"
+
+static const char *SCRIPT =
+    "function price(var base:int, var quantity:int):float {\n"
+    "    return base * quantity * discount(quantity);\n"
+    "}\n"
+    "function greet(var name:string):string {\n"
+    "    return \"你好，\" + name;\n"
+    "}\n"
+    "function squares(var values) {\n"
+    "    var result = [];\n"
+    "    for (v in values) { result = push(result, v * v); }\n"
+    "    return result;\n"
+    "}\n"
+    "function fail():int {\n"
+    "    return discount(\"many\");\n"
+    "}\n";
+
+// 宿主原生函数：按数量返回折扣，userData 为折扣起点
+static bool discountNative(SparrowVM *vm, int argCount, const SparrowValue *args,
+                           SparrowValue *result, void *userData)
+{
+    (void)argCount;
+    if (args[0].type != SPARROW_INT)
+    {
+        sparrowNativeError(vm, "discount() 的参数必须是整数");
+        return false;
+    }
+    int threshold = *(const int *)userData;
+    *result = sparrowNumber(args[0].as.integer >= threshold ? 0.9 : 1.0);
+    return true;
+}
+
+int main(void)
+{
+    SparrowVM *vm = sparrowNewVM(NULL);
+    if (vm == NULL)
+    {
+        return 1;
+    }
+
+    int threshold = 10;
+    sparrowRegister(vm, "discount", 1, discountNative, &threshold);
+
+    if (sparrowLoad(vm, SCRIPT) != SPARROW_OK)
+    {
+        printf("load failed: %s\n", sparrowError(vm));
+        sparrowFreeVM(vm);
+        return 1;
+    }
+
+    // 函数句柄只取一次，之后反复调用
+    SparrowHandle *price = sparrowGetGlobal(vm, "price");
+    SparrowHandle *greet = sparrowGetGlobal(vm, "greet");
+    SparrowHandle *squares = sparrowGetGlobal(vm, "squares");
+    SparrowHandle *fail = sparrowGetGlobal(vm, "fail");
+
+    for (int quantity = 5; quantity <= 15; quantity += 5)
+    {
+        SparrowValue args[2] = {sparrowInt(20), sparrowInt(quantity)};
+        SparrowValue result;
+        if (sparrowCall(vm, price, 2, args, &result) == SPARROW_OK)
+        {
+            printf("price(20, %d) = %g\n", quantity, result.as.number);
+        }
+    }
+
+    SparrowValue name = sparrowString("灵雀");
+    SparrowValue greeting;
+    if (sparrowCall(vm, greet, 1, &name, &greeting) == SPARROW_OK)
+    {
+        printf("%.*s\n", (int)greeting.as.string.length, greeting.as.string.chars);
+    }
+
+    // 数组经句柄传入和取回
+    SparrowHandle *input = sparrowNewArray();
+    for (int i = 1; i <= 4; i++)
+    {
+        sparrowArrayPush(input, sparrowInt(i));
+    }
+    SparrowValue arrayArg = sparrowHandleValue(input);
+    SparrowValue output;
+    if (sparrowCall(vm, squares, 1, &arrayArg, &output) == SPARROW_OK && output.type == SPARROW_HANDLE)
+    {
+        printf("squares:");
+        for (int i = 0; i < sparrowArrayLength(output.as.handle); i++)
+        {
+            SparrowValue element;
+            sparrowArrayGet(output.as.handle, i, &element);
+            printf(" %lld", (long long)element.as.integer);
+        }
+        printf(" (%s)\n", sparrowHandleTypeName(output.as.handle));
+        sparrowReleaseHandle(output.as.handle);
+    }
+    sparrowReleaseHandle(input);
+
+    // 运行时错误只影响本次调用
+    if (sparrowCall(vm, fail, 0, NULL, NULL) != SPARROW_OK)
+    {
+        printf("fail(): %s\n", sparrowError(vm));
+    }
+    SparrowValue again[2] = {sparrowInt(1), sparrowInt(10)};
+    SparrowValue result;
+    if (sparrowCall(vm, price, 2, again, &result) == SPARROW_OK)
+    {
+        printf("price(1, 10) = %g\n", result.as.number);
+    }
+
+    sparrowReleaseHandle(price);
+    sparrowReleaseHandle(greet);
+    sparrowReleaseHandle(squares);
+    sparrowReleaseHandle(fail);
+    sparrowFreeVM(vm);
+    return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef SPARROW_ARRAY_SORT_H
+#define SPARROW_ARRAY_SORT_H
+
+#include <stdbool.h>
+#include "value.h"
+
+// 排序项：排序键和元素在原数组中的位置（装饰-排序-去装饰）
+typedef struct
+{
+    Value key; // 排序键（不持有所有权）
+    int index; // 元素在原数组中的位置
+} SortEntry;
+
+// 一组排序键的类别
+typedef enum
+{
+    SORT_KEYS_INT,     // 全部为整数
+    SORT_KEYS_FLOAT,   // 全部为浮点数
+    SORT_KEYS_NUMBER,  // 整数与浮点数混合
+    SORT_KEYS_STRING,  // 全部为字符串
+    SORT_KEYS_BOOL,    // 全部为布尔值
+    SORT_KEYS_INVALID  // 类别混合或包含无法比较的值
+} SortKeyKind;
+
+// 判断一组排序键的类别（空数组视为 SORT_KEYS_INT）
+SortKeyKind classifySortKeys(const SortEntry *entries, int count);
+
+// 两个值能否相互比较（同为数字、同为字符串或同为布尔值）
+bool sortKeysComparable(Value a, Value b);
+
+// 比较两个可比较的值，返回负数、0 或正数；NaN 排在所有数字之后
+int compareSortKeys(Value a, Value b);
+
+/**
+ * 按排序键升序排列
+ *
+ * 纯整数或纯浮点数键使用 LSD 基数排序（本身稳定），其余使用内省排序；
+ * stable 为 true 时以原位置作为次要键，使相等键保持原有顺序。
+ */
+void sortEntries(SortEntry *entries, int count, SortKeyKind kind, bool stable);
+
+#endif // SPARROW_ARRAY_SORT_H
@@ -28,6 +28,8 @@ typedef enum
     EXPR_DOT_ACCESS,    // 点访问表达式（如 obj.member）
     EXPR_STRUCT_LITERAL, // 结构体字面量
     EXPR_STRUCT_ASSIGN,  // 结构体字段赋值
+    EXPR_COMPOUND_ASSIGN, // 复合赋值（+=、-=、*=、/=、%=）
+    EXPR_MAP_LITERAL,     // 映射字面量
 } ExprType;
 
 // 语句类型
@@ -49,8 +51,18 @@ typedef enum
     STMT_DO_WHILE,   // do-while循环
     STMT_ENUM,       // 枚举声明
     STMT_STRUCT,     // 结构体声明
+    STMT_FOR_IN,     // for-in循环
+    STMT_YIELD,      // yield语句
 } StmtType;
 
+// 表达式或语句是否含有函数调用（节点以 calloc 分配，初始为未计算）
+typedef enum
+{
+    CALL_UNKNOWN, // 尚未计算
+    CALL_ABSENT,  // 不含函数调用
+    CALL_PRESENT  // 含有函数调用
+} CallState;
+
 // 枚举成员结构
 typedef struct
 {
@@ -233,10 +245,27 @@ typedef struct
     Expr *value;    // 赋值的值
 } StructAssignExpr;
 
+// 复合赋值表达式
+typedef struct
+{
+    Expr *target; // 赋值目标：变量、数组元素或结构体字段
+    TokenType op; // 运算符（TOKEN_PLUS_ASSIGN 等）
+    Expr *value;  // 右侧的值
+} CompoundAssignExpr;
+
+// 映射字面量表达式
+typedef struct
+{
+    Expr **keys;   // 键表达式
+    Expr **values; // 值表达式
+    int count;     // 键值对数量
+} MapLiteralExpr;
+
 // 表达式结构
 typedef struct Expr
 {
     ExprType type; // 表达式类型
+    CallState callState; // 是否含有函数调用，由显式栈求值器按需计算并缓存
     union
     {
         BinaryExpr binary;             // 二元表达式
@@ -255,6 +284,8 @@ typedef struct Expr
         DotAccessExpr dotAccess;       // 点访问表达式
         StructLiteralExpr structLiteral; // 结构体字面量表达式
         StructAssignExpr structAssign;   // 结构体字段赋值表达式
+        CompoundAssignExpr compoundAssign; // 复合赋值表达式
+        MapLiteralExpr mapLiteral;         // 映射字面量表达式
     } as;
 } Expr;
 
@@ -273,11 +304,23 @@ typedef struct
     bool isStatic;       // 是否为静态变量
 } VarStmt;
 
+// 尚未解析的函数体：预解析时只匹配花括号并记录标记范围，首次调用时由 parseLazyBody 解析。
+// 标记数组归加载程序的一方所有，与语法树一同释放；范围之后直到 TOKEN_EOF 的标记都可读。
+// 流式解析时没有完整的标记数组，函数体复制自己的标记（末尾加 TOKEN_EOF），由 ownsTokens 标明
+typedef struct
+{
+    Token *tokens;   // '{' 之后的第一个标记
+    int tokenCount;  // 到匹配的 '}'（含）为止的标记数
+    bool hasYield;   // 函数体中含有 yield（不计嵌套的函数声明）
+    bool ownsTokens; // tokens 由本结构持有，释放函数体时一并释放
+} LazyBody;
+
 // 代码块
 typedef struct
 {
     Stmt **statements; // 语句数组
     int count;         // 语句数量
+    LazyBody *lazy;    // 延迟解析的函数体，解析后为 NULL
 } BlockStmt;
 
 // if语句
@@ -304,6 +347,14 @@ typedef struct
     Stmt *body;        // 循环体
 } ForStmt;
 
+// for-in循环：for (x in iterable)
+typedef struct
+{
+    Token name;     // 循环变量名
+    Expr *iterable; // 被遍历的表达式
+    Stmt *body;     // 循环体
+} ForInStmt;
+
 // 函数声明
 typedef struct
 {
@@ -315,6 +366,7 @@ typedef struct
     int paramCount;             // 参数数量
     struct Stmt *body;          // 函数体
     bool isStatic;              // 是否为静态函数
+    bool isGenerator;           // 函数体中含有 yield，调用时返回生成器
 } FunctionStmt;
 
 // return语句
@@ -324,6 +376,14 @@ typedef struct
     Expr *value;   // 可能为NULL
 } ReturnStmt;
 
+// yield语句：yield 值; 或 yield* 可遍历值;
+typedef struct
+{
+    Token keyword;  // 用于错误报告的位置信息
+    Expr *value;    // 产出的值，可以为NULL
+    bool delegate;  // yield*：依次产出另一个生成器或可遍历值的全部元素
+} YieldStmt;
+
 // case 语句结构
 typedef struct
 {
@@ -355,6 +415,8 @@ typedef struct DoWhileStmt
 struct Stmt
 {
     StmtType type;
+    bool containsYield; // 该语句或其子语句中含有 yield（不计嵌套的函数声明），由 markYieldStatements 设置
+    CallState callState; // 是否含有函数调用，由显式栈求值器按需计算并缓存
     union
     {
         ExpressionStmt expression; // 表达式语句
@@ -366,6 +428,8 @@ struct Stmt
         IfStmt ifStmt;             // if语句
         WhileStmt whileLoop;       // while循环
         ForStmt forLoop;           // for循环
+        ForInStmt forIn;           // for-in循环
+        YieldStmt yieldStmt;       // yield语句
         FunctionStmt function;     // 函数声明
         ReturnStmt returnStmt;     // return语句
         SwitchStmt switchStmt;     // switch语句
@@ -394,6 +458,8 @@ Expr *createCastExpr(BaseType targetType, Expr *expression);
 Expr *createDotAccessExpr(Expr *object, Token member);
 Expr *createStructLiteralExpr(Token structName, StructFieldInit *fields, int fieldCount);
 Expr *createStructAssignExpr(Expr *object, Token field, Expr *value);
+Expr *createCompoundAssignExpr(Expr *target, TokenType op, Expr *value);
+Expr *createMapLiteralExpr(Expr **keys, Expr **values, int count);
 
 // 创建语句节点的函数
 Stmt *createExpressionStmt(Expr *expression);
@@ -402,12 +468,15 @@ Stmt *createConstStmt(Token name, TypeAnnotation type, Expr *initializer);
 Stmt *createMultiVarStmt(Token *names, int count, TypeAnnotation type, Expr *initializer);
 Stmt *createMultiConstStmt(Token *names, int count, TypeAnnotation type, Expr **initializers, int initializerCount);
 Stmt *createBlockStmt(Stmt **statements, int count);
+Stmt *createLazyBlockStmt(Token *tokens, int tokenCount, bool hasYield);
 Stmt *createIfStmt(Expr *condition, Stmt *thenBranch, Stmt *elseBranch);
 Stmt *createWhileStmt(Expr *condition, Stmt *body);
 Stmt *createDoWhileStmt(Stmt *body, Expr *condition);
 Stmt *createForStmt(Stmt *initializer, Expr *condition, Expr *increment, Stmt *body);
+Stmt *createForInStmt(Token name, Expr *iterable, Stmt *body);
 Stmt *createFunctionStmt(Token name, Token *params, bool *paramHasVar, TypeAnnotation *paramTypes, int paramCount, TypeAnnotation returnTypeToken, Stmt *body);
 Stmt *createReturnStmt(Token keyword, Expr *value);
+Stmt *createYieldStmt(Token keyword, Expr *value, bool delegate);
 Stmt *createSwitchStmt(Expr *discriminant, CaseStmt *cases, int caseCount);
 Stmt *createBreakStmt(Token keyword);
 Stmt *createEnumStmt(Token name, EnumMember *members, int memberCount);
@@ -416,6 +485,8 @@ Stmt *createStaticVarStmt(Token name, TypeAnnotation type, Expr *initializer);
 Stmt *createStaticFunctionStmt(Token name, Token *params, bool *paramHasVar, TypeAnnotation *paramTypes, int paramCount, TypeAnnotation returnType, Stmt *body);
 
 
+// 标记函数体中含有 yield 的语句，返回函数体是否含有 yield
+bool markYieldStatements(Stmt *stmt);
 
 // 释放AST节点内存
 void freeExpr(Expr *expr);
@@ -0,0 +1,83 @@
+#ifndef SPARROW_CONTAINERS_H
+#define SPARROW_CONTAINERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "value.h"
+
+// 堆中的一项
+typedef struct
+{
+    Value item;     // 元素
+    Value key;      // 键函数求出的键；没有键函数时为 null，按元素本身比较
+    uint64_t order; // 插入序号，键相等时先插入的先出
+} HeapEntry;
+
+/**
+ * 优先队列（二叉堆）
+ *
+ * 最小堆或最大堆，可带键函数：入堆时求一次键并与元素一起保存，之后的比较不再调用键函数。
+ * 键相等的元素按插入顺序出堆。
+ *
+ * refCount 只用于原生函数回调键函数期间固定堆：回调可能给持有该堆的变量重新赋值，
+ * 固定后堆在回调返回前不会被释放。值语义不变，copyValue 仍然深度复制。
+ */
+struct Heap
+{
+    HeapEntry *entries;
+    int count;
+    int capacity;
+    bool isMax;      // true 为最大堆
+    Value keyFn;     // 键函数，没有时为 null
+    uint64_t nextOrder;
+    int refCount;
+};
+
+/**
+ * 双端队列（环形缓冲区）
+ *
+ * 容量为 2 的幂，两端的插入和删除都是摊销 O(1)。
+ */
+struct Deque
+{
+    Value *items;
+    int head;     // 队首元素的位置
+    int count;
+    int capacity;
+};
+
+Value createHeap(bool isMax, Value keyFn);
+Heap *copyHeap(const Heap *heap);
+void retainHeap(Heap *heap);
+void releaseHeap(Heap *heap);
+bool heapsEqual(const Heap *a, const Heap *b);
+
+// 堆顶项，堆为空时返回 NULL
+const HeapEntry *heapTop(const Heap *heap);
+// 堆项的比较键
+Value heapEntryKey(const HeapEntry *entry);
+// 插入元素；key 为键函数求出的键（没有键函数时传 null）。item 和 key 的所有权转移给堆。
+// 内存分配失败时返回 false，并释放 item 和 key
+bool heapPush(Heap *heap, Value item, Value key);
+// 弹出堆顶元素，所有权转移给调用方；堆为空时返回 false
+bool heapPop(Heap *heap, Value *item);
+// 按出堆顺序复制所有元素到新数组
+Value heapToArray(const Heap *heap);
+
+Value createDeque(int initialCapacity);
+Deque *copyDeque(const Deque *deque);
+void freeDeque(Deque *deque);
+bool dequesEqual(const Deque *a, const Deque *b);
+
+// 第 index 个元素（从队首数起）的存储位置，0 <= index < count
+Value *dequeAt(const Deque *deque, int index);
+// 在两端插入元素，所有权转移给队列；内存分配失败时返回 false，并释放 item
+bool dequePushFront(Deque *deque, Value item);
+bool dequePushBack(Deque *deque, Value item);
+// 从两端取出元素，所有权转移给调用方；队列为空时返回 false
+bool dequePopFront(Deque *deque, Value *item);
+bool dequePopBack(Deque *deque, Value *item);
+// 从队首到队尾复制所有元素到新数组
+Value dequeToArray(const Deque *deque);
+
+#endif // SPARROW_CONTAINERS_H
@@ -45,9 +45,16 @@ void freeEnvironment(Environment* env);
 // 查找变量的索引
 Value *getVariableRef(Environment *env, const char *name);
 
+// 获取变量的存储位置，并返回其是否为常量
+Value *getVariableSlot(Environment *env, const char *name, bool *isConst);
+
+// 当前作用域中是否已有同名常量
+bool isLocalConstant(Environment *env, const char *name);
+
 void initStaticStorage(StaticStorage *storage);
 void defineStaticVariable(StaticStorage *storage, const char *name, Value value, bool isConst);
 Value getStaticVariable(StaticStorage *storage, const char *name);
+Value *getStaticVariableSlot(StaticStorage *storage, const char *name, bool *isConst);
 void assignStaticVariable(StaticStorage *storage, const char *name, Value value);
 void freeStaticStorage(StaticStorage *storage);
 
@@ -8,8 +8,12 @@
 #include "interpreter/binary_operations.h"
 #include "interpreter/unary_operations.h"
 #include "interpreter/array_operations.h"
+#include "interpreter/map_operations.h"
 #include "interpreter/function_calls.h"
 #include "interpreter/cast_operations.h"
 #include "interpreter/statement_executor.h"
+#include "interpreter/compound_assignment.h"
+#include "interpreter/generator.h"
+#include "interpreter/frame_evaluator.h"
 
 #endif // SPARROW_INTERPRETER_H
\ No newline at end of file
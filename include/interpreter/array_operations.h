@@ -8,5 +8,8 @@
 Value evaluateArrayLiteral(Interpreter *interpreter, Expr *expr);
 Value evaluateArrayAccess(Interpreter *interpreter, Expr *expr);
 Value evaluateArrayAssign(Interpreter *interpreter, Expr *expr);
+Value completeArrayAccess(Interpreter *interpreter, Expr *expr, Value arrayValue, Value indexValue);
+Value completeArrayAssign(Interpreter *interpreter, Expr *expr, Value arrayValue, Value indexValue, Value value);
+bool getArrayIndex(Interpreter *interpreter, Value indexValue, int *index);
 
 #endif // SPARROW_ARRAY_OPERATIONS_H
\ No newline at end of file
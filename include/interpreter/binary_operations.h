@@ -6,5 +6,7 @@
 
 // 二元运算函数
 Value evaluateBinary(Interpreter *interpreter, Expr *expr);
+Value completeBinary(Interpreter *interpreter, Expr *expr, Value left);
+Value applyBinary(Interpreter *interpreter, TokenType op, Value left, Value right);
 
 #endif // SPARROW_BINARY_OPERATIONS_H
\ No newline at end of file
@@ -5,5 +5,6 @@
 
 // 类型转换函数
 Value evaluateCast(Interpreter *interpreter, Expr *expr);
+Value completeCast(Interpreter *interpreter, Expr *expr, Value value);
 
 #endif // SPARROW_CAST_OPERATIONS_H
\ No newline at end of file
@@ -0,0 +1,12 @@
+// include/interpreter/compound_assignment.h
+#ifndef SPARROW_COMPOUND_ASSIGNMENT_H
+#define SPARROW_COMPOUND_ASSIGNMENT_H
+
+#include "interpreter_core.h"
+
+// 复合赋值（+=、-=、*=、/=、%=）
+Value evaluateCompoundAssign(Interpreter *interpreter, Expr *expr);
+void executeCompoundAssign(Interpreter *interpreter, Expr *expr);
+Value *completeCompoundAssign(Interpreter *interpreter, Expr *expr, Value operand);
+
+#endif // SPARROW_COMPOUND_ASSIGNMENT_H
@@ -11,8 +11,12 @@ Value evaluateLiteral(Expr *expr);
 Value evaluateGrouping(Interpreter *interpreter, Expr *expr);
 Value evaluateVariable(Interpreter *interpreter, Expr *expr);
 Value evaluateAssign(Interpreter *interpreter, Expr *expr);
+Value completeAssign(Interpreter *interpreter, Expr *expr, Value value);
 Value evaluateDotAccess(Interpreter *interpreter, Expr *expr);
+Value completeDotAccess(Interpreter *interpreter, Expr *expr, Value objectValue);
 Value evaluateStructLiteral(Interpreter *interpreter, Expr *expr);
+Value completeStructLiteral(Interpreter *interpreter, Expr *expr, Value *values);
 Value evaluateStructAssign(Interpreter *interpreter, Expr *expr);
+Value completeStructAssign(Interpreter *interpreter, Expr *expr, Value value, Value objectValue);
 
 #endif // SPARROW_EXPRESSION_EVALUATOR_H
\ No newline at end of file
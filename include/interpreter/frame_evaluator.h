@@ -0,0 +1,59 @@
+// include/interpreter/frame_evaluator.h
+#ifndef SPARROW_FRAME_EVALUATOR_H
+#define SPARROW_FRAME_EVALUATOR_H
+
+#include "interpreter_core.h"
+
+/**
+ * 显式栈求值器
+ *
+ * 含有函数调用的语句和表达式拆成任务压入堆上的任务栈，脚本函数的调用帧也在其中，
+ * 递归深度只受 maxCallDepth 和内存限制，不受 C 栈大小限制；不含函数调用的部分仍交给
+ * execute / evaluate 直接执行。
+ *
+ * 生成器也用它逐步执行函数体：含有 yield 的语句总是拆成任务，yield 时任务栈留在生成器中，
+ * 下次恢复时从栈顶继续。
+ */
+
+typedef struct Task Task;
+
+// 一次运行的任务栈和值栈，都分配在堆上
+typedef struct
+{
+    Task *tasks;
+    int taskCount;
+    int taskCapacity;
+    Value *values;
+    int valueCount;
+    int valueCapacity;
+    bool expandCalls; // 含有函数调用的语句和表达式是否拆成任务
+} Machine;
+
+// 运行任务栈的结果
+typedef enum
+{
+    MACHINE_RUNNING,   // 仍在执行（只在求值器内部使用）
+    MACHINE_DONE,      // 任务栈已空
+    MACHINE_YIELDED,   // 执行了 yield，产出的值写入 value
+    MACHINE_DELEGATED, // 执行了 yield*，其值是生成器，写入 value 由调用方委托
+    MACHINE_FAILED     // 运行时错误，已弹出全部任务
+} MachineResult;
+
+void initMachine(Machine *machine, bool expandCalls);
+
+// 释放任务和值，不恢复任务切换前的环境；用于已结束或挂起的任务栈
+void freeMachine(Machine *machine);
+
+// 开始执行一条语句：不需要拆开的语句立即执行完，其余的压入任务栈
+void beginStatement(Interpreter *interpreter, Machine *machine, Stmt *stmt);
+
+// 执行任务直到任务栈为空、yield 或出错
+MachineResult runMachine(Interpreter *interpreter, Machine *machine, Value *value);
+
+// 用显式栈执行一条语句
+void executeExplicit(Interpreter *interpreter, Stmt *stmt);
+
+// 用显式栈调用脚本函数，参数只读借用
+Value callFunctionExplicit(Interpreter *interpreter, Function *function, const Value *arguments, int argCount);
+
+#endif // SPARROW_FRAME_EVALUATOR_H
@@ -5,6 +5,23 @@
 
 // 函数调用函数
 Value evaluateCall(Interpreter *interpreter, Expr *expr);
-Value callFunction(Interpreter *interpreter, Function *function, Value *arguments, int argCount);
+Value callFunction(Interpreter *interpreter, Function *function, const Value *arguments, int argCount);
+
+// 首次调用前解析延迟的函数体；失败时已报告运行时错误并返回 false
+bool prepareFunctionBody(Interpreter *interpreter, Function *function);
+
+// return f(...) 的尾调用：prepareTailCall 记入 returnStatus，takeReturnValue 取出 return 的值（尾调用在此执行）
+bool prepareTailCall(Interpreter *interpreter, Expr *expr);
+Value takeReturnValue(Interpreter *interpreter);
+
+// 供原生函数回调脚本函数或原生函数，参数只读借用
+Value callCallable(Interpreter *interpreter, Value callee, const Value *arguments, int argCount);
+int callableArity(Value callee);
+
+// 变量表达式的存储位置（只读借用，不复制），找不到时返回 NULL
+const Value *borrowVariable(Interpreter *interpreter, Expr *expr);
+
+// 借用就地修改的原生函数第一个参数变量的存储位置，失败时已报告运行时错误并返回 false
+bool bindMutableArgument(Interpreter *interpreter, NativeFunction *native, Expr *argument, Value *arg);
 
 #endif // SPARROW_FUNCTION_CALLS_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+// include/interpreter/generator.h
+#ifndef SPARROW_GENERATOR_H
+#define SPARROW_GENERATOR_H
+
+#include "interpreter_core.h"
+#include "frame_evaluator.h"
+
+typedef enum
+{
+    GENERATOR_SUSPENDED, // 尚未开始或停在 yield 处
+    GENERATOR_RUNNING,   // 正在执行
+    GENERATOR_DONE       // 已结束
+} GeneratorState;
+
+/**
+ * 生成器
+ *
+ * 执行状态保存在自己的任务栈中（无栈协程），挂起时不占用 C 栈：含有 yield 的语句由显式栈
+ * 求值器拆成任务，其余语句由 execute 一次执行完（--explicit-stack 下含有调用的语句也拆开）。
+ * yield* 委托给另一个生成器时记录在 delegate 中，恢复时直接进入委托链最内层的生成器，递归的生成器不会加深 C 栈；
+ * 最内层的生成器缓存在 innermost 中，深层委托每次恢复不必从头遍历委托链。
+ * 生成器按引用计数共享，复制生成器值得到的是同一个生成器。
+ */
+struct Generator
+{
+    char *name;             // 生成器函数名
+    Stmt *body;             // 函数体
+    Environment *scope;     // 参数所在的环境
+    Environment *environment; // 挂起时所在的环境，恢复时从这里继续
+    Machine machine;        // 任务栈
+    bool started;           // 是否已开始执行函数体
+    GeneratorState state;
+    Generator *delegate;    // yield* 正在委托的生成器
+    Generator *delegator;   // 正在委托给本生成器的生成器，同一时间至多一个
+    Generator *innermost;   // 委托链最内层生成器的缓存（不持有引用）
+    uint64_t innermostEpoch; // 缓存时的委托纪元，与当前纪元不同则缓存失效
+    int refCount;
+};
+
+// 恢复生成器的结果
+typedef enum
+{
+    GENERATOR_YIELDED,  // 产出了一个值
+    GENERATOR_FINISHED, // 已结束，没有更多值
+    GENERATOR_FAILED    // 运行时错误，已通过 runtimeError 报告
+} GeneratorResult;
+
+// 以参数副本创建生成器，函数体在第一次恢复时才开始执行
+Value createGenerator(Interpreter *interpreter, Function *function, const Value *arguments, int argCount);
+void retainGenerator(Generator *generator);
+void releaseGenerator(Generator *generator);
+
+// 执行到下一个 yield，产出的值写入 value
+GeneratorResult resumeGenerator(Interpreter *interpreter, Generator *generator, Value *value);
+
+#endif // SPARROW_GENERATOR_H
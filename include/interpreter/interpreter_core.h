@@ -5,7 +5,21 @@
 #include "../environment.h"
 #include "../value.h"
 
+// return 语句的执行状态：由 execute 设置，调用方（函数调用、循环等）检查并清除
 typedef struct {
+    bool hasReturn;
+    Value value;
+    bool isTailCall;  // 尾调用：value 是待调用的脚本函数，参数在 arguments 中，由 callFunction 复用当前调用帧执行
+    Value *arguments;
+    int argCount;
+} ReturnStatusType;
+
+// break 语句的执行状态
+typedef struct {
+    bool hasBreak;
+} BreakStatusType;
+
+typedef struct Interpreter {
     Environment* globals;   
     Environment* environment; 
     StaticStorage *staticStorage;  
@@ -13,21 +27,25 @@ typedef struct {
     char errorMessage[256];
     bool hasMainFunction;  
     Function* mainFunction; 
+    OutputBuffer output;    // 标准输出缓冲区
+    bool explicitStack;     // 用显式栈求值器执行，脚本函数之间的调用不占用 C 栈
+    int maxCallDepth;       // 脚本函数的最大调用深度
+    int callDepth;          // 当前调用深度
+    uintptr_t stackBase;    // interpret 开始时的 C 栈位置，0 表示未记录
+    size_t stackLimit;      // 递归求值时允许使用的 C 栈字节数
+    ReturnStatusType returnStatus; // 控制流状态都属于解释器实例，多个解释器可以在不同线程中同时运行
+    BreakStatusType breakStatus;
+    uint64_t delegationEpoch;      // 委托纪元：生成器委托链每断开一环就递增，使缓存的最内层生成器失效
+    NativeFunction *activeNative;  // 正在调用的 v2 原生函数，宿主注册的原生函数由此取得回调
+    char **scriptArgs;             // args() 返回的脚本参数，由调用方持有
+    int scriptArgCount;
+    bool inputDisabled;            // input() 报告运行时错误而不是读取标准输入（常驻模式）
+    uint64_t deadline;             // 执行截止时间（CLOCK_MONOTONIC 纳秒），0 表示不限时，见 setTimeLimit
+    unsigned int deadlineCountdown; // 距离下一次读取时钟还要检查的次数
 } Interpreter;
 
-// 定义全局状态结构体类型
-typedef struct {
-    bool hasReturn;
-    Value value;
-} ReturnStatusType;
-
-typedef struct {
-    bool hasBreak;
-} BreakStatusType;
-
-// 全局状态变量外部声明
-extern ReturnStatusType returnStatus;
-extern BreakStatusType breakStatus;
+// 默认的最大调用深度；递归求值时通常先受 C 栈大小限制
+#define DEFAULT_MAX_CALL_DEPTH 2000000
 
 // 核心解释器函数
 void initInterpreter(Interpreter* interpreter);
@@ -38,4 +56,20 @@ const char* getInterpreterError(Interpreter* interpreter);
 void freeInterpreter(Interpreter* interpreter);
 void runtimeError(Interpreter *interpreter, const char *format, ...);
 
+// 进入一层脚本函数调用：超出最大调用深度或 C 栈即将耗尽时报告运行时错误并返回 false
+bool enterCall(Interpreter *interpreter);
+void leaveCall(Interpreter *interpreter);
+
+// 从现在起限制执行时间（毫秒），0 表示不限时
+void setTimeLimit(Interpreter *interpreter, int milliseconds);
+// 循环每次迭代和每次脚本函数调用时检查：超过截止时间时报告运行时错误并返回 false
+bool checkDeadline(Interpreter *interpreter);
+
+// 条件判断的真值规则，if/while、生成器、显式栈求值器和 filter 等原生函数共用
+bool isTruthy(Value value);
+
+// 分配在堆上的作用域：生成器挂起期间、显式栈求值器的任务出栈之前都要保持有效
+Environment *createHeapScope(Environment *enclosing); // 内存不足时返回 NULL
+void freeHeapScope(Environment *scope);
+
 #endif // SPARROW_INTERPRETER_CORE_H
\ No newline at end of file
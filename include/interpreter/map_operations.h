@@ -0,0 +1,17 @@
+// include/interpreter/map_operations.h
+#ifndef SPARROW_MAP_OPERATIONS_H
+#define SPARROW_MAP_OPERATIONS_H
+
+#include "interpreter_core.h"
+#include "../map.h"
+
+// 映射操作函数
+Value evaluateMapLiteral(Interpreter *interpreter, Expr *expr);
+
+// 检查映射的键是否受支持，不支持时报告运行时错误
+bool checkMapKey(Interpreter *interpreter, Value key);
+
+// 以 key 为键写入 value 的副本，key 的所有权转移给映射
+bool mapAssign(Interpreter *interpreter, Map *map, Value key, Value value);
+
+#endif // SPARROW_MAP_OPERATIONS_H
@@ -4,4 +4,10 @@
 
 #include "interpreter_core.h"
 
+// for-in 的下一个元素，cursor 为遍历位置（初始为 0）；没有更多元素或出错时返回 false
+bool forInNext(Interpreter *interpreter, Value iterable, int64_t *cursor, Value *element);
+
+// for-in 遍历的变量在外层环境 outer 中的存储位置，找不到时返回 NULL
+const Value *forInSource(Interpreter *interpreter, Environment *outer, Expr *iterable);
+
 #endif // SPARROW_STATEMENT_EXECUTOR_H
\ No newline at end of file
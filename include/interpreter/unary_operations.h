@@ -6,6 +6,7 @@
 
 // 一元运算函数
 Value evaluateUnary(Interpreter *interpreter, Expr *expr);
+Value applyUnary(Interpreter *interpreter, TokenType op, Value right);
 Value evaluatePostfix(Interpreter *interpreter, Expr *expr);
 Value evaluatePrefix(Interpreter *interpreter, Expr *expr);
 
@@ -5,6 +5,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 // 定义所有可能的标记类型
 typedef enum
@@ -24,6 +26,11 @@ typedef enum
 	TOKEN_DIVIDE,	   // /
 	TOKEN_MODULO,	   // %
 	TOKEN_ASSIGN,	   // =
+	TOKEN_PLUS_ASSIGN,	   // +=
+	TOKEN_MINUS_ASSIGN,	   // -=
+	TOKEN_MULTIPLY_ASSIGN, // *=
+	TOKEN_DIVIDE_ASSIGN,   // /=
+	TOKEN_MODULO_ASSIGN,   // %=
 	TOKEN_EQ,		   // ==
 	TOKEN_NE,		   // !=
 	TOKEN_LT,		   // <
@@ -74,6 +81,7 @@ typedef enum
 	TOKEN_FALSE,	   // false
 	TOKEN_ENUM,		   // enum
 	TOKEN_STRUCT,	   // struct
+	TOKEN_YIELD,	   // yield
 	// 错误标记
 	TOKEN_ERROR
 } TokenType;
@@ -86,24 +94,45 @@ typedef struct
 	int line;	  // 行号
 	union
 	{
-		int intValue;	   // 整数值
+		int64_t intValue;  // 整数值
 		double floatValue; // 浮点数值
 		char *stringValue; // 字符串值
 	} value;
 } Token;
 
+// 存放标记文本的内存块：标识符、数字和字符串的 lexeme 以及字符串值依次以 '\0' 结尾写入，
+// 关键字、运算符和错误信息的 lexeme 指向静态字符串
+typedef struct LexemeBlock
+{
+	struct LexemeBlock *next;
+	size_t used;
+	size_t capacity;
+	char data[];
+} LexemeBlock;
+
 // 词法分析器结构
 typedef struct
 {
-	const char *source;	 // 源代码
+	const char *source;	 // 当前标记的起始位置
 	const char *current; // 当前解析位置
+	const char *end;	 // 源代码末尾的 '\0'
 	int line;			 // 当前行号
+	LexemeBlock *text;	 // 已生成标记的文本，标记不再使用时用 freeLexemeBlocks 释放
 } Lexer;
 
+// 词法分析的结果：标记数组和标记文本所在的内存块，用 freeTokenList 一同释放
+typedef struct
+{
+	Token *tokens;
+	int count;
+	LexemeBlock *text;
+} TokenList;
+
 void initLexer(Lexer *lexer, const char *source);					// 初始化词法分析器
 Token nextToken(Lexer *lexer);										// 获取下一个标记
-void freeToken(Token *token);										// 释放标记内存
+void freeLexemeBlocks(LexemeBlock *blocks);							// 释放标记文本
 const char *getTokenName(TokenType type);							// 获取标记名称
-Token *performLexicalAnalysis(const char *source, int *tokenCount); // 执行词法分析
+bool performLexicalAnalysis(const char *source, TokenList *list);	// 执行词法分析，失败时 list 为空
+void freeTokenList(TokenList *list);								// 释放标记数组和标记文本
 
 #endif // SPARROW_LEXER_H
\ No newline at end of file
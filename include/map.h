@@ -0,0 +1,60 @@
+#ifndef SPARROW_MAP_H
+#define SPARROW_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "value.h"
+
+// 映射中的一个键值对；key 为 VAL_NULL 表示该项已被删除
+typedef struct
+{
+    Value key;
+    Value value;
+    uint32_t hash; // 键的哈希值，扩容和比较时不必重新计算
+} MapEntry;
+
+// 哈希索引中的一个槽位；entry < 0 表示空槽
+typedef struct
+{
+    uint32_t hash;
+    int32_t entry; // 在 entries 中的位置
+} MapSlot;
+
+/**
+ * 映射（哈希表）
+ *
+ * 键值对按插入顺序存放在 entries 中，遍历和打印时保持插入顺序；
+ * slots 是开放寻址的哈希索引，采用 Robin Hood 线性探测：插入时距离理想位置更远的项
+ * 抢占较近项的槽位，使探测长度保持均匀，查找遇到更短的探测距离即可提前结束；
+ * 删除时把后续项向前移动（backward shift），不留墓碑。
+ */
+struct Map
+{
+    MapEntry *entries;
+    int entryCount;    // entries 中已使用的项数（含已删除项）
+    int entryCapacity;
+    int count;         // 有效键值对个数
+    MapSlot *slots;
+    uint32_t slotMask; // 槽位数 - 1，槽位数为 2 的幂
+};
+
+Value createMap(int initialCapacity);
+void freeMap(Map *map);
+Map *copyMap(const Map *map);
+bool mapsEqual(const Map *a, const Map *b);
+
+// 键必须是字符串、整数、浮点数（非 NaN）或布尔值；整数与值相等的浮点数视为同一个键
+bool mapKeySupported(Value key);
+
+// 查找键，返回值的存储位置，不存在时返回 NULL
+Value *mapGet(const Map *map, Value key);
+bool mapHas(const Map *map, Value key);
+
+// 设置键值对，key 和 value 的所有权转移给映射；键已存在时保留原有位置并替换值。
+// 内存分配失败时返回 false，并释放传入的 key 和 value
+bool mapSet(Map *map, Value key, Value value);
+
+// 删除键，返回该键是否存在
+bool mapRemove(Map *map, Value key);
+
+#endif // SPARROW_MAP_H
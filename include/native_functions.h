@@ -12,17 +12,74 @@ NativeFunction *createNativeFn(const char *name, int arity,
                                Value (*function)(int, Value *));
 
 // 基础原生函数声明
-Value printNative(int argCount, Value *args);   // 打印
+NativeStatus printNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 打印
 Value clockNative(int argCount, Value *args);   // 获取当前时间
-Value typeNative(int argCount, Value *args);    // 获取值类型
-Value inputNative(int argCount, Value *args);   // 获取用户输入
-Value printlnNative(int argCount, Value *args); // 打印并换行
+NativeStatus typeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);    // 获取值类型
+NativeStatus inputNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 获取用户输入
+NativeStatus printlnNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 打印并换行
+NativeStatus flushNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 写出缓冲的输出
+NativeStatus argsNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);    // 获取脚本参数
+
+// 计时和基准测试函数
+NativeStatus nanoTimeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 单调时钟纳秒数
+NativeStatus wallTimeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 当前时间（秒）
+NativeStatus benchNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 基准测试
 
 // 数组相关的原生函数
-Value lengthNative(int argCount, Value *args); // 获取数组长度
+NativeStatus lengthNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 获取数组或字符串长度
 Value pushNative(int argCount, Value *args);   // 向动态数组添加元素
 Value popNative(int argCount, Value *args);    // 从动态数组获取最后元素
 Value popArrayNative(int argCount, Value *args); // 从动态数组移除最后元素，返回新数组
 Value sliceNative(int argCount, Value *args);  // 数组切片
 
+// 高阶数组函数
+NativeStatus mapNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 映射
+NativeStatus filterNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);  // 过滤
+NativeStatus reduceNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);  // 归约
+NativeStatus forEachNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 遍历
+NativeStatus anyNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 存在满足条件的元素
+NativeStatus allNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 所有元素满足条件
+
+// 排序和查找函数
+NativeStatus sortNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);         // 排序
+NativeStatus sortByNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);       // 按键或字段排序
+NativeStatus binarySearchNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 二分查找
+NativeStatus lowerBoundNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 下界
+NativeStatus partitionNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);    // 按条件划分
+
+// 数值归约与查找函数（向量化）
+NativeStatus sumNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 求和
+NativeStatus meanNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);    // 平均值
+NativeStatus minNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 最小值
+NativeStatus maxNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 最大值
+NativeStatus dotNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 点积
+NativeStatus indexOfNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 查找位置
+NativeStatus countNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 计数
+
+// 映射函数
+NativeStatus hasNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);    // 是否包含键
+NativeStatus keysNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 所有键
+NativeStatus valuesNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 所有值
+NativeStatus removeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 删除键
+
+// 优先队列和双端队列函数
+NativeStatus heapNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);      // 创建堆
+NativeStatus heapPushNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);  // 入堆
+NativeStatus heapPopNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 弹出堆顶
+NativeStatus heapPeekNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);  // 查看堆顶
+NativeStatus dequeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);     // 创建双端队列
+NativeStatus pushFrontNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 队首插入
+NativeStatus pushBackNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);  // 队尾插入
+NativeStatus popFrontNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);  // 队首取出
+NativeStatus popBackNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 队尾取出
+NativeStatus peekFrontNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 查看队首
+NativeStatus peekBackNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);  // 查看队尾
+NativeStatus toArrayNative(Interpreter *interpreter, int argCount, const Value *args, Value *result);   // 转换为数组
+
+// 区间函数
+NativeStatus rangeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 创建区间
+
+// 生成器函数
+NativeStatus nextNative(Interpreter *interpreter, int argCount, const Value *args, Value *result); // 恢复生成器
+
 #endif // SPARROW_NATIVE_FUNCTIONS_H
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef SPARROW_NUMERIC_CONVERSION_H
+#define SPARROW_NUMERIC_CONVERSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "value.h"
+
+// 格式化任意 double 或 int64 所需的缓冲区大小（含结尾的 '\0'）
+#define NUMBER_BUFFER_SIZE 32
+
+// 数字解析结果状态
+typedef enum
+{
+    NUMBER_PARSE_OK,           // 解析成功
+    NUMBER_PARSE_EMPTY,        // 空文本（或只有空白）
+    NUMBER_PARSE_INVALID,      // 不是合法的数字
+    NUMBER_PARSE_OUT_OF_RANGE, // 超出 double 的表示范围
+    NUMBER_PARSE_TOO_LONG      // 文本过长，无法在栈上缓冲
+} NumberParseStatus;
+
+// 数字解析结果
+typedef struct
+{
+    bool isInteger;     // 无小数点和指数且在 int64 范围内时为 true
+    int64_t integer;    // isInteger 为 true 时有效
+    double number;      // 始终有效（整数时为其 double 近似值）
+    size_t errorOffset; // 解析失败时第一个非法字符相对 text 的偏移
+} ParsedNumber;
+
+/**
+ * 解析数字文本，不进行任何堆内存分配
+ *
+ * 语法：[空白][+|-]数字[.数字][(e|E)[+|-]数字][空白]，整数部分和小数部分可以省略其一。
+ * text 不要求以 '\0' 结尾。超出 int64 范围的整数按浮点数返回。
+ */
+NumberParseStatus parseNumber(const char *text, size_t length, ParsedNumber *result);
+
+// 解析状态的说明文字，用于错误信息
+const char *numberParseStatusMessage(NumberParseStatus status);
+
+/**
+ * 数字格式化，返回写入的字符数（不含 '\0'）
+ *
+ * buffer 至少需要 NUMBER_BUFFER_SIZE 字节。
+ * formatDouble 输出能够精确还原原值的最短十进制表示，整数值不带小数点，
+ * 十进制指数小于 -4 或不小于 21 时使用科学计数法（如 1e-05、1.5e+21）。
+ */
+int formatInt64(int64_t value, char *buffer);
+int formatDouble(double value, char *buffer);
+
+// 按值的类型（VAL_INT 或 VAL_NUMBER）格式化
+int formatNumberValue(Value value, char *buffer);
+
+#endif // SPARROW_NUMERIC_CONVERSION_H
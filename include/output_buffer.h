@@ -0,0 +1,49 @@
+#ifndef SPARROW_OUTPUT_BUFFER_H
+#define SPARROW_OUTPUT_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// 默认缓冲区大小
+#define OUTPUT_BUFFER_CAPACITY 65536
+
+// 缓冲模式
+typedef enum
+{
+    OUTPUT_LINE_BUFFERED, // 写入换行符时刷新（交互式终端）
+    OUTPUT_FULLY_BUFFERED // 仅在缓冲区满或显式刷新时写出（管道、文件）
+} OutputMode;
+
+/**
+ * 解释器的输出缓冲区
+ *
+ * print/println 等的输出先累积在缓冲区中，再通过 write(2) 成块写入 fd，
+ * 避免每个标量、分隔符都触发一次 stdio 调用。
+ * 刷新时机：缓冲区满、行缓冲模式下写入换行、input() 读取前、flush()、解释器释放时。
+ * 捕获模式下不写出，缓冲区按需增长，全部输出保留在 data 中，由调用方读取。
+ */
+typedef struct OutputBuffer
+{
+    int fd;          // 目标文件描述符，-1 表示捕获模式
+    OutputMode mode; // 缓冲模式
+    char *data;      // 缓冲数据
+    size_t length;   // 已缓冲的字节数
+    size_t capacity; // 缓冲区容量
+    bool failed;     // 写入失败后丢弃后续输出
+} OutputBuffer;
+
+void initOutputBuffer(OutputBuffer *buffer, int fd, OutputMode mode);
+void initOutputCapture(OutputBuffer *buffer); // 捕获模式，用于把脚本输出返回给 --serve 的客户端
+void freeOutputBuffer(OutputBuffer *buffer); // 释放前会先刷新
+
+// 根据环境变量 SPARROW_OUTPUT_BUFFERING（line/full）或 fd 是否为终端选择缓冲模式
+OutputMode defaultOutputMode(int fd);
+
+void setOutputMode(OutputBuffer *buffer, OutputMode mode);
+bool flushOutput(OutputBuffer *buffer);
+
+void outputWrite(OutputBuffer *buffer, const char *data, size_t length);
+void outputString(OutputBuffer *buffer, const char *str);
+void outputChar(OutputBuffer *buffer, char c);
+
+#endif // SPARROW_OUTPUT_BUFFER_H
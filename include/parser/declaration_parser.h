@@ -11,4 +11,7 @@ Stmt *constDeclaration(Parser *parser);
 Stmt *enumDeclaration(Parser *parser);
 Stmt *structDeclaration(Parser *parser);
 
+// 解析预解析时跳过的函数体，把语句就地填入 body；失败时写入 error 并返回 false，body 保持未解析
+bool parseLazyBody(Stmt *body, char *error, size_t errorSize);
+
 #endif // SPARROW_DECLARATION_PARSER_H
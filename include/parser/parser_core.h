@@ -4,18 +4,42 @@
 #include "../lexer.h"
 #include "../ast.h"
 
-// 解析器状态
+// 流式模式的环形缓冲区初始容量（2 的幂）：解析器最多向前看 2 个标记，向后只需要 previous
+#define PARSER_WINDOW 8
+
+// 语句和表达式的最大嵌套深度：语法树的每层嵌套在解析、求值和释放时都占用 C 栈
+#define MAX_NESTING_DEPTH 1000
+
+/**
+ * 解析器状态
+ *
+ * 数组模式（initParser）在词法分析得到的完整标记数组上解析。
+ * 流式模式（initStreamingParser）按需调用 nextToken，标记只存放在环形缓冲区中：
+ * 序号为 i 的标记位于 tokens[i % capacity]，平时只保留当前标记前后的几个；
+ * 预解析函数体时设置 mark，保留从 '{' 之后起的全部标记，缓冲区不够时扩大一倍。
+ */
 typedef struct
 {
-    Token *tokens;      // 令牌数组
+    Token *tokens;      // 令牌数组；流式模式下为环形缓冲区
     int current;        // 当前令牌索引
-    int count;          // 令牌数量
-    int hadError;       // 是否有解析错误
-    char errorMsg[256]; // 解析错误信息
+    int count;          // 令牌数量；流式模式下为已从词法分析器读取的数量
+    int hadError;       // 当前声明是否有解析错误，错误恢复（synchronize）后清零
+    int errorCount;     // 遇到的解析错误总数，不随错误恢复清零
+    char errorMsg[256]; // 第一个解析错误的信息
+    bool lazyFunctions; // 预解析模式：函数体只匹配花括号，首次调用时再解析（见 parseLazyBody）
+    bool copyFunctionBodies; // 延迟的函数体复制自己的标记，不引用 tokens（流式模式下总是复制）
+    Lexer *lexer;       // 流式模式的词法分析器，数组模式为 NULL
+    int capacity;       // 流式模式下环形缓冲区的容量
+    int mark;           // 流式模式下从该序号起的标记不被覆盖，-1 表示不保留
+    int depth;          // 当前位置在语法树中的嵌套深度
 } Parser;
 
 // 核心解析器函数
 void initParser(Parser *parser, Token *tokens, int count);
+// 流式解析：标记的文本留在 lexer->text 中，语法树引用它，由调用方在释放语法树后释放
+bool initStreamingParser(Parser *parser, Lexer *lexer);
+// 释放流式模式的环形缓冲区；数组模式下不做任何事
+void freeParser(Parser *parser);
 Stmt **parse(Parser *parser, int *stmtCount);
 int hadParseError(Parser *parser);
 const char *getParseErrorMsg(Parser *parser);
@@ -26,9 +50,14 @@ int check(Parser *parser, TokenType type);
 Token advance(Parser *parser);
 Token peek(Parser *parser);
 Token previous(Parser *parser);
+Token *tokenAt(Parser *parser, int index); // 序号为 index 的标记；流式模式下只能访问缓冲区中保留的标记
 int isAtEnd(Parser *parser);
 Token consume(Parser *parser, TokenType type, const char *message);
 void synchronize(Parser *parser);
 void error(Parser *parser, const char *message);
 
+// 进入一层嵌套，超过 MAX_NESTING_DEPTH 时报告错误并返回 false；返回 true 时离开这一层需调用 leaveNesting
+bool enterNesting(Parser *parser);
+void leaveNesting(Parser *parser);
+
 #endif // SPARROW_PARSER_CORE_H
@@ -11,6 +11,7 @@ Stmt *ifStatement(Parser *parser);
 Stmt *whileStatement(Parser *parser);
 Stmt *forStatement(Parser *parser);
 Stmt *returnStatement(Parser *parser);
+Stmt *yieldStatement(Parser *parser);
 Stmt *switchStatement(Parser *parser);
 Stmt *breakStatement(Parser *parser);
 Stmt *doWhileStatement(Parser *parser);
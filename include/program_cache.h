@@ -0,0 +1,65 @@
+#ifndef SPARROW_PROGRAM_CACHE_H
+#define SPARROW_PROGRAM_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "ast.h"
+
+/**
+ * 预编译程序缓存（.spwc）
+ *
+ * 解析成功后把语法树序列化到用户缓存目录中的 .spwc 文件（见 programCachePath），
+ * 下次运行时校验格式版本、源代码长度和哈希以及文件内容的哈希，一致则 mmap 该文件直接重建语法树，
+ * 跳过词法分析和解析。
+ *
+ * 文件由固定的文件头、字符串区和节点区组成：字符串区中每个不同的标识符、字面量文本只存一次，
+ * 以 '\0' 结尾；节点区按前序写出语法树，整数用变长编码，名称记为字符串区中的偏移。
+ * 重建的语法树中 Token 的 lexeme 和字符串值直接指向映射的字符串区，不再复制。
+ *
+ * 尚未解析的函数体（见 LazyBody）按标记保存，加载后仍在首次调用时解析。
+ */
+
+// 格式版本：语法树节点的字段或编码方式变化时递增
+#define PROGRAM_CACHE_VERSION 2
+
+typedef enum
+{
+    PROGRAM_OK,
+    PROGRAM_READ_ERROR,  // 无法读取源文件
+    PROGRAM_LEX_ERROR,   // 词法分析失败（流式解析时内存不足）
+    PROGRAM_PARSE_ERROR  // 解析错误，语法树仍然保留以便统一释放
+} ProgramStatus;
+
+// 加载得到的程序：语法树中的名称指向 text 或 image，二者与语法树一同释放
+typedef struct
+{
+    char *source;
+    LexemeBlock *text; // 流式解析时词法分析器保存的标记文本，从缓存加载时为空
+    Token *bodyTokens; // 从缓存加载的延迟函数体的标记，lexeme 指向 image
+    void *image;   // 映射的 .spwc 文件，解析得到时为 NULL
+    size_t imageSize;
+    Stmt **statements;
+    int stmtCount;
+    bool fromCache;  // 语法树是否来自缓存
+    char error[320]; // 失败时的错误信息（以换行结尾）
+} LoadedProgram;
+
+// 读取并解析脚本；useCache 为 true 时优先使用有效的 .spwc，解析成功后写入或更新它。
+// lazyFunctions 为 true 时函数体在首次调用时才解析（见 parseLazyBody），其中的语法错误届时才报告
+ProgramStatus loadProgram(LoadedProgram *program, const char *path, bool useCache, bool lazyFunctions);
+void freeLoadedProgram(LoadedProgram *program);
+
+// 缓存文件的路径：$XDG_CACHE_HOME/sparrow（默认 ~/.cache/sparrow）下以脚本绝对路径的哈希命名，
+// 必要时创建该目录；脚本不存在或缓存目录不可用时返回 NULL，返回的字符串由调用方释放
+char *programCachePath(const char *path);
+
+// 把语法树写入缓存文件（先写临时文件再改名），失败时不留下不完整的文件
+bool saveProgramCache(const char *cachePath, const char *source, size_t sourceLength,
+                      Stmt **statements, int stmtCount);
+
+// 读取缓存文件：与源代码不匹配、格式不兼容或内容损坏时返回 false，不修改 program。
+// lazyFunctions 为 false 时同样拒绝含延迟函数体的缓存：其中的函数体尚未检查语法
+bool loadProgramCache(const char *cachePath, const char *source, size_t sourceLength, bool lazyFunctions,
+                      LoadedProgram *program);
+
+#endif // SPARROW_PROGRAM_CACHE_H
@@ -0,0 +1,34 @@
+#ifndef SPARROW_SERVER_H
+#define SPARROW_SERVER_H
+
+#include <stdbool.h>
+
+/**
+ * 常驻模式：sparrow --serve /path/to.sock
+ *
+ * 在 Unix 域套接字上接受运行请求（格式见 server_protocol.h），按路径在内存中缓存解析好的程序，
+ * 文件的修改时间或大小变化时重新加载。每个请求在新的解释器中执行缓存的语法树，
+ * 输出捕获在内存中，连同退出状态一起返回给客户端。
+ *
+ * 请求按到达顺序逐个执行：语法树在执行时会写入调用缓存，不能被多个解释器同时使用。
+ * 连接上的收发设有超时，空闲或只发送了半个请求的连接会被断开；每个请求的执行时间有上限，
+ * 超时的请求以运行时错误结束。input() 在常驻模式下报告运行时错误，不会等待守护进程的标准输入。
+ * 这样一个请求最多占用守护进程 timeLimit 秒，之后其他客户端的请求照常执行。
+ */
+
+// 未指定 --time-limit 时每个请求的执行时间上限（秒）
+#define SERVER_DEFAULT_TIME_LIMIT 10
+
+typedef struct
+{
+    bool explicitStack;
+    int maxCallDepth;
+    bool useCache;      // 首次加载脚本时使用并更新 .spwc 缓存
+    bool lazyFunctions; // 函数体在首次调用时才解析
+    int timeLimit;      // 每个请求的执行时间上限（秒），0 表示不限时
+} ServerOptions;
+
+// 运行到收到 SIGINT 或 SIGTERM 为止，返回进程退出码
+int runServer(const char *socketPath, const ServerOptions *options);
+
+#endif // SPARROW_SERVER_H
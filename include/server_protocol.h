@@ -0,0 +1,26 @@
+#ifndef SPARROW_SERVER_PROTOCOL_H
+#define SPARROW_SERVER_PROTOCOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * sparrow --serve 与客户端之间的消息格式
+ *
+ * 所有整数为网络字节序的 32 位整数，字符串为“长度 + 字节”（不含 '\0'）。
+ *   请求：参数个数 n，随后 n 个字符串；第一个为脚本的绝对路径，其余为脚本参数
+ *   响应：退出状态，随后是脚本的标准输出和错误信息两个字符串
+ * 一个连接上可以依次发送多个请求，客户端关闭连接即结束会话。
+ */
+
+// 单个字符串和参数个数的上限，防止异常请求耗尽内存
+#define SERVER_MAX_FRAME (64u * 1024 * 1024)
+#define SERVER_MAX_ARGS 4096
+
+bool sendUint32(int fd, uint32_t value);
+bool receiveUint32(int fd, uint32_t *value);            // 对端关闭或出错时返回 false
+bool sendFrame(int fd, const char *data, size_t length);
+char *receiveFrame(int fd, size_t *length);             // 返回以 '\0' 结尾的新字符串，失败时返回 NULL
+
+#endif // SPARROW_SERVER_PROTOCOL_H
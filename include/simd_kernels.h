@@ -0,0 +1,112 @@
+#ifndef SPARROW_SIMD_KERNELS_H
+#define SPARROW_SIMD_KERNELS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "value.h"
+
+// 向量指令集级别
+typedef enum
+{
+    SIMD_SCALAR, // 标量回退实现
+    SIMD_SSE2,
+    SIMD_AVX2
+} SimdLevel;
+
+/**
+ * 当前使用的指令集级别
+ *
+ * 首次调用时通过 cpuid 检测 CPU 支持的最高级别；可用环境变量
+ * SPARROW_SIMD=scalar|sse2|avx2 降低级别（用于基准对比），不会高于 CPU 实际支持的级别。
+ */
+SimdLevel simdLevel(void);
+const char *simdLevelName(SimdLevel level);
+
+/**
+ * 以下核函数直接读取 Value 数组：元素为 16 字节的 {类型, 负载}，
+ * 向量实现一次装入多个元素，取出负载部分后运算。
+ * 除 valueTypeRun 外，调用方须保证所有元素的类型与函数名一致（VAL_NUMBER 或 VAL_INT）。
+ *
+ * 浮点求和与点积固定按「下标模 4 分成 4 路累加，再按 (s0+s1)+(s2+s3) 合并，最后依次加上
+ * 不足 4 个的尾部」的顺序计算，因此各指令集级别的结果逐位相同。
+ */
+
+// 从头开始连续为 type 类型的元素个数
+size_t valueTypeRun(const Value *values, size_t count, ValueType type);
+
+double sumNumbers(const Value *values, size_t count);
+// 整数求和；中间结果溢出时返回 false，由调用方改用精确的逐个累加
+bool sumIntegers(const Value *values, size_t count, int64_t *sum);
+
+// 最小值和最大值（count > 0）；包含 NaN 时两者都为 NaN
+void minMaxNumbers(const Value *values, size_t count, double *min, double *max);
+void minMaxIntegers(const Value *values, size_t count, int64_t *min, int64_t *max);
+
+double dotNumbers(const Value *a, const Value *b, size_t count);
+
+// 第一个等于 target 的位置，找不到时返回 count
+size_t indexOfNumber(const Value *values, size_t count, double target);
+size_t indexOfInteger(const Value *values, size_t count, int64_t target);
+
+size_t countNumber(const Value *values, size_t count, double target);
+size_t countInteger(const Value *values, size_t count, int64_t target);
+
+// 逐元素算术运算
+typedef enum
+{
+    ARITH_ADD,
+    ARITH_SUB,
+    ARITH_MUL,
+    ARITH_DIV
+} ArithmeticOp;
+
+// 逐元素运算的操作数：values 不为 NULL 时为数组，否则把标量广播到每个位置
+typedef struct
+{
+    const Value *values;
+    double number;   // 标量（浮点数运算）
+    int64_t integer; // 标量（整数运算）
+} ArithmeticOperand;
+
+// out[i] = a[i] op b[i]，数组操作数须全为浮点数，结果为 VAL_NUMBER；out 可以与操作数是同一数组
+void arithmeticNumbers(ArithmeticOp op, ArithmeticOperand a, ArithmeticOperand b, Value *out, size_t count);
+// 整数逐元素运算，结果为 VAL_INT；任一元素溢出、除数为零或不能整除时返回 false，由调用方逐个处理
+bool arithmeticIntegers(ArithmeticOp op, ArithmeticOperand a, ArithmeticOperand b, Value *out, size_t count);
+
+/**
+ * 词法分析的文本扫描：只读取 text 的前 length 个字节，向量实现每次比较 16 或 32 个字节，
+ * 不足一个寄存器的尾部逐字节处理
+ */
+
+// 开头连续的标识符字符（字母、数字、下划线）个数
+size_t identifierRun(const char *text, size_t length);
+// 开头连续的空白字符（空格、制表符、回车、换行）个数，其中的换行符个数累加到 *newlines
+size_t whitespaceRun(const char *text, size_t length, int *newlines);
+// 第一个等于 a 或 b 的字节的位置，找不到时返回 length
+size_t findEitherByte(const char *text, size_t length, char a, char b);
+
+// 数组级数值运算的结果
+typedef enum
+{
+    NUMERIC_OK,
+    NUMERIC_EMPTY,           // 数组为空
+    NUMERIC_NOT_A_NUMBER,    // 包含非数字元素
+    NUMERIC_LENGTH_MISMATCH  // 两个数组长度不同
+} NumericStatus;
+
+// 数组级操作：按类型分段，同类数字段交给核函数，其余元素用 valuesEqual 逐个比较
+
+// 从 start 开始第一个等于 target 的元素位置，找不到时返回 -1
+int arrayIndexOf(const Array *array, Value target, int start);
+// 等于 target 的元素个数
+int arrayCount(const Array *array, Value target);
+
+// 求和：全是整数时结果为整数（超出 int64 时提升为浮点数），否则为浮点数；空数组的和为 0
+NumericStatus arraySum(const Array *array, Value *result);
+// 最小值和最大值，保留元素原有的类型；包含 NaN 时两者都为 NaN
+NumericStatus arrayMinMax(const Array *array, Value *min, Value *max);
+// 点积：全是整数且不溢出时结果为整数，否则为浮点数
+NumericStatus arrayDot(const Array *a, const Array *b, Value *result);
+
+#endif // SPARROW_SIMD_KERNELS_H
@@ -0,0 +1,138 @@
+// include/sparrow.h - 灵雀嵌入 API
+#ifndef SPARROW_H
+#define SPARROW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 灵雀嵌入 API
+ *
+ * 宿主程序通过 libsparrow.a / libsparrow.so 使用解释器：创建虚拟机、加载一次源代码，
+ * 之后反复按名称取得的函数句柄调用脚本函数。词法分析、解析、解释器初始化和原生函数注册
+ * 只在创建和加载时进行一次。
+ *
+ * 本头文件只依赖标准头文件，不暴露解释器内部的数据结构：标量和字符串以 SparrowValue 交换，
+ * 数组、映射、函数等其他值通过不透明的 SparrowHandle 持有。
+ *
+ * 一个虚拟机同一时刻只能在一个线程中使用；不同的虚拟机可以在不同线程中同时运行。
+ */
+
+// libsparrow.so 只导出本头文件中的函数（其余目标文件以 -fvisibility=hidden 编译）
+#if defined(__GNUC__)
+#define SPARROW_API __attribute__((visibility("default")))
+#else
+#define SPARROW_API
+#endif
+
+typedef struct SparrowVM SparrowVM;
+typedef struct SparrowHandle SparrowHandle;
+
+typedef enum
+{
+    SPARROW_OK,
+    SPARROW_COMPILE_ERROR, // 读取文件、词法分析或解析失败
+    SPARROW_RUNTIME_ERROR  // 运行时错误
+} SparrowResult;
+
+typedef enum
+{
+    SPARROW_NULL,
+    SPARROW_BOOL,
+    SPARROW_INT,
+    SPARROW_NUMBER,
+    SPARROW_STRING,
+    SPARROW_HANDLE // 数组、映射、函数等其他值
+} SparrowType;
+
+/**
+ * 与脚本交换的值
+ *
+ * 字符串只借用字符数据：传入时由虚拟机复制；返回给宿主的字符串在下一次 sparrowCall 或
+ * 释放虚拟机之前有效。返回给宿主的句柄归宿主所有，须用 sparrowReleaseHandle 释放；
+ * 原生函数收到的句柄参数只在本次调用期间有效。
+ */
+typedef struct
+{
+    SparrowType type;
+    union
+    {
+        bool boolean;
+        int64_t integer;
+        double number;
+        struct
+        {
+            const char *chars;
+            size_t length;
+        } string;
+        SparrowHandle *handle;
+    } as;
+} SparrowValue;
+
+// 虚拟机配置，sparrowDefaultConfig 填入默认值
+typedef struct
+{
+    bool explicitStack; // 用显式栈求值器执行
+    int maxCallDepth;   // 脚本函数的最大调用深度
+    int outputFd;       // print/println 的输出目标，默认为标准输出
+    size_t stackLimit;  // 递归求值允许使用的 C 栈字节数，0 表示按 ulimit -s 计算
+    bool lazyFunctions; // 函数体在首次调用时才解析，其中的语法错误届时作为运行时错误报告
+} SparrowConfig;
+
+/**
+ * 宿主原生函数
+ *
+ * 参数只读借用。成功时把返回值写入 result 并返回 true；失败时先调用 sparrowNativeError
+ * 报告错误，再返回 false。原生函数中可以调用 sparrowCall 回调脚本函数。
+ */
+typedef bool (*SparrowNativeFn)(SparrowVM *vm, int argCount, const SparrowValue *args,
+                                SparrowValue *result, void *userData);
+
+// 虚拟机
+SPARROW_API void sparrowDefaultConfig(SparrowConfig *config);
+SPARROW_API SparrowVM *sparrowNewVM(const SparrowConfig *config); // config 为 NULL 时使用默认配置
+SPARROW_API void sparrowFreeVM(SparrowVM *vm);                    // 释放前写出缓冲的输出
+
+// 加载源代码：解析并执行顶层语句（有 main 函数时调用之）。可多次加载，后加载的定义覆盖先前的
+SPARROW_API SparrowResult sparrowLoad(SparrowVM *vm, const char *source);
+SPARROW_API SparrowResult sparrowLoadFile(SparrowVM *vm, const char *path);
+
+// 最近一次失败的错误信息
+SPARROW_API const char *sparrowError(const SparrowVM *vm);
+
+// 注册宿主原生函数为全局变量，arity 为 -1 表示可变参数
+SPARROW_API bool sparrowRegister(SparrowVM *vm, const char *name, int arity, SparrowNativeFn function, void *userData);
+SPARROW_API void sparrowNativeError(SparrowVM *vm, const char *message);
+
+// 取得全局函数（或其他全局变量）的句柄，不存在时返回 NULL
+SPARROW_API SparrowHandle *sparrowGetGlobal(SparrowVM *vm, const char *name);
+
+// 调用函数句柄；result 可以为 NULL
+SPARROW_API SparrowResult sparrowCall(SparrowVM *vm, SparrowHandle *function, int argCount,
+                                      const SparrowValue *args, SparrowValue *result);
+
+// 写出缓冲的输出
+SPARROW_API void sparrowFlush(SparrowVM *vm);
+
+// 句柄
+SPARROW_API void sparrowReleaseHandle(SparrowHandle *handle);
+SPARROW_API const char *sparrowHandleTypeName(const SparrowHandle *handle);
+
+// 数组句柄
+SPARROW_API SparrowHandle *sparrowNewArray(void);
+SPARROW_API bool sparrowArrayPush(SparrowHandle *array, SparrowValue value);
+SPARROW_API int sparrowArrayLength(const SparrowHandle *array); // 不是数组时返回 -1
+// 取出元素：字符串借用数组中的数据，其他复合值得到新的句柄（须释放）
+SPARROW_API bool sparrowArrayGet(const SparrowHandle *array, int index, SparrowValue *value);
+
+// SparrowValue 构造
+SPARROW_API SparrowValue sparrowNull(void);
+SPARROW_API SparrowValue sparrowBool(bool value);
+SPARROW_API SparrowValue sparrowInt(int64_t value);
+SPARROW_API SparrowValue sparrowNumber(double value);
+SPARROW_API SparrowValue sparrowString(const char *chars); // 以 '\0' 结尾
+SPARROW_API SparrowValue sparrowStringWithLength(const char *chars, size_t length);
+SPARROW_API SparrowValue sparrowHandleValue(SparrowHandle *handle);
+
+#endif // SPARROW_H
@@ -2,13 +2,20 @@
 #define SPARROW_VALUE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "type_system.h"
+#include "output_buffer.h"
 // #include "environment.h"
 
 typedef struct Environment Environment;
 // 前向声明
 typedef struct Value Value;
 typedef struct Array Array;
+typedef struct Map Map;
+typedef struct Heap Heap;
+typedef struct Deque Deque;
+typedef struct Generator Generator;
 
 // 结构体字段值前向声明
 typedef struct StructFieldValue StructFieldValue;
@@ -18,13 +25,19 @@ typedef enum
 {
     VAL_NULL,
     VAL_BOOL,
-    VAL_NUMBER,
+    VAL_NUMBER, // 浮点数（double）
+    VAL_INT,    // 64位整数
     VAL_STRING,
     VAL_FUNCTION,
     VAL_NATIVE_FUNCTION,
     VAL_ARRAY,
     VAL_ENUM_VALUE,
-    VAL_STRUCT
+    VAL_STRUCT,
+    VAL_MAP,
+    VAL_HEAP,
+    VAL_DEQUE,
+    VAL_RANGE,
+    VAL_GENERATOR
 } ValueType;
 
 
@@ -44,6 +57,14 @@ typedef struct
     int fieldCount;             // 字段数量
 } StructValue;
 
+// 整数区间 [start, end)，按 step 递增或递减；只保存三个端点，不生成元素
+typedef struct
+{
+    int64_t start;
+    int64_t end;
+    int64_t step; // 不为 0
+} Range;
+
 // 函数类型前向声明
 typedef struct Function Function;
 typedef struct NativeFunction NativeFunction;
@@ -64,15 +85,31 @@ struct Value
     {
         bool boolean;
         double number;
+        int64_t integer;
         char *string;
         Function *function;
         NativeFunction *nativeFunction;
         Array *array;
         EnumValue *enumValue;
         StructValue *structValue;
+        Map *map;
+        Heap *heap;
+        Deque *deque;
+        Range *range;
+        Generator *generator;
     } as;
 };
 
+// 字符串头部，紧邻字符数据之前存放；Value 中的 string 指针指向字符数据本身
+typedef struct
+{
+    size_t length;   // 字符串长度（不含结尾的 '\0'）
+    size_t capacity; // 可容纳的字符数（不含结尾的 '\0'）
+} StringHeader;
+
+// 由字符串指针取得其头部
+#define STRING_HEADER(str) ((StringHeader *)(str) - 1)
+
 // 结构体字段值定义（必须在 Value 定义之后）
 struct StructFieldValue
 {
@@ -90,21 +127,48 @@ struct Function
     TypeAnnotation returnType;  // 返回类型
     struct Stmt *body;          // 函数体
     Environment *closure;       // 闭包环境
+    bool isGenerator;           // 生成器函数：调用时返回生成器，不执行函数体
 };
 
+struct Interpreter;
+
+// v2 原生函数的返回状态
+typedef enum
+{
+    NATIVE_OK,   // 成功，结果写入 result
+    NATIVE_ERROR // 失败，原生函数已通过 runtimeError 报告错误
+} NativeStatus;
+
+/**
+ * v2 原生函数调用约定
+ *
+ * 可以访问解释器（报告运行时错误、回调脚本函数），参数为只读借用，
+ * 原生函数不得释放或修改参数；需要返回参数中的值时应先 copyValue。
+ */
+typedef NativeStatus (*NativeFn)(struct Interpreter *interpreter, int argCount, const Value *args, Value *result);
+
+// 原生函数标志
+#define NATIVE_BORROWS_ARGS 0x1      // 变量参数直接借用，不做复制（原生函数不得回调脚本代码）
+#define NATIVE_MUTATES_FIRST_ARG 0x2 // 第一个参数必须是变量，借用其存储位置，原生函数可就地修改其中的容器
+
 // 本地函数类型
 struct NativeFunction
 {
     char *name;
-    int arity;
-    Value (*function)(int argCount, Value *args);
+    int arity;                                    // 参数数量，-1 表示可变参数
+    Value (*function)(int argCount, Value *args); // v1 调用约定（参数为副本）
+    NativeFn native;                              // v2 调用约定，非 NULL 时优先使用
+    int flags;                                    // NATIVE_* 标志
+    bool isStatic;                                // 来自静态注册表，复制和释放时只传递指针
 };
 
 // 值操作函数
 Value createNull();
 Value createBool(bool value);
 Value createNumber(double value);
+Value createInt(int64_t value);
 Value createString(const char *value);
+Value createStringWithLength(const char *chars, size_t length);
 Value createFunction(Function *function);
 Value createNativeFunction(NativeFunction *function);
 Value createEnumValue(const char *enumName, const char *memberName, int value);
@@ -112,6 +176,10 @@ Value createStruct(const char *structName, StructFieldValue *fields, int fieldCo
 void freeEnumValue(EnumValue *enumValue);
 void freeStructValue(StructValue *structValue);
 
+// 字符串操作函数
+size_t stringLength(const char *string);
+bool appendToString(Value *target, const char *suffix, size_t suffixLength);
+
 // 数组操作函数
 Value createArray(BaseType elementType, int initialCapacity);
 void arrayPush(Array *array, Value value);
@@ -119,8 +187,21 @@ Value arrayGet(Array *array, int index);
 void arraySet(Array *array, int index, Value value);
 int arrayLength(Array *array);
 
+// 区间操作函数
+Value createRange(int64_t start, int64_t end, int64_t step);
+int64_t rangeLength(const Range *range);
+int64_t rangeAt(const Range *range, int64_t index);
+bool rangeContains(const Range *range, Value value);
+
+// 数值辅助函数
+bool isNumeric(Value value);
+double asDouble(Value value);
+int compareIntDouble(int64_t integer, double number); // 精确比较，返回 -1、0 或 1
+
 // 值比较和操作
 bool valuesEqual(Value a, Value b);
+const char *valueTypeName(Value value); // 与 type() 的返回值相同
+void writeValue(OutputBuffer *out, Value value);
 void printValue(Value value);
 Value copyValue(Value value);
 void freeValue(Value value);
@@ -0,0 +1,339 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "array_sort.h"
+
+// 小于该长度的区间使用插入排序
+#define INSERTION_SORT_THRESHOLD 16
+
+// 不小于该长度的纯数字数组使用基数排序
+#define RADIX_SORT_THRESHOLD 64
+
+static int sortKeyClass(Value value)
+{
+    switch (value.type)
+    {
+    case VAL_INT:
+    case VAL_NUMBER:
+        return 1;
+    case VAL_STRING:
+        return 2;
+    case VAL_BOOL:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+SortKeyKind classifySortKeys(const SortEntry *entries, int count)
+{
+    bool hasInt = false;
+    bool hasFloat = false;
+    int keyClass = count > 0 ? sortKeyClass(entries[0].key) : 1;
+
+    for (int i = 0; i < count; i++)
+    {
+        Value key = entries[i].key;
+        if (sortKeyClass(key) != keyClass || keyClass == 0)
+        {
+            return SORT_KEYS_INVALID;
+        }
+        hasInt = hasInt || key.type == VAL_INT;
+        hasFloat = hasFloat || key.type == VAL_NUMBER;
+    }
+
+    if (keyClass == 2)
+        return SORT_KEYS_STRING;
+    if (keyClass == 3)
+        return SORT_KEYS_BOOL;
+    if (hasInt && hasFloat)
+        return SORT_KEYS_NUMBER;
+    return hasFloat ? SORT_KEYS_FLOAT : SORT_KEYS_INT;
+}
+
+bool sortKeysComparable(Value a, Value b)
+{
+    int keyClass = sortKeyClass(a);
+    return keyClass != 0 && keyClass == sortKeyClass(b);
+}
+
+static int compareDoubles(double a, double b)
+{
+    if (isnan(a))
+        return isnan(b) ? 0 : 1;
+    if (isnan(b))
+        return -1;
+    return (a > b) - (a < b);
+}
+
+int compareSortKeys(Value a, Value b)
+{
+    if (a.type == VAL_INT && b.type == VAL_INT)
+    {
+        return (a.as.integer > b.as.integer) - (a.as.integer < b.as.integer);
+    }
+    if (a.type == VAL_NUMBER && b.type == VAL_NUMBER)
+    {
+        return compareDoubles(a.as.number, b.as.number);
+    }
+    if (a.type == VAL_INT && b.type == VAL_NUMBER)
+    {
+        return compareIntDouble(a.as.integer, b.as.number);
+    }
+    if (a.type == VAL_NUMBER && b.type == VAL_INT)
+    {
+        return -compareIntDouble(b.as.integer, a.as.number);
+    }
+    if (a.type == VAL_STRING && b.type == VAL_STRING)
+    {
+        size_t lengthA = stringLength(a.as.string);
+        size_t lengthB = stringLength(b.as.string);
+        int result = memcmp(a.as.string, b.as.string, lengthA < lengthB ? lengthA : lengthB);
+        if (result != 0)
+            return result;
+        return (lengthA > lengthB) - (lengthA < lengthB);
+    }
+    if (a.type == VAL_BOOL && b.type == VAL_BOOL)
+    {
+        return (int)a.as.boolean - (int)b.as.boolean;
+    }
+    return 0;
+}
+
+static int compareEntries(const SortEntry *a, const SortEntry *b, bool stable)
+{
+    int result = compareSortKeys(a->key, b->key);
+    if (result == 0 && stable)
+    {
+        result = (a->index > b->index) - (a->index < b->index);
+    }
+    return result;
+}
+
+static void swapEntries(SortEntry *a, SortEntry *b)
+{
+    SortEntry temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+static void insertionSort(SortEntry *entries, int count, bool stable)
+{
+    for (int i = 1; i < count; i++)
+    {
+        SortEntry current = entries[i];
+        int j = i - 1;
+        while (j >= 0 && compareEntries(&entries[j], &current, stable) > 0)
+        {
+            entries[j + 1] = entries[j];
+            j--;
+        }
+        entries[j + 1] = current;
+    }
+}
+
+static void siftDown(SortEntry *entries, int root, int count, bool stable)
+{
+    for (;;)
+    {
+        int child = root * 2 + 1;
+        if (child >= count)
+            return;
+        if (child + 1 < count && compareEntries(&entries[child], &entries[child + 1], stable) < 0)
+            child++;
+        if (compareEntries(&entries[root], &entries[child], stable) >= 0)
+            return;
+        swapEntries(&entries[root], &entries[child]);
+        root = child;
+    }
+}
+
+static void heapSort(SortEntry *entries, int count, bool stable)
+{
+    for (int i = count / 2 - 1; i >= 0; i--)
+    {
+        siftDown(entries, i, count, stable);
+    }
+    for (int end = count - 1; end > 0; end--)
+    {
+        swapEntries(&entries[0], &entries[end]);
+        siftDown(entries, 0, end, stable);
+    }
+}
+
+// 三数取中，把中位数放到 entries[0] 作为枢轴
+static void medianOfThreeToFront(SortEntry *entries, int count, bool stable)
+{
+    SortEntry *a = &entries[1];
+    SortEntry *b = &entries[count / 2];
+    SortEntry *c = &entries[count - 1];
+
+    if (compareEntries(a, b, stable) > 0)
+        swapEntries(a, b);
+    if (compareEntries(b, c, stable) > 0)
+        swapEntries(b, c);
+    if (compareEntries(a, b, stable) > 0)
+        swapEntries(a, b);
+    swapEntries(&entries[0], b);
+}
+
+/**
+ * 内省排序：快速排序在递归过深时改用堆排序，保证 O(n log n) 最坏复杂度；
+ * 较小的一侧递归，较大的一侧循环处理，栈深度为 O(log n)。
+ */
+static void introSort(SortEntry *entries, int count, int depthLimit, bool stable)
+{
+    while (count > INSERTION_SORT_THRESHOLD)
+    {
+        if (depthLimit-- == 0)
+        {
+            heapSort(entries, count, stable);
+            return;
+        }
+
+        medianOfThreeToFront(entries, count, stable);
+
+        // Hoare 划分，枢轴位于 entries[0]
+        int i = 0;
+        int j = count;
+        for (;;)
+        {
+            do
+            {
+                i++;
+            } while (i < count && compareEntries(&entries[i], &entries[0], stable) < 0);
+            do
+            {
+                j--;
+            } while (compareEntries(&entries[j], &entries[0], stable) > 0);
+            if (i >= j)
+                break;
+            swapEntries(&entries[i], &entries[j]);
+        }
+        swapEntries(&entries[0], &entries[j]);
+
+        int leftCount = j;
+        int rightCount = count - j - 1;
+        if (leftCount < rightCount)
+        {
+            introSort(entries, leftCount, depthLimit, stable);
+            entries += j + 1;
+            count = rightCount;
+        }
+        else
+        {
+            introSort(entries + j + 1, rightCount, depthLimit, stable);
+            count = leftCount;
+        }
+    }
+
+    insertionSort(entries, count, stable);
+}
+
+// 将数字映射为保持大小顺序的无符号整数
+static uint64_t radixKey(Value key)
+{
+    if (key.type == VAL_INT)
+    {
+        return (uint64_t)key.as.integer ^ 0x8000000000000000ULL;
+    }
+
+    double number = key.as.number;
+    if (isnan(number))
+    {
+        return UINT64_MAX; // NaN 排在最后
+    }
+    if (number == 0)
+    {
+        number = 0; // -0 与 0 相等
+    }
+
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    // 正数翻转符号位，负数翻转所有位
+    return (bits & 0x8000000000000000ULL) ? ~bits : bits ^ 0x8000000000000000ULL;
+}
+
+typedef struct
+{
+    uint64_t key;
+    SortEntry entry;
+} RadixItem;
+
+/**
+ * LSD 基数排序，每轮 8 位，共 8 轮；所有键在某个字节上相同时跳过该轮。
+ * 分配失败时返回 false，由调用方改用比较排序。
+ */
+static bool radixSort(SortEntry *entries, int count)
+{
+    RadixItem *items = (RadixItem *)malloc(sizeof(RadixItem) * (size_t)count * 2);
+    if (items == NULL)
+    {
+        return false;
+    }
+
+    RadixItem *source = items;
+    RadixItem *target = items + count;
+    for (int i = 0; i < count; i++)
+    {
+        source[i].key = radixKey(entries[i].key);
+        source[i].entry = entries[i];
+    }
+
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256] = {0};
+        for (int i = 0; i < count; i++)
+        {
+            histogram[(source[i].key >> shift) & 0xFF]++;
+        }
+        if (histogram[(source[0].key >> shift) & 0xFF] == (size_t)count)
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            size_t bucketCount = histogram[b];
+            histogram[b] = offset;
+            offset += bucketCount;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            target[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+        }
+
+        RadixItem *swap = source;
+        source = target;
+        target = swap;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        entries[i] = source[i].entry;
+    }
+    free(items);
+    return true;
+}
+
+void sortEntries(SortEntry *entries, int count, SortKeyKind kind, bool stable)
+{
+    if (count < 2)
+    {
+        return;
+    }
+
+    if ((kind == SORT_KEYS_INT || kind == SORT_KEYS_FLOAT) && count >= RADIX_SORT_THRESHOLD &&
+        radixSort(entries, count))
+    {
+        return;
+    }
+
+    int depthLimit = 0;
+    for (int n = count; n > 1; n >>= 1)
+    {
+        depthLimit += 2;
+    }
+    introSort(entries, count, depthLimit, stable);
+}
@@ -3,7 +3,7 @@
 // 创建二元表达式
 Expr *createBinaryExpr(Expr *left, TokenType op, Expr *right)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_BINARY;
     expr->as.binary.left = left;
     expr->as.binary.op = op;
@@ -14,7 +14,7 @@ Expr *createBinaryExpr(Expr *left, TokenType op, Expr *right)
 // 创建一元表达式
 Expr *createUnaryExpr(TokenType op, Expr *right)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_UNARY;
     expr->as.unary.op = op;
     expr->as.unary.right = right;
@@ -24,7 +24,7 @@ Expr *createUnaryExpr(TokenType op, Expr *right)
 // 创建字面量表达式
 Expr *createLiteralExpr(Token value)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_LITERAL;
     expr->as.literal.value = value;
     return expr;
@@ -33,7 +33,7 @@ Expr *createLiteralExpr(Token value)
 // 创建分组表达式
 Expr *createGroupingExpr(Expr *expression)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_GROUPING;
     expr->as.grouping.expression = expression;
     return expr;
@@ -42,7 +42,7 @@ Expr *createGroupingExpr(Expr *expression)
 // 创建变量引用
 Expr *createVariableExpr(Token name)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_VARIABLE;
     expr->as.variable.name = name;
     return expr;
@@ -51,7 +51,7 @@ Expr *createVariableExpr(Token name)
 // 创建赋值表达式
 Expr *createAssignExpr(Token name, Expr *value)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_ASSIGN;
     expr->as.assign.name = name;
     expr->as.assign.value = value;
@@ -61,7 +61,7 @@ Expr *createAssignExpr(Token name, Expr *value)
 // 创建函数调用
 Expr *createCallExpr(Expr *callee, Token paren, Expr **arguments, int argCount)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_CALL;
     expr->as.call.callee = callee;
     expr->as.call.paren = paren;
@@ -72,7 +72,7 @@ Expr *createCallExpr(Expr *callee, Token paren, Expr **arguments, int argCount)
 
 Expr *createPostfixExpr(Expr *operand, TokenType op)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     expr->type = EXPR_POSTFIX;
     expr->as.postfix.operand = operand;
     expr->as.postfix.op = op;
@@ -81,7 +81,7 @@ Expr *createPostfixExpr(Expr *operand, TokenType op)
 
 Expr *createPrefixExpr(Expr *operand, TokenType op)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     if (expr == NULL)
     {
         return NULL;
@@ -95,7 +95,7 @@ Expr *createPrefixExpr(Expr *operand, TokenType op)
 // 创建多变量声明
 Stmt *createMultiVarStmt(Token *names, int count, TypeAnnotation type, Expr *initializer)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -113,7 +113,7 @@ Stmt *createMultiVarStmt(Token *names, int count, TypeAnnotation type, Expr *ini
 
 Stmt *createMultiConstStmt(Token *names, int count, TypeAnnotation type, Expr **initializers, int initializerCount)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -131,7 +131,7 @@ Stmt *createMultiConstStmt(Token *names, int count, TypeAnnotation type, Expr **
 // 创建表达式语句
 Stmt *createExpressionStmt(Expr *expression)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         // 处理内存分配失败
@@ -145,7 +145,7 @@ Stmt *createExpressionStmt(Expr *expression)
 // 创建变量声明
 Stmt *createVarStmt(Token name, TypeAnnotation type, Expr *initializer)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_VAR;
     stmt->as.var.name = name;
     stmt->as.var.type = type;
@@ -157,7 +157,7 @@ Stmt *createVarStmt(Token name, TypeAnnotation type, Expr *initializer)
 // 创建 static 变量声明
 Stmt *createStaticVarStmt(Token name, TypeAnnotation type, Expr *initializer)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_VAR;
     stmt->as.var.name = name;
     stmt->as.var.type = type;
@@ -169,7 +169,7 @@ Stmt *createStaticVarStmt(Token name, TypeAnnotation type, Expr *initializer)
 // 创建常量声明
 Stmt *createConstStmt(Token name, TypeAnnotation type, Expr *initializer)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -186,17 +186,35 @@ Stmt *createConstStmt(Token name, TypeAnnotation type, Expr *initializer)
 // 创建代码块
 Stmt *createBlockStmt(Stmt **statements, int count)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_BLOCK;
     stmt->as.block.statements = statements;
     stmt->as.block.count = count;
     return stmt;
 }
 
+// 创建延迟解析的函数体：语句列表为空，首次调用时由 parseLazyBody 就地填入
+Stmt *createLazyBlockStmt(Token *tokens, int tokenCount, bool hasYield)
+{
+    LazyBody *lazy = (LazyBody *)malloc(sizeof(LazyBody));
+    if (lazy == NULL)
+    {
+        return NULL;
+    }
+    lazy->tokens = tokens;
+    lazy->tokenCount = tokenCount;
+    lazy->hasYield = hasYield;
+    lazy->ownsTokens = false;
+
+    Stmt *stmt = createBlockStmt(NULL, 0);
+    stmt->as.block.lazy = lazy;
+    return stmt;
+}
+
 // 创建if语句
 Stmt *createIfStmt(Expr *condition, Stmt *thenBranch, Stmt *elseBranch)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_IF;
     stmt->as.ifStmt.condition = condition;
     stmt->as.ifStmt.thenBranch = thenBranch;
@@ -207,7 +225,7 @@ Stmt *createIfStmt(Expr *condition, Stmt *thenBranch, Stmt *elseBranch)
 // 创建while循环
 Stmt *createWhileStmt(Expr *condition, Stmt *body)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_WHILE;
     stmt->as.whileLoop.condition = condition;
     stmt->as.whileLoop.body = body;
@@ -216,7 +234,7 @@ Stmt *createWhileStmt(Expr *condition, Stmt *body)
 
 Stmt *createDoWhileStmt(Stmt *body, Expr *condition)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -230,7 +248,7 @@ Stmt *createDoWhileStmt(Stmt *body, Expr *condition)
 // 创建for循环
 Stmt *createForStmt(Stmt *initializer, Expr *condition, Expr *increment, Stmt *body)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_FOR;
     stmt->as.forLoop.initializer = initializer;
     stmt->as.forLoop.condition = condition;
@@ -239,10 +257,25 @@ Stmt *createForStmt(Stmt *initializer, Expr *condition, Expr *increment, Stmt *b
     return stmt;
 }
 
+// 创建for-in循环
+Stmt *createForInStmt(Token name, Expr *iterable, Stmt *body)
+{
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
+    if (stmt == NULL)
+    {
+        return NULL;
+    }
+    stmt->type = STMT_FOR_IN;
+    stmt->as.forIn.name = name;
+    stmt->as.forIn.iterable = iterable;
+    stmt->as.forIn.body = body;
+    return stmt;
+}
+
 // 创建函数声明
 Stmt *createFunctionStmt(Token name, Token *params, bool *paramHasVar, TypeAnnotation *paramTypes, int paramCount, TypeAnnotation returnType, Stmt *body)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_FUNCTION;
     stmt->as.function.name = name;
     stmt->as.function.params = params;
@@ -266,6 +299,7 @@ Stmt *createFunctionStmt(Token name, Token *params, bool *paramHasVar, TypeAnnot
 
     stmt->as.function.body = body;
     stmt->as.function.isStatic = false;
+    stmt->as.function.isGenerator = markYieldStatements(body);
 
     return stmt;
 }
@@ -279,17 +313,87 @@ Stmt *createStaticFunctionStmt(Token name, Token *params, bool *paramHasVar, Typ
 // 创建return语句
 Stmt *createReturnStmt(Token keyword, Expr *value)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     stmt->type = STMT_RETURN;
     stmt->as.returnStmt.keyword = keyword;
     stmt->as.returnStmt.value = value;
     return stmt;
 }
 
+// 创建yield语句
+Stmt *createYieldStmt(Token keyword, Expr *value, bool delegate)
+{
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
+    stmt->type = STMT_YIELD;
+    stmt->as.yieldStmt.keyword = keyword;
+    stmt->as.yieldStmt.value = value;
+    stmt->as.yieldStmt.delegate = delegate;
+    return stmt;
+}
+
+/**
+ * 标记含有 yield 的语句
+ *
+ * 生成器逐帧执行这些语句以便在 yield 处挂起，不含 yield 的语句仍交给 execute 一次执行完。
+ * 嵌套的函数声明在自身创建时已经标记过，这里不进入。
+ */
+bool markYieldStatements(Stmt *stmt)
+{
+    if (stmt == NULL)
+    {
+        return false;
+    }
+
+    bool found = false;
+    switch (stmt->type)
+    {
+    case STMT_YIELD:
+        found = true;
+        break;
+    case STMT_BLOCK:
+        if (stmt->as.block.lazy != NULL)
+        {
+            found = stmt->as.block.lazy->hasYield;
+        }
+        for (int i = 0; i < stmt->as.block.count; i++)
+        {
+            found = markYieldStatements(stmt->as.block.statements[i]) || found;
+        }
+        break;
+    case STMT_IF:
+        found = markYieldStatements(stmt->as.ifStmt.thenBranch);
+        found = markYieldStatements(stmt->as.ifStmt.elseBranch) || found;
+        break;
+    case STMT_WHILE:
+        found = markYieldStatements(stmt->as.whileLoop.body);
+        break;
+    case STMT_DO_WHILE:
+        found = markYieldStatements(stmt->as.doWhile.body);
+        break;
+    case STMT_FOR:
+        found = markYieldStatements(stmt->as.forLoop.body);
+        break;
+    case STMT_FOR_IN:
+        found = markYieldStatements(stmt->as.forIn.body);
+        break;
+    case STMT_SWITCH:
+        for (int i = 0; i < stmt->as.switchStmt.caseCount; i++)
+        {
+            found = markYieldStatements(stmt->as.switchStmt.cases[i].body) || found;
+        }
+        break;
+    default:
+        break;
+    }
+
+    stmt->containsYield = found;
+    return found;
+}
+
 // 创建 switch 语句
 Stmt *createSwitchStmt(Expr *discriminant, CaseStmt *cases, int caseCount)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -304,7 +408,7 @@ Stmt *createSwitchStmt(Expr *discriminant, CaseStmt *cases, int caseCount)
 // 创建 break 语句
 Stmt *createBreakStmt(Token keyword)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -316,7 +420,7 @@ Stmt *createBreakStmt(Token keyword)
 
 Stmt *createEnumStmt(Token name, EnumMember *members, int memberCount)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -334,7 +438,7 @@ Stmt *createEnumStmt(Token name, EnumMember *members, int memberCount)
  */
 Stmt *createStructStmt(Token name, StructField *fields, int fieldCount)
 {
-    Stmt *stmt = (Stmt *)malloc(sizeof(Stmt));
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
     if (stmt == NULL)
     {
         return NULL;
@@ -688,6 +792,57 @@ Expr *copyExpr(Expr *expr)
         return createStructAssignExpr(objectCopy, expr->as.structAssign.field, valueCopy);
     }
 
+    case EXPR_COMPOUND_ASSIGN:
+    {
+        Expr *targetCopy = copyExpr(expr->as.compoundAssign.target);
+        Expr *valueCopy = copyExpr(expr->as.compoundAssign.value);
+        if (targetCopy == NULL || valueCopy == NULL)
+        {
+            if (targetCopy) freeExpr(targetCopy);
+            if (valueCopy) freeExpr(valueCopy);
+            return NULL;
+        }
+        return createCompoundAssignExpr(targetCopy, expr->as.compoundAssign.op, valueCopy);
+    }
+
+    case EXPR_MAP_LITERAL:
+    {
+        int count = expr->as.mapLiteral.count;
+        Expr **keysCopy = NULL;
+        Expr **valuesCopy = NULL;
+        if (count > 0)
+        {
+            keysCopy = (Expr **)calloc(count, sizeof(Expr *));
+            valuesCopy = (Expr **)calloc(count, sizeof(Expr *));
+            if (keysCopy == NULL || valuesCopy == NULL)
+            {
+                free(keysCopy);
+                free(valuesCopy);
+                fprintf(stderr, "内存分配失败\n");
+                return NULL;
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                keysCopy[i] = copyExpr(expr->as.mapLiteral.keys[i]);
+                valuesCopy[i] = copyExpr(expr->as.mapLiteral.values[i]);
+                if (keysCopy[i] == NULL || valuesCopy[i] == NULL)
+                {
+                    // 清理已复制的键值对
+                    for (int j = 0; j <= i; j++)
+                    {
+                        if (keysCopy[j]) freeExpr(keysCopy[j]);
+                        if (valuesCopy[j]) freeExpr(valuesCopy[j]);
+                    }
+                    free(keysCopy);
+                    free(valuesCopy);
+                    return NULL;
+                }
+            }
+        }
+        return createMapLiteralExpr(keysCopy, valuesCopy, count);
+    }
+
     default:
         fprintf(stderr, "未知的表达式类型\n");
         return NULL;
@@ -710,7 +865,7 @@ Expr *copyExpr(Expr *expr)
  */
 Expr *createArrayLiteralExpr(Expr **elements, int elementCount)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr)); // 分配内存
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr)); // 分配内存
     if (expr == NULL)                          // 检查内存分配是否成功
         return NULL;
 
@@ -736,7 +891,7 @@ Expr *createArrayLiteralExpr(Expr **elements, int elementCount)
  */
 Expr *createArrayAccessExpr(Expr *array, Expr *index)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr)); // 分配内存
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr)); // 分配内存
     if (expr == NULL)
         return NULL;
 
@@ -763,7 +918,7 @@ Expr *createArrayAccessExpr(Expr *array, Expr *index)
  */
 Expr *createArrayAssignExpr(Expr *array, Expr *index, Expr *value)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr)); // 分配内存
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr)); // 分配内存
     if (expr == NULL)
         return NULL;
 
@@ -789,7 +944,7 @@ Expr *createArrayAssignExpr(Expr *array, Expr *index, Expr *value)
  */
 Expr *createCastExpr(BaseType targetType, Expr *expression)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     if (expr == NULL)
         return NULL;
 
@@ -804,7 +959,7 @@ Expr *createCastExpr(BaseType targetType, Expr *expression)
  */
 Expr *createDotAccessExpr(Expr *object, Token member)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     if (expr == NULL)
         return NULL;
 
@@ -819,7 +974,7 @@ Expr *createDotAccessExpr(Expr *object, Token member)
  */
 Expr *createStructLiteralExpr(Token structName, StructFieldInit *fields, int fieldCount)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     if (expr == NULL)
         return NULL;
 
@@ -835,7 +990,7 @@ Expr *createStructLiteralExpr(Token structName, StructFieldInit *fields, int fie
  */
 Expr *createStructAssignExpr(Expr *object, Token field, Expr *value)
 {
-    Expr *expr = (Expr *)malloc(sizeof(Expr));
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
     if (expr == NULL)
         return NULL;
 
@@ -846,6 +1001,43 @@ Expr *createStructAssignExpr(Expr *object, Token field, Expr *value)
     return expr;
 }
 
+/**
+ * 创建复合赋值表达式
+ *
+ * target 保留原始的访问表达式（变量、数组访问或点访问），由解释器
+ * 解析为存储位置后原地更新，而不是展开成 target = target op value。
+ */
+Expr *createCompoundAssignExpr(Expr *target, TokenType op, Expr *value)
+{
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
+    if (expr == NULL)
+        return NULL;
+
+    expr->type = EXPR_COMPOUND_ASSIGN;
+    expr->as.compoundAssign.target = target;
+    expr->as.compoundAssign.op = op;
+    expr->as.compoundAssign.value = value;
+    return expr;
+}
+
+/**
+ * 创建映射字面量表达式，如 {"a": 1, "b": 2}
+ *
+ * keys 和 values 一一对应，求值时按书写顺序插入，重复的键以后出现的为准。
+ */
+Expr *createMapLiteralExpr(Expr **keys, Expr **values, int count)
+{
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
+    if (expr == NULL)
+        return NULL;
+
+    expr->type = EXPR_MAP_LITERAL;
+    expr->as.mapLiteral.keys = keys;
+    expr->as.mapLiteral.values = values;
+    expr->as.mapLiteral.count = count;
+    return expr;
+}
+
 /**
  * 释放表达式节点及其所有子节点的内存
  *
@@ -860,6 +1052,7 @@ Expr *createStructAssignExpr(Expr *object, Token field, Expr *value)
  * - 数组访问：释放数组和索引表达式
  * - 数组赋值：释放数组、索引和赋值值
  * - 类型转换：释放被转换的表达式
+ * - 复合赋值：释放赋值目标和右侧的值
  * - 字面量和变量：无需额外释放
  *
  * @param expr 要释放的表达式节点指针，可以为NULL（安全处理）
@@ -955,6 +1148,19 @@ void freeExpr(Expr *expr)
             freeExpr(expr->as.structAssign.value);
         }
         break;
+    case EXPR_COMPOUND_ASSIGN:
+        freeExpr(expr->as.compoundAssign.target);
+        freeExpr(expr->as.compoundAssign.value);
+        break;
+    case EXPR_MAP_LITERAL:
+        for (int i = 0; i < expr->as.mapLiteral.count; i++)
+        {
+            freeExpr(expr->as.mapLiteral.keys[i]);
+            freeExpr(expr->as.mapLiteral.values[i]);
+        }
+        free(expr->as.mapLiteral.keys);
+        free(expr->as.mapLiteral.values);
+        break;
     case EXPR_LITERAL:
     case EXPR_VARIABLE:
         // 这些节点没有需要释放的指针
@@ -1018,6 +1224,11 @@ void freeStmt(Stmt *stmt)
             freeStmt(stmt->as.block.statements[i]);
         }
         free(stmt->as.block.statements);
+        if (stmt->as.block.lazy != NULL && stmt->as.block.lazy->ownsTokens)
+        {
+            free(stmt->as.block.lazy->tokens);
+        }
+        free(stmt->as.block.lazy);
         break;
     case STMT_IF:
         freeExpr(stmt->as.ifStmt.condition);
@@ -1058,6 +1269,10 @@ void freeStmt(Stmt *stmt)
         }
         freeStmt(stmt->as.forLoop.body);
         break;
+    case STMT_FOR_IN:
+        freeExpr(stmt->as.forIn.iterable);
+        freeStmt(stmt->as.forIn.body);
+        break;
     case STMT_FUNCTION:
         if (stmt->as.function.params)
         {
@@ -1082,6 +1297,12 @@ void freeStmt(Stmt *stmt)
             freeExpr(stmt->as.returnStmt.value);
         }
         break;
+    case STMT_YIELD:
+        if (stmt->as.yieldStmt.value)
+        {
+            freeExpr(stmt->as.yieldStmt.value);
+        }
+        break;
     case STMT_SWITCH:
         if (stmt->as.switchStmt.discriminant != NULL)
         {
@@ -0,0 +1,97 @@
+#define _XOPEN_SOURCE 700
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "server_protocol.h"
+
+/**
+ * sparrow-client：把脚本交给 sparrow --serve 执行
+ *
+ * 用法：sparrow-client socket script [args...]
+ *
+ * 脚本路径先转换为绝对路径再发送，使常驻进程的工作目录不影响查找和缓存。
+ * 脚本的输出写到标准输出，错误信息写到标准错误，退出状态与常驻进程返回的一致。
+ */
+
+static int connectServer(const char *socketPath)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Socket path too long '%s'\n", socketPath);
+        return -1;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+    if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        fprintf(stderr, "Could not connect to '%s'\n", socketPath);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: sparrow-client socket script [args...]\n");
+        return 1;
+    }
+
+    char path[PATH_MAX];
+    if (realpath(argv[2], path) == NULL)
+    {
+        printf("Could not read file '%s'\n", argv[2]);
+        return 1;
+    }
+
+    int fd = connectServer(argv[1]);
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    // 请求：脚本路径和脚本参数
+    bool sent = sendUint32(fd, (uint32_t)(argc - 2)) && sendFrame(fd, path, strlen(path));
+    for (int i = 3; i < argc && sent; i++)
+    {
+        sent = sendFrame(fd, argv[i], strlen(argv[i]));
+    }
+
+    // 响应：退出状态、标准输出、错误信息
+    uint32_t status = 1;
+    size_t outputLength = 0;
+    size_t errorLength = 0;
+    char *output = NULL;
+    char *error = NULL;
+    if (!sent || !receiveUint32(fd, &status) || (output = receiveFrame(fd, &outputLength)) == NULL ||
+        (error = receiveFrame(fd, &errorLength)) == NULL)
+    {
+        fprintf(stderr, "Lost connection to '%s'\n", argv[1]);
+        free(output);
+        close(fd);
+        return 1;
+    }
+    close(fd);
+
+    fwrite(output, 1, outputLength, stdout);
+    fflush(stdout);
+    fwrite(error, 1, errorLength, stderr);
+    free(output);
+    free(error);
+    return (int)status;
+}
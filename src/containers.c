@@ -0,0 +1,404 @@
+#include <stdlib.h>
+#include "containers.h"
+#include "array_sort.h"
+
+// 最小容量
+#define CONTAINER_MIN_CAPACITY 8
+
+Value createHeap(bool isMax, Value keyFn)
+{
+    Value value;
+    Heap *heap = (Heap *)malloc(sizeof(Heap));
+    if (heap == NULL)
+    {
+        return createNull();
+    }
+
+    heap->entries = NULL;
+    heap->count = 0;
+    heap->capacity = 0;
+    heap->isMax = isMax;
+    heap->keyFn = copyValue(keyFn);
+    heap->nextOrder = 0;
+    heap->refCount = 1;
+
+    value.type = VAL_HEAP;
+    value.as.heap = heap;
+    return value;
+}
+
+Heap *copyHeap(const Heap *heap)
+{
+    Value heapValue = createHeap(heap->isMax, heap->keyFn);
+    if (heapValue.type != VAL_HEAP)
+    {
+        return NULL;
+    }
+
+    Heap *copy = heapValue.as.heap;
+    if (heap->count > 0)
+    {
+        copy->entries = (HeapEntry *)malloc(sizeof(HeapEntry) * (size_t)heap->count);
+        if (copy->entries == NULL)
+        {
+            releaseHeap(copy);
+            return NULL;
+        }
+        copy->capacity = heap->count;
+    }
+
+    // 保持存储顺序不变，复制后的堆与原堆出堆顺序相同
+    for (int i = 0; i < heap->count; i++)
+    {
+        copy->entries[i].item = copyValue(heap->entries[i].item);
+        copy->entries[i].key = copyValue(heap->entries[i].key);
+        copy->entries[i].order = heap->entries[i].order;
+    }
+    copy->count = heap->count;
+    copy->nextOrder = heap->nextOrder;
+    return copy;
+}
+
+void retainHeap(Heap *heap)
+{
+    heap->refCount++;
+}
+
+void releaseHeap(Heap *heap)
+{
+    if (heap == NULL || --heap->refCount > 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < heap->count; i++)
+    {
+        freeValue(heap->entries[i].item);
+        freeValue(heap->entries[i].key);
+    }
+    freeValue(heap->keyFn);
+    free(heap->entries);
+    free(heap);
+}
+
+// 两个堆方向相同且按存储顺序逐项相等
+bool heapsEqual(const Heap *a, const Heap *b)
+{
+    if (a->isMax != b->isMax || a->count != b->count)
+    {
+        return false;
+    }
+    for (int i = 0; i < a->count; i++)
+    {
+        if (!valuesEqual(a->entries[i].item, b->entries[i].item))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Value heapEntryKey(const HeapEntry *entry)
+{
+    return entry->key.type != VAL_NULL ? entry->key : entry->item;
+}
+
+const HeapEntry *heapTop(const Heap *heap)
+{
+    return heap->count > 0 ? &heap->entries[0] : NULL;
+}
+
+// a 是否应排在 b 之前出堆
+static bool entryBefore(const Heap *heap, const HeapEntry *a, const HeapEntry *b)
+{
+    int result = compareSortKeys(heapEntryKey(a), heapEntryKey(b));
+    if (heap->isMax)
+    {
+        result = -result;
+    }
+    return result < 0 || (result == 0 && a->order < b->order);
+}
+
+static void siftUp(Heap *heap, int index)
+{
+    HeapEntry entry = heap->entries[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) / 2;
+        if (!entryBefore(heap, &entry, &heap->entries[parent]))
+        {
+            break;
+        }
+        heap->entries[index] = heap->entries[parent];
+        index = parent;
+    }
+    heap->entries[index] = entry;
+}
+
+static void siftDown(HeapEntry *entries, int count, int index, const Heap *heap)
+{
+    HeapEntry entry = entries[index];
+    for (;;)
+    {
+        int child = index * 2 + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && entryBefore(heap, &entries[child + 1], &entries[child]))
+        {
+            child++;
+        }
+        if (!entryBefore(heap, &entries[child], &entry))
+        {
+            break;
+        }
+        entries[index] = entries[child];
+        index = child;
+    }
+    entries[index] = entry;
+}
+
+bool heapPush(Heap *heap, Value item, Value key)
+{
+    if (heap->count == heap->capacity)
+    {
+        int newCapacity = heap->capacity < CONTAINER_MIN_CAPACITY ? CONTAINER_MIN_CAPACITY : heap->capacity * 2;
+        HeapEntry *entries = (HeapEntry *)realloc(heap->entries, sizeof(HeapEntry) * (size_t)newCapacity);
+        if (entries == NULL)
+        {
+            freeValue(item);
+            freeValue(key);
+            return false;
+        }
+        heap->entries = entries;
+        heap->capacity = newCapacity;
+    }
+
+    HeapEntry *entry = &heap->entries[heap->count];
+    entry->item = item;
+    entry->key = key;
+    entry->order = heap->nextOrder++;
+    siftUp(heap, heap->count++);
+    return true;
+}
+
+bool heapPop(Heap *heap, Value *item)
+{
+    if (heap->count == 0)
+    {
+        return false;
+    }
+
+    *item = heap->entries[0].item;
+    freeValue(heap->entries[0].key);
+
+    heap->count--;
+    if (heap->count > 0)
+    {
+        heap->entries[0] = heap->entries[heap->count];
+        siftDown(heap->entries, heap->count, 0, heap);
+    }
+    return true;
+}
+
+// 在存储的浅拷贝上逐个弹出，只复制元素本身
+Value heapToArray(const Heap *heap)
+{
+    Value result = createArray(TYPE_ANY, heap->count);
+    if (result.type != VAL_ARRAY || heap->count == 0)
+    {
+        return result;
+    }
+
+    HeapEntry *scratch = (HeapEntry *)malloc(sizeof(HeapEntry) * (size_t)heap->count);
+    if (scratch == NULL)
+    {
+        freeValue(result);
+        return createNull();
+    }
+    for (int i = 0; i < heap->count; i++)
+    {
+        scratch[i] = heap->entries[i];
+    }
+
+    Array *output = result.as.array;
+    for (int remaining = heap->count; remaining > 0; remaining--)
+    {
+        output->elements[output->count++] = copyValue(scratch[0].item);
+        scratch[0] = scratch[remaining - 1];
+        siftDown(scratch, remaining - 1, 0, heap);
+    }
+    free(scratch);
+    return result;
+}
+
+static Deque *allocateDeque(int capacity)
+{
+    Deque *deque = (Deque *)malloc(sizeof(Deque));
+    if (deque == NULL)
+    {
+        return NULL;
+    }
+
+    int rounded = CONTAINER_MIN_CAPACITY;
+    while (rounded < capacity)
+    {
+        rounded *= 2;
+    }
+
+    deque->items = (Value *)malloc(sizeof(Value) * (size_t)rounded);
+    if (deque->items == NULL)
+    {
+        free(deque);
+        return NULL;
+    }
+    deque->head = 0;
+    deque->count = 0;
+    deque->capacity = rounded;
+    return deque;
+}
+
+Value createDeque(int initialCapacity)
+{
+    Value value;
+    value.type = VAL_DEQUE;
+    value.as.deque = allocateDeque(initialCapacity);
+    if (value.as.deque == NULL)
+    {
+        value.type = VAL_NULL;
+    }
+    return value;
+}
+
+Value *dequeAt(const Deque *deque, int index)
+{
+    return &deque->items[(deque->head + index) & (deque->capacity - 1)];
+}
+
+Deque *copyDeque(const Deque *deque)
+{
+    Deque *copy = allocateDeque(deque->count);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < deque->count; i++)
+    {
+        copy->items[i] = copyValue(*dequeAt(deque, i));
+    }
+    copy->count = deque->count;
+    return copy;
+}
+
+void freeDeque(Deque *deque)
+{
+    if (deque == NULL)
+    {
+        return;
+    }
+    for (int i = 0; i < deque->count; i++)
+    {
+        freeValue(*dequeAt(deque, i));
+    }
+    free(deque->items);
+    free(deque);
+}
+
+bool dequesEqual(const Deque *a, const Deque *b)
+{
+    if (a->count != b->count)
+    {
+        return false;
+    }
+    for (int i = 0; i < a->count; i++)
+    {
+        if (!valuesEqual(*dequeAt(a, i), *dequeAt(b, i)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 容量翻倍，把元素按顺序搬到新缓冲区的开头
+static bool growDeque(Deque *deque)
+{
+    int newCapacity = deque->capacity * 2;
+    Value *items = (Value *)malloc(sizeof(Value) * (size_t)newCapacity);
+    if (items == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < deque->count; i++)
+    {
+        items[i] = *dequeAt(deque, i);
+    }
+    free(deque->items);
+    deque->items = items;
+    deque->head = 0;
+    deque->capacity = newCapacity;
+    return true;
+}
+
+bool dequePushFront(Deque *deque, Value item)
+{
+    if (deque->count == deque->capacity && !growDeque(deque))
+    {
+        freeValue(item);
+        return false;
+    }
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->items[deque->head] = item;
+    deque->count++;
+    return true;
+}
+
+bool dequePushBack(Deque *deque, Value item)
+{
+    if (deque->count == deque->capacity && !growDeque(deque))
+    {
+        freeValue(item);
+        return false;
+    }
+    *dequeAt(deque, deque->count) = item;
+    deque->count++;
+    return true;
+}
+
+bool dequePopFront(Deque *deque, Value *item)
+{
+    if (deque->count == 0)
+    {
+        return false;
+    }
+    *item = deque->items[deque->head];
+    deque->head = (deque->head + 1) & (deque->capacity - 1);
+    deque->count--;
+    return true;
+}
+
+bool dequePopBack(Deque *deque, Value *item)
+{
+    if (deque->count == 0)
+    {
+        return false;
+    }
+    *item = *dequeAt(deque, deque->count - 1);
+    deque->count--;
+    return true;
+}
+
+Value dequeToArray(const Deque *deque)
+{
+    Value result = createArray(TYPE_ANY, deque->count);
+    if (result.type != VAL_ARRAY)
+    {
+        return result;
+    }
+    for (int i = 0; i < deque->count; i++)
+    {
+        result.as.array->elements[result.as.array->count++] = copyValue(*dequeAt(deque, i));
+    }
+    return result;
+}
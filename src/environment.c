@@ -7,16 +7,7 @@
 #include "environment.h"
 #include "interpreter.h"
 
-// 运行时错误结构
-typedef struct
-{
-    bool hadError;     // 是否发生错误
-    bool hadReturn;    // 是否发生返回
-    Value returnValue; // 返回值
-} RuntimeError;
-
-// 静态变量用于跟踪运行时状态
-static RuntimeError error;
+static int findVariable(Environment *env, const char *name);
 
 /**
  * 初始化环境结构体
@@ -89,6 +80,7 @@ void initEnvironment(Environment *env, Environment *enclosing)
  *
  * @warning 如果内存分配失败，函数会输出错误信息到stderr并提前返回
  *          调用者应确保传入的环境结构体已正确初始化
+ * @note 同一作用域中已有同名的内置原生函数时替换该原生函数
  */
 void defineVariable(Environment *env, const char *name, Value value)
 {
@@ -98,6 +90,18 @@ void defineVariable(Environment *env, const char *name, Value value)
         return;
     }
 
+    // 脚本定义与内置原生函数同名的变量（如 sum、count）时替换该原生函数，否则查找时仍会命中原生函数
+    int existing = findVariable(env, name);
+    if (existing >= 0 && env->values[existing].type == VAL_NATIVE_FUNCTION &&
+        env->values[existing].as.nativeFunction != NULL &&
+        strcmp(env->values[existing].as.nativeFunction->name, name) == 0)
+    {
+        Value copy = copyValue(value);
+        freeValue(env->values[existing]);
+        env->values[existing] = copy;
+        return;
+    }
+
     // 确保数组有足够空间
     if (env->count >= env->capacity)
     {
@@ -443,21 +447,11 @@ void freeEnvironment(Environment *env)
     // 释放所有变量名
     if (env->names != NULL)
     {
-        bool isGlobalEnv = (env->enclosing == NULL);
+        // 变量名都是 defineVariable 复制的，包括原生函数名
         for (int i = 0; i < env->count; i++)
         {
-            if (env->names[i] != NULL)
-            {
-                if (isGlobalEnv && i < 3)
-                {
-                    // 跳过全局环境中的原生函数名
-                }
-                else
-                {
-                    free(env->names[i]);
-                }
-                env->names[i] = NULL;
-            }
+            free(env->names[i]);
+            env->names[i] = NULL;
         }
         free(env->names);
         env->names = NULL;
@@ -512,6 +506,44 @@ Value *getVariableRef(Environment *env, const char *name)
     return NULL; // 未找到
 }
 
+/**
+ * 获取变量的存储位置及其常量标记
+ *
+ * 与 getVariableRef 相同，但同时通过 isConst 返回该变量是否为常量，
+ * 供需要原地修改变量的操作（如复合赋值）在写入前检查。
+ *
+ * @param env 要查找的环境指针
+ * @param name 要查找的变量名
+ * @param isConst 输出参数，找到变量时写入其常量标记，可以为NULL
+ * @return Value* 找到时返回指向变量值的指针，否则返回NULL
+ */
+Value *getVariableSlot(Environment *env, const char *name, bool *isConst)
+{
+    for (Environment *current = env; current != NULL; current = current->enclosing)
+    {
+        for (int i = 0; i < current->count; i++)
+        {
+            if (current->names[i] != NULL && strcmp(current->names[i], name) == 0)
+            {
+                if (isConst != NULL)
+                {
+                    *isConst = current->isConst[i];
+                }
+                return &current->values[i];
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// 当前作用域（不含外层环境）中是否已有同名常量；变量声明在定义前检查，避免遮盖常量
+bool isLocalConstant(Environment *env, const char *name)
+{
+    int index = findVariable(env, name);
+    return index >= 0 && env->isConst[index];
+}
+
 void initStaticStorage(StaticStorage *storage) {
     storage->capacity = 8;
     storage->count = 0;
@@ -588,6 +620,24 @@ Value getStaticVariable(StaticStorage *storage, const char *name) {
     return createNull();
 }
 
+// 获取静态变量的存储位置及其常量标记，未找到时返回NULL
+Value *getStaticVariableSlot(StaticStorage *storage, const char *name, bool *isConst) {
+    if (storage == NULL || name == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < storage->count; i++) {
+        if (storage->names[i] != NULL && strcmp(storage->names[i], name) == 0) {
+            if (isConst != NULL) {
+                *isConst = storage->isConst[i];
+            }
+            return &storage->values[i];
+        }
+    }
+
+    return NULL;
+}
+
 void assignStaticVariable(StaticStorage *storage, const char *name, Value value) {
     if (storage == NULL || name == NULL) {
         fprintf(stderr, "ERROR: NULL parameter in assignStaticVariable\n");
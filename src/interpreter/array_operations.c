@@ -1,8 +1,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "../include/interpreter.h"
 
+// 将索引值转换为数组下标：整数直接使用，浮点数按原有规则截断；
+// 超出 int 范围的索引视为无效下标 -1。索引不是数字时报告运行时错误并返回 false
+bool getArrayIndex(Interpreter *interpreter, Value indexValue, int *index) {
+    if (indexValue.type == VAL_INT) {
+        int64_t value = indexValue.as.integer;
+        *index = (value >= 0 && value <= INT_MAX) ? (int)value : -1;
+        return true;
+    }
+
+    if (indexValue.type == VAL_NUMBER) {
+        double value = indexValue.as.number;
+        *index = (value >= 0 && value <= INT_MAX) ? (int)value : -1;
+        return true;
+    }
+
+    runtimeError(interpreter, "数组索引必须是数字");
+    return false;
+}
+
+// 元素求值得到的值直接移入数组，不再复制（arrayPush 会复制传入的值）
 Value evaluateArrayLiteral(Interpreter *interpreter, Expr *expr) {
     Value arrayValue = createArray(TYPE_ANY, expr->as.arrayLiteral.elementCount);
     
@@ -11,127 +32,156 @@ Value evaluateArrayLiteral(Interpreter *interpreter, Expr *expr) {
         return createNull();
     }
 
+    Array *array = arrayValue.as.array;
     for (int i = 0; i < expr->as.arrayLiteral.elementCount; i++) {
         Value element = evaluate(interpreter, expr->as.arrayLiteral.elements[i]);
         
         if (interpreter->hadError) {
+            freeValue(element);
             freeValue(arrayValue);
             return createNull();
         }
 
-        Value elementCopy = copyValue(element);
-        arrayPush(arrayValue.as.array, elementCopy);
-        freeValue(element);
+        array->elements[array->count++] = element;
     }
 
     return arrayValue;
 }
 
-Value evaluateArrayAccess(Interpreter *interpreter, Expr *expr) {
-    Value arrayValue = evaluate(interpreter, expr->as.arrayAccess.array);
-    if (interpreter->hadError) {
-        return createNull();
+// 从数组或映射中取出元素的副本；数组越界或映射中不存在该键时为 null
+static Value indexContainer(Interpreter *interpreter, Value container, Value indexValue) {
+    if (container.type == VAL_MAP) {
+        if (!checkMapKey(interpreter, indexValue)) {
+            return createNull();
+        }
+        Value *element = mapGet(container.as.map, indexValue);
+        return element != NULL ? copyValue(*element) : createNull();
     }
 
-    Value indexValue = evaluate(interpreter, expr->as.arrayAccess.index);
-    if (interpreter->hadError) {
-        freeValue(arrayValue);
+    if (container.type != VAL_ARRAY) {
+        runtimeError(interpreter, "只能对数组或映射进行索引访问");
         return createNull();
     }
 
-    if (arrayValue.type != VAL_ARRAY) {
-        freeValue(arrayValue);
-        freeValue(indexValue);
-        runtimeError(interpreter, "只能对数组进行索引访问");
+    int index;
+    if (!getArrayIndex(interpreter, indexValue, &index)) {
         return createNull();
     }
+    return arrayGet(container.as.array, index);
+}
+
+/**
+ * 索引访问
+ *
+ * 被索引的是变量时先求值索引，再直接借用变量中的数组或映射，只复制取出的元素，
+ * 避免每次 a[i] 都深度复制整个容器。
+ */
+Value evaluateArrayAccess(Interpreter *interpreter, Expr *expr) {
+    Value arrayValue = createNull();
+    if (expr->as.arrayAccess.array->type != EXPR_VARIABLE) {
+        arrayValue = evaluate(interpreter, expr->as.arrayAccess.array);
+        if (interpreter->hadError) {
+            return createNull();
+        }
+    }
 
-    if (indexValue.type != VAL_NUMBER) {
+    Value indexValue = evaluate(interpreter, expr->as.arrayAccess.index);
+    if (interpreter->hadError) {
         freeValue(arrayValue);
         freeValue(indexValue);
-        runtimeError(interpreter, "数组索引必须是数字");
         return createNull();
     }
 
-    int index = (int)indexValue.as.number;
-    Value result = arrayGet(arrayValue.as.array, index);
+    return completeArrayAccess(interpreter, expr, arrayValue, indexValue);
+}
+
+// 以已求值的容器和索引完成索引访问，两者都由本函数释放；被索引的是变量时容器不求值（传入 null）
+Value completeArrayAccess(Interpreter *interpreter, Expr *expr, Value arrayValue, Value indexValue) {
+    if (expr->as.arrayAccess.array->type == EXPR_VARIABLE) {
+        const Value *slot = borrowVariable(interpreter, expr->as.arrayAccess.array);
+        if (slot != NULL) {
+            Value result = indexContainer(interpreter, *slot, indexValue);
+            freeValue(indexValue);
+            return result;
+        }
+
+        // 未找到变量时交给常规求值报告错误
+        arrayValue = evaluate(interpreter, expr->as.arrayAccess.array);
+    }
 
+    Value result = interpreter->hadError ? createNull() : indexContainer(interpreter, arrayValue, indexValue);
     freeValue(arrayValue);
     freeValue(indexValue);
     return result;
 }
 
-Value evaluateArrayAssign(Interpreter *interpreter, Expr *expr) {
-    if (expr->as.arrayAssign.array->type == EXPR_VARIABLE) {
-        Value *arrayRef = getVariableRef(interpreter->environment,
-                                        expr->as.arrayAssign.array->as.variable.name.lexeme);
-
-        if (arrayRef == NULL || arrayRef->type != VAL_ARRAY) {
-            runtimeError(interpreter, "只能对数组进行索引赋值");
-            return createNull();
-        }
-
-        Value indexValue = evaluate(interpreter, expr->as.arrayAssign.index);
-        if (interpreter->hadError) {
-            return createNull();
-        }
-
-        Value value = evaluate(interpreter, expr->as.arrayAssign.value);
-        if (interpreter->hadError) {
-            freeValue(indexValue);
-            return createNull();
-        }
+// 向数组或映射写入元素；indexValue 的所有权转移给本函数，value 由调用方释放
+static void assignContainer(Interpreter *interpreter, Value *container, Value indexValue, Value value) {
+    if (container->type == VAL_MAP) {
+        mapAssign(interpreter, container->as.map, indexValue, value);
+        return;
+    }
 
-        if (indexValue.type != VAL_NUMBER) {
-            freeValue(indexValue);
-            freeValue(value);
-            runtimeError(interpreter, "数组索引必须是数字");
-            return createNull();
-        }
+    if (container->type != VAL_ARRAY) {
+        freeValue(indexValue);
+        runtimeError(interpreter, "只能对数组或映射进行索引赋值");
+        return;
+    }
 
-        int index = (int)indexValue.as.number;
-        arraySet(arrayRef->as.array, index, value);
+    int index;
+    if (getArrayIndex(interpreter, indexValue, &index)) {
+        arraySet(container->as.array, index, value);
+    }
+    freeValue(indexValue);
+}
 
-        freeValue(indexValue);
-        return value;
-    } else {
-        Value arrayValue = evaluate(interpreter, expr->as.arrayAssign.array);
+Value evaluateArrayAssign(Interpreter *interpreter, Expr *expr) {
+    Value arrayValue = createNull();
+    if (expr->as.arrayAssign.array->type != EXPR_VARIABLE) {
+        arrayValue = evaluate(interpreter, expr->as.arrayAssign.array);
         if (interpreter->hadError) return createNull();
+    }
 
-        Value indexValue = evaluate(interpreter, expr->as.arrayAssign.index);
-        if (interpreter->hadError) {
-            freeValue(arrayValue);
-            return createNull();
-        }
+    Value indexValue = evaluate(interpreter, expr->as.arrayAssign.index);
+    if (interpreter->hadError) {
+        freeValue(arrayValue);
+        freeValue(indexValue);
+        return createNull();
+    }
 
-        Value value = evaluate(interpreter, expr->as.arrayAssign.value);
-        if (interpreter->hadError) {
-            freeValue(arrayValue);
-            freeValue(indexValue);
-            return createNull();
-        }
+    Value value = evaluate(interpreter, expr->as.arrayAssign.value);
+    if (interpreter->hadError) {
+        freeValue(arrayValue);
+        freeValue(indexValue);
+        freeValue(value);
+        return createNull();
+    }
 
-        if (arrayValue.type != VAL_ARRAY) {
-            freeValue(arrayValue);
-            freeValue(indexValue);
-            freeValue(value);
-            runtimeError(interpreter, "只能对数组进行索引赋值");
-            return createNull();
-        }
+    return completeArrayAssign(interpreter, expr, arrayValue, indexValue, value);
+}
 
-        if (indexValue.type != VAL_NUMBER) {
-            freeValue(arrayValue);
+// 以已求值的容器、索引和右侧的值完成索引赋值，返回右侧的值；被索引的是变量时容器不求值（传入 null）
+Value completeArrayAssign(Interpreter *interpreter, Expr *expr, Value arrayValue, Value indexValue, Value value) {
+    if (expr->as.arrayAssign.array->type == EXPR_VARIABLE) {
+        // 先求值索引和右侧的值再取变量的存储位置，避免求值过程使指针失效
+        Value *arrayRef = getVariableRef(interpreter->environment,
+                                        expr->as.arrayAssign.array->as.variable.name.lexeme);
+        if (arrayRef == NULL) {
             freeValue(indexValue);
             freeValue(value);
-            runtimeError(interpreter, "数组索引必须是数字");
+            runtimeError(interpreter, "只能对数组或映射进行索引赋值");
             return createNull();
         }
 
-        int index = (int)indexValue.as.number;
-        arraySet(arrayValue.as.array, index, value);
-
+        assignContainer(interpreter, arrayRef, indexValue, value);
+    } else {
+        assignContainer(interpreter, &arrayValue, indexValue, value);
         freeValue(arrayValue);
-        freeValue(indexValue);
-        return value;
     }
-}
\ No newline at end of file
+
+    if (interpreter->hadError) {
+        freeValue(value);
+        return createNull();
+    }
+    return value;
+}
@@ -2,7 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
 #include "../include/interpreter.h"
+#include "../include/numeric_conversion.h"
+#include "../include/simd_kernels.h"
 
 // 前向声明
 static Value handleAddition(Value left, Value right, Interpreter *interpreter);
@@ -14,17 +17,30 @@ static Value handleComparison(Value left, Value right, TokenType op, Interpreter
 static Value handleEquality(Value left, Value right, TokenType op, Interpreter *interpreter);
 static Value handleLogical(Value left, Value right, TokenType op, Interpreter *interpreter);
 static Value handleInOperator(Value left, Value right, Interpreter *interpreter);
+static Value handleArrayArithmetic(Value left, Value right, TokenType op, Interpreter *interpreter);
+static Value arrayArithmetic(Value left, Value right, TokenType op, Interpreter *interpreter);
+static bool evaluateBorrowedArrayArithmetic(Interpreter *interpreter, Expr *expr, Value *result);
 
 Value evaluateBinary(Interpreter *interpreter, Expr *expr)
 {
+    Value borrowedResult;
+    if (evaluateBorrowedArrayArithmetic(interpreter, expr, &borrowedResult))
+    {
+        return borrowedResult;
+    }
+
     Value left = evaluate(interpreter, expr->as.binary.left);
+    return completeBinary(interpreter, expr, left);
+}
 
+// 左操作数已求值（所有权转移给本函数），完成短路求值、右操作数求值和运算
+Value completeBinary(Interpreter *interpreter, Expr *expr, Value left)
+{
     // 短路求值处理
     if ((expr->as.binary.op == TOKEN_AND || expr->as.binary.op == TOKEN_OR) &&
         interpreter->hadError == false)
     {
-        bool leftTruthy = left.type != VAL_NULL &&
-                          !(left.type == VAL_BOOL && !left.as.boolean);
+        bool leftTruthy = isTruthy(left);
 
         if ((expr->as.binary.op == TOKEN_AND && !leftTruthy) ||
             (expr->as.binary.op == TOKEN_OR && leftTruthy))
@@ -36,6 +52,25 @@ Value evaluateBinary(Interpreter *interpreter, Expr *expr)
         return evaluate(interpreter, expr->as.binary.right);
     }
 
+    // 右侧为数组或映射变量时直接在变量中查找，不复制整个容器
+    if (expr->as.binary.op == TOKEN_IN && expr->as.binary.right->type == EXPR_VARIABLE &&
+        !interpreter->hadError)
+    {
+        const Value *slot = borrowVariable(interpreter, expr->as.binary.right);
+        if (slot != NULL && slot->type == VAL_ARRAY)
+        {
+            bool found = arrayIndexOf(slot->as.array, left, 0) >= 0;
+            freeValue(left);
+            return createBool(found);
+        }
+        if (slot != NULL && slot->type == VAL_MAP)
+        {
+            bool found = mapHas(slot->as.map, left);
+            freeValue(left);
+            return createBool(found);
+        }
+    }
+
     Value right = evaluate(interpreter, expr->as.binary.right);
 
     if (interpreter->hadError)
@@ -45,7 +80,13 @@ Value evaluateBinary(Interpreter *interpreter, Expr *expr)
         return createNull();
     }
 
-    switch (expr->as.binary.op)
+    return applyBinary(interpreter, expr->as.binary.op, left, right);
+}
+
+// 对已求值的两个操作数执行二元运算（不含短路求值），释放两个操作数
+Value applyBinary(Interpreter *interpreter, TokenType op, Value left, Value right)
+{
+    switch (op)
     {
     case TOKEN_PLUS:
         return handleAddition(left, right, interpreter);
@@ -61,13 +102,13 @@ Value evaluateBinary(Interpreter *interpreter, Expr *expr)
     case TOKEN_LE:
     case TOKEN_GT:
     case TOKEN_GE:
-        return handleComparison(left, right, expr->as.binary.op, interpreter);
+        return handleComparison(left, right, op, interpreter);
     case TOKEN_EQ:
     case TOKEN_NE:
-        return handleEquality(left, right, expr->as.binary.op, interpreter);
+        return handleEquality(left, right, op, interpreter);
     case TOKEN_AND:
     case TOKEN_OR:
-        return handleLogical(left, right, expr->as.binary.op, interpreter);
+        return handleLogical(left, right, op, interpreter);
     case TOKEN_IN:
         return handleInOperator(left, right, interpreter);
     }
@@ -80,21 +121,29 @@ Value evaluateBinary(Interpreter *interpreter, Expr *expr)
 
 static Value handleAddition(Value left, Value right, Interpreter *interpreter)
 {
-    if (left.type == VAL_NUMBER && right.type == VAL_NUMBER)
+    if (left.type == VAL_ARRAY || right.type == VAL_ARRAY)
     {
-        double result = left.as.number + right.as.number;
-        freeValue(left);
-        freeValue(right);
-        return createNumber(result);
+        return handleArrayArithmetic(left, right, TOKEN_PLUS, interpreter);
+    }
+
+    if (left.type == VAL_INT && right.type == VAL_INT)
+    {
+        int64_t result;
+        if (__builtin_add_overflow(left.as.integer, right.as.integer, &result))
+        {
+            // 溢出时提升为浮点数
+            return createNumber((double)left.as.integer + (double)right.as.integer);
+        }
+        return createInt(result);
+    }
+    else if (isNumeric(left) && isNumeric(right))
+    {
+        return createNumber(asDouble(left) + asDouble(right));
     }
     else if (left.type == VAL_STRING && right.type == VAL_STRING)
     {
-        // 字符串连接
-        int leftLen = strlen(left.as.string);
-        int rightLen = strlen(right.as.string);
-        char *result = malloc(leftLen + rightLen + 1);
-
-        if (result == NULL)
+        // 字符串连接：直接在左操作数（临时值）的缓冲区上追加，省去一次分配和复制
+        if (!appendToString(&left, right.as.string, stringLength(right.as.string)))
         {
             freeValue(left);
             freeValue(right);
@@ -102,84 +151,40 @@ static Value handleAddition(Value left, Value right, Interpreter *interpreter)
             return createNull();
         }
 
-        strcpy(result, left.as.string);
-        strcat(result, right.as.string);
-
-        freeValue(left);
         freeValue(right);
-
-        Value strValue = createString(result);
-        free(result);
-        return strValue;
+        return left;
     }
-    else if (left.type == VAL_STRING && right.type == VAL_NUMBER)
+    else if (left.type == VAL_STRING && isNumeric(right))
     {
         // 字符串 + 数字：将数字转换为字符串后连接
-        char numberStr[64];
-        if (right.as.number == (int)right.as.number)
-        {
-            snprintf(numberStr, sizeof(numberStr), "%d", (int)right.as.number);
-        }
-        else
-        {
-            snprintf(numberStr, sizeof(numberStr), "%g", right.as.number);
-        }
+        char numberStr[NUMBER_BUFFER_SIZE];
+        int numberLength = formatNumberValue(right, numberStr);
 
-        int leftLen = strlen(left.as.string);
-        int rightLen = strlen(numberStr);
-        char *result = malloc(leftLen + rightLen + 1);
-
-        if (result == NULL)
+        if (!appendToString(&left, numberStr, (size_t)numberLength))
         {
             freeValue(left);
-            freeValue(right);
             runtimeError(interpreter, "内存分配失败");
             return createNull();
         }
-
-        strcpy(result, left.as.string);
-        strcat(result, numberStr);
-
-        freeValue(left);
-        freeValue(right);
-
-        Value strValue = createString(result);
-        free(result);
-        return strValue;
+        return left;
     }
-    else if (left.type == VAL_NUMBER && right.type == VAL_STRING)
+    else if (isNumeric(left) && right.type == VAL_STRING)
     {
         // 数字 + 字符串：将数字转换为字符串后连接
-        char numberStr[64];
-        if (left.as.number == (int)left.as.number)
-        {
-            snprintf(numberStr, sizeof(numberStr), "%d", (int)left.as.number);
-        }
-        else
-        {
-            snprintf(numberStr, sizeof(numberStr), "%g", left.as.number);
-        }
-
-        int leftLen = strlen(numberStr);
-        int rightLen = strlen(right.as.string);
-        char *result = malloc(leftLen + rightLen + 1);
+        char numberStr[NUMBER_BUFFER_SIZE];
+        int numberLength = formatNumberValue(left, numberStr);
 
-        if (result == NULL)
+        Value strValue = createStringWithLength(numberStr, (size_t)numberLength);
+        if (strValue.type == VAL_NULL ||
+            !appendToString(&strValue, right.as.string, stringLength(right.as.string)))
         {
-            freeValue(left);
+            freeValue(strValue);
             freeValue(right);
             runtimeError(interpreter, "内存分配失败");
             return createNull();
         }
 
-        strcpy(result, numberStr);
-        strcat(result, right.as.string);
-
-        freeValue(left);
         freeValue(right);
-
-        Value strValue = createString(result);
-        free(result);
         return strValue;
     }
 
@@ -191,7 +196,22 @@ static Value handleAddition(Value left, Value right, Interpreter *interpreter)
 
 static Value handleSubtraction(Value left, Value right, Interpreter *interpreter)
 {
-    if (left.type != VAL_NUMBER || right.type != VAL_NUMBER)
+    if (left.type == VAL_ARRAY || right.type == VAL_ARRAY)
+    {
+        return handleArrayArithmetic(left, right, TOKEN_MINUS, interpreter);
+    }
+
+    if (left.type == VAL_INT && right.type == VAL_INT)
+    {
+        int64_t result;
+        if (__builtin_sub_overflow(left.as.integer, right.as.integer, &result))
+        {
+            return createNumber((double)left.as.integer - (double)right.as.integer);
+        }
+        return createInt(result);
+    }
+
+    if (!isNumeric(left) || !isNumeric(right))
     {
         freeValue(left);
         freeValue(right);
@@ -199,15 +219,27 @@ static Value handleSubtraction(Value left, Value right, Interpreter *interpreter
         return createNull();
     }
 
-    double result = left.as.number - right.as.number;
-    freeValue(left);
-    freeValue(right);
-    return createNumber(result);
+    return createNumber(asDouble(left) - asDouble(right));
 }
 
 static Value handleMultiplication(Value left, Value right, Interpreter *interpreter)
 {
-    if (left.type != VAL_NUMBER || right.type != VAL_NUMBER)
+    if (left.type == VAL_ARRAY || right.type == VAL_ARRAY)
+    {
+        return handleArrayArithmetic(left, right, TOKEN_MULTIPLY, interpreter);
+    }
+
+    if (left.type == VAL_INT && right.type == VAL_INT)
+    {
+        int64_t result;
+        if (__builtin_mul_overflow(left.as.integer, right.as.integer, &result))
+        {
+            return createNumber((double)left.as.integer * (double)right.as.integer);
+        }
+        return createInt(result);
+    }
+
+    if (!isNumeric(left) || !isNumeric(right))
     {
         freeValue(left);
         freeValue(right);
@@ -215,15 +247,17 @@ static Value handleMultiplication(Value left, Value right, Interpreter *interpre
         return createNull();
     }
 
-    double result = left.as.number * right.as.number;
-    freeValue(left);
-    freeValue(right);
-    return createNumber(result);
+    return createNumber(asDouble(left) * asDouble(right));
 }
 
 static Value handleDivision(Value left, Value right, Interpreter *interpreter)
 {
-    if (left.type != VAL_NUMBER || right.type != VAL_NUMBER)
+    if (left.type == VAL_ARRAY || right.type == VAL_ARRAY)
+    {
+        return handleArrayArithmetic(left, right, TOKEN_DIVIDE, interpreter);
+    }
+
+    if (!isNumeric(left) || !isNumeric(right))
     {
         freeValue(left);
         freeValue(right);
@@ -232,23 +266,26 @@ static Value handleDivision(Value left, Value right, Interpreter *interpreter)
     }
 
     // 检查除数是否为零
-    if (right.as.number == 0)
+    if (asDouble(right) == 0)
     {
-        freeValue(left);
-        freeValue(right);
         runtimeError(interpreter, "除数不能为零。");
         return createNull();
     }
 
-    double result = left.as.number / right.as.number;
-    freeValue(left);
-    freeValue(right);
-    return createNumber(result);
+    // 整数能整除时结果仍为整数，否则得到浮点数（如 20 / 6）
+    if (left.type == VAL_INT && right.type == VAL_INT &&
+        !(left.as.integer == INT64_MIN && right.as.integer == -1) &&
+        left.as.integer % right.as.integer == 0)
+    {
+        return createInt(left.as.integer / right.as.integer);
+    }
+
+    return createNumber(asDouble(left) / asDouble(right));
 }
 
 static Value handleModulo(Value left, Value right, Interpreter *interpreter)
 {
-    if (left.type != VAL_NUMBER || right.type != VAL_NUMBER)
+    if (!isNumeric(left) || !isNumeric(right))
     {
         freeValue(left);
         freeValue(right);
@@ -257,23 +294,28 @@ static Value handleModulo(Value left, Value right, Interpreter *interpreter)
     }
 
     // 检查除数是否为零
-    if (right.as.number == 0)
+    if (asDouble(right) == 0)
     {
-        freeValue(left);
-        freeValue(right);
         runtimeError(interpreter, "取模运算的除数不能为零。");
         return createNull();
     }
 
-    double result = fmod(left.as.number, right.as.number);
-    freeValue(left);
-    freeValue(right);
-    return createNumber(result);
+    if (left.type == VAL_INT && right.type == VAL_INT)
+    {
+        // INT64_MIN % -1 在 C 中是未定义行为，其数学结果为 0
+        if (right.as.integer == -1)
+        {
+            return createInt(0);
+        }
+        return createInt(left.as.integer % right.as.integer);
+    }
+
+    return createNumber(fmod(asDouble(left), asDouble(right)));
 }
 
 static Value handleComparison(Value left, Value right, TokenType op, Interpreter *interpreter)
 {
-    if (left.type != VAL_NUMBER || right.type != VAL_NUMBER)
+    if (!isNumeric(left) || !isNumeric(right))
     {
         freeValue(left);
         freeValue(right);
@@ -281,30 +323,56 @@ static Value handleComparison(Value left, Value right, TokenType op, Interpreter
         return createNull();
     }
 
+    int order;
+    if (left.type == VAL_INT && right.type == VAL_INT)
+    {
+        // 整数直接比较，避免转换为 double 丢失精度
+        order = (left.as.integer > right.as.integer) - (left.as.integer < right.as.integer);
+    }
+    else
+    {
+        double a = asDouble(left);
+        double b = asDouble(right);
+        if (a != a || b != b)
+        {
+            // NaN 与任何值比较都为 false
+            return createBool(false);
+        }
+        // 整数与浮点数混合时精确比较，与 == 和 sort() 的结果一致
+        if (left.type == VAL_INT)
+        {
+            order = compareIntDouble(left.as.integer, b);
+        }
+        else if (right.type == VAL_INT)
+        {
+            order = -compareIntDouble(right.as.integer, a);
+        }
+        else
+        {
+            order = (a > b) - (a < b);
+        }
+    }
+
     bool result;
     switch (op)
     {
     case TOKEN_LT:
-        result = left.as.number < right.as.number;
+        result = order < 0;
         break;
     case TOKEN_LE:
-        result = left.as.number <= right.as.number;
+        result = order <= 0;
         break;
     case TOKEN_GT:
-        result = left.as.number > right.as.number;
+        result = order > 0;
         break;
     case TOKEN_GE:
-        result = left.as.number >= right.as.number;
+        result = order >= 0;
         break;
     default:
-        freeValue(left);
-        freeValue(right);
         runtimeError(interpreter, "未知的比较运算符");
         return createNull();
     }
 
-    freeValue(left);
-    freeValue(right);
     return createBool(result);
 }
 
@@ -351,15 +419,13 @@ static Value handleLogical(Value left, Value right, TokenType op, Interpreter *i
         else
         {
             // 左操作数为真，返回右操作数的真值
-            result = (right.type != VAL_NULL) &&
-                     !(right.type == VAL_BOOL && !right.as.boolean);
+            result = isTruthy(right);
         }
     }
     else if (op == TOKEN_OR)
     {
         // 逻辑或运算符 (||)
-        bool leftTruthy = (left.type != VAL_NULL) &&
-                          !(left.type == VAL_BOOL && !left.as.boolean);
+        bool leftTruthy = isTruthy(left);
 
         if (leftTruthy)
         {
@@ -368,8 +434,7 @@ static Value handleLogical(Value left, Value right, TokenType op, Interpreter *i
         else
         {
             // 左操作数为假，返回右操作数的真值
-            result = (right.type != VAL_NULL) &&
-                     !(right.type == VAL_BOOL && !right.as.boolean);
+            result = isTruthy(right);
         }
     }
     else
@@ -396,21 +461,11 @@ static Value handleInOperator(Value left, Value right, Interpreter *interpreter)
             return createBool(false);
         }
 
-        // 在数组中查找元素
-        Array *array = right.as.array;
-        for (int i = 0; i < array->count; i++)
-        {
-            if (valuesEqual(left, array->elements[i]))
-            {
-                freeValue(left);
-                freeValue(right);
-                return createBool(true);
-            }
-        }
-
+        // 在数组中查找元素，数字段使用向量化核函数
+        bool found = arrayIndexOf(right.as.array, left, 0) >= 0;
         freeValue(left);
         freeValue(right);
-        return createBool(false);
+        return createBool(found);
     }
     else if (right.type == VAL_STRING)
     {
@@ -435,11 +490,242 @@ static Value handleInOperator(Value left, Value right, Interpreter *interpreter)
         freeValue(right);
         return createBool(found);
     }
+    else if (right.type == VAL_RANGE)
+    {
+        // 区间按算术判断，不生成元素
+        bool found = rangeContains(right.as.range, left);
+        freeValue(left);
+        freeValue(right);
+        return createBool(found);
+    }
+    else if (right.type == VAL_MAP)
+    {
+        // 映射按键查找
+        bool found = mapHas(right.as.map, left);
+        freeValue(left);
+        freeValue(right);
+        return createBool(found);
+    }
     else
     {
         freeValue(left);
         freeValue(right);
-        runtimeError(interpreter, "in 操作符的右操作数必须是数组或字符串");
+        runtimeError(interpreter, "in 操作符的右操作数必须是数组、字符串、映射或区间");
         return createNull();
     }
-}
\ No newline at end of file
+}
+
+// 逐元素运算的数组操作数（标量时返回 NULL）
+static Array *arithmeticArray(Value operand)
+{
+    return operand.type == VAL_ARRAY ? operand.as.array : NULL;
+}
+
+static int arithmeticCount(Value operand)
+{
+    Array *array = arithmeticArray(operand);
+    return array != NULL ? array->count : 0;
+}
+
+static const Value *arithmeticElements(Value operand)
+{
+    Array *array = arithmeticArray(operand);
+    return array != NULL ? array->elements : NULL;
+}
+
+// 操作数（数组或标量）是否全为 type 类型
+static bool operandAllOfType(Value operand, ValueType type, size_t count)
+{
+    if (operand.type != VAL_ARRAY)
+    {
+        return operand.type == type;
+    }
+    return valueTypeRun(arithmeticElements(operand), count, type) == count;
+}
+
+static ArithmeticOperand makeOperand(Value operand)
+{
+    ArithmeticOperand result = {NULL, 0, 0};
+    if (operand.type == VAL_ARRAY)
+    {
+        result.values = arithmeticElements(operand);
+    }
+    else
+    {
+        result.number = asDouble(operand);
+        result.integer = operand.type == VAL_INT ? operand.as.integer : 0;
+    }
+    return result;
+}
+
+// 逐个元素套用标量运算规则
+static Value applyScalarArithmetic(Value x, Value y, TokenType op, Interpreter *interpreter)
+{
+    switch (op)
+    {
+    case TOKEN_PLUS:
+        return handleAddition(x, y, interpreter);
+    case TOKEN_MINUS:
+        return handleSubtraction(x, y, interpreter);
+    case TOKEN_MULTIPLY:
+        return handleMultiplication(x, y, interpreter);
+    default:
+        return handleDivision(x, y, interpreter);
+    }
+}
+
+// 数组逐元素运算，运算后释放两个操作数
+static Value handleArrayArithmetic(Value left, Value right, TokenType op, Interpreter *interpreter)
+{
+    Value result = arrayArithmetic(left, right, op, interpreter);
+    freeValue(left);
+    freeValue(right);
+    return result;
+}
+
+/**
+ * 操作数都是变量或字面量、且至少一个变量是数组时，直接借用变量中的数组做逐元素运算，
+ * 省去对整个数组的两次复制。不满足条件时返回 false，按常规路径求值。
+ */
+static bool evaluateBorrowedArrayArithmetic(Interpreter *interpreter, Expr *expr, Value *result)
+{
+    TokenType op = expr->as.binary.op;
+    if (op != TOKEN_PLUS && op != TOKEN_MINUS && op != TOKEN_MULTIPLY && op != TOKEN_DIVIDE)
+    {
+        return false;
+    }
+
+    Expr *operands[2] = {expr->as.binary.left, expr->as.binary.right};
+    const Value *slots[2] = {NULL, NULL};
+    bool hasArray = false;
+    for (int i = 0; i < 2; i++)
+    {
+        if (operands[i]->type == EXPR_VARIABLE)
+        {
+            slots[i] = borrowVariable(interpreter, operands[i]);
+            if (slots[i] == NULL)
+            {
+                return false; // 交给常规路径报告未定义变量
+            }
+            hasArray = hasArray || slots[i]->type == VAL_ARRAY;
+        }
+        else if (operands[i]->type != EXPR_LITERAL)
+        {
+            return false;
+        }
+    }
+    if (!hasArray)
+    {
+        return false;
+    }
+
+    Value values[2];
+    for (int i = 0; i < 2; i++)
+    {
+        values[i] = slots[i] != NULL ? *slots[i] : evaluate(interpreter, operands[i]);
+    }
+
+    *result = interpreter->hadError ? createNull() : arrayArithmetic(values[0], values[1], op, interpreter);
+    for (int i = 0; i < 2; i++)
+    {
+        if (slots[i] == NULL)
+        {
+            freeValue(values[i]);
+        }
+    }
+    return true;
+}
+
+/**
+ * 数组逐元素算术运算：两个等长的数字数组，或数组与数字标量；不释放操作数
+ *
+ * 结果数组一次分配。全为浮点数时交给向量化核函数；全为整数时先尝试整数核函数，
+ * 遇到溢出或不能整除等需要提升为浮点数的情况，再按标量运算规则逐个计算。
+ */
+static Value arrayArithmetic(Value left, Value right, TokenType op, Interpreter *interpreter)
+{
+    Array *leftArray = arithmeticArray(left);
+    Array *rightArray = arithmeticArray(right);
+    const char *opName = op == TOKEN_PLUS ? "+" : op == TOKEN_MINUS ? "-" : op == TOKEN_MULTIPLY ? "*" : "/";
+
+    if ((leftArray == NULL && !isNumeric(left)) || (rightArray == NULL && !isNumeric(right)))
+    {
+        runtimeError(interpreter, "%s 运算符的数组操作数只能与数字或数组运算", opName);
+        return createNull();
+    }
+
+    int count = leftArray != NULL ? arithmeticCount(left) : arithmeticCount(right);
+    if (leftArray != NULL && rightArray != NULL && arithmeticCount(left) != arithmeticCount(right))
+    {
+        runtimeError(interpreter, "%s 运算符的两个数组长度不同（%d 和 %d）", opName,
+                     arithmeticCount(left), arithmeticCount(right));
+        return createNull();
+    }
+
+    // 数组操作数全为浮点数或全为整数时走核函数，否则逐个检查元素
+    size_t n = (size_t)count;
+    bool allIntegers = operandAllOfType(left, VAL_INT, n) && operandAllOfType(right, VAL_INT, n);
+    bool floatKernel = (leftArray == NULL || operandAllOfType(left, VAL_NUMBER, n)) &&
+                       (rightArray == NULL || operandAllOfType(right, VAL_NUMBER, n));
+
+    for (int side = 0; side < 2 && !allIntegers && !floatKernel; side++)
+    {
+        Value operand = side == 0 ? left : right;
+        const Value *elements = arithmeticElements(operand);
+        for (int i = 0; operand.type == VAL_ARRAY && i < count; i++)
+        {
+            if (!isNumeric(elements[i]))
+            {
+                runtimeError(interpreter, "%s 运算符的数组元素必须是数字，第 %d 个元素不是", opName, i);
+                return createNull();
+            }
+        }
+    }
+
+    Value result = createArray(TYPE_ANY, count);
+    if (result.type != VAL_ARRAY)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return createNull();
+    }
+
+    Value *out = result.as.array->elements;
+    ArithmeticOp kernelOp = op == TOKEN_PLUS ? ARITH_ADD : op == TOKEN_MINUS ? ARITH_SUB : op == TOKEN_MULTIPLY ? ARITH_MUL : ARITH_DIV;
+    ArithmeticOperand a = makeOperand(left);
+    ArithmeticOperand b = makeOperand(right);
+    bool done = false;
+
+    if (floatKernel)
+    {
+        // 浮点数组，标量可以是整数：与标量规则一样按 double 计算
+        bool zeroDivisor = kernelOp == ARITH_DIV &&
+                           (rightArray != NULL ? countNumber(b.values, n, 0) > 0 : b.number == 0);
+        if (!zeroDivisor)
+        {
+            arithmeticNumbers(kernelOp, a, b, out, n);
+            done = true;
+        }
+    }
+    else if (allIntegers)
+    {
+        done = arithmeticIntegers(kernelOp, a, b, out, n);
+    }
+
+    if (!done)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            Value x = leftArray != NULL ? leftArray->elements[i] : left;
+            Value y = rightArray != NULL ? rightArray->elements[i] : right;
+            out[i] = applyScalarArithmetic(x, y, op, interpreter);
+            if (interpreter->hadError)
+            {
+                freeValue(result);
+                return createNull();
+            }
+        }
+    }
+
+    result.as.array->count = count;
+    return result;
+}
@@ -1,49 +1,82 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../include/interpreter.h"
+#include "../include/numeric_conversion.h"
+
+// 将字符串值解析为数字，失败时报告运行时错误；无论成功与否都会释放字符串
+static bool parseStringNumber(Interpreter *interpreter, Value value, const char *targetName, ParsedNumber *parsed) {
+    NumberParseStatus status = parseNumber(value.as.string, stringLength(value.as.string), parsed);
+    if (status != NUMBER_PARSE_OK) {
+        runtimeError(interpreter, "无法将字符串 \"%s\" 转换为%s：%s",
+                     value.as.string, targetName, numberParseStatusMessage(status));
+        freeValue(value);
+        return false;
+    }
+    freeValue(value);
+    return true;
+}
 
 Value evaluateCast(Interpreter *interpreter, Expr *expr) {
     Value value = evaluate(interpreter, expr->as.cast.expression);
     if (interpreter->hadError) {
         return createNull();
     }
+    return completeCast(interpreter, expr, value);
+}
 
+// 将已求值的操作数转换为目标类型，操作数由本函数释放
+Value completeCast(Interpreter *interpreter, Expr *expr, Value value) {
     BaseType targetType = expr->as.cast.targetType;
 
     switch (targetType) {
     case TYPE_INT:
-        if (value.type == VAL_NUMBER) {
-            int intValue = (int)value.as.number;
-            freeValue(value);
-            return createNumber((double)intValue);
+        if (value.type == VAL_INT) {
+            return value;
+        } else if (value.type == VAL_NUMBER) {
+            double number = value.as.number;
+            if (number != number || number < -9223372036854775808.0 || number >= 9223372036854775808.0) {
+                runtimeError(interpreter, "浮点数 %g 超出整数范围", number);
+                return createNull();
+            }
+            return createInt((int64_t)number);
         } else if (value.type == VAL_STRING) {
-            int intValue = atoi(value.as.string);
-            freeValue(value);
-            return createNumber((double)intValue);
+            ParsedNumber parsed;
+            if (!parseStringNumber(interpreter, value, "整数", &parsed)) {
+                return createNull();
+            }
+            if (parsed.isInteger) {
+                return createInt(parsed.integer);
+            }
+            // 小数或指数形式的字符串按浮点数转换规则截断
+            if (parsed.number < -9223372036854775808.0 || parsed.number >= 9223372036854775808.0) {
+                runtimeError(interpreter, "浮点数 %g 超出整数范围", parsed.number);
+                return createNull();
+            }
+            return createInt((int64_t)parsed.number);
         }
         break;
 
     case TYPE_FLOAT:
         if (value.type == VAL_NUMBER) {
             return value;
+        } else if (value.type == VAL_INT) {
+            return createNumber((double)value.as.integer);
         } else if (value.type == VAL_STRING) {
-            double floatValue = atof(value.as.string);
-            freeValue(value);
-            return createNumber(floatValue);
+            ParsedNumber parsed;
+            if (!parseStringNumber(interpreter, value, "浮点数", &parsed)) {
+                return createNull();
+            }
+            return createNumber(parsed.number);
         }
         break;
 
     case TYPE_STRING:
-        if (value.type == VAL_NUMBER) {
-            char buffer[32];
-            if (value.as.number == (int)value.as.number) {
-                snprintf(buffer, sizeof(buffer), "%d", (int)value.as.number);
-            } else {
-                snprintf(buffer, sizeof(buffer), "%g", value.as.number);
-            }
-            freeValue(value);
-            return createString(buffer);
+        if (isNumeric(value)) {
+            char buffer[NUMBER_BUFFER_SIZE];
+            int length = formatNumberValue(value, buffer);
+            return createStringWithLength(buffer, (size_t)length);
         } else if (value.type == VAL_BOOL) {
             const char *str = value.as.boolean ? "true" : "false";
             freeValue(value);
@@ -52,7 +85,9 @@ Value evaluateCast(Interpreter *interpreter, Expr *expr) {
         break;
 
     case TYPE_BOOL:
-        if (value.type == VAL_NUMBER) {
+        if (value.type == VAL_INT) {
+            return createBool(value.as.integer != 0);
+        } else if (value.type == VAL_NUMBER) {
             bool boolValue = value.as.number != 0;
             freeValue(value);
             return createBool(boolValue);
@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include "../include/interpreter.h"
+#include "../include/numeric_conversion.h"
+
+// 复合赋值运算符的显示名称，用于错误信息
+static const char *operatorName(TokenType op) {
+    switch (op) {
+    case TOKEN_PLUS_ASSIGN:
+        return "+=";
+    case TOKEN_MINUS_ASSIGN:
+        return "-=";
+    case TOKEN_MULTIPLY_ASSIGN:
+        return "*=";
+    case TOKEN_DIVIDE_ASSIGN:
+        return "/=";
+    case TOKEN_MODULO_ASSIGN:
+        return "%=";
+    default:
+        return "?=";
+    }
+}
+
+/**
+ * 解析复合赋值的目标，返回其存储位置
+ *
+ * 变量直接返回环境（或静态存储）中的槽位；数组元素、映射的值和结构体字段先递归解析
+ * 外层容器的槽位，再定位到其中的元素，因此整个过程不会复制容器。
+ * 每一层都先求值索引表达式再取指针，保证取得的指针在返回前不会因求值而失效。
+ */
+static Value *resolveTarget(Interpreter *interpreter, Expr *target) {
+    switch (target->type) {
+    case EXPR_VARIABLE: {
+        const char *name = target->as.variable.name.lexeme;
+        bool isConst = false;
+
+        Value *slot = getStaticVariableSlot(interpreter->staticStorage, name, &isConst);
+        if (slot == NULL) {
+            slot = getVariableSlot(interpreter->environment, name, &isConst);
+        }
+
+        if (slot == NULL) {
+            runtimeError(interpreter, "未定义的变量 '%s'", name);
+            return NULL;
+        }
+        if (isConst) {
+            runtimeError(interpreter, "不能对常量 '%s' 赋值", name);
+            return NULL;
+        }
+        return slot;
+    }
+
+    case EXPR_ARRAY_ACCESS: {
+        Value indexValue = evaluate(interpreter, target->as.arrayAccess.index);
+        if (interpreter->hadError) {
+            freeValue(indexValue);
+            return NULL;
+        }
+
+        Value *containerSlot = resolveTarget(interpreter, target->as.arrayAccess.array);
+        if (containerSlot == NULL) {
+            freeValue(indexValue);
+            return NULL;
+        }
+
+        if (containerSlot->type == VAL_MAP) {
+            Value *element = checkMapKey(interpreter, indexValue)
+                                 ? mapGet(containerSlot->as.map, indexValue)
+                                 : NULL;
+            if (element == NULL && !interpreter->hadError) {
+                runtimeError(interpreter, "映射中不存在该键");
+            }
+            freeValue(indexValue);
+            return element;
+        }
+
+        int index;
+        bool validIndex = getArrayIndex(interpreter, indexValue, &index);
+        freeValue(indexValue);
+        if (!validIndex) {
+            return NULL;
+        }
+        if (containerSlot->type != VAL_ARRAY) {
+            runtimeError(interpreter, "只能对数组或映射进行索引赋值");
+            return NULL;
+        }
+        if (index < 0 || index >= containerSlot->as.array->count) {
+            runtimeError(interpreter, "数组索引越界：%d", index);
+            return NULL;
+        }
+        return &containerSlot->as.array->elements[index];
+    }
+
+    case EXPR_DOT_ACCESS: {
+        Value *objectSlot = resolveTarget(interpreter, target->as.dotAccess.object);
+        if (objectSlot == NULL) {
+            return NULL;
+        }
+        if (objectSlot->type != VAL_STRUCT) {
+            runtimeError(interpreter, "Can only assign to struct fields");
+            return NULL;
+        }
+
+        StructValue *structValue = objectSlot->as.structValue;
+        const char *fieldName = target->as.dotAccess.member.lexeme;
+        for (int i = 0; i < structValue->fieldCount; i++) {
+            if (strcmp(structValue->fields[i].name, fieldName) == 0) {
+                return structValue->fields[i].value;
+            }
+        }
+
+        runtimeError(interpreter, "Struct field not found");
+        return NULL;
+    }
+
+    default:
+        runtimeError(interpreter, "无效的复合赋值目标");
+        return NULL;
+    }
+}
+
+// 字符串 += 值：在原缓冲区末尾追加，摊销 O(1)
+static bool appendInPlace(Interpreter *interpreter, Value *slot, Value operand) {
+    bool appended;
+
+    if (operand.type == VAL_STRING) {
+        appended = appendToString(slot, operand.as.string, stringLength(operand.as.string));
+    } else if (isNumeric(operand)) {
+        char numberStr[NUMBER_BUFFER_SIZE];
+        int length = formatNumberValue(operand, numberStr);
+        appended = appendToString(slot, numberStr, (size_t)length);
+    } else {
+        runtimeError(interpreter, "+= 运算符只支持数字加法或字符串连接");
+        return false;
+    }
+
+    if (!appended) {
+        runtimeError(interpreter, "内存分配失败");
+        return false;
+    }
+    return true;
+}
+
+// 数字 += 字符串：与 + 运算符一致，结果为拼接后的新字符串
+static bool prependNumber(Interpreter *interpreter, Value *slot, Value operand) {
+    char numberStr[NUMBER_BUFFER_SIZE];
+    int length = formatNumberValue(*slot, numberStr);
+
+    Value result = createStringWithLength(numberStr, (size_t)length);
+    if (result.type == VAL_NULL ||
+        !appendToString(&result, operand.as.string, stringLength(operand.as.string))) {
+        freeValue(result);
+        runtimeError(interpreter, "内存分配失败");
+        return false;
+    }
+
+    *slot = result;
+    return true;
+}
+
+// 整数原地运算，溢出时提升为浮点数
+static bool applyIntegerInPlace(Interpreter *interpreter, Value *slot, TokenType op, int64_t operand) {
+    int64_t current = slot->as.integer;
+    int64_t result;
+    bool overflow = false;
+
+    switch (op) {
+    case TOKEN_PLUS_ASSIGN:
+        overflow = __builtin_add_overflow(current, operand, &result);
+        break;
+    case TOKEN_MINUS_ASSIGN:
+        overflow = __builtin_sub_overflow(current, operand, &result);
+        break;
+    case TOKEN_MULTIPLY_ASSIGN:
+        overflow = __builtin_mul_overflow(current, operand, &result);
+        break;
+    case TOKEN_DIVIDE_ASSIGN:
+        if (operand == 0) {
+            runtimeError(interpreter, "除数不能为零。");
+            return false;
+        }
+        // 不能整除时结果为浮点数，与 / 运算符一致
+        if ((current == INT64_MIN && operand == -1) || current % operand != 0) {
+            *slot = createNumber((double)current / (double)operand);
+            return true;
+        }
+        result = current / operand;
+        break;
+    case TOKEN_MODULO_ASSIGN:
+        if (operand == 0) {
+            runtimeError(interpreter, "取模运算的除数不能为零。");
+            return false;
+        }
+        result = operand == -1 ? 0 : current % operand;
+        break;
+    default:
+        runtimeError(interpreter, "未知的复合赋值运算符");
+        return false;
+    }
+
+    if (overflow) {
+        double a = (double)current;
+        double b = (double)operand;
+        *slot = createNumber(op == TOKEN_PLUS_ASSIGN ? a + b : op == TOKEN_MINUS_ASSIGN ? a - b : a * b);
+        return true;
+    }
+
+    slot->as.integer = result;
+    return true;
+}
+
+// 将运算结果直接写回目标槽位，数字运算不产生任何临时值
+static bool applyInPlace(Interpreter *interpreter, Value *slot, TokenType op, Value operand) {
+    if (op == TOKEN_PLUS_ASSIGN) {
+        if (slot->type == VAL_STRING) {
+            return appendInPlace(interpreter, slot, operand);
+        }
+        if (isNumeric(*slot) && operand.type == VAL_STRING) {
+            return prependNumber(interpreter, slot, operand);
+        }
+    }
+
+    if (!isNumeric(*slot) || !isNumeric(operand)) {
+        runtimeError(interpreter, "%s 运算符的操作数必须是数字。", operatorName(op));
+        return false;
+    }
+
+    if (slot->type == VAL_INT && operand.type == VAL_INT) {
+        return applyIntegerInPlace(interpreter, slot, op, operand.as.integer);
+    }
+
+    // 与浮点数混合运算时提升为浮点数
+    double current = asDouble(*slot);
+    double value = asDouble(operand);
+
+    switch (op) {
+    case TOKEN_PLUS_ASSIGN:
+        *slot = createNumber(current + value);
+        return true;
+    case TOKEN_MINUS_ASSIGN:
+        *slot = createNumber(current - value);
+        return true;
+    case TOKEN_MULTIPLY_ASSIGN:
+        *slot = createNumber(current * value);
+        return true;
+    case TOKEN_DIVIDE_ASSIGN:
+        if (value == 0) {
+            runtimeError(interpreter, "除数不能为零。");
+            return false;
+        }
+        *slot = createNumber(current / value);
+        return true;
+    case TOKEN_MODULO_ASSIGN:
+        if (value == 0) {
+            runtimeError(interpreter, "取模运算的除数不能为零。");
+            return false;
+        }
+        *slot = createNumber(fmod(current, value));
+        return true;
+    default:
+        runtimeError(interpreter, "未知的复合赋值运算符");
+        return false;
+    }
+}
+
+// 执行复合赋值，成功时返回被更新的槽位
+static Value *performCompoundAssign(Interpreter *interpreter, Expr *expr) {
+    // 先求值右侧，避免其副作用（如函数调用中扩容数组）使已解析的槽位失效
+    Value operand = evaluate(interpreter, expr->as.compoundAssign.value);
+    if (interpreter->hadError) {
+        freeValue(operand);
+        return NULL;
+    }
+
+    return completeCompoundAssign(interpreter, expr, operand);
+}
+
+// 右侧已求值（由本函数释放），解析目标并就地更新，成功时返回被更新的槽位
+Value *completeCompoundAssign(Interpreter *interpreter, Expr *expr, Value operand) {
+    Value *slot = resolveTarget(interpreter, expr->as.compoundAssign.target);
+    if (slot == NULL) {
+        freeValue(operand);
+        return NULL;
+    }
+
+    bool ok = applyInPlace(interpreter, slot, expr->as.compoundAssign.op, operand);
+    freeValue(operand);
+    return ok ? slot : NULL;
+}
+
+Value evaluateCompoundAssign(Interpreter *interpreter, Expr *expr) {
+    Value *slot = performCompoundAssign(interpreter, expr);
+    if (slot == NULL) {
+        return createNull();
+    }
+    return copyValue(*slot);
+}
+
+// 作为语句执行时不需要表达式的值，省去对结果（可能是很长的字符串）的复制
+void executeCompoundAssign(Interpreter *interpreter, Expr *expr) {
+    performCompoundAssign(interpreter, expr);
+}
@@ -43,6 +43,10 @@ Value evaluate(Interpreter *interpreter, Expr *expr) {
         return evaluateStructLiteral(interpreter, expr);
     case EXPR_STRUCT_ASSIGN:
         return evaluateStructAssign(interpreter, expr);
+    case EXPR_COMPOUND_ASSIGN:
+        return evaluateCompoundAssign(interpreter, expr);
+    case EXPR_MAP_LITERAL:
+        return evaluateMapLiteral(interpreter, expr);
     }
 
     return createNull();
@@ -52,14 +56,11 @@ Value evaluateLiteral(Expr *expr) {
     Token token = expr->as.literal.value;
 
     switch (token.type) {
-    case TOKEN_INTEGER: {
-        double value = atof(token.lexeme);
-        return createNumber(value);
-    }
-    case TOKEN_FLOAT: {
-        double value = atof(token.lexeme);
-        return createNumber(value);
-    }
+    case TOKEN_INTEGER:
+        // 数值已由词法分析器解析（超出 int64 范围的整数字面量为 TOKEN_FLOAT）
+        return createInt(token.value.intValue);
+    case TOKEN_FLOAT:
+        return createNumber(token.value.floatValue);
     case TOKEN_STRING: {
         int len = strlen(token.lexeme);
         if (len >= 2 && token.lexeme[0] == '"' && token.lexeme[len - 1] == '"') {
@@ -128,6 +129,11 @@ Value evaluateAssign(Interpreter *interpreter, Expr *expr) {
     if (interpreter->hadError)
         return createNull();
 
+    return completeAssign(interpreter, expr, value);
+}
+
+// 将已求值的右侧赋给变量，并作为赋值表达式的值返回
+Value completeAssign(Interpreter *interpreter, Expr *expr, Value value) {
     // 首先尝试在静态存储中赋值
     bool foundInStatic = false;
     for (int i = 0; i < interpreter->staticStorage->count; i++) {
@@ -147,15 +153,19 @@ Value evaluateAssign(Interpreter *interpreter, Expr *expr) {
 }
 
 Value evaluateDotAccess(Interpreter *interpreter, Expr *expr) {
-    Expr *object = expr->as.dotAccess.object;
-    Token member = expr->as.dotAccess.member;
-    
     // 首先求值对象表达式
-    Value objectValue = evaluate(interpreter, object);
+    Value objectValue = evaluate(interpreter, expr->as.dotAccess.object);
     if (interpreter->hadError) {
         return createNull();
     }
-    
+    return completeDotAccess(interpreter, expr, objectValue);
+}
+
+// 以已求值的对象完成成员访问，对象由本函数释放
+Value completeDotAccess(Interpreter *interpreter, Expr *expr, Value objectValue) {
+    Expr *object = expr->as.dotAccess.object;
+    Token member = expr->as.dotAccess.member;
+
     // 检查对象类型
     if (objectValue.type == VAL_STRUCT) {
         // 结构体成员访问
@@ -211,70 +221,55 @@ Value evaluateDotAccess(Interpreter *interpreter, Expr *expr) {
 }
 
 Value evaluateStructLiteral(Interpreter *interpreter, Expr *expr) {
-    const char *structName = expr->as.structLiteral.structName.lexeme;
     int fieldCount = expr->as.structLiteral.fieldCount;
-    StructFieldInit *fieldInits = expr->as.structLiteral.fields;
-    
-    // 分配结构体字段值数组
-    StructFieldValue *fields = malloc(sizeof(StructFieldValue) * fieldCount);
-    if (fields == NULL) {
+    Value *values = malloc(sizeof(Value) * (fieldCount > 0 ? fieldCount : 1));
+    if (values == NULL) {
         runtimeError(interpreter, "Memory allocation failed");
         return createNull();
     }
-    
-    // 求值每个字段
+
+    // 按书写顺序求值每个字段
     for (int i = 0; i < fieldCount; i++) {
-        // 复制字段名
-        size_t nameLen = strlen(fieldInits[i].name.lexeme);
-        fields[i].name = malloc(nameLen + 1);
-        if (fields[i].name == NULL) {
-            // 清理已分配的内存
-            for (int j = 0; j < i; j++) {
-                free(fields[j].name);
-                freeValue(*fields[j].value);
-                free(fields[j].value);
-            }
-            free(fields);
-            runtimeError(interpreter, "Memory allocation failed");
-            return createNull();
-        }
-        strcpy(fields[i].name, fieldInits[i].name.lexeme);
-        
-        // 求值字段值
-        Value fieldValue = evaluate(interpreter, fieldInits[i].value);
+        values[i] = evaluate(interpreter, expr->as.structLiteral.fields[i].value);
         if (interpreter->hadError) {
-            // 清理已分配的内存
             for (int j = 0; j <= i; j++) {
-                free(fields[j].name);
-                if (j < i) {
-                    freeValue(*fields[j].value);
-                    free(fields[j].value);
-                }
+                freeValue(values[j]);
             }
-            free(fields);
+            free(values);
             return createNull();
         }
-        
-        // 分配并复制值
-        fields[i].value = malloc(sizeof(Value));
-        if (fields[i].value == NULL) {
-            // 清理已分配的内存
-            freeValue(fieldValue);
-            for (int j = 0; j <= i; j++) {
-                free(fields[j].name);
-                if (j < i) {
-                    freeValue(*fields[j].value);
-                    free(fields[j].value);
-                }
-            }
-            free(fields);
-            runtimeError(interpreter, "Memory allocation failed");
-            return createNull();
+    }
+
+    Value result = completeStructLiteral(interpreter, expr, values);
+    free(values);
+    return result;
+}
+
+// 以按书写顺序求值的字段值创建结构体，字段值由本函数释放
+Value completeStructLiteral(Interpreter *interpreter, Expr *expr, Value *values) {
+    int fieldCount = expr->as.structLiteral.fieldCount;
+    StructFieldInit *fieldInits = expr->as.structLiteral.fields;
+
+    StructFieldValue *fields = malloc(sizeof(StructFieldValue) * (fieldCount > 0 ? fieldCount : 1));
+    if (fields == NULL) {
+        for (int i = 0; i < fieldCount; i++) {
+            freeValue(values[i]);
         }
-        *fields[i].value = fieldValue;
+        runtimeError(interpreter, "Memory allocation failed");
+        return createNull();
     }
-    
-    return createStruct(structName, fields, fieldCount);
+    for (int i = 0; i < fieldCount; i++) {
+        fields[i].name = (char *)fieldInits[i].name.lexeme;
+        fields[i].value = &values[i];
+    }
+
+    // createStruct 复制字段名和字段值，临时字段数组随后释放
+    Value result = createStruct(expr->as.structLiteral.structName.lexeme, fields, fieldCount);
+    for (int i = 0; i < fieldCount; i++) {
+        freeValue(values[i]);
+    }
+    free(fields);
+    return result;
 }
 
 Value evaluateStructAssign(Interpreter *interpreter, Expr *expr) {
@@ -290,7 +285,11 @@ Value evaluateStructAssign(Interpreter *interpreter, Expr *expr) {
         freeValue(value);
         return createNull();
     }
-    
+    return completeStructAssign(interpreter, expr, value, objectValue);
+}
+
+// 以已求值的右侧的值和结构体对象完成字段赋值，返回右侧的值；对象由本函数释放
+Value completeStructAssign(Interpreter *interpreter, Expr *expr, Value value, Value objectValue) {
     // 检查对象是否为结构体
     if (objectValue.type != VAL_STRUCT) {
         freeValue(value);
@@ -0,0 +1,1489 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/interpreter.h"
+
+// 任务类型：每种任务是一段待执行的计算，操作数和中间结果保存在值栈上
+typedef enum
+{
+    TASK_EVAL,           // 求值 expr，结果压入值栈
+    TASK_BINARY,         // 左操作数已在值栈上，继续处理右操作数
+    TASK_BINARY_APPLY,   // 左右操作数都已在值栈上
+    TASK_UNARY,          // 操作数已在值栈上
+    TASK_ASSIGN,         // 右侧的值已在值栈上
+    TASK_COMPOUND_ASSIGN, // 右侧的值已在值栈上
+    TASK_CALL,           // 参数已依次压入值栈；flag 表示尾调用，index 为 1 表示被调用者的值在参数之下
+    TASK_ARRAY_LITERAL,  // 元素已依次压入值栈
+    TASK_MAP_LITERAL,    // 逐个求值键值对并插入 iterable 中的映射，index 为已求值的键值对数
+    TASK_STRUCT_LITERAL, // 字段值已依次压入值栈
+    TASK_INDEX,          // 容器（不是变量时）和索引已在值栈上
+    TASK_INDEX_ASSIGN,   // 容器（不是变量时）、索引和右侧的值已在值栈上
+    TASK_DOT,            // 对象已在值栈上
+    TASK_FIELD_ASSIGN,   // 右侧的值和结构体对象已在值栈上
+    TASK_CAST,           // 操作数已在值栈上
+    TASK_DISCARD,        // 丢弃表达式语句的值
+    TASK_DEFINE,         // 以栈顶的值定义变量或常量
+    TASK_RETURN,         // 以栈顶的值从函数返回
+    TASK_IF,             // 栈顶是条件
+    TASK_BLOCK,          // 在新环境中逐条执行代码块中的语句
+    TASK_WHILE,
+    TASK_DO_WHILE,
+    TASK_FOR,
+    TASK_FOR_IN,
+    TASK_SWITCH,
+    TASK_YIELD,          // 产出栈顶的值；yield* 的值不是生成器时转为 TASK_YIELD_EACH
+    TASK_YIELD_EACH,     // yield* 逐个产出 iterable 中的元素
+    TASK_FUNCTION        // 脚本函数的调用帧，逐条执行函数体，结束时在值栈上留下返回值
+} TaskKind;
+
+struct Task
+{
+    TaskKind kind;
+    Expr *expr;
+    Stmt *stmt;
+    Environment *scope;    // 任务创建的环境，出栈时释放
+    Environment *previous; // 进入任务前的环境，出栈时恢复；为 NULL 表示任务不切换环境
+    int index;             // 代码块的下一条语句、switch 的下一个 case，或循环所处的阶段
+    int valueBase;         // 函数帧开始时值栈的高度
+    int64_t cursor;        // for-in 和 yield* 的遍历位置
+    Value iterable;        // for-in 和 yield* 遍历的值，或 switch 的判别值
+    bool flag;             // for-in 遍历的是变量、switch 已匹配，或复合赋值作为语句执行
+};
+
+// 表达式列表中是否有含调用的表达式
+static bool anyHasCall(Expr **exprs, int count);
+
+/**
+ * 表达式是否含有需要在任务栈上展开的函数调用
+ *
+ * 只检查求值器会拆开的表达式；自增自减和复合赋值的目标整体交给 evaluate，其中的调用按普通方式执行。
+ * 结果缓存在节点上，每个节点只计算一次。
+ */
+static bool exprHasCall(Expr *expr)
+{
+    if (expr == NULL)
+    {
+        return false;
+    }
+    if (expr->callState == CALL_UNKNOWN)
+    {
+        bool found;
+        switch (expr->type)
+        {
+        case EXPR_CALL:
+            found = true;
+            break;
+        case EXPR_GROUPING:
+            found = exprHasCall(expr->as.grouping.expression);
+            break;
+        case EXPR_BINARY:
+            found = exprHasCall(expr->as.binary.left) || exprHasCall(expr->as.binary.right);
+            break;
+        case EXPR_UNARY:
+            found = exprHasCall(expr->as.unary.right);
+            break;
+        case EXPR_ASSIGN:
+            found = exprHasCall(expr->as.assign.value);
+            break;
+        case EXPR_COMPOUND_ASSIGN:
+            found = exprHasCall(expr->as.compoundAssign.value);
+            break;
+        case EXPR_ARRAY_LITERAL:
+            found = anyHasCall(expr->as.arrayLiteral.elements, expr->as.arrayLiteral.elementCount);
+            break;
+        case EXPR_MAP_LITERAL:
+            found = anyHasCall(expr->as.mapLiteral.keys, expr->as.mapLiteral.count) ||
+                    anyHasCall(expr->as.mapLiteral.values, expr->as.mapLiteral.count);
+            break;
+        case EXPR_STRUCT_LITERAL:
+            found = false;
+            for (int i = 0; i < expr->as.structLiteral.fieldCount && !found; i++)
+            {
+                found = exprHasCall(expr->as.structLiteral.fields[i].value);
+            }
+            break;
+        case EXPR_ARRAY_ACCESS:
+            found = exprHasCall(expr->as.arrayAccess.array) || exprHasCall(expr->as.arrayAccess.index);
+            break;
+        case EXPR_ARRAY_ASSIGN:
+            found = exprHasCall(expr->as.arrayAssign.array) || exprHasCall(expr->as.arrayAssign.index) ||
+                    exprHasCall(expr->as.arrayAssign.value);
+            break;
+        case EXPR_DOT_ACCESS:
+            found = exprHasCall(expr->as.dotAccess.object);
+            break;
+        case EXPR_STRUCT_ASSIGN:
+            found = exprHasCall(expr->as.structAssign.value) || exprHasCall(expr->as.structAssign.object);
+            break;
+        case EXPR_CAST:
+            found = exprHasCall(expr->as.cast.expression);
+            break;
+        default:
+            found = false;
+            break;
+        }
+        expr->callState = found ? CALL_PRESENT : CALL_ABSENT;
+    }
+    return expr->callState == CALL_PRESENT;
+}
+
+static bool anyHasCall(Expr **exprs, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (exprHasCall(exprs[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 语句是否含有函数调用；不含调用的语句直接交给 execute
+static bool stmtHasCall(Stmt *stmt)
+{
+    if (stmt == NULL)
+    {
+        return false;
+    }
+    if (stmt->callState == CALL_UNKNOWN)
+    {
+        bool found = false;
+        switch (stmt->type)
+        {
+        case STMT_EXPRESSION:
+            found = exprHasCall(stmt->as.expression.expression);
+            break;
+        case STMT_VAR:
+            found = exprHasCall(stmt->as.var.initializer);
+            break;
+        case STMT_CONST:
+            found = exprHasCall(stmt->as.constStmt.initializer);
+            break;
+        case STMT_RETURN:
+            found = exprHasCall(stmt->as.returnStmt.value);
+            break;
+        case STMT_IF:
+            found = exprHasCall(stmt->as.ifStmt.condition) || stmtHasCall(stmt->as.ifStmt.thenBranch) ||
+                    stmtHasCall(stmt->as.ifStmt.elseBranch);
+            break;
+        case STMT_BLOCK:
+            for (int i = 0; i < stmt->as.block.count && !found; i++)
+            {
+                found = stmtHasCall(stmt->as.block.statements[i]);
+            }
+            break;
+        case STMT_WHILE:
+            found = exprHasCall(stmt->as.whileLoop.condition) || stmtHasCall(stmt->as.whileLoop.body);
+            break;
+        case STMT_DO_WHILE:
+            found = stmtHasCall(stmt->as.doWhile.body) || exprHasCall(stmt->as.doWhile.condition);
+            break;
+        case STMT_FOR:
+            found = stmtHasCall(stmt->as.forLoop.initializer) || exprHasCall(stmt->as.forLoop.condition) ||
+                    exprHasCall(stmt->as.forLoop.increment) || stmtHasCall(stmt->as.forLoop.body);
+            break;
+        case STMT_FOR_IN:
+            found = exprHasCall(stmt->as.forIn.iterable) || stmtHasCall(stmt->as.forIn.body);
+            break;
+        case STMT_SWITCH:
+            found = exprHasCall(stmt->as.switchStmt.discriminant);
+            for (int i = 0; i < stmt->as.switchStmt.caseCount && !found; i++)
+            {
+                found = stmtHasCall(stmt->as.switchStmt.cases[i].body);
+            }
+            break;
+        default:
+            break;
+        }
+        stmt->callState = found ? CALL_PRESENT : CALL_ABSENT;
+    }
+    return stmt->callState == CALL_PRESENT;
+}
+
+void initMachine(Machine *machine, bool expandCalls)
+{
+    machine->tasks = NULL;
+    machine->taskCount = 0;
+    machine->taskCapacity = 0;
+    machine->values = NULL;
+    machine->valueCount = 0;
+    machine->valueCapacity = 0;
+    machine->expandCalls = expandCalls;
+}
+
+static Task *pushTask(Interpreter *interpreter, Machine *machine, TaskKind kind)
+{
+    if (machine->taskCount == machine->taskCapacity)
+    {
+        int capacity = machine->taskCapacity < 16 ? 16 : machine->taskCapacity * 2;
+        Task *tasks = (Task *)realloc(machine->tasks, sizeof(Task) * capacity);
+        if (tasks == NULL)
+        {
+            runtimeError(interpreter, "内存分配失败");
+            return NULL;
+        }
+        machine->tasks = tasks;
+        machine->taskCapacity = capacity;
+    }
+
+    Task *task = &machine->tasks[machine->taskCount++];
+    task->kind = kind;
+    task->expr = NULL;
+    task->stmt = NULL;
+    task->scope = NULL;
+    task->previous = NULL;
+    task->index = 0;
+    task->valueBase = machine->valueCount;
+    task->cursor = 0;
+    task->iterable = createNull();
+    task->flag = false;
+    return task;
+}
+
+static bool pushExprTask(Interpreter *interpreter, Machine *machine, TaskKind kind, Expr *expr)
+{
+    Task *task = pushTask(interpreter, machine, kind);
+    if (task == NULL)
+    {
+        return false;
+    }
+    task->expr = expr;
+    return true;
+}
+
+// 任务后进先出：表达式倒序压入，按从左到右的顺序求值
+static bool pushOperands(Interpreter *interpreter, Machine *machine, Expr **exprs, int count)
+{
+    for (int i = count - 1; i >= 0; i--)
+    {
+        if (!pushExprTask(interpreter, machine, TASK_EVAL, exprs[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool pushStmtTask(Interpreter *interpreter, Machine *machine, TaskKind kind, Stmt *stmt)
+{
+    Task *task = pushTask(interpreter, machine, kind);
+    if (task == NULL)
+    {
+        return false;
+    }
+    task->stmt = stmt;
+    return true;
+}
+
+// 弹出栈顶的任务，恢复它切换前的环境并释放它持有的资源
+static void popTask(Interpreter *interpreter, Machine *machine)
+{
+    Task *task = &machine->tasks[--machine->taskCount];
+    if (task->kind == TASK_FUNCTION)
+    {
+        leaveCall(interpreter);
+    }
+    if (task->previous != NULL)
+    {
+        interpreter->environment = task->previous;
+    }
+    if (task->scope != NULL)
+    {
+        freeHeapScope(task->scope);
+    }
+    freeValue(task->iterable);
+}
+
+static void pushValue(Interpreter *interpreter, Machine *machine, Value value)
+{
+    if (machine->valueCount == machine->valueCapacity)
+    {
+        int capacity = machine->valueCapacity < 16 ? 16 : machine->valueCapacity * 2;
+        Value *values = (Value *)realloc(machine->values, sizeof(Value) * capacity);
+        if (values == NULL)
+        {
+            freeValue(value);
+            runtimeError(interpreter, "内存分配失败");
+            return;
+        }
+        machine->values = values;
+        machine->valueCapacity = capacity;
+    }
+    machine->values[machine->valueCount++] = value;
+}
+
+static Value popValue(Machine *machine)
+{
+    return machine->values[--machine->valueCount];
+}
+
+// 释放值栈中 base 以上的值
+static void dropValues(Machine *machine, int base)
+{
+    while (machine->valueCount > base)
+    {
+        freeValue(machine->values[--machine->valueCount]);
+    }
+}
+
+void freeMachine(Machine *machine)
+{
+    while (machine->taskCount > 0)
+    {
+        Task *task = &machine->tasks[--machine->taskCount];
+        if (task->scope != NULL)
+        {
+            freeHeapScope(task->scope);
+        }
+        freeValue(task->iterable);
+    }
+    dropValues(machine, 0);
+    free(machine->tasks);
+    free(machine->values);
+    machine->tasks = NULL;
+    machine->values = NULL;
+    machine->taskCapacity = 0;
+    machine->valueCapacity = 0;
+}
+
+// 结束栈顶的函数帧，以 value 作为调用表达式的值
+static void finishFunction(Interpreter *interpreter, Machine *machine, Value value)
+{
+    dropValues(machine, machine->tasks[machine->taskCount - 1].valueBase);
+    popTask(interpreter, machine);
+    pushValue(interpreter, machine, value);
+}
+
+// return 结束最近的函数帧；不在本次运行的函数中时与 execute 一致，留给外层处理
+static void unwindReturn(Interpreter *interpreter, Machine *machine, Value value)
+{
+    while (machine->taskCount > 0 && machine->tasks[machine->taskCount - 1].kind != TASK_FUNCTION)
+    {
+        popTask(interpreter, machine);
+    }
+    if (machine->taskCount == 0)
+    {
+        interpreter->returnStatus.hasReturn = true;
+        interpreter->returnStatus.value = value;
+        return;
+    }
+    finishFunction(interpreter, machine, value);
+}
+
+// break 结束最近的循环或 switch，弹出它及其内部的任务；不跨越函数帧
+static void unwindBreak(Interpreter *interpreter, Machine *machine)
+{
+    while (machine->taskCount > 0)
+    {
+        TaskKind kind = machine->tasks[machine->taskCount - 1].kind;
+        if (kind == TASK_FUNCTION)
+        {
+            return;
+        }
+        popTask(interpreter, machine);
+        if (kind == TASK_WHILE || kind == TASK_DO_WHILE || kind == TASK_FOR ||
+            kind == TASK_FOR_IN || kind == TASK_SWITCH)
+        {
+            return;
+        }
+    }
+    interpreter->breakStatus.hasBreak = true;
+}
+
+// 处理 execute 直接执行完一条语句后留下的 return 和 break
+static void afterExecute(Interpreter *interpreter, Machine *machine)
+{
+    if (interpreter->hadError)
+    {
+        return;
+    }
+    if (interpreter->returnStatus.hasReturn)
+    {
+        Value value = takeReturnValue(interpreter);
+        if (interpreter->hadError)
+        {
+            freeValue(value);
+            return;
+        }
+        unwindReturn(interpreter, machine, value);
+    }
+    else if (interpreter->breakStatus.hasBreak)
+    {
+        interpreter->breakStatus.hasBreak = false;
+        unwindBreak(interpreter, machine);
+    }
+}
+
+/**
+ * 进入脚本函数：检查参数数量和调用深度，在新环境中绑定参数副本，压入调用帧
+ *
+ * 成功压入调用帧时返回 true；生成器函数不执行函数体，生成器写入 result 并返回 false；
+ * 出错时已通过 runtimeError 报告并返回 false。
+ */
+static bool enterFunction(Interpreter *interpreter, Machine *machine, Function *function,
+                          const Value *arguments, int argCount, Value *result)
+{
+    *result = createNull();
+    if (function->arity != argCount)
+    {
+        runtimeError(interpreter, "期望 %d 个参数，但得到 %d 个。", function->arity, argCount);
+        return false;
+    }
+    if (!prepareFunctionBody(interpreter, function))
+    {
+        return false;
+    }
+    if (function->isGenerator)
+    {
+        *result = createGenerator(interpreter, function, arguments, argCount);
+        return false;
+    }
+    if (!enterCall(interpreter))
+    {
+        return false;
+    }
+
+    Environment *scope = createHeapScope(function->closure);
+    if (scope == NULL)
+    {
+        leaveCall(interpreter);
+        runtimeError(interpreter, "内存分配失败");
+        return false;
+    }
+    for (int i = 0; i < argCount; i++)
+    {
+        defineVariable(scope, function->paramNames[i], arguments[i]);
+    }
+
+    Task *frame = pushTask(interpreter, machine, TASK_FUNCTION);
+    if (frame == NULL)
+    {
+        freeHeapScope(scope);
+        leaveCall(interpreter);
+        return false;
+    }
+    frame->stmt = function->body;
+    frame->scope = scope;
+    frame->previous = interpreter->environment;
+    interpreter->environment = scope;
+    return true;
+}
+
+// tail 为 true 表示调用是 return 的值（尾调用）
+static void beginCall(Interpreter *interpreter, Machine *machine, Expr *expr, bool tail)
+{
+    // 被调用者是变量时在参数求值后借用：脚本函数总是展开，原生函数只在参数含有调用时展开，
+    // 否则交给 evaluateCall，以保留对变量参数的借用。被调用者不是变量时先求值被调用者，总是展开
+    Expr *callee = expr->as.call.callee;
+    int argCount = expr->as.call.argCount;
+    bool onStack = callee->type != EXPR_VARIABLE;
+    const Value *slot = onStack ? NULL : borrowVariable(interpreter, callee);
+    bool expand = onStack;
+    bool mutates = false;
+    if (slot != NULL && slot->type == VAL_FUNCTION && slot->as.function != NULL)
+    {
+        expand = true;
+    }
+    else if (slot != NULL && slot->type == VAL_NATIVE_FUNCTION && slot->as.nativeFunction != NULL)
+    {
+        // 就地修改的原生函数的第一个参数在调用时借用变量，不是变量时交给 evaluateCall 报告错误
+        mutates = (slot->as.nativeFunction->flags & NATIVE_MUTATES_FIRST_ARG) != 0 && argCount > 0;
+        expand = anyHasCall(expr->as.call.arguments, argCount) &&
+                 (!mutates || expr->as.call.arguments[0]->type == EXPR_VARIABLE);
+    }
+
+    if (!expand)
+    {
+        pushValue(interpreter, machine, evaluate(interpreter, expr));
+        return;
+    }
+
+    Task *task = pushTask(interpreter, machine, TASK_CALL);
+    if (task == NULL)
+    {
+        return;
+    }
+    task->expr = expr;
+    task->flag = tail;
+    task->index = onStack ? 1 : 0;
+    if (mutates)
+    {
+        // 第一个参数的占位，调用时替换为借用的变量
+        pushValue(interpreter, machine, createNull());
+        pushOperands(interpreter, machine, expr->as.call.arguments + 1, argCount - 1);
+        return;
+    }
+    if (pushOperands(interpreter, machine, expr->as.call.arguments, argCount) && onStack)
+    {
+        pushExprTask(interpreter, machine, TASK_EVAL, callee);
+    }
+}
+
+/**
+ * 尾调用：复用最近的函数帧，在被调用者的闭包中重新绑定参数并从头执行其函数体
+ *
+ * 参数位于值栈的 argBase 处。不在函数中（没有函数帧）时返回 false，按普通调用处理。
+ */
+static bool reuseFrame(Interpreter *interpreter, Machine *machine, Function *function, int argBase, int argCount)
+{
+    int frame = machine->taskCount - 1;
+    while (frame >= 0 && machine->tasks[frame].kind != TASK_FUNCTION)
+    {
+        frame--;
+    }
+    if (frame < 0)
+    {
+        return false;
+    }
+    if (function->arity != argCount)
+    {
+        runtimeError(interpreter, "期望 %d 个参数，但得到 %d 个。", function->arity, argCount);
+        return true;
+    }
+    if (!prepareFunctionBody(interpreter, function))
+    {
+        return true;
+    }
+
+    // 先绑定参数再释放原有的环境：被调用者和参数可能来自其中的局部变量
+    Environment *scope = createHeapScope(function->closure);
+    if (scope == NULL)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return true;
+    }
+    for (int i = 0; i < argCount; i++)
+    {
+        defineVariable(scope, function->paramNames[i], machine->values[argBase + i]);
+    }
+    Stmt *body = function->body;
+
+    while (machine->taskCount - 1 > frame)
+    {
+        popTask(interpreter, machine);
+    }
+    Task *task = &machine->tasks[frame];
+    dropValues(machine, task->valueBase);
+    freeHeapScope(task->scope);
+    task->scope = scope;
+    task->stmt = body;
+    task->index = 0;
+    interpreter->environment = scope;
+    return true;
+}
+
+/**
+ * 参数求值完毕后调用
+ *
+ * 被调用者是变量时在此时重新借用，求值参数期间对该变量的修改会生效；onStack 为 true 时
+ * 被调用者的值在参数之下，与参数一起释放。
+ */
+static void finishCall(Interpreter *interpreter, Machine *machine, Expr *expr, bool tail, bool onStack)
+{
+    int argCount = expr->as.call.argCount;
+    int argBase = machine->valueCount - argCount;
+    int base = onStack ? argBase - 1 : argBase;
+    Value *arguments = &machine->values[argBase];
+    const Value *slot = onStack ? &machine->values[base] : borrowVariable(interpreter, expr->as.call.callee);
+
+    Value result = createNull();
+    if (slot != NULL && slot->type == VAL_FUNCTION && slot->as.function != NULL)
+    {
+        if (tail && !slot->as.function->isGenerator &&
+            reuseFrame(interpreter, machine, slot->as.function, argBase, argCount))
+        {
+            return;
+        }
+        int frame = machine->taskCount;
+        bool entered = enterFunction(interpreter, machine, slot->as.function, arguments, argCount, &result);
+        dropValues(machine, base);
+        if (entered)
+        {
+            machine->tasks[frame].valueBase = base;
+            return;
+        }
+    }
+    else if (slot != NULL && slot->type == VAL_NATIVE_FUNCTION && slot->as.nativeFunction != NULL)
+    {
+        Value callee = *slot;
+        NativeFunction *native = callee.as.nativeFunction;
+        if ((native->flags & NATIVE_MUTATES_FIRST_ARG) != 0 && argCount > 0)
+        {
+            // 第一个参数改为借用变量的存储位置，借用的值不随值栈释放
+            freeValue(arguments[0]);
+            arguments[0] = createNull();
+            if (bindMutableArgument(interpreter, native, expr->as.call.arguments[0], &arguments[0]))
+            {
+                result = callCallable(interpreter, callee, arguments, argCount);
+            }
+            arguments[0] = createNull();
+        }
+        else
+        {
+            result = callCallable(interpreter, callee, arguments, argCount);
+        }
+        dropValues(machine, base);
+    }
+    else
+    {
+        runtimeError(interpreter, "只能调用函数。");
+        dropValues(machine, base);
+    }
+    pushValue(interpreter, machine, result);
+}
+
+// 开始求值表达式：不含调用或不展开调用时直接求值，其余的拆成任务
+static void beginExpression(Interpreter *interpreter, Machine *machine, Expr *expr)
+{
+    if (!machine->expandCalls || !exprHasCall(expr))
+    {
+        pushValue(interpreter, machine, evaluate(interpreter, expr));
+        return;
+    }
+
+    switch (expr->type)
+    {
+    case EXPR_GROUPING:
+        pushExprTask(interpreter, machine, TASK_EVAL, expr->as.grouping.expression);
+        break;
+    case EXPR_BINARY:
+        if (pushExprTask(interpreter, machine, TASK_BINARY, expr))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.binary.left);
+        }
+        break;
+    case EXPR_UNARY:
+        if (pushExprTask(interpreter, machine, TASK_UNARY, expr))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.unary.right);
+        }
+        break;
+    case EXPR_ASSIGN:
+        if (pushExprTask(interpreter, machine, TASK_ASSIGN, expr))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.assign.value);
+        }
+        break;
+    case EXPR_COMPOUND_ASSIGN:
+        if (pushExprTask(interpreter, machine, TASK_COMPOUND_ASSIGN, expr))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.compoundAssign.value);
+        }
+        break;
+    case EXPR_CALL:
+        beginCall(interpreter, machine, expr, false);
+        break;
+    case EXPR_ARRAY_LITERAL:
+        if (pushExprTask(interpreter, machine, TASK_ARRAY_LITERAL, expr))
+        {
+            pushOperands(interpreter, machine, expr->as.arrayLiteral.elements, expr->as.arrayLiteral.elementCount);
+        }
+        break;
+    case EXPR_MAP_LITERAL:
+    {
+        Value map = createMap(expr->as.mapLiteral.count);
+        if (map.type == VAL_NULL)
+        {
+            runtimeError(interpreter, "创建映射失败");
+            break;
+        }
+        Task *task = pushTask(interpreter, machine, TASK_MAP_LITERAL);
+        if (task == NULL)
+        {
+            freeValue(map);
+            break;
+        }
+        task->expr = expr;
+        task->iterable = map;
+        break;
+    }
+    case EXPR_STRUCT_LITERAL:
+        if (pushExprTask(interpreter, machine, TASK_STRUCT_LITERAL, expr))
+        {
+            for (int i = expr->as.structLiteral.fieldCount - 1; i >= 0; i--)
+            {
+                if (!pushExprTask(interpreter, machine, TASK_EVAL, expr->as.structLiteral.fields[i].value))
+                {
+                    break;
+                }
+            }
+        }
+        break;
+    case EXPR_ARRAY_ACCESS:
+        // 被索引的是变量时与 evaluateArrayAccess 一致，只求值索引，完成时再借用变量
+        if (pushExprTask(interpreter, machine, TASK_INDEX, expr) &&
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.arrayAccess.index) &&
+            expr->as.arrayAccess.array->type != EXPR_VARIABLE)
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.arrayAccess.array);
+        }
+        break;
+    case EXPR_ARRAY_ASSIGN:
+        if (pushExprTask(interpreter, machine, TASK_INDEX_ASSIGN, expr) &&
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.arrayAssign.value) &&
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.arrayAssign.index) &&
+            expr->as.arrayAssign.array->type != EXPR_VARIABLE)
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.arrayAssign.array);
+        }
+        break;
+    case EXPR_DOT_ACCESS:
+        if (pushExprTask(interpreter, machine, TASK_DOT, expr))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.dotAccess.object);
+        }
+        break;
+    case EXPR_STRUCT_ASSIGN:
+        // 与 evaluateStructAssign 一致，先求值右侧的值再求值结构体对象
+        if (pushExprTask(interpreter, machine, TASK_FIELD_ASSIGN, expr) &&
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.structAssign.object))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.structAssign.value);
+        }
+        break;
+    case EXPR_CAST:
+        if (pushExprTask(interpreter, machine, TASK_CAST, expr))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.cast.expression);
+        }
+        break;
+    default:
+        pushValue(interpreter, machine, evaluate(interpreter, expr));
+        break;
+    }
+}
+
+// 元素已依次压入值栈，与 evaluateArrayLiteral 一致直接移入新建的数组
+static void finishArrayLiteral(Interpreter *interpreter, Machine *machine, Expr *expr)
+{
+    int count = expr->as.arrayLiteral.elementCount;
+    int base = machine->valueCount - count;
+    Value array = createArray(TYPE_ANY, count);
+    if (array.type == VAL_NULL)
+    {
+        dropValues(machine, base);
+        runtimeError(interpreter, "创建数组失败");
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        array.as.array->elements[array.as.array->count++] = machine->values[base + i];
+    }
+    machine->valueCount = base;
+    pushValue(interpreter, machine, array);
+}
+
+// 与 evaluateMapLiteral 一致：按书写顺序求值键和值，每对求值后立即插入，重复的键以后出现的为准
+static void continueMapLiteral(Interpreter *interpreter, Machine *machine)
+{
+    Task *task = &machine->tasks[machine->taskCount - 1];
+    Expr *expr = task->expr;
+    if (task->index > 0)
+    {
+        Value value = popValue(machine);
+        Value key = popValue(machine);
+        if (!checkMapKey(interpreter, key))
+        {
+            freeValue(key);
+            freeValue(value);
+            return;
+        }
+        if (!mapSet(task->iterable.as.map, key, value))
+        {
+            runtimeError(interpreter, "内存分配失败");
+            return;
+        }
+    }
+
+    if (task->index < expr->as.mapLiteral.count)
+    {
+        int i = task->index++;
+        if (pushExprTask(interpreter, machine, TASK_EVAL, expr->as.mapLiteral.values[i]))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr->as.mapLiteral.keys[i]);
+        }
+        return;
+    }
+
+    Value map = task->iterable;
+    task->iterable = createNull();
+    popTask(interpreter, machine);
+    pushValue(interpreter, machine, map);
+}
+
+// 左操作数已求值：右操作数不含调用时由 completeBinary 一次完成，否则继续展开
+static void continueBinary(Interpreter *interpreter, Machine *machine, Expr *expr)
+{
+    TokenType op = expr->as.binary.op;
+    if (!exprHasCall(expr->as.binary.right))
+    {
+        Value left = popValue(machine);
+        pushValue(interpreter, machine, completeBinary(interpreter, expr, left));
+        return;
+    }
+
+    if (op == TOKEN_AND || op == TOKEN_OR)
+    {
+        // 短路：左操作数即为结果时留在值栈上
+        bool truthy = isTruthy(machine->values[machine->valueCount - 1]);
+        if ((op == TOKEN_AND && !truthy) || (op == TOKEN_OR && truthy))
+        {
+            return;
+        }
+        freeValue(popValue(machine));
+        pushExprTask(interpreter, machine, TASK_EVAL, expr->as.binary.right);
+        return;
+    }
+
+    if (pushExprTask(interpreter, machine, TASK_BINARY_APPLY, expr))
+    {
+        pushExprTask(interpreter, machine, TASK_EVAL, expr->as.binary.right);
+    }
+}
+
+static void beginForIn(Interpreter *interpreter, Machine *machine, Stmt *stmt)
+{
+    Environment *scope = interpreter->environment;
+    Expr *iterableExpr = stmt->as.forIn.iterable;
+    bool borrowed = iterableExpr->type == EXPR_VARIABLE &&
+                    forInSource(interpreter, scope, iterableExpr) != NULL;
+
+    // 遍历的值不是变量时只求值一次；其中的调用不展开
+    Value iterable = createNull();
+    if (!borrowed)
+    {
+        iterable = evaluate(interpreter, iterableExpr);
+        if (interpreter->hadError)
+        {
+            freeValue(iterable);
+            return;
+        }
+    }
+
+    Environment *loopScope = createHeapScope(scope);
+    Task *task = loopScope != NULL ? pushTask(interpreter, machine, TASK_FOR_IN) : NULL;
+    if (task == NULL)
+    {
+        if (loopScope == NULL)
+        {
+            runtimeError(interpreter, "内存分配失败");
+        }
+        else
+        {
+            freeHeapScope(loopScope);
+        }
+        freeValue(iterable);
+        return;
+    }
+    defineVariable(loopScope, stmt->as.forIn.name.lexeme, createNull());
+    task->stmt = stmt;
+    task->scope = loopScope;
+    task->previous = scope;
+    task->iterable = iterable;
+    task->flag = borrowed;
+}
+
+/**
+ * 开始执行一条语句
+ *
+ * 既不含 yield、也不含要展开的调用的语句直接交给 execute；其余的语句压入对应的任务，
+ * 先求值的表达式压在上面。if 求值条件后转入所选分支；for 的初始化语句与 executeFor 一致
+ * 在当前环境中执行。
+ */
+void beginStatement(Interpreter *interpreter, Machine *machine, Stmt *stmt)
+{
+    if (stmt == NULL)
+    {
+        return;
+    }
+    if (!stmt->containsYield && !(machine->expandCalls && stmtHasCall(stmt)))
+    {
+        execute(interpreter, stmt);
+        afterExecute(interpreter, machine);
+        return;
+    }
+
+    switch (stmt->type)
+    {
+    case STMT_EXPRESSION:
+    {
+        Expr *expr = stmt->as.expression.expression;
+        if (expr->type == EXPR_COMPOUND_ASSIGN)
+        {
+            // 作为语句执行时不需要复合赋值的结果
+            Task *task = pushTask(interpreter, machine, TASK_COMPOUND_ASSIGN);
+            if (task != NULL)
+            {
+                task->expr = expr;
+                task->flag = true;
+                pushExprTask(interpreter, machine, TASK_EVAL, expr->as.compoundAssign.value);
+            }
+        }
+        else if (pushStmtTask(interpreter, machine, TASK_DISCARD, stmt))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, expr);
+        }
+        break;
+    }
+    case STMT_VAR:
+        if (pushStmtTask(interpreter, machine, TASK_DEFINE, stmt))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.var.initializer);
+        }
+        break;
+    case STMT_CONST:
+        if (pushStmtTask(interpreter, machine, TASK_DEFINE, stmt))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.constStmt.initializer);
+        }
+        break;
+    case STMT_RETURN:
+        if (pushStmtTask(interpreter, machine, TASK_RETURN, stmt))
+        {
+            Expr *value = stmt->as.returnStmt.value;
+            if (value->type == EXPR_CALL)
+            {
+                beginCall(interpreter, machine, value, true);
+            }
+            else
+            {
+                pushExprTask(interpreter, machine, TASK_EVAL, value);
+            }
+        }
+        break;
+    case STMT_IF:
+        if (pushStmtTask(interpreter, machine, TASK_IF, stmt))
+        {
+            pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.ifStmt.condition);
+        }
+        break;
+    case STMT_BLOCK:
+    {
+        Environment *scope = createHeapScope(interpreter->environment);
+        Task *task = scope != NULL ? pushTask(interpreter, machine, TASK_BLOCK) : NULL;
+        if (task == NULL)
+        {
+            if (scope == NULL)
+            {
+                runtimeError(interpreter, "内存分配失败");
+            }
+            else
+            {
+                freeHeapScope(scope);
+            }
+            break;
+        }
+        task->stmt = stmt;
+        task->scope = scope;
+        task->previous = interpreter->environment;
+        interpreter->environment = scope;
+        break;
+    }
+    case STMT_WHILE:
+        pushStmtTask(interpreter, machine, TASK_WHILE, stmt);
+        break;
+    case STMT_DO_WHILE:
+        pushStmtTask(interpreter, machine, TASK_DO_WHILE, stmt);
+        break;
+    case STMT_FOR:
+        if (pushStmtTask(interpreter, machine, TASK_FOR, stmt))
+        {
+            beginStatement(interpreter, machine, stmt->as.forLoop.initializer);
+        }
+        break;
+    case STMT_FOR_IN:
+        beginForIn(interpreter, machine, stmt);
+        break;
+    case STMT_SWITCH:
+    {
+        // index 为 -1 表示判别值尚未取出
+        Task *task = pushTask(interpreter, machine, TASK_SWITCH);
+        if (task != NULL)
+        {
+            task->stmt = stmt;
+            task->index = -1;
+            pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.switchStmt.discriminant);
+        }
+        break;
+    }
+    case STMT_YIELD:
+        if (pushStmtTask(interpreter, machine, TASK_YIELD, stmt))
+        {
+            if (stmt->as.yieldStmt.value != NULL)
+            {
+                pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.yieldStmt.value);
+            }
+            else
+            {
+                pushValue(interpreter, machine, createNull());
+            }
+        }
+        break;
+    default:
+        execute(interpreter, stmt);
+        afterExecute(interpreter, machine);
+        break;
+    }
+}
+
+// 从值栈取出条件并判断真假
+static bool popCondition(Machine *machine)
+{
+    Value condition = popValue(machine);
+    bool truthy = isTruthy(condition);
+    freeValue(condition);
+    return truthy;
+}
+
+// 以栈顶的值完成变量或常量声明，与 executeVar / executeConst 一致
+static void finishDefine(Interpreter *interpreter, Machine *machine, Stmt *stmt)
+{
+    Value value = popValue(machine);
+    if (stmt->type == STMT_CONST)
+    {
+        if (stmt->as.constStmt.isStatic)
+        {
+            defineStaticVariable(interpreter->staticStorage, stmt->as.constStmt.name.lexeme, value, true);
+        }
+        else
+        {
+            defineConstant(interpreter->environment, stmt->as.constStmt.name.lexeme, value);
+        }
+        return;
+    }
+
+    if (stmt->as.var.isStatic)
+    {
+        defineStaticVariable(interpreter->staticStorage, stmt->as.var.name.lexeme, value, false);
+    }
+    else if (isLocalConstant(interpreter->environment, stmt->as.var.name.lexeme))
+    {
+        runtimeError(interpreter, "不能重新定义常量 '%s'", stmt->as.var.name.lexeme);
+    }
+    else
+    {
+        defineVariable(interpreter->environment, stmt->as.var.name.lexeme, value);
+    }
+    freeValue(value);
+}
+
+// 推进栈顶的语句任务：开始其下一条子语句，或在其结束时出栈
+static void stepStatement(Interpreter *interpreter, Machine *machine)
+{
+    Task *task = &machine->tasks[machine->taskCount - 1];
+    Stmt *stmt = task->stmt;
+
+    switch (task->kind)
+    {
+    case TASK_BLOCK:
+        if (task->index >= stmt->as.block.count)
+        {
+            popTask(interpreter, machine);
+            return;
+        }
+        if (task->scope != NULL)
+        {
+            interpreter->environment = task->scope;
+        }
+        beginStatement(interpreter, machine, stmt->as.block.statements[task->index++]);
+        return;
+
+    case TASK_WHILE:
+        if (task->index == 0)
+        {
+            task->index = 1;
+            pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.whileLoop.condition);
+            return;
+        }
+        if (!popCondition(machine))
+        {
+            popTask(interpreter, machine);
+            return;
+        }
+        task->index = 0;
+        beginStatement(interpreter, machine, stmt->as.whileLoop.body);
+        return;
+
+    case TASK_DO_WHILE:
+        // 0：执行循环体；1：求值条件；2：判断条件
+        if (task->index == 1)
+        {
+            task->index = 2;
+            pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.doWhile.condition);
+            return;
+        }
+        if (task->index == 2 && !popCondition(machine))
+        {
+            popTask(interpreter, machine);
+            return;
+        }
+        task->index = 1;
+        beginStatement(interpreter, machine, stmt->as.doWhile.body);
+        return;
+
+    case TASK_FOR:
+        // 0：求值条件；1：判断条件；2：循环体已执行，求值增量表达式
+        if (task->index == 2)
+        {
+            task->index = 0;
+            if (stmt->as.forLoop.increment != NULL &&
+                pushStmtTask(interpreter, machine, TASK_DISCARD, stmt))
+            {
+                pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.forLoop.increment);
+            }
+            return;
+        }
+        if (task->index == 0 && stmt->as.forLoop.condition != NULL)
+        {
+            task->index = 1;
+            pushExprTask(interpreter, machine, TASK_EVAL, stmt->as.forLoop.condition);
+            return;
+        }
+        if (task->index == 1 && !popCondition(machine))
+        {
+            popTask(interpreter, machine);
+            return;
+        }
+        task->index = 2;
+        beginStatement(interpreter, machine, stmt->as.forLoop.body);
+        return;
+
+    case TASK_FOR_IN:
+    {
+        Value iterable = task->iterable;
+        if (task->flag)
+        {
+            const Value *slot = forInSource(interpreter, task->previous, stmt->as.forIn.iterable);
+            if (slot == NULL)
+            {
+                popTask(interpreter, machine);
+                return;
+            }
+            iterable = *slot;
+        }
+
+        Value element;
+        if (!forInNext(interpreter, iterable, &task->cursor, &element))
+        {
+            popTask(interpreter, machine);
+            return;
+        }
+
+        // 循环变量是该任务作用域中的第一个变量
+        freeValue(task->scope->values[0]);
+        task->scope->values[0] = element;
+        interpreter->environment = task->scope;
+        beginStatement(interpreter, machine, stmt->as.forIn.body);
+        return;
+    }
+
+    case TASK_SWITCH:
+        if (task->index < 0)
+        {
+            task->iterable = popValue(machine);
+            task->index = 0;
+            return;
+        }
+        // 与 executeSwitch 一致：按顺序匹配，default 在尚未匹配时命中，之后的 case 依次贯穿执行
+        while (task->index < stmt->as.switchStmt.caseCount)
+        {
+            CaseStmt *caseStmt = &stmt->as.switchStmt.cases[task->index++];
+            if (!task->flag)
+            {
+                if (caseStmt->value == NULL)
+                {
+                    task->flag = true;
+                }
+                else
+                {
+                    Value caseValue = evaluate(interpreter, caseStmt->value);
+                    if (interpreter->hadError)
+                    {
+                        freeValue(caseValue);
+                        return;
+                    }
+                    task->flag = valuesEqual(task->iterable, caseValue);
+                    freeValue(caseValue);
+                }
+            }
+            if (task->flag)
+            {
+                beginStatement(interpreter, machine, caseStmt->body);
+                return;
+            }
+        }
+        popTask(interpreter, machine);
+        return;
+
+    case TASK_FUNCTION:
+        // 函数体的代码块直接在参数所在的环境中逐条执行，省去一层环境
+        interpreter->environment = task->scope;
+        if (stmt != NULL && stmt->type == STMT_BLOCK && task->index < stmt->as.block.count)
+        {
+            beginStatement(interpreter, machine, stmt->as.block.statements[task->index++]);
+            return;
+        }
+        if (stmt != NULL && stmt->type != STMT_BLOCK && task->index == 0)
+        {
+            task->index = 1;
+            beginStatement(interpreter, machine, stmt);
+            return;
+        }
+        // 函数体执行完毕而没有 return
+        finishFunction(interpreter, machine, createNull());
+        return;
+
+    default:
+        popTask(interpreter, machine);
+        return;
+    }
+}
+
+// yield* 的值是生成器时交给调用方委托，否则逐个产出数组、字符串、区间等值中的元素
+static MachineResult beginYieldEach(Interpreter *interpreter, Machine *machine, Stmt *stmt)
+{
+    if (machine->values[machine->valueCount - 1].type == VAL_GENERATOR)
+    {
+        return MACHINE_DELEGATED;
+    }
+    Value iterable = popValue(machine);
+    Task *task = pushTask(interpreter, machine, TASK_YIELD_EACH);
+    if (task == NULL)
+    {
+        freeValue(iterable);
+        return MACHINE_RUNNING;
+    }
+    task->stmt = stmt;
+    task->iterable = iterable;
+    return MACHINE_RUNNING;
+}
+
+// 执行栈顶的任务；执行到 yield 时返回产出的方式，产出的值留在值栈顶
+static MachineResult step(Interpreter *interpreter, Machine *machine)
+{
+    Task *task = &machine->tasks[machine->taskCount - 1];
+    Expr *expr = task->expr;
+    Stmt *stmt = task->stmt;
+
+    switch (task->kind)
+    {
+    case TASK_EVAL:
+        machine->taskCount--;
+        beginExpression(interpreter, machine, expr);
+        break;
+
+    case TASK_BINARY:
+        machine->taskCount--;
+        continueBinary(interpreter, machine, expr);
+        break;
+
+    case TASK_BINARY_APPLY:
+    {
+        machine->taskCount--;
+        Value right = popValue(machine);
+        Value left = popValue(machine);
+        pushValue(interpreter, machine, applyBinary(interpreter, expr->as.binary.op, left, right));
+        break;
+    }
+
+    case TASK_UNARY:
+        machine->taskCount--;
+        pushValue(interpreter, machine, applyUnary(interpreter, expr->as.unary.op, popValue(machine)));
+        break;
+
+    case TASK_ASSIGN:
+        machine->taskCount--;
+        pushValue(interpreter, machine, completeAssign(interpreter, expr, popValue(machine)));
+        break;
+
+    case TASK_COMPOUND_ASSIGN:
+    {
+        bool discard = task->flag;
+        machine->taskCount--;
+        Value *slot = completeCompoundAssign(interpreter, expr, popValue(machine));
+        if (!discard)
+        {
+            pushValue(interpreter, machine, slot != NULL ? copyValue(*slot) : createNull());
+        }
+        break;
+    }
+
+    case TASK_CALL:
+    {
+        bool tail = task->flag;
+        bool onStack = task->index == 1;
+        machine->taskCount--;
+        finishCall(interpreter, machine, expr, tail, onStack);
+        break;
+    }
+
+    case TASK_ARRAY_LITERAL:
+        machine->taskCount--;
+        finishArrayLiteral(interpreter, machine, expr);
+        break;
+
+    case TASK_MAP_LITERAL:
+        continueMapLiteral(interpreter, machine);
+        break;
+
+    case TASK_STRUCT_LITERAL:
+    {
+        machine->taskCount--;
+        int base = machine->valueCount - expr->as.structLiteral.fieldCount;
+        Value result = completeStructLiteral(interpreter, expr, &machine->values[base]);
+        machine->valueCount = base;
+        pushValue(interpreter, machine, result);
+        break;
+    }
+
+    case TASK_INDEX:
+    {
+        machine->taskCount--;
+        Value index = popValue(machine);
+        Value container = expr->as.arrayAccess.array->type == EXPR_VARIABLE ? createNull() : popValue(machine);
+        pushValue(interpreter, machine, completeArrayAccess(interpreter, expr, container, index));
+        break;
+    }
+
+    case TASK_INDEX_ASSIGN:
+    {
+        machine->taskCount--;
+        Value value = popValue(machine);
+        Value index = popValue(machine);
+        Value container = expr->as.arrayAssign.array->type == EXPR_VARIABLE ? createNull() : popValue(machine);
+        pushValue(interpreter, machine, completeArrayAssign(interpreter, expr, container, index, value));
+        break;
+    }
+
+    case TASK_DOT:
+        machine->taskCount--;
+        pushValue(interpreter, machine, completeDotAccess(interpreter, expr, popValue(machine)));
+        break;
+
+    case TASK_FIELD_ASSIGN:
+    {
+        machine->taskCount--;
+        Value object = popValue(machine);
+        Value value = popValue(machine);
+        pushValue(interpreter, machine, completeStructAssign(interpreter, expr, value, object));
+        break;
+    }
+
+    case TASK_CAST:
+        machine->taskCount--;
+        pushValue(interpreter, machine, completeCast(interpreter, expr, popValue(machine)));
+        break;
+
+    case TASK_DISCARD:
+        machine->taskCount--;
+        freeValue(popValue(machine));
+        break;
+
+    case TASK_DEFINE:
+        machine->taskCount--;
+        finishDefine(interpreter, machine, stmt);
+        break;
+
+    case TASK_RETURN:
+        machine->taskCount--;
+        unwindReturn(interpreter, machine, popValue(machine));
+        break;
+
+    case TASK_IF:
+    {
+        machine->taskCount--;
+        bool truthy = popCondition(machine);
+        beginStatement(interpreter, machine, truthy ? stmt->as.ifStmt.thenBranch : stmt->as.ifStmt.elseBranch);
+        break;
+    }
+
+    case TASK_YIELD:
+        machine->taskCount--;
+        if (stmt->as.yieldStmt.delegate)
+        {
+            return beginYieldEach(interpreter, machine, stmt);
+        }
+        return MACHINE_YIELDED;
+
+    case TASK_YIELD_EACH:
+    {
+        Value element;
+        if (!forInNext(interpreter, task->iterable, &task->cursor, &element))
+        {
+            popTask(interpreter, machine);
+            break;
+        }
+        pushValue(interpreter, machine, element);
+        return MACHINE_YIELDED;
+    }
+
+    default:
+        stepStatement(interpreter, machine);
+        break;
+    }
+    return MACHINE_RUNNING;
+}
+
+// 执行任务直到任务栈为空、yield 或出错；出错时弹出全部任务，恢复环境并释放其资源
+MachineResult runMachine(Interpreter *interpreter, Machine *machine, Value *value)
+{
+    MachineResult result = MACHINE_RUNNING;
+    while (result == MACHINE_RUNNING && machine->taskCount > 0 && !interpreter->hadError &&
+           checkDeadline(interpreter))
+    {
+        result = step(interpreter, machine);
+    }
+    if (interpreter->hadError)
+    {
+        while (machine->taskCount > 0)
+        {
+            popTask(interpreter, machine);
+        }
+        dropValues(machine, 0);
+        return MACHINE_FAILED;
+    }
+    if (result == MACHINE_RUNNING)
+    {
+        return MACHINE_DONE;
+    }
+    *value = popValue(machine);
+    return result;
+}
+
+void executeExplicit(Interpreter *interpreter, Stmt *stmt)
+{
+    Machine machine;
+    initMachine(&machine, true);
+    Environment *previous = interpreter->environment;
+
+    // yield 只出现在生成器函数中，这里的任务栈不会产出值
+    Value value;
+    beginStatement(interpreter, &machine, stmt);
+    runMachine(interpreter, &machine, &value);
+
+    freeMachine(&machine);
+    interpreter->environment = previous;
+}
+
+Value callFunctionExplicit(Interpreter *interpreter, Function *function, const Value *arguments, int argCount)
+{
+    Machine machine;
+    initMachine(&machine, true);
+    Environment *previous = interpreter->environment;
+    interpreter->returnStatus.hasReturn = false;
+
+    Value result = createNull();
+    if (enterFunction(interpreter, &machine, function, arguments, argCount, &result))
+    {
+        Value value;
+        if (runMachine(interpreter, &machine, &value) == MACHINE_DONE && machine.valueCount > 0)
+        {
+            result = popValue(&machine);
+        }
+    }
+
+    freeMachine(&machine);
+    interpreter->environment = previous;
+    return result;
+}
@@ -2,14 +2,83 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../include/interpreter.h"
+#include "../include/parser/declaration_parser.h"
 
-Value callFunction(Interpreter *interpreter, Function *function, Value *arguments, int argCount)
+// 取出尾调用的被调用者和参数，清除 returnStatus
+static Value takeTailCall(Interpreter *interpreter, Value **arguments, int *argCount)
+{
+    Value callee = interpreter->returnStatus.value;
+    *arguments = interpreter->returnStatus.arguments;
+    *argCount = interpreter->returnStatus.argCount;
+    interpreter->returnStatus.hasReturn = false;
+    interpreter->returnStatus.value = createNull();
+    interpreter->returnStatus.isTailCall = false;
+    interpreter->returnStatus.arguments = NULL;
+    interpreter->returnStatus.argCount = 0;
+    return callee;
+}
+
+static void freeArguments(Value *arguments, int argCount)
+{
+    for (int i = 0; i < argCount; i++)
+    {
+        freeValue(arguments[i]);
+    }
+    free(arguments);
+}
+
+/**
+ * 函数体在预解析时被跳过的，在首次调用时解析（见 parseLazyBody）
+ *
+ * 函数值的副本共享同一个函数体节点，解析一次后所有副本都看到完整的函数体。解析失败时报告运行时错误。
+ */
+bool prepareFunctionBody(Interpreter *interpreter, Function *function)
+{
+    if (function->body == NULL || function->body->as.block.lazy == NULL)
+    {
+        return true;
+    }
+    char message[256];
+    if (!parseLazyBody(function->body, message, sizeof(message)))
+    {
+        runtimeError(interpreter, "%s", message);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 调用脚本函数
+ *
+ * 函数体以 return f(...) 结束时，executeReturn 只求值被调用者和参数（见 prepareTailCall），
+ * 这里在同一个调用帧中重新绑定参数并执行 f 的函数体，尾递归不加深 C 栈，也不累积环境。
+ */
+Value callFunction(Interpreter *interpreter, Function *function, const Value *arguments, int argCount)
 {
     if (function->arity != argCount)
     {
         runtimeError(interpreter, "期望 %d 个参数，但得到 %d 个。", function->arity, argCount);
         return createNull();
     }
+    if (!prepareFunctionBody(interpreter, function))
+    {
+        return createNull();
+    }
+
+    if (function->isGenerator)
+    {
+        return createGenerator(interpreter, function, arguments, argCount);
+    }
+
+    if (interpreter->explicitStack)
+    {
+        return callFunctionExplicit(interpreter, function, arguments, argCount);
+    }
+
+    if (!enterCall(interpreter))
+    {
+        return createNull();
+    }
 
     Environment env;
     initEnvironment(&env, function->closure);
@@ -22,22 +91,391 @@ Value callFunction(Interpreter *interpreter, Function *function, Value *argument
     Environment *previous = interpreter->environment;
     interpreter->environment = &env;
 
-    returnStatus.hasReturn = false;
-    returnStatus.value = createNull();
+    // 尾调用的被调用者副本，保证其函数体执行期间函数定义有效
+    Value tailCallee = createNull();
+    Value result = createNull();
 
-    execute(interpreter, function->body);
+    for (;;)
+    {
+        interpreter->returnStatus.hasReturn = false;
+        interpreter->returnStatus.value = createNull();
+
+        execute(interpreter, function->body);
+
+        if (!interpreter->returnStatus.hasReturn)
+        {
+            break;
+        }
+        if (!interpreter->returnStatus.isTailCall)
+        {
+            result = interpreter->returnStatus.value;
+            interpreter->returnStatus.hasReturn = false;
+            break;
+        }
+
+        Value *tailArguments;
+        int tailArgCount;
+        Value callee = takeTailCall(interpreter, &tailArguments, &tailArgCount);
+        Function *target = callee.as.function;
+        if (interpreter->hadError || !checkDeadline(interpreter) || target->arity != tailArgCount ||
+            !prepareFunctionBody(interpreter, target))
+        {
+            if (!interpreter->hadError)
+            {
+                runtimeError(interpreter, "期望 %d 个参数，但得到 %d 个。", target->arity, tailArgCount);
+            }
+            freeArguments(tailArguments, tailArgCount);
+            freeValue(callee);
+            break;
+        }
+
+        // 复用当前调用帧：丢弃原有的局部变量，在被调用者的闭包中重新绑定参数
+        freeEnvironment(&env);
+        initEnvironment(&env, target->closure);
+        for (int i = 0; i < tailArgCount; i++)
+        {
+            defineVariable(&env, target->paramNames[i], tailArguments[i]);
+        }
+        freeArguments(tailArguments, tailArgCount);
+        interpreter->environment = &env;
+
+        freeValue(tailCallee);
+        tailCallee = callee;
+        function = target;
+    }
 
     interpreter->environment = previous;
     freeEnvironment(&env);
+    freeValue(tailCallee);
+    leaveCall(interpreter);
+
+    return result;
+}
 
-    if (returnStatus.hasReturn)
+/**
+ * 准备 return 中的尾调用
+ *
+ * 被调用者是变量中的脚本函数（非生成器）时，求值被调用者和参数并记入 returnStatus，
+ * 返回 true；否则不求值任何内容并返回 false，由调用方按普通 return 处理。
+ */
+bool prepareTailCall(Interpreter *interpreter, Expr *expr)
+{
+    Expr *calleeExpr = expr->as.call.callee;
+    if (calleeExpr->type != EXPR_VARIABLE)
+    {
+        return false;
+    }
+    const Value *slot = borrowVariable(interpreter, calleeExpr);
+    if (slot == NULL || slot->type != VAL_FUNCTION || slot->as.function == NULL || slot->as.function->isGenerator)
     {
-        Value result = returnStatus.value;
-        returnStatus.hasReturn = false;
+        return false;
+    }
+
+    // 与 evaluateCall 一致，先取得被调用者，再从左到右求值参数
+    Value callee = copyValue(*slot);
+    int argCount = expr->as.call.argCount;
+    Value *arguments = (Value *)malloc(sizeof(Value) * (argCount > 0 ? argCount : 1));
+    if (arguments == NULL)
+    {
+        freeValue(callee);
+        runtimeError(interpreter, "内存分配失败");
+        return true;
+    }
+
+    for (int i = 0; i < argCount; i++)
+    {
+        arguments[i] = evaluate(interpreter, expr->as.call.arguments[i]);
+        if (interpreter->hadError)
+        {
+            freeArguments(arguments, i + 1);
+            freeValue(callee);
+            return true;
+        }
+    }
+
+    interpreter->returnStatus.hasReturn = true;
+    interpreter->returnStatus.value = callee;
+    interpreter->returnStatus.isTailCall = true;
+    interpreter->returnStatus.arguments = arguments;
+    interpreter->returnStatus.argCount = argCount;
+    return true;
+}
+
+/**
+ * 取出 return 的值并清除 returnStatus
+ *
+ * 供不能复用调用帧的地方（生成器、显式栈求值器）使用：尾调用在此按普通调用执行。
+ */
+Value takeReturnValue(Interpreter *interpreter)
+{
+    if (!interpreter->returnStatus.isTailCall)
+    {
+        Value value = interpreter->returnStatus.value;
+        interpreter->returnStatus.hasReturn = false;
+        interpreter->returnStatus.value = createNull();
+        return value;
+    }
+
+    Value *arguments;
+    int argCount;
+    Value callee = takeTailCall(interpreter, &arguments, &argCount);
+    Value result = callFunction(interpreter, callee.as.function, arguments, argCount);
+    freeArguments(arguments, argCount);
+    freeValue(callee);
+    return result;
+}
+
+/**
+ * 从原生函数中调用可调用值
+ *
+ * 脚本函数直接进入 callFunction（形参绑定时才复制参数）；v2 原生函数直接借用参数；
+ * v1 原生函数按其约定传入参数副本。出错时已通过 runtimeError 报告并返回 null。
+ */
+Value callCallable(Interpreter *interpreter, Value callee, const Value *arguments, int argCount)
+{
+    if (callee.type == VAL_FUNCTION && callee.as.function != NULL)
+    {
+        return callFunction(interpreter, callee.as.function, arguments, argCount);
+    }
+
+    if (callee.type != VAL_NATIVE_FUNCTION || callee.as.nativeFunction == NULL)
+    {
+        runtimeError(interpreter, "只能调用函数。");
+        return createNull();
+    }
+
+    NativeFunction *native = callee.as.nativeFunction;
+    if (native->native != NULL)
+    {
+        if (native->arity >= 0 && argCount != native->arity)
+        {
+            runtimeError(interpreter, "%s() 期望 %d 个参数，但得到 %d 个。", native->name, native->arity, argCount);
+            return createNull();
+        }
+
+        Value result = createNull();
+        interpreter->activeNative = native;
+        if (native->native(interpreter, argCount, arguments, &result) != NATIVE_OK)
+        {
+            freeValue(result);
+            if (!interpreter->hadError)
+            {
+                runtimeError(interpreter, "%s() 执行失败", native->name);
+            }
+            return createNull();
+        }
         return result;
     }
 
-    return createNull();
+    if (native->function == NULL)
+    {
+        return createNull();
+    }
+
+    Value copies[argCount > 0 ? argCount : 1];
+    for (int i = 0; i < argCount; i++)
+    {
+        copies[i] = copyValue(arguments[i]);
+    }
+    Value result = native->function(argCount, copies);
+    for (int i = 0; i < argCount; i++)
+    {
+        freeValue(copies[i]);
+    }
+    return result;
+}
+
+// 可调用值声明的参数数量，可变参数或非函数时返回 -1
+int callableArity(Value callee)
+{
+    if (callee.type == VAL_FUNCTION && callee.as.function != NULL)
+    {
+        return callee.as.function->arity;
+    }
+    if (callee.type == VAL_NATIVE_FUNCTION && callee.as.nativeFunction != NULL)
+    {
+        return callee.as.nativeFunction->arity;
+    }
+    return -1;
+}
+
+// 参数表达式全部是变量或字面量时，求值过程没有副作用，借用的变量值在调用期间保持有效
+static bool canBorrowArguments(Expr *expr)
+{
+    for (int i = 0; i < expr->as.call.argCount; i++)
+    {
+        ExprType type = expr->as.call.arguments[i]->type;
+        if (type != EXPR_VARIABLE && type != EXPR_LITERAL)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 取得变量的存储位置，查找顺序与 evaluateVariable 一致；找不到时返回 NULL
+const Value *borrowVariable(Interpreter *interpreter, Expr *expr)
+{
+    const char *name = expr->as.variable.name.lexeme;
+
+    Value *slot = getStaticVariableSlot(interpreter->staticStorage, name, NULL);
+    if (slot != NULL && slot->type != VAL_NULL)
+    {
+        return slot;
+    }
+    return getVariableSlot(interpreter->environment, name, NULL);
+}
+
+/**
+ * 借用 NATIVE_MUTATES_FIRST_ARG 原生函数第一个参数的存储位置，写入 *arg
+ *
+ * 参数必须是已定义的非常量变量，否则报告运行时错误并返回 false。应在其余参数求值之后调用，
+ * 且借用的值不由调用方释放。
+ */
+bool bindMutableArgument(Interpreter *interpreter, NativeFunction *native, Expr *argument, Value *arg)
+{
+    if (argument->type != EXPR_VARIABLE)
+    {
+        runtimeError(interpreter, "%s() 的第一个参数必须是变量", native->name);
+        return false;
+    }
+
+    const char *name = argument->as.variable.name.lexeme;
+    bool isConst = false;
+    Value *slot = getStaticVariableSlot(interpreter->staticStorage, name, &isConst);
+    if (slot == NULL)
+    {
+        slot = getVariableSlot(interpreter->environment, name, &isConst);
+    }
+
+    if (slot == NULL)
+    {
+        runtimeError(interpreter, "未定义的变量 '%s'", name);
+        return false;
+    }
+    if (isConst)
+    {
+        runtimeError(interpreter, "%s() 不能修改常量 '%s'", native->name, name);
+        return false;
+    }
+    *arg = *slot;
+    return true;
+}
+
+// 参数较少时使用栈上数组，避免每次调用分配内存
+#define NATIVE_STACK_ARGS 8
+
+/**
+ * 调用 v2 原生函数
+ *
+ * 带 NATIVE_BORROWS_ARGS 标志的原生函数在参数均为变量或字面量时，直接借用变量中的值，
+ * 不做深度复制；其余参数照常求值，调用结束后释放。
+ * 带 NATIVE_MUTATES_FIRST_ARG 标志的原生函数的第一个参数必须是变量：先求值其余参数，
+ * 再借用该变量的存储位置，原生函数对其中容器的修改直接作用于变量。
+ */
+static Value callNative(Interpreter *interpreter, NativeFunction *native, Expr *expr)
+{
+    int argCount = expr->as.call.argCount;
+    if (native->arity >= 0 && argCount != native->arity)
+    {
+        runtimeError(interpreter, "%s() 期望 %d 个参数，但得到 %d 个。", native->name, native->arity, argCount);
+        return createNull();
+    }
+
+    Value stackArgs[NATIVE_STACK_ARGS];
+    bool stackOwned[NATIVE_STACK_ARGS];
+    Value *args = stackArgs;
+    bool *owned = stackOwned;
+
+    if (argCount > NATIVE_STACK_ARGS)
+    {
+        args = (Value *)malloc(sizeof(Value) * argCount);
+        owned = (bool *)malloc(sizeof(bool) * argCount);
+        if (args == NULL || owned == NULL)
+        {
+            free(args);
+            free(owned);
+            runtimeError(interpreter, "内存分配失败");
+            return createNull();
+        }
+    }
+
+    bool borrow = (native->flags & NATIVE_BORROWS_ARGS) != 0 && canBorrowArguments(expr);
+    bool mutates = (native->flags & NATIVE_MUTATES_FIRST_ARG) != 0 && argCount > 0;
+    int evaluated = 0;
+    if (mutates)
+    {
+        if (expr->as.call.arguments[0]->type != EXPR_VARIABLE)
+        {
+            runtimeError(interpreter, "%s() 的第一个参数必须是变量", native->name);
+        }
+        args[0] = createNull();
+        owned[0] = false;
+        evaluated = 1;
+    }
+
+    for (; evaluated < argCount && !interpreter->hadError; evaluated++)
+    {
+        Expr *argument = expr->as.call.arguments[evaluated];
+        const Value *slot = NULL;
+        if (borrow && argument->type == EXPR_VARIABLE)
+        {
+            slot = borrowVariable(interpreter, argument);
+        }
+
+        if (slot != NULL)
+        {
+            args[evaluated] = *slot;
+            owned[evaluated] = false;
+        }
+        else
+        {
+            args[evaluated] = evaluate(interpreter, argument);
+            owned[evaluated] = true;
+        }
+
+        if (interpreter->hadError)
+        {
+            evaluated++;
+            break;
+        }
+    }
+
+    // 其余参数求值后再借用，避免求值过程改写该变量使借用的值失效
+    if (mutates && !interpreter->hadError)
+    {
+        bindMutableArgument(interpreter, native, expr->as.call.arguments[0], &args[0]);
+    }
+
+    Value result = createNull();
+    if (!interpreter->hadError)
+    {
+        interpreter->activeNative = native;
+        if (native->native(interpreter, argCount, args, &result) != NATIVE_OK)
+        {
+            freeValue(result);
+            result = createNull();
+            if (!interpreter->hadError)
+            {
+                runtimeError(interpreter, "%s() 执行失败", native->name);
+            }
+        }
+    }
+
+    for (int i = 0; i < evaluated; i++)
+    {
+        if (owned[i])
+        {
+            freeValue(args[i]);
+        }
+    }
+    if (args != stackArgs)
+    {
+        free(args);
+        free(owned);
+    }
+
+    return result;
 }
 
 Value evaluateCall(Interpreter *interpreter, Expr *expr)
@@ -56,6 +494,15 @@ Value evaluateCall(Interpreter *interpreter, Expr *expr)
         return createNull();
     }
 
+    // v2 原生函数自行处理参数（可借用而不复制）
+    if (callee.type == VAL_NATIVE_FUNCTION && callee.as.nativeFunction != NULL &&
+        callee.as.nativeFunction->native != NULL)
+    {
+        Value result = callNative(interpreter, callee.as.nativeFunction, expr);
+        freeValue(callee);
+        return result;
+    }
+
     Value *arguments = NULL;
     if (expr->as.call.argCount > 0)
     {
@@ -0,0 +1,230 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/interpreter.h"
+
+Value createGenerator(Interpreter *interpreter, Function *function, const Value *arguments, int argCount)
+{
+    Generator *generator = (Generator *)malloc(sizeof(Generator));
+    Environment *scope = generator != NULL ? createHeapScope(function->closure) : NULL;
+    if (scope == NULL)
+    {
+        free(generator);
+        runtimeError(interpreter, "内存分配失败");
+        return createNull();
+    }
+
+    for (int i = 0; i < argCount; i++)
+    {
+        defineVariable(scope, function->paramNames[i], arguments[i]);
+    }
+
+    generator->name = NULL;
+    if (function->name != NULL)
+    {
+        size_t length = strlen(function->name);
+        generator->name = (char *)malloc(length + 1);
+        if (generator->name != NULL)
+        {
+            memcpy(generator->name, function->name, length + 1);
+        }
+    }
+    generator->body = function->body;
+    generator->scope = scope;
+    generator->environment = scope;
+    initMachine(&generator->machine, interpreter->explicitStack);
+    generator->started = false;
+    generator->state = GENERATOR_SUSPENDED;
+    generator->delegate = NULL;
+    generator->delegator = NULL;
+    generator->innermost = NULL;
+    generator->innermostEpoch = 0;
+    generator->refCount = 1;
+
+    Value value;
+    value.type = VAL_GENERATOR;
+    value.as.generator = generator;
+    return value;
+}
+
+// 结束生成器，立即释放任务栈和参数环境
+static void finishGenerator(Generator *generator)
+{
+    freeMachine(&generator->machine);
+    if (generator->scope != NULL)
+    {
+        freeHeapScope(generator->scope);
+        generator->scope = NULL;
+    }
+    generator->environment = NULL;
+    generator->state = GENERATOR_DONE;
+}
+
+void retainGenerator(Generator *generator)
+{
+    generator->refCount++;
+}
+
+// 沿委托链逐个释放，不随委托深度递归
+void releaseGenerator(Generator *generator)
+{
+    while (generator != NULL && --generator->refCount == 0)
+    {
+        Generator *delegate = generator->delegate;
+        generator->delegate = NULL;
+        if (delegate != NULL)
+        {
+            delegate->delegator = NULL;
+        }
+        finishGenerator(generator);
+        free(generator->name);
+        free(generator);
+        generator = delegate;
+    }
+}
+
+// yield* 的值是生成器时委托给它：不在本生成器中逐个转发，由 resumeGenerator 直接恢复委托链最内层的生成器
+static MachineResult delegateTo(Interpreter *interpreter, Generator *generator, Value value)
+{
+    Generator *target = value.as.generator;
+    if (target->delegator != NULL)
+    {
+        freeValue(value);
+        runtimeError(interpreter, "yield* 的生成器已被另一个生成器委托");
+        return MACHINE_FAILED;
+    }
+    for (Generator *inner = target; inner != NULL; inner = inner->delegate)
+    {
+        if (inner == generator || inner->state == GENERATOR_RUNNING)
+        {
+            freeValue(value);
+            runtimeError(interpreter, "yield* 不能委托给正在运行的生成器");
+            return MACHINE_FAILED;
+        }
+    }
+    generator->delegate = target;
+    target->delegator = generator;
+    return MACHINE_DELEGATED;
+}
+
+// 函数体执行完毕或遇到 return：生成器的返回值不产出，直接结束（return f(...) 中的调用仍要执行）
+static MachineResult finishBody(Interpreter *interpreter)
+{
+    interpreter->breakStatus.hasBreak = false;
+    if (interpreter->returnStatus.hasReturn)
+    {
+        freeValue(takeReturnValue(interpreter));
+    }
+    return interpreter->hadError ? MACHINE_FAILED : MACHINE_DONE;
+}
+
+// 执行单个生成器直到 yield、委托、结束或出错，不进入其委托的生成器
+static MachineResult runGenerator(Interpreter *interpreter, Generator *generator, Value *value)
+{
+    if (generator->state == GENERATOR_DONE)
+    {
+        return MACHINE_DONE;
+    }
+    if (generator->state == GENERATOR_RUNNING)
+    {
+        runtimeError(interpreter, "生成器 '%s' 正在运行，不能在其内部再次恢复",
+                     generator->name != NULL ? generator->name : "anonymous");
+        return MACHINE_FAILED;
+    }
+
+    generator->state = GENERATOR_RUNNING;
+    interpreter->environment = generator->environment;
+    if (!generator->started)
+    {
+        generator->started = true;
+        beginStatement(interpreter, &generator->machine, generator->body);
+    }
+
+    MachineResult result = runMachine(interpreter, &generator->machine, value);
+    if (result == MACHINE_DELEGATED)
+    {
+        result = delegateTo(interpreter, generator, *value);
+    }
+    else if (result == MACHINE_DONE)
+    {
+        result = finishBody(interpreter);
+    }
+
+    if (result == MACHINE_YIELDED || result == MACHINE_DELEGATED)
+    {
+        generator->environment = interpreter->environment;
+        generator->state = GENERATOR_SUSPENDED;
+    }
+    else
+    {
+        finishGenerator(generator);
+    }
+    return result;
+}
+
+/**
+ * 恢复生成器
+ *
+ * 每次从委托链最内层的生成器开始执行；它结束后从上一层的 yield* 之后继续。
+ * 委托链只在堆上记录，C 栈深度与委托深度无关。
+ *
+ * 委托链中的一环只在内层生成器结束时断开，因此纪元未变时缓存的 innermost 仍在链上，
+ * 只需从它向内查找新增的委托。
+ */
+GeneratorResult resumeGenerator(Interpreter *interpreter, Generator *generator, Value *value)
+{
+    // 执行期间脚本可能改写保存该生成器的变量，先持有一个引用
+    retainGenerator(generator);
+    Environment *previous = interpreter->environment;
+    GeneratorResult result;
+
+    for (;;)
+    {
+        Generator *current = generator;
+        if (generator->innermost != NULL && generator->innermostEpoch == interpreter->delegationEpoch)
+        {
+            current = generator->innermost;
+        }
+        while (current->delegate != NULL)
+        {
+            current = current->delegate;
+        }
+        generator->innermost = current;
+        generator->innermostEpoch = interpreter->delegationEpoch;
+
+        MachineResult step = runGenerator(interpreter, current, value);
+        if (step == MACHINE_DELEGATED)
+        {
+            continue;
+        }
+        if (step == MACHINE_YIELDED)
+        {
+            result = GENERATOR_YIELDED;
+            break;
+        }
+        if (step == MACHINE_FAILED)
+        {
+            result = GENERATOR_FAILED;
+            break;
+        }
+
+        if (current == generator)
+        {
+            result = GENERATOR_FINISHED;
+            break;
+        }
+
+        Generator *parent = current->delegator;
+        parent->delegate = NULL;
+        current->delegator = NULL;
+        releaseGenerator(current);
+
+        interpreter->delegationEpoch++;
+        generator->innermost = parent;
+        generator->innermostEpoch = interpreter->delegationEpoch;
+    }
+
+    interpreter->environment = previous;
+    releaseGenerator(generator);
+    return result;
+}
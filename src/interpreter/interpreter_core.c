@@ -1,13 +1,30 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
 #include "../include/interpreter.h"
 #include "../include/native_functions.h"
 
-// 定义全局状态变量（实际定义，不是声明）
-ReturnStatusType returnStatus = {false, {0}};
-BreakStatusType breakStatus = {false};
+// 为 C 栈保留的余量：两次调用深度检查之间的求值、原生函数和错误处理使用
+#define STACK_SAFETY_MARGIN (256 * 1024)
+#define DEFAULT_STACK_SIZE (8 * 1024 * 1024)
+
+// 限时执行时每检查这么多次才读取一次时钟
+#define DEADLINE_CHECK_INTERVAL 1024
+
+// 递归求值允许使用的 C 栈字节数，按当前栈大小限制扣除余量
+static size_t usableStackSize(void) {
+    size_t size = DEFAULT_STACK_SIZE;
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+        size = (size_t)limit.rlim_cur;
+    }
+    return size > 2 * STACK_SAFETY_MARGIN ? size - STACK_SAFETY_MARGIN : size / 2;
+}
 
 void initInterpreter(Interpreter *interpreter) {
     interpreter->globals = (Environment *)malloc(sizeof(Environment));
@@ -17,6 +34,24 @@ void initInterpreter(Interpreter *interpreter) {
     interpreter->errorMessage[0] = '\0';
     interpreter->hasMainFunction = false;
     interpreter->mainFunction = NULL;
+    interpreter->explicitStack = false;
+    interpreter->maxCallDepth = DEFAULT_MAX_CALL_DEPTH;
+    interpreter->callDepth = 0;
+    interpreter->stackBase = 0;
+    interpreter->stackLimit = usableStackSize();
+    interpreter->returnStatus.hasReturn = false;
+    interpreter->returnStatus.value = createNull();
+    interpreter->returnStatus.isTailCall = false;
+    interpreter->returnStatus.arguments = NULL;
+    interpreter->returnStatus.argCount = 0;
+    interpreter->breakStatus.hasBreak = false;
+    interpreter->delegationEpoch = 0;
+    interpreter->activeNative = NULL;
+    interpreter->scriptArgs = NULL;
+    interpreter->scriptArgCount = 0;
+    interpreter->inputDisabled = false;
+    interpreter->deadline = 0;
+    interpreter->deadlineCountdown = 0;
 
     // 初始化静态存储
     interpreter->staticStorage = (StaticStorage *)malloc(sizeof(StaticStorage));
@@ -26,10 +61,16 @@ void initInterpreter(Interpreter *interpreter) {
     }
     initStaticStorage(interpreter->staticStorage);
 
+    initOutputBuffer(&interpreter->output, STDOUT_FILENO, defaultOutputMode(STDOUT_FILENO));
+
     registerAllNativeFunctions(interpreter);
 }
 
 void interpret(Interpreter *interpreter, Stmt **statements, int count) {
+    // 以此处为 C 栈的起点估计递归求值已用的栈空间
+    char stackMarker;
+    interpreter->stackBase = (uintptr_t)&stackMarker;
+
     // 第一阶段：执行函数定义和枚举声明
     for (int i = 0; i < count; i++) {
         bool isEnum = (statements[i]->type == STMT_ENUM);
@@ -48,7 +89,11 @@ void interpret(Interpreter *interpreter, Stmt **statements, int count) {
         bool isFunction = (statements[i]->type == STMT_FUNCTION);
 
         if (!isEnum && !isFunction) {
-            execute(interpreter, statements[i]);
+            if (interpreter->explicitStack) {
+                executeExplicit(interpreter, statements[i]);
+            } else {
+                execute(interpreter, statements[i]);
+            }
             if (interpreter->hadError) {
                 return;
             }
@@ -72,6 +117,85 @@ void runtimeError(Interpreter *interpreter, const char *format, ...) {
     interpreter->hadError = true;
 }
 
+bool enterCall(Interpreter *interpreter) {
+    if (!checkDeadline(interpreter)) {
+        return false;
+    }
+    if (interpreter->callDepth >= interpreter->maxCallDepth) {
+        runtimeError(interpreter, "超出最大调用深度 %d", interpreter->maxCallDepth);
+        return false;
+    }
+
+    // 栈向下或向上增长都按距离计算
+    char marker;
+    if (interpreter->stackBase != 0) {
+        uintptr_t base = interpreter->stackBase;
+        uintptr_t here = (uintptr_t)&marker;
+        size_t used = base > here ? base - here : here - base;
+        if (used > interpreter->stackLimit) {
+            // 显式栈求值器中脚本函数之间的调用不占用 C 栈，只有经由原生函数回调
+            //（map、sortBy 等）或未展开的表达式（自增自减、复合赋值的目标）的递归才会到这里
+            if (interpreter->explicitStack) {
+                runtimeError(interpreter,
+                             "调用层次过深（深度 %d），C 栈即将耗尽；递归经由原生函数的回调或复合赋值、自增自减的目标时仍占用 C 栈",
+                             interpreter->callDepth);
+            } else {
+                runtimeError(interpreter, "调用层次过深（深度 %d），C 栈即将耗尽；可使用 --explicit-stack 运行",
+                             interpreter->callDepth);
+            }
+            return false;
+        }
+    }
+
+    interpreter->callDepth++;
+    return true;
+}
+
+void leaveCall(Interpreter *interpreter) {
+    interpreter->callDepth--;
+}
+
+static uint64_t monotonicNanos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void setTimeLimit(Interpreter *interpreter, int milliseconds) {
+    interpreter->deadline = milliseconds > 0 ? monotonicNanos() + (uint64_t)milliseconds * 1000000ULL : 0;
+    interpreter->deadlineCountdown = DEADLINE_CHECK_INTERVAL;
+}
+
+bool checkDeadline(Interpreter *interpreter) {
+    if (interpreter->deadline == 0 || --interpreter->deadlineCountdown > 0) {
+        return true;
+    }
+    interpreter->deadlineCountdown = DEADLINE_CHECK_INTERVAL;
+    if (monotonicNanos() < interpreter->deadline) {
+        return true;
+    }
+    runtimeError(interpreter, "执行超时");
+    return false;
+}
+
+// 条件判断的真值规则：只有 null 和 false 为假
+bool isTruthy(Value value) {
+    return value.type != VAL_NULL && !(value.type == VAL_BOOL && !value.as.boolean);
+}
+
+Environment *createHeapScope(Environment *enclosing) {
+    Environment *scope = (Environment *)malloc(sizeof(Environment));
+    if (scope != NULL) {
+        initEnvironment(scope, enclosing);
+    }
+    return scope;
+}
+
+void freeHeapScope(Environment *scope) {
+    freeEnvironment(scope);
+    free(scope);
+}
+
 bool hadInterpreterError(Interpreter *interpreter) {
     return interpreter != NULL && interpreter->hadError;
 }
@@ -86,6 +210,9 @@ void freeInterpreter(Interpreter *interpreter) {
     if (interpreter == NULL)
         return;
 
+    // 程序结束时写出剩余输出
+    freeOutputBuffer(&interpreter->output);
+
     if (interpreter->globals != NULL) {
         if (interpreter->environment == interpreter->globals) {
             interpreter->environment = NULL;
@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "../include/interpreter.h"
+
+bool checkMapKey(Interpreter *interpreter, Value key) {
+    if (!mapKeySupported(key)) {
+        runtimeError(interpreter, "映射的键必须是字符串、数字（不能为 NaN）或布尔值");
+        return false;
+    }
+    return true;
+}
+
+bool mapAssign(Interpreter *interpreter, Map *map, Value key, Value value) {
+    if (!checkMapKey(interpreter, key)) {
+        freeValue(key);
+        return false;
+    }
+    if (!mapSet(map, key, copyValue(value))) {
+        runtimeError(interpreter, "内存分配失败");
+        return false;
+    }
+    return true;
+}
+
+// 按书写顺序求值并插入键值对，重复的键以后出现的为准
+Value evaluateMapLiteral(Interpreter *interpreter, Expr *expr) {
+    Value mapValue = createMap(expr->as.mapLiteral.count);
+    if (mapValue.type == VAL_NULL) {
+        runtimeError(interpreter, "创建映射失败");
+        return createNull();
+    }
+
+    for (int i = 0; i < expr->as.mapLiteral.count; i++) {
+        Value key = evaluate(interpreter, expr->as.mapLiteral.keys[i]);
+        if (interpreter->hadError) {
+            freeValue(key);
+            freeValue(mapValue);
+            return createNull();
+        }
+
+        Value value = evaluate(interpreter, expr->as.mapLiteral.values[i]);
+        if (interpreter->hadError) {
+            freeValue(key);
+            freeValue(value);
+            freeValue(mapValue);
+            return createNull();
+        }
+
+        if (!checkMapKey(interpreter, key)) {
+            freeValue(key);
+            freeValue(value);
+            freeValue(mapValue);
+            return createNull();
+        }
+        if (!mapSet(mapValue.as.map, key, value)) {
+            freeValue(mapValue);
+            runtimeError(interpreter, "内存分配失败");
+            return createNull();
+        }
+    }
+
+    return mapValue;
+}
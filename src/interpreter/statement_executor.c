@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../include/interpreter.h"
+#include "../include/containers.h"
 
 // 前向声明内部函数
 static void executeExpression(Interpreter *interpreter, Stmt *stmt);
@@ -14,6 +15,7 @@ static void executeIf(Interpreter *interpreter, Stmt *stmt);
 static void executeWhile(Interpreter *interpreter, Stmt *stmt);
 static void executeDoWhile(Interpreter *interpreter, Stmt *stmt);
 static void executeFor(Interpreter *interpreter, Stmt *stmt);
+static void executeForIn(Interpreter *interpreter, Stmt *stmt);
 static void executeFunction(Interpreter *interpreter, Stmt *stmt);
 static void executeReturn(Interpreter *interpreter, Stmt *stmt);
 static void executeSwitch(Interpreter *interpreter, Stmt *stmt);
@@ -58,6 +60,13 @@ void execute(Interpreter *interpreter, Stmt *stmt) {
     case STMT_FOR:
         executeFor(interpreter, stmt);
         break;
+    case STMT_FOR_IN:
+        executeForIn(interpreter, stmt);
+        break;
+    case STMT_YIELD:
+        // 含有 yield 的函数调用时返回生成器，函数体由生成器执行；能执行到这里说明 yield 不在函数中
+        runtimeError(interpreter, "yield 只能在函数中使用");
+        break;
     case STMT_FUNCTION:
         executeFunction(interpreter, stmt);
         break;
@@ -82,6 +91,13 @@ void execute(Interpreter *interpreter, Stmt *stmt) {
 }
 
 static void executeExpression(Interpreter *interpreter, Stmt *stmt) {
+    // 复合赋值语句的结果会被丢弃，直接原地更新而不复制结果
+    if (stmt->as.expression.expression != NULL &&
+        stmt->as.expression.expression->type == EXPR_COMPOUND_ASSIGN) {
+        executeCompoundAssign(interpreter, stmt->as.expression.expression);
+        return;
+    }
+
     Value value = evaluate(interpreter, stmt->as.expression.expression);
     freeValue(value);
 }
@@ -95,6 +111,8 @@ static void executeVar(Interpreter *interpreter, Stmt *stmt) {
 
     if (stmt->as.var.isStatic) {
         defineStaticVariable(interpreter->staticStorage, stmt->as.var.name.lexeme, value, false);
+    } else if (isLocalConstant(interpreter->environment, stmt->as.var.name.lexeme)) {
+        runtimeError(interpreter, "不能重新定义常量 '%s'", stmt->as.var.name.lexeme);
     } else {
         defineVariable(interpreter->environment, stmt->as.var.name.lexeme, value);
     }
@@ -146,6 +164,9 @@ static void executeMultiVar(Interpreter *interpreter, Stmt *stmt) {
     for (int i = 0; i < stmt->as.multiVar.count; i++) {
         if (stmt->as.multiVar.isStatic) {
             defineStaticVariable(interpreter->staticStorage, stmt->as.multiVar.names[i].lexeme, initialValue, false);
+        } else if (isLocalConstant(interpreter->environment, stmt->as.multiVar.names[i].lexeme)) {
+            runtimeError(interpreter, "不能重新定义常量 '%s'", stmt->as.multiVar.names[i].lexeme);
+            break;
         } else {
             Value valueCopy = copyValue(initialValue);
             defineVariable(interpreter->environment, stmt->as.multiVar.names[i].lexeme, valueCopy);
@@ -201,9 +222,9 @@ static void executeBlock(Interpreter *interpreter, Stmt **statements, int count,
         execute(interpreter, statements[i]);
         if (interpreter->hadError)
             break;
-        if (breakStatus.hasBreak)
+        if (interpreter->breakStatus.hasBreak)
             break;
-        if (returnStatus.hasReturn)
+        if (interpreter->returnStatus.hasReturn)
             break;
     }
 
@@ -213,11 +234,10 @@ static void executeBlock(Interpreter *interpreter, Stmt **statements, int count,
 
 static void executeIf(Interpreter *interpreter, Stmt *stmt) {
     Value condition = evaluate(interpreter, stmt->as.ifStmt.condition);
-    bool isTruthy = condition.type != VAL_NULL &&
-                    !(condition.type == VAL_BOOL && !condition.as.boolean);
+    bool truthy = isTruthy(condition);
     freeValue(condition);
 
-    if (isTruthy) {
+    if (truthy) {
         execute(interpreter, stmt->as.ifStmt.thenBranch);
     } else if (stmt->as.ifStmt.elseBranch != NULL) {
         execute(interpreter, stmt->as.ifStmt.elseBranch);
@@ -225,45 +245,45 @@ static void executeIf(Interpreter *interpreter, Stmt *stmt) {
 }
 
 static void executeWhile(Interpreter *interpreter, Stmt *stmt) {
-    while (true) {
+    while (checkDeadline(interpreter)) {
         Value condition = evaluate(interpreter, stmt->as.whileLoop.condition);
-        bool isTruthy = condition.type != VAL_NULL &&
-                        !(condition.type == VAL_BOOL && !condition.as.boolean);
+        bool truthy = isTruthy(condition);
         freeValue(condition);
 
-        if (!isTruthy)
+        if (!truthy)
             break;
 
         execute(interpreter, stmt->as.whileLoop.body);
         if (interpreter->hadError)
             break;
-        if (breakStatus.hasBreak) {
-            breakStatus.hasBreak = false;
+        if (interpreter->breakStatus.hasBreak) {
+            interpreter->breakStatus.hasBreak = false;
             break;
         }
-        if (returnStatus.hasReturn)
+        if (interpreter->returnStatus.hasReturn)
             break;
     }
 }
 
 static void executeDoWhile(Interpreter *interpreter, Stmt *stmt) {
     do {
+        if (!checkDeadline(interpreter))
+            break;
         execute(interpreter, stmt->as.doWhile.body);
         if (interpreter->hadError)
             break;
-        if (breakStatus.hasBreak) {
-            breakStatus.hasBreak = false;
+        if (interpreter->breakStatus.hasBreak) {
+            interpreter->breakStatus.hasBreak = false;
             break;
         }
-        if (returnStatus.hasReturn)
+        if (interpreter->returnStatus.hasReturn)
             break;
 
         Value condition = evaluate(interpreter, stmt->as.doWhile.condition);
-        bool isTruthy = condition.type != VAL_NULL &&
-                        !(condition.type == VAL_BOOL && !condition.as.boolean);
+        bool truthy = isTruthy(condition);
         freeValue(condition);
 
-        if (!isTruthy)
+        if (!truthy)
             break;
     } while (true);
 }
@@ -273,25 +293,24 @@ static void executeFor(Interpreter *interpreter, Stmt *stmt) {
         execute(interpreter, stmt->as.forLoop.initializer);
     }
 
-    while (true) {
+    while (checkDeadline(interpreter)) {
         if (stmt->as.forLoop.condition != NULL) {
             Value condition = evaluate(interpreter, stmt->as.forLoop.condition);
-            bool isTruthy = condition.type != VAL_NULL &&
-                            !(condition.type == VAL_BOOL && !condition.as.boolean);
+            bool truthy = isTruthy(condition);
             freeValue(condition);
 
-            if (!isTruthy)
+            if (!truthy)
                 break;
         }
 
         execute(interpreter, stmt->as.forLoop.body);
         if (interpreter->hadError)
             break;
-        if (breakStatus.hasBreak) {
-            breakStatus.hasBreak = false;
+        if (interpreter->breakStatus.hasBreak) {
+            interpreter->breakStatus.hasBreak = false;
             break;
         }
-        if (returnStatus.hasReturn)
+        if (interpreter->returnStatus.hasReturn)
             break;
 
         if (stmt->as.forLoop.increment != NULL) {
@@ -301,6 +320,151 @@ static void executeFor(Interpreter *interpreter, Stmt *stmt) {
     }
 }
 
+// UTF-8 字符的字节数；非法的首字节或被截断的字符按单个字节处理
+static size_t utf8CharLength(const char *chars, size_t remaining) {
+    unsigned char lead = (unsigned char)chars[0];
+    size_t length = 1;
+    if (lead >= 0xF0 && lead < 0xF8)
+        length = 4;
+    else if (lead >= 0xE0)
+        length = 3;
+    else if (lead >= 0xC0)
+        length = 2;
+
+    if (length > remaining)
+        return 1;
+    for (size_t i = 1; i < length; i++) {
+        if (((unsigned char)chars[i] & 0xC0) != 0x80)
+            return 1;
+    }
+    return length;
+}
+
+/**
+ * 取得 for-in 的下一个元素
+ *
+ * cursor 是遍历位置：数组、区间、双端队列为元素下标，字符串为字节偏移，映射为 entries 下标；
+ * 生成器自己保存执行位置，每次恢复到下一个 yield。
+ * 每次都按当前容器状态检查边界，循环体修改或重新赋值被遍历的变量时不会越界。
+ * 没有更多元素时返回 false。
+ */
+bool forInNext(Interpreter *interpreter, Value iterable, int64_t *cursor, Value *element) {
+    switch (iterable.type) {
+    case VAL_ARRAY:
+        if (iterable.as.array == NULL || *cursor >= iterable.as.array->count)
+            return false;
+        *element = copyValue(iterable.as.array->elements[(*cursor)++]);
+        return true;
+    case VAL_STRING: {
+        size_t length = iterable.as.string != NULL ? stringLength(iterable.as.string) : 0;
+        if ((size_t)*cursor >= length)
+            return false;
+        const char *chars = iterable.as.string + *cursor;
+        size_t charLength = utf8CharLength(chars, length - (size_t)*cursor);
+        *element = createStringWithLength(chars, charLength);
+        *cursor += (int64_t)charLength;
+        return true;
+    }
+    case VAL_RANGE:
+        if (*cursor >= rangeLength(iterable.as.range))
+            return false;
+        *element = createInt(rangeAt(iterable.as.range, (*cursor)++));
+        return true;
+    case VAL_MAP: {
+        Map *map = iterable.as.map;
+        // 跳过已删除的项，按插入顺序产生键
+        while (map != NULL && *cursor < map->entryCount) {
+            MapEntry *entry = &map->entries[(*cursor)++];
+            if (entry->key.type != VAL_NULL) {
+                *element = copyValue(entry->key);
+                return true;
+            }
+        }
+        return false;
+    }
+    case VAL_DEQUE:
+        if (iterable.as.deque == NULL || *cursor >= iterable.as.deque->count)
+            return false;
+        *element = copyValue(*dequeAt(iterable.as.deque, (int)(*cursor)++));
+        return true;
+    case VAL_GENERATOR:
+        return resumeGenerator(interpreter, iterable.as.generator, element) == GENERATOR_YIELDED;
+    default:
+        runtimeError(interpreter, "for-in 只能遍历数组、字符串、映射、双端队列、区间或生成器");
+        return false;
+    }
+}
+
+// 被遍历的变量在外层作用域中的存储位置，查找顺序与 borrowVariable 一致
+const Value *forInSource(Interpreter *interpreter, Environment *outer, Expr *iterable) {
+    const char *name = iterable->as.variable.name.lexeme;
+    Value *slot = getStaticVariableSlot(interpreter->staticStorage, name, NULL);
+    if (slot != NULL && slot->type != VAL_NULL)
+        return slot;
+    return getVariableSlot(outer, name, NULL);
+}
+
+/**
+ * for (x in iterable)
+ *
+ * 被遍历的是变量时不复制整个容器，每次迭代重新借用变量的存储位置取下一个元素；
+ * 其他表达式只求值一次。区间按下标计算元素，不生成数组，内存占用与长度无关。
+ * 循环变量位于独立的作用域中，每个元素复制后写入其槽位。
+ */
+static void executeForIn(Interpreter *interpreter, Stmt *stmt) {
+    Expr *iterableExpr = stmt->as.forIn.iterable;
+    Environment *previous = interpreter->environment;
+
+    bool borrowed = iterableExpr->type == EXPR_VARIABLE &&
+                    forInSource(interpreter, previous, iterableExpr) != NULL;
+    Value owned = createNull();
+    if (!borrowed) {
+        owned = evaluate(interpreter, iterableExpr);
+        if (interpreter->hadError) {
+            freeValue(owned);
+            return;
+        }
+    }
+
+    Environment loopEnv;
+    initEnvironment(&loopEnv, previous);
+    defineVariable(&loopEnv, stmt->as.forIn.name.lexeme, createNull());
+    interpreter->environment = &loopEnv;
+
+    int64_t cursor = 0;
+    while (checkDeadline(interpreter)) {
+        Value iterable = owned;
+        if (borrowed) {
+            const Value *slot = forInSource(interpreter, previous, iterableExpr);
+            if (slot == NULL)
+                break;
+            iterable = *slot;
+        }
+
+        Value element;
+        if (!forInNext(interpreter, iterable, &cursor, &element))
+            break;
+
+        // 循环变量是该作用域中的第一个变量
+        freeValue(loopEnv.values[0]);
+        loopEnv.values[0] = element;
+
+        execute(interpreter, stmt->as.forIn.body);
+        if (interpreter->hadError)
+            break;
+        if (interpreter->breakStatus.hasBreak) {
+            interpreter->breakStatus.hasBreak = false;
+            break;
+        }
+        if (interpreter->returnStatus.hasReturn)
+            break;
+    }
+
+    interpreter->environment = previous;
+    freeEnvironment(&loopEnv);
+    freeValue(owned);
+}
+
 static void executeFunction(Interpreter *interpreter, Stmt *stmt)
 {
     // 创建函数对象
@@ -366,44 +530,59 @@ static void executeFunction(Interpreter *interpreter, Stmt *stmt)
 
     // 设置函数体
     function->body = stmt->as.function.body;
+    function->isGenerator = stmt->as.function.isGenerator;
 
     // 设置闭包环境（当前为全局环境）
     function->closure = interpreter->globals;
 
-    // 检查是否是 main 函数
-    if (strcmp(function->name, "main") == 0)
-    {
-        interpreter->hasMainFunction = true;
-        interpreter->mainFunction = function;
-    }
-
     // 创建函数值并定义到环境中
     Value functionValue;
     functionValue.type = VAL_FUNCTION;
     functionValue.as.function = function;
 
-    // 检查是否是静态函数
+    // 定义时保存的是副本：main 函数指向环境中的副本，这里的函数对象随后释放
+    bool isConst;
+    Value *slot;
     if (stmt->as.function.isStatic)
     {
         // 静态函数在静态存储中定义
         defineStaticVariable(interpreter->staticStorage, function->name, functionValue, true);
+        slot = getStaticVariableSlot(interpreter->staticStorage, function->name, &isConst);
     }
     else
     {
         // 普通函数在全局环境中定义
         defineVariable(interpreter->globals, function->name, functionValue);
+        slot = getVariableSlot(interpreter->globals, function->name, &isConst);
+    }
+
+    // 检查是否是 main 函数
+    if (strcmp(function->name, "main") == 0 && slot != NULL && slot->type == VAL_FUNCTION)
+    {
+        interpreter->hasMainFunction = true;
+        interpreter->mainFunction = slot->as.function;
     }
+
+    freeValue(functionValue);
 }
 
 static void executeReturn(Interpreter *interpreter, Stmt *stmt) {
+    Expr *valueExpr = stmt->as.returnStmt.value;
+
+    // 函数中的 return f(...) 是尾调用：只求值被调用者和参数，由 callFunction 复用当前调用帧执行
+    if (valueExpr != NULL && valueExpr->type == EXPR_CALL && interpreter->callDepth > 0 &&
+        prepareTailCall(interpreter, valueExpr)) {
+        return;
+    }
+
     Value value = createNull();
 
-    if (stmt->as.returnStmt.value != NULL) {
-        value = evaluate(interpreter, stmt->as.returnStmt.value);
+    if (valueExpr != NULL) {
+        value = evaluate(interpreter, valueExpr);
     }
 
-    returnStatus.hasReturn = true;
-    returnStatus.value = value;
+    interpreter->returnStatus.hasReturn = true;
+    interpreter->returnStatus.value = value;
 }
 
 static void executeSwitch(Interpreter *interpreter, Stmt *stmt) {
@@ -414,7 +593,7 @@ static void executeSwitch(Interpreter *interpreter, Stmt *stmt) {
 
     bool matched = false;
     bool fallthrough = false;
-    breakStatus.hasBreak = false;
+    interpreter->breakStatus.hasBreak = false;
 
     for (int i = 0; i < stmt->as.switchStmt.caseCount; i++) {
         CaseStmt *caseStmt = &stmt->as.switchStmt.cases[i];
@@ -441,18 +620,18 @@ static void executeSwitch(Interpreter *interpreter, Stmt *stmt) {
 
         if (fallthrough) {
             execute(interpreter, caseStmt->body);
-            if (breakStatus.hasBreak || interpreter->hadError) {
+            if (interpreter->breakStatus.hasBreak || interpreter->returnStatus.hasReturn || interpreter->hadError) {
                 break;
             }
         }
     }
 
     freeValue(discriminant);
-    breakStatus.hasBreak = false;
+    interpreter->breakStatus.hasBreak = false;
 }
 
 static void executeBreak(Interpreter *interpreter, Stmt *stmt) {
-    breakStatus.hasBreak = true;
+    interpreter->breakStatus.hasBreak = true;
 }
 
 static void executeEnum(Interpreter *interpreter, Stmt *stmt) {
@@ -468,7 +647,9 @@ static void executeEnum(Interpreter *interpreter, Stmt *stmt) {
             if (interpreter->hadError)
                 return;
 
-            if (val.type == VAL_NUMBER) {
+            if (val.type == VAL_INT) {
+                enumValue = (int)val.as.integer;
+            } else if (val.type == VAL_NUMBER) {
                 enumValue = (int)val.as.number;
                 currentValue = enumValue;
             } else {
@@ -481,7 +662,7 @@ static void executeEnum(Interpreter *interpreter, Stmt *stmt) {
             enumValue = currentValue;
         }
 
-        Value enumVal = createNumber((double)enumValue);
+        Value enumVal = createInt(enumValue);
 
         char *fullName = malloc(strlen(enumName) + strlen(member->name.lexeme) + 2);
         if (fullName == NULL) {
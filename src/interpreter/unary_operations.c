@@ -1,13 +1,37 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../include/interpreter.h"
 
+// 对数字加上 delta（±1）；整数溢出时提升为浮点数
+static Value stepNumber(Value value, int delta) {
+    if (value.type == VAL_INT) {
+        int64_t result;
+        if (__builtin_add_overflow(value.as.integer, (int64_t)delta, &result)) {
+            return createNumber((double)value.as.integer + delta);
+        }
+        return createInt(result);
+    }
+    return createNumber(value.as.number + delta);
+}
+
 Value evaluateUnary(Interpreter *interpreter, Expr *expr) {
     Value right = evaluate(interpreter, expr->as.unary.right);
+    return applyUnary(interpreter, expr->as.unary.op, right);
+}
 
-    switch (expr->as.unary.op) {
+// 对已求值的操作数执行一元运算，释放操作数
+Value applyUnary(Interpreter *interpreter, TokenType op, Value right) {
+    switch (op) {
     case TOKEN_MINUS:
+        if (right.type == VAL_INT) {
+            // -INT64_MIN 无法用 int64 表示，提升为浮点数
+            if (right.as.integer == INT64_MIN) {
+                return createNumber(-(double)right.as.integer);
+            }
+            return createInt(-right.as.integer);
+        }
         if (right.type != VAL_NUMBER) {
             freeValue(right);
             runtimeError(interpreter, "操作数必须是数字。");
@@ -20,7 +44,7 @@ Value evaluateUnary(Interpreter *interpreter, Expr *expr) {
         }
 
     case TOKEN_PLUS:
-        if (right.type != VAL_NUMBER) {
+        if (!isNumeric(right)) {
             freeValue(right);
             runtimeError(interpreter, "操作数必须是数字。");
             return createNull();
@@ -28,10 +52,9 @@ Value evaluateUnary(Interpreter *interpreter, Expr *expr) {
         return right;
 
     case TOKEN_NOT: {
-        bool isTruthy = (right.type != VAL_NULL &&
-                         !(right.type == VAL_BOOL && !right.as.boolean));
+        bool truthy = isTruthy(right);
         freeValue(right);
-        return createBool(!isTruthy);
+        return createBool(!truthy);
     }
     default:
         freeValue(right);
@@ -53,7 +76,7 @@ Value evaluatePostfix(Interpreter *interpreter, Expr *expr) {
         return createNull();
     }
 
-    if (oldValue.type != VAL_NUMBER) {
+    if (!isNumeric(oldValue)) {
         freeValue(oldValue);
         runtimeError(interpreter, "后缀运算符只能应用于数字类型。");
         return createNull();
@@ -61,9 +84,9 @@ Value evaluatePostfix(Interpreter *interpreter, Expr *expr) {
 
     Value newValue;
     if (expr->as.postfix.op == TOKEN_PLUS_PLUS) {
-        newValue = createNumber(oldValue.as.number + 1);
+        newValue = stepNumber(oldValue, 1);
     } else if (expr->as.postfix.op == TOKEN_MINUS_MINUS) {
-        newValue = createNumber(oldValue.as.number - 1);
+        newValue = stepNumber(oldValue, -1);
     } else {
         freeValue(oldValue);
         runtimeError(interpreter, "未知的后缀运算符。");
@@ -84,7 +107,7 @@ Value evaluatePrefix(Interpreter *interpreter, Expr *expr) {
         return createNull();
     }
 
-    if (oldValue.type != VAL_NUMBER) {
+    if (!isNumeric(oldValue)) {
         freeValue(oldValue);
         runtimeError(interpreter, "前缀运算符只能应用于数字类型。");
         return createNull();
@@ -92,9 +115,9 @@ Value evaluatePrefix(Interpreter *interpreter, Expr *expr) {
 
     Value newValue;
     if (expr->as.prefix.op == TOKEN_PLUS_PLUS) {
-        newValue = createNumber(oldValue.as.number + 1);
+        newValue = stepNumber(oldValue, 1);
     } else if (expr->as.prefix.op == TOKEN_MINUS_MINUS) {
-        newValue = createNumber(oldValue.as.number - 1);
+        newValue = stepNumber(oldValue, -1);
     } else {
         freeValue(oldValue);
         runtimeError(interpreter, "未知的前缀运算符。");
@@ -1,56 +1,90 @@
+#include <limits.h>
 #include "lexer.h"
-
-// 关键字查找结构
-typedef struct
-{
-    const char *keyword;
-    int length;
-    TokenType type;
-} Keyword;
-
-// 关键字表
-static Keyword keywords[] = {
-    {"if", 2, TOKEN_IF},
-    {"else", 4, TOKEN_ELSE},
-    {"in", 2, TOKEN_IN},
-    {"while", 5, TOKEN_WHILE},
-    {"for", 3, TOKEN_FOR},
-    {"do", 2, TOKEN_DO},
-    {"return", 6, TOKEN_RETURN},
-    {"function", 8, TOKEN_FUNCTION},
-    {"var", 3, TOKEN_VAR},
-    {"switch", 6, TOKEN_SWITCH},
-    {"case", 4, TOKEN_CASE},
-    {"default", 7, TOKEN_DEFAULT},
-    {"break", 5, TOKEN_BREAK},
-    {"const", 5, TOKEN_CONST},
-    {"static", 6, TOKEN_STATIC},
-    {"void", 4, TOKEN_VOID},
-    {"int", 3, TOKEN_INT},
-    {"float", 5, TOKEN_FLOAT_TYPE},
-    {"double", 6, TOKEN_DOUBLE},
-    {"string", 6, TOKEN_STRING_TYPE},
-    {"bool", 4, TOKEN_BOOL},
-    {"import", 6, TOKEN_IMPORT},
-    {"null", 4, TOKEN_NULL},
-    {"true", 4, TOKEN_TRUE},
-    {"false", 5, TOKEN_FALSE},
-    {"enum", 4, TOKEN_ENUM},
-    {"struct", 6, TOKEN_STRUCT},
-    {NULL, 0, TOKEN_ERROR} // 表结束标记
+#include "numeric_conversion.h"
+#include "simd_kernels.h"
+
+// 文本固定的标记直接引用这些静态字符串，不再为每个标记分配内存
+static const char *const fixedLexemes[TOKEN_ERROR + 1] = {
+    [TOKEN_EOF] = "",
+    [TOKEN_PLUS] = "+",
+    [TOKEN_MINUS] = "-",
+    [TOKEN_PLUS_PLUS] = "++",
+    [TOKEN_MINUS_MINUS] = "--",
+    [TOKEN_MULTIPLY] = "*",
+    [TOKEN_DIVIDE] = "/",
+    [TOKEN_MODULO] = "%",
+    [TOKEN_ASSIGN] = "=",
+    [TOKEN_PLUS_ASSIGN] = "+=",
+    [TOKEN_MINUS_ASSIGN] = "-=",
+    [TOKEN_MULTIPLY_ASSIGN] = "*=",
+    [TOKEN_DIVIDE_ASSIGN] = "/=",
+    [TOKEN_MODULO_ASSIGN] = "%=",
+    [TOKEN_EQ] = "==",
+    [TOKEN_NE] = "!=",
+    [TOKEN_LT] = "<",
+    [TOKEN_LE] = "<=",
+    [TOKEN_GT] = ">",
+    [TOKEN_GE] = ">=",
+    [TOKEN_NOT] = "!",
+    [TOKEN_AND] = "&&",
+    [TOKEN_OR] = "||",
+    [TOKEN_LPAREN] = "(",
+    [TOKEN_RPAREN] = ")",
+    [TOKEN_LBRACE] = "{",
+    [TOKEN_RBRACE] = "}",
+    [TOKEN_LBRACKET] = "[",
+    [TOKEN_RBRACKET] = "]",
+    [TOKEN_SEMICOLON] = ";",
+    [TOKEN_COMMA] = ",",
+    [TOKEN_COLON] = ":",
+    [TOKEN_DOT] = ".",
+    [TOKEN_IF] = "if",
+    [TOKEN_ELSE] = "else",
+    [TOKEN_IN] = "in",
+    [TOKEN_WHILE] = "while",
+    [TOKEN_FOR] = "for",
+    [TOKEN_RETURN] = "return",
+    [TOKEN_FUNCTION] = "function",
+    [TOKEN_VAR] = "var",
+    [TOKEN_VOID] = "void",
+    [TOKEN_INT] = "int",
+    [TOKEN_FLOAT_TYPE] = "float",
+    [TOKEN_DOUBLE] = "double",
+    [TOKEN_STRING_TYPE] = "string",
+    [TOKEN_BOOL] = "bool",
+    [TOKEN_CONST] = "const",
+    [TOKEN_STATIC] = "static",
+    [TOKEN_SWITCH] = "switch",
+    [TOKEN_CASE] = "case",
+    [TOKEN_DEFAULT] = "default",
+    [TOKEN_DO] = "do",
+    [TOKEN_BREAK] = "break",
+    [TOKEN_IMPORT] = "import",
+    [TOKEN_NULL] = "null",
+    [TOKEN_TRUE] = "true",
+    [TOKEN_FALSE] = "false",
+    [TOKEN_ENUM] = "enum",
+    [TOKEN_STRUCT] = "struct",
+    [TOKEN_YIELD] = "yield",
 };
 
+// 标记文本内存块的默认大小，更长的字符串单独分配
+#define LEXEME_BLOCK_SIZE (64 * 1024)
+
 // 静态函数前向声明
 static int isAtEnd(Lexer *lexer);
+static size_t remaining(Lexer *lexer);
 static char advance(Lexer *lexer);
 static char peek(Lexer *lexer);
 static char peekNext(Lexer *lexer);
 static int match(Lexer *lexer, char expected);
 static void skipWhitespaceAndComments(Lexer *lexer);
+static char *allocateText(Lexer *lexer, size_t size);
 static Token makeToken(Lexer *lexer, TokenType type);
 static Token errorToken(Lexer *lexer, const char *message);
 static int isAlpha(char c);
 static int isDigit(char c);
+static TokenType keywordType(const char *start, int length);
 static Token identifier(Lexer *lexer);
 static Token number(Lexer *lexer);
 static Token string(Lexer *lexer);
@@ -60,40 +94,39 @@ void initLexer(Lexer *lexer, const char *source)
 {
     lexer->source = source;
     lexer->current = source;
+    lexer->end = source + strlen(source);
     lexer->line = 1;
+    lexer->text = NULL;
 }
 
 /**
  * @brief 执行词法分析，将源代码转换为令牌序列
  *
- * 此函数对输入的源代码进行词法分析，生成令牌数组。函数会自动管理内存，
- * 当令牌数量超过初始容量时会动态扩展数组大小。
+ * 令牌数组的初始容量按源代码长度估计，通常一次分配即可容纳全部令牌。
+ * 令牌的 lexeme 和字符串值指向 list->text 中的内存块或静态字符串，不单独分配。
  *
  * @param source 待分析的源代码字符串，必须以null结尾
- * @param tokenCount 输出参数，用于返回生成的令牌数量
+ * @param list 输出参数，成功时保存令牌数组、令牌数量和令牌文本
  *
- * @return Token* 返回令牌数组的指针，调用者负责释放内存；
- *                如果内存分配失败则返回NULL
+ * @return bool 成功返回 true；内存分配失败时清理已分配的资源，list 置空并返回 false
  *
  * @note 返回的令牌数组包含源代码的所有令牌，包括最后的EOF令牌
- * @note 如果函数执行失败，*tokenCount将被设置为0
- * @note 调用者需要负责释放返回的令牌数组以及数组中每个令牌的内存
- *
- * @warning 如果内存分配失败，函数会自动清理已分配的资源
+ * @note 调用者用 freeTokenList 释放令牌数组和令牌文本
  */
-Token *performLexicalAnalysis(const char *source, int *tokenCount)
+bool performLexicalAnalysis(const char *source, TokenList *list)
 {
     Lexer lexer;
     initLexer(&lexer, source);
+    memset(list, 0, sizeof(*list));
 
-    // 分配初始令牌数组
-    int capacity = 100;
-    Token *tokens = malloc(sizeof(Token) * capacity);
+    // 令牌连同其后的空白平均占 5 个字符左右，按此预估容量
+    size_t estimate = (size_t)(lexer.end - source) / 5 + 16;
+    int capacity = estimate < INT_MAX / 2 ? (int)estimate : INT_MAX / 2;
+    Token *tokens = malloc(sizeof(Token) * (size_t)capacity);
     if (tokens == NULL)
     {
         fprintf(stderr, "内存分配失败\n");
-        *tokenCount = 0;
-        return NULL;
+        return false;
     }
 
     int count = 0;
@@ -106,27 +139,25 @@ Token *performLexicalAnalysis(const char *source, int *tokenCount)
         // 检查是否需要扩展数组
         if (count >= capacity)
         {
-            capacity *= 2;
-            Token *newTokens = realloc(tokens, sizeof(Token) * capacity);
+            Token *newTokens = capacity <= INT_MAX / 2 ? realloc(tokens, sizeof(Token) * (size_t)capacity * 2) : NULL;
             if (newTokens == NULL)
             {
                 fprintf(stderr, "内存重新分配失败\n");
-                for (int i = 0; i < count; i++)
-                {
-                    freeToken(&tokens[i]);
-                }
                 free(tokens);
-                *tokenCount = 0;
-                return NULL;
+                freeLexemeBlocks(lexer.text);
+                return false;
             }
+            capacity *= 2;
             tokens = newTokens;
         }
 
         tokens[count++] = token;
     } while (token.type != TOKEN_EOF);
 
-    *tokenCount = count;
-    return tokens;
+    list->tokens = tokens;
+    list->count = count;
+    list->text = lexer.text;
+    return true;
 }
 
 // 检查是否到达源代码末尾
@@ -167,6 +198,12 @@ static int match(Lexer *lexer, char expected)
     return 1;
 }
 
+// 当前位置到源代码末尾的字节数
+static size_t remaining(Lexer *lexer)
+{
+    return (size_t)(lexer->end - lexer->current);
+}
+
 /**
  * 跳过词法分析器当前位置的空白字符和注释
  *
@@ -176,6 +213,9 @@ static int match(Lexer *lexer, char expected)
  * - 单行注释
  * - 多行注释
  *
+ * 空白、单行注释和多行注释的正文都交给文本扫描核函数成段跳过（见 simd_kernels.h），
+ * 不再逐个字符调用 advance。
+ *
  * @param lexer 指向词法分析器结构的指针
  *
  * @note 函数会自动处理嵌套在多行注释中的换行符，正确维护行号计数
@@ -186,90 +226,135 @@ static void skipWhitespaceAndComments(Lexer *lexer)
 {
     for (;;)
     {
-        char c = peek(lexer);
-
-        switch (c)
+        // 标记之间最常见的是单个空格，直接跳过；换行和缩进等更长的空白才交给核函数
+        if (peek(lexer) == ' ')
         {
-        case ' ':
-        case '\r':
-        case '\t':
             advance(lexer);
-            break;
+        }
+        char c = peek(lexer);
+        if (c == ' ' || c == '\n' || c == '\t' || c == '\r')
+        {
+            lexer->current += whitespaceRun(lexer->current, remaining(lexer), &lexer->line);
+        }
 
-        case '\n':
-            lexer->line++;
-            advance(lexer);
-            break;
+        if (peek(lexer) != '/')
+        {
+            return;
+        }
 
-        case '/':
-            if (peekNext(lexer) == '/')
+        if (peekNext(lexer) == '/')
+        {
+            // 单行注释，跳到行尾，换行符在下一轮计入行号
+            lexer->current += findEitherByte(lexer->current, remaining(lexer), '\n', '\n');
+        }
+        else if (peekNext(lexer) == '*')
+        {
+            // 多行注释：逐段跳到下一个 '*' 或换行符
+            lexer->current += 2;
+            for (;;)
             {
-                // 单行注释，跳过整行
-                while (peek(lexer) != '\n' && !isAtEnd(lexer))
+                lexer->current += findEitherByte(lexer->current, remaining(lexer), '*', '\n');
+                if (isAtEnd(lexer))
                 {
-                    advance(lexer);
+                    break;
                 }
-            }
-            else if (peekNext(lexer) == '*')
-            {
-                // 多行注释
-                advance(lexer); // 跳过 '/'
-                advance(lexer); // 跳过 '*'
-
-                while (!isAtEnd(lexer) && !(peek(lexer) == '*' && peekNext(lexer) == '/'))
+                if (peek(lexer) == '\n')
                 {
-                    if (peek(lexer) == '\n')
-                        lexer->line++;
-                    advance(lexer);
+                    lexer->line++;
                 }
-
-                if (!isAtEnd(lexer))
+                else if (peekNext(lexer) == '/')
                 {
-                    advance(lexer); // 跳过 '*'
-                    advance(lexer); // 跳过 '/'
+                    lexer->current += 2; // 跳过 "*/"
+                    break;
                 }
+                advance(lexer);
             }
-            else
-            {
-                return; // 这是除法运算符，不是注释
-            }
-            break;
-
-        default:
-            return;
+        }
+        else
+        {
+            return; // 这是除法运算符，不是注释
         }
     }
 }
 
+/**
+ * 在标记文本内存块中分配 size 字节
+ *
+ * 当前内存块剩余空间不足时分配新块。超过默认块大小的请求单独成块，
+ * 挂在当前块之后，当前块剩余的空间仍留给后续的短文本。
+ *
+ * @param lexer 词法分析器，其 text 链表的第一个块为当前块
+ * @param size 需要的字节数
+ * @return 分配到的内存；内存分配失败时返回NULL
+ */
+static char *allocateText(Lexer *lexer, size_t size)
+{
+    LexemeBlock *block = lexer->text;
+    if (block != NULL && block->capacity - block->used >= size)
+    {
+        char *text = block->data + block->used;
+        block->used += size;
+        return text;
+    }
+
+    size_t capacity = size > LEXEME_BLOCK_SIZE ? size : LEXEME_BLOCK_SIZE;
+    LexemeBlock *newBlock = (LexemeBlock *)malloc(sizeof(LexemeBlock) + capacity);
+    if (newBlock == NULL)
+    {
+        return NULL;
+    }
+    newBlock->capacity = capacity;
+    newBlock->used = size;
+    if (capacity > LEXEME_BLOCK_SIZE && block != NULL)
+    {
+        newBlock->next = block->next;
+        block->next = newBlock;
+    }
+    else
+    {
+        newBlock->next = block;
+        lexer->text = newBlock;
+    }
+    return newBlock->data;
+}
+
 /**
  * 创建一个新的词法单元(Token)
  *
- * 此函数根据给定的词法分析器状态和词法单元类型创建一个新的Token。
- * 它会计算从源码起始位置到当前位置的词素长度，分配内存来存储词素字符串，
- * 并设置相应的行号信息。函数执行完毕后会重置词法分析器的源码指针。
+ * 关键字、运算符和EOF的词素指向静态字符串；标识符和数字的词素
+ * （从标记起始位置到当前位置）复制到标记文本内存块中并以'\0'结尾。
+ * 函数执行完毕后会把标记起始位置重置为当前位置。
  *
  * @param lexer 指向词法分析器结构体的指针，包含当前解析状态
  * @param type 要创建的词法单元类型
- * @return 返回创建的Token结构体，包含类型、词素字符串和行号信息
+ * @return 返回创建的Token结构体；内存分配失败时返回错误Token
  *
- * @note 调用者需要负责释放返回Token中lexeme字段分配的内存
- * @warning 确保lexer->current >= lexer->source，否则可能导致未定义行为
+ * @note 词素的内存随词法分析器的标记文本一同释放，调用者不单独释放
  */
 static Token makeToken(Lexer *lexer, TokenType type)
 {
     Token token;
     token.type = type;
-
-    // 计算词素长度并复制
-    int length = lexer->current - lexer->source;
-
-    // 分配内存并复制词素
-    token.lexeme = (char *)malloc(length + 1);
-    strncpy(token.lexeme, lexer->source, length);
-    token.lexeme[length] = '\0';
-
-    // 保存行号信息
     token.line = lexer->line;
+    token.value.intValue = 0;
+
+    const char *fixed = fixedLexemes[type];
+    if (fixed != NULL)
+    {
+        token.lexeme = (char *)fixed;
+    }
+    else
+    {
+        size_t length = (size_t)(lexer->current - lexer->source);
+        token.lexeme = allocateText(lexer, length + 1);
+        if (token.lexeme == NULL)
+        {
+            lexer->source = lexer->current;
+            return errorToken(lexer, "Memory allocation failed.");
+        }
+        memcpy(token.lexeme, lexer->source, length);
+        token.lexeme[length] = '\0';
+    }
 
     // 重置源指针为当前位置
     lexer->source = lexer->current;
@@ -284,25 +369,16 @@ static Token makeToken(Lexer *lexer, TokenType type)
  * 该Token包含错误类型、错误消息和出错的行号信息。
  *
  * @param lexer 指向词法分析器实例的指针，用于获取当前行号
- * @param message 错误消息字符串，描述具体的错误信息
+ * @param message 错误消息字符串，必须是静态字符串，Token的lexeme直接指向它
  * @return Token 返回一个类型为TOKEN_ERROR的Token结构体
- *
- * @note 函数会为错误消息分配内存，调用者需要确保在适当时候释放Token中的lexeme内存
- * @warning 如果内存分配失败，token.lexeme将为NULL
  */
 static Token errorToken(Lexer *lexer, const char *message)
 {
     Token token;
     token.type = TOKEN_ERROR;
-
-    size_t messageLen = strlen(message);
-    token.lexeme = (char *)malloc(messageLen + 1);
-    if (token.lexeme != NULL)
-    {
-        strcpy(token.lexeme, message);
-    }
-
+    token.lexeme = (char *)message;
     token.line = lexer->line;
+    token.value.intValue = 0;
 
     return token;
 }
@@ -321,33 +397,118 @@ static int isDigit(char c)
     return c >= '0' && c <= '9';
 }
 
-// 处理标识符和关键字
-static Token identifier(Lexer *lexer)
+// 长度与关键字相同的标识符，其余字符也相同时为该关键字
+static TokenType checkKeyword(const char *start, int length, const char *keyword, TokenType type)
 {
-    // 记录起始位置
-    const char *start = lexer->current - 1; // 退回一个字符，刚刚被advance消费掉的字符
-
-    while (isAlpha(peek(lexer)) || isDigit(peek(lexer)))
-    {
-        advance(lexer);
-    }
-
-    // 计算标识符长度
-    int length = lexer->current - start;
+    return memcmp(start, keyword, (size_t)length) == 0 ? type : TOKEN_IDENTIFIER;
+}
 
-    // 检查是否为关键字
-    for (int i = 0; keywords[i].keyword != NULL; i++)
+/**
+ * 判断标识符是否为关键字
+ *
+ * 先按长度、再按首字符分支（首字符相同时再看另一个能区分它们的字符），
+ * 每个标识符最多与一个关键字比较。增加关键字时在对应长度下补充分支。
+ *
+ * @return 关键字的标记类型，不是关键字时返回 TOKEN_IDENTIFIER
+ */
+static TokenType keywordType(const char *start, int length)
+{
+    switch (length)
     {
-        if (length == keywords[i].length &&
-            strncmp(start, keywords[i].keyword, length) == 0)
+    case 2:
+        switch (start[0])
+        {
+        case 'i':
+            return start[1] == 'f' ? TOKEN_IF : start[1] == 'n' ? TOKEN_IN : TOKEN_IDENTIFIER;
+        case 'd':
+            return checkKeyword(start, length, "do", TOKEN_DO);
+        }
+        break;
+    case 3:
+        switch (start[0])
+        {
+        case 'f':
+            return checkKeyword(start, length, "for", TOKEN_FOR);
+        case 'v':
+            return checkKeyword(start, length, "var", TOKEN_VAR);
+        case 'i':
+            return checkKeyword(start, length, "int", TOKEN_INT);
+        }
+        break;
+    case 4:
+        switch (start[0])
+        {
+        case 'e':
+            return start[1] == 'l' ? checkKeyword(start, length, "else", TOKEN_ELSE)
+                                   : checkKeyword(start, length, "enum", TOKEN_ENUM);
+        case 'c':
+            return checkKeyword(start, length, "case", TOKEN_CASE);
+        case 'v':
+            return checkKeyword(start, length, "void", TOKEN_VOID);
+        case 'b':
+            return checkKeyword(start, length, "bool", TOKEN_BOOL);
+        case 'n':
+            return checkKeyword(start, length, "null", TOKEN_NULL);
+        case 't':
+            return checkKeyword(start, length, "true", TOKEN_TRUE);
+        }
+        break;
+    case 5:
+        switch (start[0])
         {
-            // 匹配到关键字
-            return makeToken(lexer, keywords[i].type);
+        case 'w':
+            return checkKeyword(start, length, "while", TOKEN_WHILE);
+        case 'b':
+            return checkKeyword(start, length, "break", TOKEN_BREAK);
+        case 'c':
+            return checkKeyword(start, length, "const", TOKEN_CONST);
+        case 'f':
+            return start[1] == 'l' ? checkKeyword(start, length, "float", TOKEN_FLOAT_TYPE)
+                                   : checkKeyword(start, length, "false", TOKEN_FALSE);
+        case 'y':
+            return checkKeyword(start, length, "yield", TOKEN_YIELD);
         }
+        break;
+    case 6:
+        switch (start[0])
+        {
+        case 'r':
+            return checkKeyword(start, length, "return", TOKEN_RETURN);
+        case 'd':
+            return checkKeyword(start, length, "double", TOKEN_DOUBLE);
+        case 'i':
+            return checkKeyword(start, length, "import", TOKEN_IMPORT);
+        case 's':
+            // switch、static、string、struct 的末字符各不相同
+            switch (start[5])
+            {
+            case 'h':
+                return checkKeyword(start, length, "switch", TOKEN_SWITCH);
+            case 'c':
+                return checkKeyword(start, length, "static", TOKEN_STATIC);
+            case 'g':
+                return checkKeyword(start, length, "string", TOKEN_STRING_TYPE);
+            case 't':
+                return checkKeyword(start, length, "struct", TOKEN_STRUCT);
+            }
+            break;
+        }
+        break;
+    case 7:
+        return checkKeyword(start, length, "default", TOKEN_DEFAULT);
+    case 8:
+        return checkKeyword(start, length, "function", TOKEN_FUNCTION);
     }
+    return TOKEN_IDENTIFIER;
+}
+
+// 处理标识符和关键字：首字符已被 advance 消费，其余的标识符字符成段跳过
+static Token identifier(Lexer *lexer)
+{
+    lexer->current += identifierRun(lexer->current, remaining(lexer));
 
-    // 不是关键字，就是普通标识符
-    return makeToken(lexer, TOKEN_IDENTIFIER);
+    int length = (int)(lexer->current - lexer->source);
+    return makeToken(lexer, keywordType(lexer->source, length));
 }
 
 // 处理数字（整数和浮点数）
@@ -368,21 +529,63 @@ static Token number(Lexer *lexer)
             advance(lexer);
         }
 
-        Token token = makeToken(lexer, TOKEN_FLOAT);
-        token.value.floatValue = atof(token.lexeme);
+    }
+
+    // 在词法分析阶段就完成数值转换，求值时直接使用标记中的值
+    ParsedNumber parsed;
+    size_t length = (size_t)(lexer->current - lexer->source);
+    if (parseNumber(lexer->source, length, &parsed) != NUMBER_PARSE_OK)
+    {
+        lexer->source = lexer->current;
+        return errorToken(lexer, "Invalid number literal.");
+    }
+
+    if (parsed.isInteger)
+    {
+        Token token = makeToken(lexer, TOKEN_INTEGER);
+        token.value.intValue = parsed.integer;
         return token;
     }
 
-    Token token = makeToken(lexer, TOKEN_INTEGER);
-    token.value.intValue = atoi(token.lexeme);
+    // 小数，或超出 int64 范围的整数
+    Token token = makeToken(lexer, TOKEN_FLOAT);
+    token.value.floatValue = parsed.number;
     return token;
 }
 
+// 转义序列 \c 表示的字符；未知转义序列保持原样
+static char escapedChar(char c)
+{
+    switch (c)
+    {
+    case 'n':
+        return '\n';
+    case 't':
+        return '\t';
+    case 'r':
+        return '\r';
+    case '0':
+        return '\0';
+    case 'b':
+        return '\b'; // 退格符
+    case 'f':
+        return '\f'; // 换页符
+    case 'v':
+        return '\v'; // 垂直制表符
+    case 'a':
+        return '\a'; // 响铃符
+    default:
+        return c; // 包括 \\、\" 和 \/
+    }
+}
+
 /**
  * 解析字符串字面量
  *
  * 从当前位置开始解析一个由双引号包围的字符串字面量，支持标准的转义序列。
- * 函数会动态分配内存来存储解析后的字符串内容，并处理各种转义字符。
+ * 先逐段跳过引号和反斜杠以外的字符找到结束的引号，再在标记文本内存块中一次分配词素和字符串值：
+ * 词素是包括引号的原始文本；字符串值是去掉引号、处理转义后的内容，
+ * 其长度不超过原始文本，没有转义时直接复制。
  *
  * 支持的转义序列：
  * - \n: 换行符
@@ -401,141 +604,74 @@ static Token number(Lexer *lexer)
  * @param lexer 词法分析器指针，包含当前解析状态
  * @return Token 返回字符串类型的token，如果解析失败则返回错误token
  *
- * @note 函数会为字符串内容分配内存，调用者需要负责释放token.value.stringValue
+ * @note 字符串值随词法分析器的标记文本一同释放
  * @note 如果遇到未终止的字符串或内存分配失败，会返回相应的错误token
- * @note 初始缓冲区大小为256字节，根据需要自动扩展
  */
 static Token string(Lexer *lexer)
 {
+    const char *content = lexer->current;
+    bool escaped = false;
 
-    // 分配缓冲区
-    int bufferSize = 256;
-    char *buffer = malloc(bufferSize);
-    if (buffer == NULL)
-    {
-        return errorToken(lexer, "Memory allocation failed.");
-    }
-
-    int bufferPos = 0;
-
-    while (peek(lexer) != '"' && !isAtEnd(lexer))
+    // 成段跳到下一个引号或反斜杠
+    for (;;)
     {
-        char c = peek(lexer);
-
-        if (c == '\\')
+        lexer->current += findEitherByte(lexer->current, remaining(lexer), '"', '\\');
+        if (isAtEnd(lexer))
         {
-            // 处理转义字符
-            advance(lexer); // 跳过反斜杠
-
-            if (isAtEnd(lexer))
-            {
-                free(buffer);
-                return errorToken(lexer, "Unterminated string escape sequence.");
-            }
-
-            char escaped = advance(lexer);
-            char actualChar;
-
-            switch (escaped)
-            {
-            case 'n':
-                actualChar = '\n';
-                break;
-            case 't':
-                actualChar = '\t';
-                break;
-            case 'r':
-                actualChar = '\r';
-                break;
-            case '\\':
-                actualChar = '\\';
-                break;
-            case '"':
-                actualChar = '"';
-                break;
-            case '0':
-                actualChar = '\0';
-                break;
-            case 'b':
-                actualChar = '\b'; // 退格符
-                break;
-            case 'f':
-                actualChar = '\f'; // 换页符
-                break;
-            case 'v':
-                actualChar = '\v'; // 垂直制表符
-                break;
-            case 'a':
-                actualChar = '\a'; // 响铃符
-                break;
-            case '/':
-                actualChar = '/'; // 斜杠
-                break;
-            default:
-                // 未知转义序列，保持原样
-                actualChar = escaped;
-                break;
-            }
-
-            // 确保缓冲区足够大
-            if (bufferPos >= bufferSize - 1)
-            {
-                bufferSize *= 2;
-                char *newBuffer = realloc(buffer, bufferSize);
-                if (newBuffer == NULL)
-                {
-                    free(buffer);
-                    return errorToken(lexer, "Memory allocation failed.");
-                }
-                buffer = newBuffer;
-            }
-
-            buffer[bufferPos++] = actualChar;
+            return errorToken(lexer, "Unterminated string.");
         }
-        else
+        if (peek(lexer) == '"')
         {
-            // 普通字符
-            if (bufferPos >= bufferSize - 1)
-            {
-                bufferSize *= 2;
-                char *newBuffer = realloc(buffer, bufferSize);
-                if (newBuffer == NULL)
-                {
-                    free(buffer);
-                    return errorToken(lexer, "Memory allocation failed.");
-                }
-                buffer = newBuffer;
-            }
+            break;
+        }
 
-            buffer[bufferPos++] = advance(lexer);
+        advance(lexer); // 跳过反斜杠
+        if (isAtEnd(lexer))
+        {
+            return errorToken(lexer, "Unterminated string escape sequence.");
         }
+        advance(lexer);
+        escaped = true;
     }
 
-    if (isAtEnd(lexer))
-    {
-        free(buffer);
-        return errorToken(lexer, "Unterminated string.");
-    }
+    size_t contentLength = (size_t)(lexer->current - content);
 
     // 消耗结束的引号
     advance(lexer);
 
-    // 添加字符串结束符
-    buffer[bufferPos] = '\0';
-
-    // 创建 token
-    Token token = makeToken(lexer, TOKEN_STRING);
-
-    // 复制处理后的字符串到 value.stringValue
-    token.value.stringValue = malloc(strlen(buffer) + 1);
-    if (token.value.stringValue != NULL)
+    size_t length = (size_t)(lexer->current - lexer->source);
+    char *text = allocateText(lexer, length + 1 + contentLength + 1);
+    if (text == NULL)
     {
-        strcpy(token.value.stringValue, buffer);
+        lexer->source = lexer->current;
+        return errorToken(lexer, "Memory allocation failed.");
     }
+    memcpy(text, lexer->source, length);
+    text[length] = '\0';
 
-    // 释放临时缓冲区
-    free(buffer);
+    char *value = text + length + 1;
+    if (!escaped)
+    {
+        memcpy(value, content, contentLength);
+        value[contentLength] = '\0';
+    }
+    else
+    {
+        size_t valueLength = 0;
+        for (size_t i = 0; i < contentLength; i++)
+        {
+            char c = content[i];
+            value[valueLength++] = c == '\\' ? escapedChar(content[++i]) : c;
+        }
+        value[valueLength] = '\0';
+    }
 
+    Token token;
+    token.type = TOKEN_STRING;
+    token.lexeme = text;
+    token.line = lexer->line;
+    token.value.stringValue = value;
+    lexer->source = lexer->current;
     return token;
 }
 
@@ -546,7 +682,7 @@ static Token string(Lexer *lexer)
  * - 标识符和关键字
  * - 数字字面量
  * - 单字符操作符：括号、分隔符、算术运算符等
- * - 双字符操作符：++、--、==、!=、<=、>=、&&、||
+ * - 双字符操作符：++、--、==、!=、<=、>=、&&、||、+=、-=、*=、/=、%=
  * - 字符串字面量
  * - 文件结束标记
  *
@@ -616,19 +752,27 @@ Token nextToken(Lexer *lexer)
         {
             return makeToken(lexer, TOKEN_PLUS_PLUS);
         }
+        if (match(lexer, '='))
+        {
+            return makeToken(lexer, TOKEN_PLUS_ASSIGN);
+        }
         return makeToken(lexer, TOKEN_PLUS);
     case '-':
         if (match(lexer, '-'))
         {
             return makeToken(lexer, TOKEN_MINUS_MINUS);
         }
+        if (match(lexer, '='))
+        {
+            return makeToken(lexer, TOKEN_MINUS_ASSIGN);
+        }
         return makeToken(lexer, TOKEN_MINUS);
     case '*':
-        return makeToken(lexer, TOKEN_MULTIPLY);
+        return makeToken(lexer, match(lexer, '=') ? TOKEN_MULTIPLY_ASSIGN : TOKEN_MULTIPLY);
     case '/':
-        return makeToken(lexer, TOKEN_DIVIDE);
+        return makeToken(lexer, match(lexer, '=') ? TOKEN_DIVIDE_ASSIGN : TOKEN_DIVIDE);
     case '%':
-        return makeToken(lexer, TOKEN_MODULO);
+        return makeToken(lexer, match(lexer, '=') ? TOKEN_MODULO_ASSIGN : TOKEN_MODULO);
 
     // 可能是单字符或双字符的标记
     case '=':
@@ -659,34 +803,23 @@ Token nextToken(Lexer *lexer)
     return errorToken(lexer, "Unexpected character.");
 }
 
-/**
- * 释放Token结构体及其相关内存
- *
- * 此函数负责安全地释放Token结构体中动态分配的内存，包括词素(lexeme)
- * 和字符串类型的值。函数会检查指针的有效性，防止重复释放或空指针访问。
- *
- * @param token 指向要释放的Token结构体的指针，可以为NULL
- *
- * @note 函数会将释放后的指针设置为NULL，防止悬空指针
- * @note 对于字符串类型的token，会额外释放其字符串值的内存
- * @note 传入NULL指针是安全的，函数会直接返回
- */
-void freeToken(Token *token)
+// 释放标记文本的全部内存块；此后指向其中的 lexeme 和字符串值都不再有效
+void freeLexemeBlocks(LexemeBlock *blocks)
 {
-    if (token == NULL)
-        return;
-
-    if (token->lexeme != NULL)
+    while (blocks != NULL)
     {
-        free(token->lexeme);
-        token->lexeme = NULL;
+        LexemeBlock *next = blocks->next;
+        free(blocks);
+        blocks = next;
     }
+}
 
-    if (token->type == TOKEN_STRING && token->value.stringValue != NULL)
-    {
-        free(token->value.stringValue);
-        token->value.stringValue = NULL;
-    }
+// 释放词法分析的结果并把 list 置空
+void freeTokenList(TokenList *list)
+{
+    free(list->tokens);
+    freeLexemeBlocks(list->text);
+    memset(list, 0, sizeof(*list));
 }
 
 // 获取标记类型的字符串表示
@@ -716,6 +849,16 @@ const char *getTokenName(TokenType type)
         return "MODULO";
     case TOKEN_ASSIGN:
         return "ASSIGN";
+    case TOKEN_PLUS_ASSIGN:
+        return "PLUS_ASSIGN";
+    case TOKEN_MINUS_ASSIGN:
+        return "MINUS_ASSIGN";
+    case TOKEN_MULTIPLY_ASSIGN:
+        return "MULTIPLY_ASSIGN";
+    case TOKEN_DIVIDE_ASSIGN:
+        return "DIVIDE_ASSIGN";
+    case TOKEN_MODULO_ASSIGN:
+        return "MODULO_ASSIGN";
     case TOKEN_EQ:
         return "EQUAL";
     case TOKEN_NE:
@@ -796,6 +939,8 @@ const char *getTokenName(TokenType type)
         return "BREAK";
     case TOKEN_IN:
         return "IN";
+    case TOKEN_YIELD:
+        return "YIELD";
     case TOKEN_NULL:
         return "NULL";
     case TOKEN_TRUE:
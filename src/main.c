@@ -1,10 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "lexer.h"
 #include "parser.h"
 #include "interpreter.h"
 #include "file_utils.h"
+#include "server.h"
+#include "program_cache.h"
 
 /**
  * 执行程序语句
@@ -14,85 +17,140 @@
  * 
  * @param statements 指向语句指针数组的指针，包含要执行的所有语句
  * @param stmtCount 语句数组中语句的数量
+ * @param explicitStack 是否使用显式栈求值器
+ * @param maxCallDepth 最大调用深度
+ * @param timeLimit 执行时间上限（秒），0 表示不限时
+ * @param scriptArgs 脚本路径之后的命令行参数，由 args() 返回
+ * @param scriptArgCount 脚本参数的数量
+ * @return 没有发生运行时错误时返回 true
  * 
  * @note 如果在执行过程中发生运行时错误，错误信息将输出到stderr
  * @note 函数会自动管理解释器的生命周期，包括初始化和资源释放
  */
-void executeProgram(Stmt **statements, int stmtCount)
+bool executeProgram(Stmt **statements, int stmtCount, bool explicitStack, int maxCallDepth, int timeLimit,
+					char **scriptArgs, int scriptArgCount)
 {
 	Interpreter interpreter;
 	initInterpreter(&interpreter);
+	interpreter.explicitStack = explicitStack;
+	interpreter.maxCallDepth = maxCallDepth;
+	interpreter.scriptArgs = scriptArgs;
+	interpreter.scriptArgCount = scriptArgCount;
+	setTimeLimit(&interpreter, timeLimit * 1000);
 
 	// 执行程序
 	interpret(&interpreter, statements, stmtCount);
 
 	// 检查是否有运行时错误
-	if (hadInterpreterError(&interpreter))
+	bool succeeded = !hadInterpreterError(&interpreter);
+	if (!succeeded)
 	{
 		fprintf(stderr, "Runtime error: %s\n", getInterpreterError(&interpreter));
 	}
 
 	// 释放解释器资源
 	freeInterpreter(&interpreter);
+	return succeeded;
+}
+
+static void printUsage(void)
+{
+	printf("Usage: sparrow [--explicit-stack] [--max-depth=N] [--time-limit=S] [--no-cache] [--lazy] script [args...]\n");
+	printf("       sparrow [--explicit-stack] [--max-depth=N] [--time-limit=S] [--no-cache] [--lazy] --serve socket\n");
 }
 
 int main(int argc, char *argv[])
 {
-	if (argc < 2)
+	// 解析脚本路径之前的选项
+	bool explicitStack = false;
+	int maxCallDepth = DEFAULT_MAX_CALL_DEPTH;
+	int timeLimit = -1; // 未指定时命令行不限时，常驻模式使用 SERVER_DEFAULT_TIME_LIMIT
+	bool useCache = true;
+	bool lazyFunctions = false;
+	const char *socketPath = NULL;
+	int argIndex = 1;
+	for (; argIndex < argc && strncmp(argv[argIndex], "--", 2) == 0; argIndex++)
 	{
-		printf("Usage: sparrow [script]\n");
-		return 1;
+		const char *option = argv[argIndex];
+		if (strcmp(option, "--explicit-stack") == 0)
+		{
+			explicitStack = true;
+		}
+		else if (strncmp(option, "--max-depth=", 12) == 0)
+		{
+			char *end;
+			long depth = strtol(option + 12, &end, 10);
+			if (end == option + 12 || *end != '\0' || depth < 1 || depth > INT_MAX)
+			{
+				printf("Invalid max depth '%s'\n", option + 12);
+				return 1;
+			}
+			maxCallDepth = (int)depth;
+		}
+		else if (strncmp(option, "--time-limit=", 13) == 0)
+		{
+			char *end;
+			long seconds = strtol(option + 13, &end, 10);
+			if (end == option + 13 || *end != '\0' || seconds < 0 || seconds > INT_MAX / 1000)
+			{
+				printf("Invalid time limit '%s'\n", option + 13);
+				return 1;
+			}
+			timeLimit = (int)seconds;
+		}
+		else if (strcmp(option, "--no-cache") == 0)
+		{
+			useCache = false;
+		}
+		else if (strcmp(option, "--lazy") == 0)
+		{
+			lazyFunctions = true;
+		}
+		else if (strcmp(option, "--serve") == 0 && argIndex + 1 < argc)
+		{
+			socketPath = argv[++argIndex];
+		}
+		else
+		{
+			printf("Unknown option '%s'\n", option);
+			printUsage();
+			return 1;
+		}
 	}
 
-	// 读取源代码文件
-	char *source = readFile(argv[1]);
-	if (source == NULL)
+	// 常驻模式：在套接字上接受运行请求
+	if (socketPath != NULL)
 	{
-		printf("Could not read file '%s'\n", argv[1]);
-		return 1;
+		ServerOptions options = {explicitStack, maxCallDepth, useCache, lazyFunctions,
+								 timeLimit >= 0 ? timeLimit : SERVER_DEFAULT_TIME_LIMIT};
+		return runServer(socketPath, &options);
 	}
 
-	// 执行词法分析 (不输出过程)
-	int tokenCount = 0;
-	Token *tokens = performLexicalAnalysis(source, &tokenCount);
-	if (tokens == NULL)
+	if (argIndex >= argc)
 	{
-		printf("Lexical analysis failed\n");
-		free(source);
+		printUsage();
 		return 1;
 	}
 
-	// 执行语法分析 (不输出过程)
-	Parser parser;
-	initParser(&parser, tokens, tokenCount);
-
-	int stmtCount = 0;
-	Stmt **statements = parse(&parser, &stmtCount);
-
-	if (hadParseError(&parser))
+	// 读取并解析源代码；有效的 .spwc 缓存存在时跳过词法分析和解析
+	// 读取、解析和运行时错误都写到标准错误并以状态 1 退出，与 sparrow-client 一致
+	const char *path = argv[argIndex];
+	LoadedProgram program;
+	ProgramStatus status = loadProgram(&program, path, useCache, lazyFunctions);
+	bool succeeded = false;
+	if (status != PROGRAM_OK)
 	{
-		printf("Parse error: %s\n", getParseErrorMsg(&parser));
+		fprintf(stderr, "%s", program.error);
 	}
 	else
 	{
 		// 执行程序
-		executeProgram(statements, stmtCount);
-
-		// 释放语句内存
-		for (int i = 0; i < stmtCount; i++)
-		{
-			freeStmt(statements[i]);
-		}
-		free(statements);
+		succeeded = executeProgram(program.statements, program.stmtCount, explicitStack, maxCallDepth,
+								   timeLimit >= 0 ? timeLimit : 0, argv + argIndex + 1, argc - argIndex - 1);
 	}
 
-	// 释放标记和源代码内存
-	for (int i = 0; i < tokenCount; i++)
-	{
-		freeToken(&tokens[i]);
-	}
-	free(tokens);
-	free(source);
+	// 释放语法树、标记和源代码内存
+	freeLoadedProgram(&program);
 
-	return 0;
+	return succeeded ? 0 : 1;
 }
\ No newline at end of file
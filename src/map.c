@@ -0,0 +1,443 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "map.h"
+
+// 最小容量
+#define MAP_MIN_CAPACITY 8
+
+// 哈希索引的最大装载率为 7/8
+#define MAP_LOAD_NUMERATOR 7
+#define MAP_LOAD_DENOMINATOR 8
+
+// splitmix64 的终结混合，使相邻整数的哈希值充分分散
+static uint64_t mixHash(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// FNV-1a
+static uint64_t hashBytes(const char *data, size_t length)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// 能精确表示为 int64 的浮点数
+static bool integralDouble(double number, int64_t *integer)
+{
+    if (number >= -9223372036854775808.0 && number < 9223372036854775808.0 &&
+        (double)(int64_t)number == number)
+    {
+        *integer = (int64_t)number;
+        return true;
+    }
+    return false;
+}
+
+// 数字键直接按数值哈希；整数值的浮点数与对应整数哈希相同，与 valuesEqual 一致
+static uint32_t hashKey(Value key)
+{
+    switch (key.type)
+    {
+    case VAL_STRING:
+        return (uint32_t)mixHash(hashBytes(key.as.string, stringLength(key.as.string)));
+    case VAL_INT:
+        return (uint32_t)mixHash((uint64_t)key.as.integer);
+    case VAL_NUMBER:
+    {
+        int64_t integer;
+        if (integralDouble(key.as.number, &integer))
+        {
+            return (uint32_t)mixHash((uint64_t)integer);
+        }
+        uint64_t bits;
+        memcpy(&bits, &key.as.number, sizeof(bits));
+        return (uint32_t)mixHash(bits);
+    }
+    case VAL_BOOL:
+        return (uint32_t)mixHash(key.as.boolean ? 0x9e3779b97f4a7c15ULL : 0x7f4a7c159e3779b9ULL);
+    default:
+        return 0;
+    }
+}
+
+bool mapKeySupported(Value key)
+{
+    switch (key.type)
+    {
+    case VAL_STRING:
+        return key.as.string != NULL;
+    case VAL_INT:
+    case VAL_BOOL:
+        return true;
+    case VAL_NUMBER:
+        return !isnan(key.as.number);
+    default:
+        return false;
+    }
+}
+
+static bool keysEqual(Value a, Value b)
+{
+    if (a.type == VAL_STRING && b.type == VAL_STRING)
+    {
+        size_t length = stringLength(a.as.string);
+        return length == stringLength(b.as.string) && memcmp(a.as.string, b.as.string, length) == 0;
+    }
+    return valuesEqual(a, b);
+}
+
+// 槽位上的项到其理想位置的探测距离
+static uint32_t probeDistance(const Map *map, uint32_t position, uint32_t hash)
+{
+    return (position - (hash & map->slotMask)) & map->slotMask;
+}
+
+// Robin Hood 插入：探测距离更短的项让出槽位，被挤出的项继续向后寻找
+static void insertSlot(Map *map, uint32_t hash, int32_t entry)
+{
+    MapSlot current = {hash, entry};
+    uint32_t position = hash & map->slotMask;
+    uint32_t distance = 0;
+
+    for (;;)
+    {
+        MapSlot *slot = &map->slots[position];
+        if (slot->entry < 0)
+        {
+            *slot = current;
+            return;
+        }
+
+        uint32_t slotDistance = probeDistance(map, position, slot->hash);
+        if (slotDistance < distance)
+        {
+            MapSlot displaced = *slot;
+            *slot = current;
+            current = displaced;
+            distance = slotDistance;
+        }
+
+        position = (position + 1) & map->slotMask;
+        distance++;
+    }
+}
+
+// 查找键所在的槽位，不存在时返回 -1
+static int64_t findSlot(const Map *map, Value key, uint32_t hash)
+{
+    uint32_t position = hash & map->slotMask;
+    uint32_t distance = 0;
+
+    for (;;)
+    {
+        const MapSlot *slot = &map->slots[position];
+        if (slot->entry < 0 || probeDistance(map, position, slot->hash) < distance)
+        {
+            return -1;
+        }
+        if (slot->hash == hash && keysEqual(map->entries[slot->entry].key, key))
+        {
+            return position;
+        }
+
+        position = (position + 1) & map->slotMask;
+        distance++;
+    }
+}
+
+// 按给定槽位数重建哈希索引，使用缓存的哈希值
+static bool rebuildSlots(Map *map, uint32_t slotCount)
+{
+    MapSlot *slots = (MapSlot *)malloc(sizeof(MapSlot) * slotCount);
+    if (slots == NULL)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < slotCount; i++)
+    {
+        slots[i].entry = -1;
+    }
+
+    free(map->slots);
+    map->slots = slots;
+    map->slotMask = slotCount - 1;
+
+    for (int i = 0; i < map->entryCount; i++)
+    {
+        if (map->entries[i].key.type != VAL_NULL)
+        {
+            insertSlot(map, map->entries[i].hash, i);
+        }
+    }
+    return true;
+}
+
+// 容纳 count 个键所需的槽位数
+static uint32_t slotCountFor(int count)
+{
+    uint32_t slotCount = MAP_MIN_CAPACITY;
+    while ((uint64_t)slotCount * MAP_LOAD_NUMERATOR < (uint64_t)count * MAP_LOAD_DENOMINATOR)
+    {
+        slotCount *= 2;
+    }
+    return slotCount;
+}
+
+// 去掉已删除的项，保持其余项的顺序
+static void compactEntries(Map *map)
+{
+    int live = 0;
+    for (int i = 0; i < map->entryCount; i++)
+    {
+        if (map->entries[i].key.type != VAL_NULL)
+        {
+            map->entries[live++] = map->entries[i];
+        }
+    }
+    map->entryCount = live;
+}
+
+// 确保还能追加一个新项
+static bool reserveEntry(Map *map)
+{
+    if ((uint64_t)(map->count + 1) * MAP_LOAD_DENOMINATOR > (uint64_t)(map->slotMask + 1) * MAP_LOAD_NUMERATOR)
+    {
+        if (!rebuildSlots(map, (map->slotMask + 1) * 2))
+        {
+            return false;
+        }
+    }
+
+    if (map->entryCount < map->entryCapacity)
+    {
+        return true;
+    }
+
+    // 已删除项超过一半时原地压缩，否则扩容
+    if (map->entryCount - map->count >= map->entryCount / 2)
+    {
+        compactEntries(map);
+        return rebuildSlots(map, map->slotMask + 1);
+    }
+
+    int newCapacity = map->entryCapacity * 2;
+    MapEntry *entries = (MapEntry *)realloc(map->entries, sizeof(MapEntry) * (size_t)newCapacity);
+    if (entries == NULL)
+    {
+        return false;
+    }
+    map->entries = entries;
+    map->entryCapacity = newCapacity;
+    return true;
+}
+
+static Map *allocateMap(int capacity)
+{
+    Map *map = (Map *)malloc(sizeof(Map));
+    if (map == NULL)
+    {
+        return NULL;
+    }
+
+    capacity = capacity > MAP_MIN_CAPACITY ? capacity : MAP_MIN_CAPACITY;
+    map->entries = (MapEntry *)malloc(sizeof(MapEntry) * (size_t)capacity);
+    map->entryCount = 0;
+    map->entryCapacity = capacity;
+    map->count = 0;
+    map->slots = NULL;
+    map->slotMask = 0;
+
+    if (map->entries == NULL || !rebuildSlots(map, slotCountFor(capacity)))
+    {
+        free(map->entries);
+        free(map->slots);
+        free(map);
+        return NULL;
+    }
+    return map;
+}
+
+Value createMap(int initialCapacity)
+{
+    Value value;
+    value.type = VAL_MAP;
+    value.as.map = allocateMap(initialCapacity);
+    if (value.as.map == NULL)
+    {
+        value.type = VAL_NULL;
+    }
+    return value;
+}
+
+void freeMap(Map *map)
+{
+    if (map == NULL)
+    {
+        return;
+    }
+
+    for (int i = 0; i < map->entryCount; i++)
+    {
+        if (map->entries[i].key.type != VAL_NULL)
+        {
+            freeValue(map->entries[i].key);
+            freeValue(map->entries[i].value);
+        }
+    }
+    free(map->entries);
+    free(map->slots);
+    free(map);
+}
+
+// 复制时顺便去掉已删除的项
+Map *copyMap(const Map *map)
+{
+    Map *copy = allocateMap(map->count);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+
+    for (int i = 0; i < map->entryCount; i++)
+    {
+        const MapEntry *entry = &map->entries[i];
+        if (entry->key.type == VAL_NULL)
+        {
+            continue;
+        }
+
+        MapEntry *target = &copy->entries[copy->entryCount];
+        target->key = copyValue(entry->key);
+        target->value = copyValue(entry->value);
+        target->hash = entry->hash;
+        insertSlot(copy, entry->hash, copy->entryCount);
+        copy->entryCount++;
+        copy->count++;
+    }
+    return copy;
+}
+
+bool mapsEqual(const Map *a, const Map *b)
+{
+    if (a->count != b->count)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < a->entryCount; i++)
+    {
+        const MapEntry *entry = &a->entries[i];
+        if (entry->key.type == VAL_NULL)
+        {
+            continue;
+        }
+
+        int64_t position = findSlot(b, entry->key, entry->hash);
+        if (position < 0 || !valuesEqual(entry->value, b->entries[b->slots[position].entry].value))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Value *mapGet(const Map *map, Value key)
+{
+    if (!mapKeySupported(key))
+    {
+        return NULL;
+    }
+
+    int64_t position = findSlot(map, key, hashKey(key));
+    return position >= 0 ? &map->entries[map->slots[position].entry].value : NULL;
+}
+
+bool mapHas(const Map *map, Value key)
+{
+    return mapGet(map, key) != NULL;
+}
+
+bool mapSet(Map *map, Value key, Value value)
+{
+    uint32_t hash = hashKey(key);
+    int64_t position = findSlot(map, key, hash);
+    if (position >= 0)
+    {
+        MapEntry *entry = &map->entries[map->slots[position].entry];
+        freeValue(entry->value);
+        entry->value = value;
+        freeValue(key);
+        return true;
+    }
+
+    if (!reserveEntry(map))
+    {
+        freeValue(key);
+        freeValue(value);
+        return false;
+    }
+
+    MapEntry *entry = &map->entries[map->entryCount];
+    entry->key = key;
+    entry->value = value;
+    entry->hash = hash;
+    insertSlot(map, hash, map->entryCount);
+    map->entryCount++;
+    map->count++;
+    return true;
+}
+
+bool mapRemove(Map *map, Value key)
+{
+    if (!mapKeySupported(key))
+    {
+        return false;
+    }
+
+    int64_t found = findSlot(map, key, hashKey(key));
+    if (found < 0)
+    {
+        return false;
+    }
+
+    uint32_t position = (uint32_t)found;
+    MapEntry *entry = &map->entries[map->slots[position].entry];
+    freeValue(entry->key);
+    freeValue(entry->value);
+    entry->key = createNull();
+    entry->value = createNull();
+    map->count--;
+
+    // 后移删除：把后面仍偏离理想位置的项依次前移一格，直到遇到空槽或已在理想位置的项
+    for (;;)
+    {
+        uint32_t next = (position + 1) & map->slotMask;
+        MapSlot *nextSlot = &map->slots[next];
+        if (nextSlot->entry < 0 || probeDistance(map, next, nextSlot->hash) == 0)
+        {
+            map->slots[position].entry = -1;
+            break;
+        }
+        map->slots[position] = *nextSlot;
+        position = next;
+    }
+
+    // 全部删除后重置，避免已删除项一直占用 entries
+    if (map->count == 0)
+    {
+        map->entryCount = 0;
+    }
+    return true;
+}
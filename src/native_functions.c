@@ -1,8 +1,14 @@
+#define _POSIX_C_SOURCE 199309L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include "native_functions.h"
+#include "array_sort.h"
+#include "simd_kernels.h"
+#include "map.h"
+#include "containers.h"
 
 // 创建原生函数对象
 NativeFunction *createNativeFn(const char *name, int arity, Value (*function)(int, Value *))
@@ -34,30 +40,85 @@ NativeFunction *createNativeFn(const char *name, int arity, Value (*function)(in
 
     native->arity = arity;
     native->function = function;
+    native->native = NULL;
+    native->flags = 0;
+    native->isStatic = false;
     return native;
 }
-// 注册单个原生函数
-static void registerNativeFunction(Interpreter *interpreter, const char *name, int arity, Value (*function)(int, Value *))
-{
-    // 验证参数
-    if (interpreter == NULL || interpreter->globals == NULL || name == NULL || function == NULL)
-    {
-        fprintf(stderr, "ERROR: Invalid arguments to registerNativeFunction\n");
-        return;
-    }
 
-    // 创建原生函数对象
-    NativeFunction *native = createNativeFn(name, arity, function);
-    if (native == NULL)
-    {
-        fprintf(stderr, "ERROR: Failed to create native function\n");
-        return;
-    }
+// 内置原生函数注册表：静态分配，注册和调用时都不再为函数对象分配内存
+static NativeFunction builtinNatives[] = {
+    // 基础函数
+    {"print", -1, NULL, printNative, NATIVE_BORROWS_ARGS, true},
+    {"println", -1, NULL, printlnNative, NATIVE_BORROWS_ARGS, true},
+    {"clock", 0, clockNative, NULL, 0, true},
+    {"type", 1, NULL, typeNative, NATIVE_BORROWS_ARGS, true},
+    {"input", -1, NULL, inputNative, NATIVE_BORROWS_ARGS, true}, // 0 或 1 个参数
+    {"flush", 0, NULL, flushNative, 0, true},
+    {"args", 0, NULL, argsNative, 0, true},
+
+    // 计时和基准测试函数
+    {"nanoTime", 0, NULL, nanoTimeNative, 0, true},
+    {"wallTime", 0, NULL, wallTimeNative, 0, true},
+    {"bench", 2, NULL, benchNative, 0, true}, // 会回调脚本函数，不能借用参数
 
-    // 创建值并定义变量
-    Value nativeValue = createNativeFunction(native);
-    defineVariable(interpreter->globals, name, nativeValue);
-}
+    // 数组相关函数
+    {"length", 1, NULL, lengthNative, NATIVE_BORROWS_ARGS, true},
+    {"push", 2, pushNative, NULL, 0, true},
+    {"pop", 1, popNative, NULL, 0, true},
+    {"popArray", 1, popArrayNative, NULL, 0, true},
+    {"slice", -1, sliceNative, NULL, 0, true}, // -1表示可变参数（2或3个）
+
+    // 高阶数组函数（会回调脚本函数，不能借用参数）
+    {"map", 2, NULL, mapNative, 0, true},
+    {"filter", 2, NULL, filterNative, 0, true},
+    {"reduce", -1, NULL, reduceNative, 0, true}, // 2 或 3 个参数
+    {"forEach", 2, NULL, forEachNative, 0, true},
+    {"any", 2, NULL, anyNative, 0, true},
+    {"all", 2, NULL, allNative, 0, true},
+
+    // 排序和查找函数
+    {"sort", -1, NULL, sortNative, NATIVE_BORROWS_ARGS, true},     // 1 或 2 个参数
+    {"sortBy", -1, NULL, sortByNative, 0, true},                   // 2 或 3 个参数，可能回调脚本函数
+    {"binarySearch", 2, NULL, binarySearchNative, NATIVE_BORROWS_ARGS, true},
+    {"lowerBound", 2, NULL, lowerBoundNative, NATIVE_BORROWS_ARGS, true},
+    {"partition", 2, NULL, partitionNative, 0, true},
+
+    // 数值归约与查找函数
+    {"sum", 1, NULL, sumNative, NATIVE_BORROWS_ARGS, true},
+    {"mean", 1, NULL, meanNative, NATIVE_BORROWS_ARGS, true},
+    {"min", 1, NULL, minNative, NATIVE_BORROWS_ARGS, true},
+    {"max", 1, NULL, maxNative, NATIVE_BORROWS_ARGS, true},
+    {"dot", 2, NULL, dotNative, NATIVE_BORROWS_ARGS, true},
+    {"indexOf", 2, NULL, indexOfNative, NATIVE_BORROWS_ARGS, true},
+    {"count", 2, NULL, countNative, NATIVE_BORROWS_ARGS, true},
+
+    // 映射函数
+    {"has", 2, NULL, hasNative, NATIVE_BORROWS_ARGS, true},
+    {"keys", 1, NULL, keysNative, NATIVE_BORROWS_ARGS, true},
+    {"values", 1, NULL, valuesNative, NATIVE_BORROWS_ARGS, true},
+    {"remove", 2, NULL, removeNative, NATIVE_MUTATES_FIRST_ARG, true}, // 就地删除，第一个参数必须是变量
+
+    // 优先队列和双端队列函数（修改类函数就地操作，第一个参数必须是变量）
+    {"heap", -1, NULL, heapNative, NATIVE_BORROWS_ARGS, true}, // 0 到 2 个参数
+    {"heapPush", 2, NULL, heapPushNative, NATIVE_MUTATES_FIRST_ARG, true},
+    {"heapPop", 1, NULL, heapPopNative, NATIVE_MUTATES_FIRST_ARG, true},
+    {"heapPeek", 1, NULL, heapPeekNative, NATIVE_BORROWS_ARGS, true},
+    {"deque", -1, NULL, dequeNative, NATIVE_BORROWS_ARGS, true}, // 0 或 1 个参数
+    {"pushFront", 2, NULL, pushFrontNative, NATIVE_MUTATES_FIRST_ARG, true},
+    {"pushBack", 2, NULL, pushBackNative, NATIVE_MUTATES_FIRST_ARG, true},
+    {"popFront", 1, NULL, popFrontNative, NATIVE_MUTATES_FIRST_ARG, true},
+    {"popBack", 1, NULL, popBackNative, NATIVE_MUTATES_FIRST_ARG, true},
+    {"peekFront", 1, NULL, peekFrontNative, NATIVE_BORROWS_ARGS, true},
+    {"peekBack", 1, NULL, peekBackNative, NATIVE_BORROWS_ARGS, true},
+    {"toArray", 1, NULL, toArrayNative, NATIVE_BORROWS_ARGS, true},
+
+    // 区间函数
+    {"range", -1, NULL, rangeNative, NATIVE_BORROWS_ARGS, true}, // 1 到 3 个参数
+
+    // 生成器函数（会执行生成器的函数体，参数不借用）
+    {"next", -1, NULL, nextNative, 0, true}, // 1 或 2 个参数
+};
 
 // 注册所有原生函数
 void registerAllNativeFunctions(Interpreter *interpreter)
@@ -69,19 +130,12 @@ void registerAllNativeFunctions(Interpreter *interpreter)
         return;
     }
 
-    // 基础函数
-    registerNativeFunction(interpreter, "print", -1, printNative);
-    registerNativeFunction(interpreter, "println", -1, printlnNative);
-    registerNativeFunction(interpreter, "clock", 0, clockNative);
-    registerNativeFunction(interpreter, "type", 1, typeNative);
-    registerNativeFunction(interpreter, "input", -1, inputNative);
-
-    // 数组相关函数
-    registerNativeFunction(interpreter, "length", 1, lengthNative);
-    registerNativeFunction(interpreter, "push", 2, pushNative);
-    registerNativeFunction(interpreter, "pop", 1, popNative);
-    registerNativeFunction(interpreter, "popArray", 1, popArrayNative);
-    registerNativeFunction(interpreter, "slice", -1, sliceNative); // -1表示可变参数（2或3个）
+    int count = (int)(sizeof(builtinNatives) / sizeof(builtinNatives[0]));
+    for (int i = 0; i < count; i++)
+    {
+        defineVariable(interpreter->globals, builtinNatives[i].name,
+                       createNativeFunction(&builtinNatives[i]));
+    }
 
     // 标记解释器支持 main 函数
     interpreter->hasMainFunction = false;
@@ -89,95 +143,103 @@ void registerAllNativeFunctions(Interpreter *interpreter)
 }
 
 // 实现 print 原生函数
-Value printNative(int argCount, Value *args)
+NativeStatus printNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
 {
-    // 添加安全检查
-    if (args == NULL && argCount > 0)
+    for (int i = 0; i < argCount; i++)
     {
-        printf("ERROR: NULL args pointer passed to printNative\n");
-        return createNull();
+        writeValue(&interpreter->output, args[i]);
+        if (i < argCount - 1)
+            outputChar(&interpreter->output, ' ');
     }
+    *result = createNull();
+    return NATIVE_OK;
+}
 
+NativeStatus printlnNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
     for (int i = 0; i < argCount; i++)
     {
-        printValue(args[i]);
+        writeValue(&interpreter->output, args[i]);
         if (i < argCount - 1)
-            printf(" ");
+            outputChar(&interpreter->output, ' ');
     }
-    return createNull();
+    outputChar(&interpreter->output, '\n');
+    *result = createNull();
+    return NATIVE_OK;
+}
+
+// flush 原生函数：立即写出缓冲的输出
+NativeStatus flushNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    (void)args;
+    flushOutput(&interpreter->output);
+    *result = createNull();
+    return NATIVE_OK;
 }
 
-Value printlnNative(int argCount, Value *args)
+// args 原生函数：返回脚本路径之后的命令行参数（字符串数组）
+NativeStatus argsNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
 {
-    // 添加安全检查
-    if (args == NULL && argCount > 0)
+    (void)argCount;
+    (void)args;
+    Value collected = createArray(TYPE_STRING, interpreter->scriptArgCount);
+    if (collected.type != VAL_ARRAY)
     {
-        printf("ERROR: NULL args pointer passed to printlnNative\n");
-        return createNull();
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
     }
 
-    for (int i = 0; i < argCount; i++)
+    Array *output = collected.as.array;
+    for (int i = 0; i < interpreter->scriptArgCount; i++)
     {
-        printValue(args[i]);
-        if (i < argCount - 1)
-            printf(" ");
+        output->elements[output->count++] = createString(interpreter->scriptArgs[i]);
     }
-    printf("\n");
-    return createNull();
+    *result = collected;
+    return NATIVE_OK;
 }
 
 // input 原生函数
-Value inputNative(int argCount, Value *args)
+NativeStatus inputNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
 {
     // 检查参数数量（0个或1个）
     if (argCount > 1)
     {
-        printf("ERROR: input() takes at most 1 argument\n");
-        return createNull();
+        runtimeError(interpreter, "input() 最多接受 1 个参数");
+        return NATIVE_ERROR;
+    }
+    if (interpreter->inputDisabled)
+    {
+        runtimeError(interpreter, "input() 在常驻模式下不可用");
+        return NATIVE_ERROR;
     }
 
     // 如果有参数，打印提示信息
     if (argCount == 1)
     {
-        if (args[0].type == VAL_STRING)
-        {
-            printf("%s", args[0].as.string);
-        }
-        else
-        {
-            // 如果参数不是字符串，先转换为字符串显示
-            printValue(args[0]);
-        }
-        fflush(stdout); // 确保提示信息立即显示
+        writeValue(&interpreter->output, args[0]);
     }
 
-    // 分配缓冲区来存储用户输入
-    char *buffer = malloc(1024);
-    if (buffer == NULL)
-    {
-        printf("ERROR: Memory allocation failed for input buffer\n");
-        return createNull();
-    }
+    // 读取前写出之前的输出和提示信息，确保其立即显示
+    flushOutput(&interpreter->output);
 
     // 读取用户输入
-    if (fgets(buffer, 1024, stdin) == NULL)
+    char buffer[1024];
+    if (fgets(buffer, sizeof(buffer), stdin) == NULL)
     {
-        free(buffer);
-        return createString(""); // 如果读取失败，返回空字符串
+        *result = createString(""); // 如果读取失败，返回空字符串
+        return NATIVE_OK;
     }
 
     // 移除换行符
     size_t len = strlen(buffer);
     if (len > 0 && buffer[len - 1] == '\n')
     {
-        buffer[len - 1] = '\0';
+        len--;
     }
 
-    // 创建字符串值
-    Value result = createString(buffer);
-    free(buffer);
-
-    return result;
+    *result = createStringWithLength(buffer, len);
+    return NATIVE_OK;
 }
 
 // 实现 clock 原生函数
@@ -189,103 +251,198 @@ Value clockNative(int argCount, Value *args)
         return createNull();
     }
     
-    return createNumber((double)time(NULL));
+    return createInt((int64_t)time(NULL));
 }
 
-// 实现 type 原生函数
-Value typeNative(int argCount, Value *args)
+// 读取单调时钟（纳秒），不受系统时间调整影响
+static int64_t monotonicNanos(void)
 {
-    if (argCount != 1)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// nanoTime 原生函数：单调时钟的纳秒数，只用于计算时间间隔
+NativeStatus nanoTimeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)args;
+    if (argCount != 0)
     {
-        return createString("ERROR: type() expects exactly 1 argument");
+        runtimeError(interpreter, "nanoTime() 不接受参数");
+        return NATIVE_ERROR;
     }
 
-    // 添加参数验证
-    if (args == NULL)
+    *result = createInt(monotonicNanos());
+    return NATIVE_OK;
+}
+
+// wallTime 原生函数：自 Unix 纪元以来的秒数（带小数部分）
+NativeStatus wallTimeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)args;
+    if (argCount != 0)
+    {
+        runtimeError(interpreter, "wallTime() 不接受参数");
+        return NATIVE_ERROR;
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    *result = createNumber((double)ts.tv_sec + (double)ts.tv_nsec / 1e9);
+    return NATIVE_OK;
+}
+
+static int compareNanos(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 单次 bench() 允许的最大迭代次数，限制样本数组的内存占用
+#define BENCH_MAX_ITERATIONS 10000000
+
+/**
+ * bench 原生函数：bench(fn, iterations)
+ *
+ * 先以 iterations / 10（1 到 1000 次）预热，再逐次计时调用无参函数 fn，
+ * 返回 BenchResult 结构体，时间单位均为纳秒：
+ * iterations、warmup、min、median、p99、max（整数）和 mean（浮点数）。
+ */
+NativeStatus benchNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount; // 参数数量由调用方按 arity 检查
+
+    if (args[0].type != VAL_FUNCTION || args[0].as.function == NULL)
+    {
+        runtimeError(interpreter, "bench() 的第一个参数必须是函数");
+        return NATIVE_ERROR;
+    }
+    if (args[1].type != VAL_INT || args[1].as.integer <= 0 || args[1].as.integer > BENCH_MAX_ITERATIONS)
     {
-        return createString("ERROR: NULL arguments passed to type()");
+        runtimeError(interpreter, "bench() 的迭代次数必须是 1 到 %d 之间的整数", BENCH_MAX_ITERATIONS);
+        return NATIVE_ERROR;
     }
 
-    Value arg = args[0];
-    const char *typeName;
+    Function *function = args[0].as.function;
+    int iterations = (int)args[1].as.integer;
+    int warmup = iterations / 10;
+    if (warmup < 1)
+        warmup = 1;
+    if (warmup > 1000)
+        warmup = 1000;
 
-    switch (arg.type)
+    for (int i = 0; i < warmup; i++)
     {
-    case VAL_NUMBER:
-        // 检查是否为整数
-        if (arg.as.number == (int)arg.as.number)
+        freeValue(callFunction(interpreter, function, NULL, 0));
+        if (interpreter->hadError)
         {
-            typeName = "int";
+            return NATIVE_ERROR;
         }
-        else
+    }
+
+    int64_t *samples = (int64_t *)malloc(sizeof(int64_t) * (size_t)iterations);
+    if (samples == NULL)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    double total = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        int64_t start = monotonicNanos();
+        Value returned = callFunction(interpreter, function, NULL, 0);
+        samples[i] = monotonicNanos() - start;
+        freeValue(returned);
+
+        if (interpreter->hadError)
         {
-            typeName = "float";
+            free(samples);
+            return NATIVE_ERROR;
         }
-        break;
-    case VAL_STRING:
-        typeName = "string";
-        break;
-    case VAL_BOOL:
-        typeName = "bool";
-        break;
-    case VAL_NULL:
-        typeName = "null";
-        break;
-    case VAL_ARRAY:
-        typeName = "array";
-        break;
-    case VAL_FUNCTION:
-        typeName = "function";
-        break;
-    case VAL_NATIVE_FUNCTION:
-        typeName = "native_function";
-        break;
-    case VAL_ENUM_VALUE:
-        typeName = "enum";
-        break;
-    default:
-        typeName = "unknown";
-        break;
+        total += (double)samples[i];
     }
 
-    return createString(typeName);
+    qsort(samples, (size_t)iterations, sizeof(int64_t), compareNanos);
+
+    // 百分位数按最近秩法取值
+    int p99Rank = (int)((99LL * iterations + 99) / 100);
+    Value fieldValues[] = {
+        createInt(iterations),
+        createInt(warmup),
+        createInt(samples[0]),
+        createInt(samples[(iterations - 1) / 2]),
+        createInt(samples[p99Rank - 1]),
+        createInt(samples[iterations - 1]),
+        createNumber(total / iterations),
+    };
+    free(samples);
+
+    StructFieldValue fields[] = {
+        {"iterations", &fieldValues[0]},
+        {"warmup", &fieldValues[1]},
+        {"min", &fieldValues[2]},
+        {"median", &fieldValues[3]},
+        {"p99", &fieldValues[4]},
+        {"max", &fieldValues[5]},
+        {"mean", &fieldValues[6]},
+    };
+    *result = createStruct("BenchResult", fields, (int)(sizeof(fields) / sizeof(fields[0])));
+    return NATIVE_OK;
 }
 
-// 实现数组长度原生函数
-Value lengthNative(int argCount, Value *args)
+// 实现 type 原生函数
+NativeStatus typeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
 {
-    // 参数验证
-    if (argCount != 1)
+    (void)interpreter;
+    (void)argCount;
+
+    *result = createString(valueTypeName(args[0]));
+    return NATIVE_OK;
+}
+
+// 实现长度原生函数：参数为借用，读取数组长度不会复制数组
+NativeStatus lengthNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+
+    if (args[0].type == VAL_ARRAY)
+    {
+        *result = createInt(args[0].as.array != NULL ? args[0].as.array->count : 0);
+        return NATIVE_OK;
+    }
+    if (args[0].type == VAL_STRING)
     {
-        return createString("Error: length() requires exactly one argument");
+        *result = createInt(args[0].as.string != NULL ? (int64_t)stringLength(args[0].as.string) : 0);
+        return NATIVE_OK;
     }
 
-    if (args == NULL)
+    if (args[0].type == VAL_MAP)
     {
-        return createString("Error: NULL arguments passed to length()");
+        *result = createInt(args[0].as.map != NULL ? args[0].as.map->count : 0);
+        return NATIVE_OK;
     }
 
-    // 检查参数类型
-    if (args[0].type == VAL_ARRAY)
+    if (args[0].type == VAL_HEAP)
     {
-        if (args[0].as.array == NULL)
-        {
-            return createNumber(0);
-        }
-        return createNumber((double)args[0].as.array->count);
+        *result = createInt(args[0].as.heap->count);
+        return NATIVE_OK;
     }
-    else if (args[0].type == VAL_STRING)
+    if (args[0].type == VAL_DEQUE)
     {
-        if (args[0].as.string == NULL)
-        {
-            return createNumber(0);
-        }
-        return createNumber((double)strlen(args[0].as.string));
+        *result = createInt(args[0].as.deque->count);
+        return NATIVE_OK;
     }
-    else
+
+    if (args[0].type == VAL_RANGE)
     {
-        return createString("Error: length() can only be called on arrays or strings");
+        *result = createInt(rangeLength(args[0].as.range));
+        return NATIVE_OK;
     }
+
+    runtimeError(interpreter, "length() 只能用于数组、字符串、映射、堆、双端队列或区间");
+    return NATIVE_ERROR;
 }
 
 // 实现数组push原生函数
@@ -469,23 +626,23 @@ Value sliceNative(int argCount, Value *args)
     }
 
     // 检查start参数是否为数字
-    if (args[1].type != VAL_NUMBER)
+    if (!isNumeric(args[1]))
     {
         return createString("Error: start index must be a number");
     }
 
     Array *sourceArray = args[0].as.array;
-    int start = (int)args[1].as.number;
+    int start = (int)asDouble(args[1]);
     int end = sourceArray->count; // 默认到数组末尾
 
     // 如果提供了end参数
     if (argCount == 3)
     {
-        if (args[2].type != VAL_NUMBER)
+        if (!isNumeric(args[2]))
         {
             return createString("Error: end index must be a number");
         }
-        end = (int)args[2].as.number;
+        end = (int)asDouble(args[2]);
     }
 
     // 处理负数索引
@@ -524,4 +681,1114 @@ Value sliceNative(int argCount, Value *args)
     }
 
     return newArray;
-}
\ No newline at end of file
+}
+
+// 校验高阶函数的参数：第一个为数组，第二个为函数
+static bool checkArrayAndCallback(Interpreter *interpreter, const char *name, const Value *args)
+{
+    if (args[0].type != VAL_ARRAY || args[0].as.array == NULL)
+    {
+        runtimeError(interpreter, "%s() 的第一个参数必须是数组", name);
+        return false;
+    }
+    if (args[1].type != VAL_FUNCTION && args[1].type != VAL_NATIVE_FUNCTION)
+    {
+        runtimeError(interpreter, "%s() 的第二个参数必须是函数", name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 对数组元素调用回调函数
+ *
+ * 元素直接从数组存储中借用，不做复制；回调声明了两个参数时额外传入元素索引。
+ * 这里的数组是调用方求值得到的副本，回调无法修改或释放它。
+ */
+static Value callElementCallback(Interpreter *interpreter, Value callback, bool passIndex, Value element, int index)
+{
+    Value callArgs[2] = {element, createInt(index)};
+    return callCallable(interpreter, callback, callArgs, passIndex ? 2 : 1);
+}
+
+// map(array, fn)：返回由 fn(元素) 组成的新数组，结果数组按原长度一次分配
+NativeStatus mapNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayAndCallback(interpreter, "map", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    bool passIndex = callableArity(args[1]) == 2;
+
+    Value mapped = createArray(TYPE_ANY, source->count);
+    if (mapped.type != VAL_ARRAY)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    Array *output = mapped.as.array;
+    for (int i = 0; i < source->count; i++)
+    {
+        Value value = callElementCallback(interpreter, args[1], passIndex, source->elements[i], i);
+        if (interpreter->hadError)
+        {
+            freeValue(value);
+            freeValue(mapped);
+            return NATIVE_ERROR;
+        }
+        // 回调的返回值归结果数组所有，直接放入而不再复制
+        output->elements[output->count++] = value;
+    }
+
+    *result = mapped;
+    return NATIVE_OK;
+}
+
+// filter(array, fn)：返回 fn(元素) 为真的元素组成的新数组
+NativeStatus filterNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayAndCallback(interpreter, "filter", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    bool passIndex = callableArity(args[1]) == 2;
+
+    // 结果最多与原数组等长，预先分配避免逐个扩容
+    Value filtered = createArray(source->elementType, source->count);
+    if (filtered.type != VAL_ARRAY)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    Array *output = filtered.as.array;
+    for (int i = 0; i < source->count; i++)
+    {
+        Value keep = callElementCallback(interpreter, args[1], passIndex, source->elements[i], i);
+        bool truthy = isTruthy(keep);
+        freeValue(keep);
+        if (interpreter->hadError)
+        {
+            freeValue(filtered);
+            return NATIVE_ERROR;
+        }
+        if (truthy)
+        {
+            output->elements[output->count++] = copyValue(source->elements[i]);
+        }
+    }
+
+    *result = filtered;
+    return NATIVE_OK;
+}
+
+// reduce(array, fn[, initial])：依次计算 acc = fn(acc, 元素)，没有初始值时以第一个元素为初值
+NativeStatus reduceNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    if (argCount != 2 && argCount != 3)
+    {
+        runtimeError(interpreter, "reduce() 需要 2 或 3 个参数");
+        return NATIVE_ERROR;
+    }
+    if (!checkArrayAndCallback(interpreter, "reduce", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    int start = 0;
+    Value accumulator;
+
+    if (argCount == 3)
+    {
+        accumulator = copyValue(args[2]);
+    }
+    else
+    {
+        if (source->count == 0)
+        {
+            runtimeError(interpreter, "reduce() 不能用于没有初始值的空数组");
+            return NATIVE_ERROR;
+        }
+        accumulator = copyValue(source->elements[0]);
+        start = 1;
+    }
+
+    for (int i = start; i < source->count; i++)
+    {
+        Value callArgs[2] = {accumulator, source->elements[i]};
+        Value next = callCallable(interpreter, args[1], callArgs, 2);
+        freeValue(accumulator);
+        accumulator = next;
+
+        if (interpreter->hadError)
+        {
+            freeValue(accumulator);
+            return NATIVE_ERROR;
+        }
+    }
+
+    *result = accumulator;
+    return NATIVE_OK;
+}
+
+// forEach(array, fn)：对每个元素调用 fn，忽略返回值
+NativeStatus forEachNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayAndCallback(interpreter, "forEach", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    bool passIndex = callableArity(args[1]) == 2;
+
+    for (int i = 0; i < source->count; i++)
+    {
+        freeValue(callElementCallback(interpreter, args[1], passIndex, source->elements[i], i));
+        if (interpreter->hadError)
+        {
+            return NATIVE_ERROR;
+        }
+    }
+
+    *result = createNull();
+    return NATIVE_OK;
+}
+
+// any/all 的共同实现：遇到结果等于 stopWhen 的元素时提前结束
+static NativeStatus matchElements(Interpreter *interpreter, const char *name, const Value *args,
+                                  bool stopWhen, Value *result)
+{
+    if (!checkArrayAndCallback(interpreter, name, args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    bool passIndex = callableArity(args[1]) == 2;
+
+    for (int i = 0; i < source->count; i++)
+    {
+        Value matched = callElementCallback(interpreter, args[1], passIndex, source->elements[i], i);
+        bool truthy = isTruthy(matched);
+        freeValue(matched);
+        if (interpreter->hadError)
+        {
+            return NATIVE_ERROR;
+        }
+        if (truthy == stopWhen)
+        {
+            *result = createBool(stopWhen);
+            return NATIVE_OK;
+        }
+    }
+
+    *result = createBool(!stopWhen);
+    return NATIVE_OK;
+}
+
+// any(array, fn)：存在 fn(元素) 为真的元素时返回 true
+NativeStatus anyNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    return matchElements(interpreter, "any", args, true, result);
+}
+
+// all(array, fn)：所有元素的 fn(元素) 都为真时返回 true（空数组返回 true）
+NativeStatus allNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    return matchElements(interpreter, "all", args, false, result);
+}
+
+// 读取可选的 stable 参数
+static bool readStableFlag(Interpreter *interpreter, const char *name, int argCount, int position,
+                           const Value *args, bool *stable)
+{
+    *stable = false;
+    if (argCount <= position)
+    {
+        return true;
+    }
+    if (args[position].type != VAL_BOOL)
+    {
+        runtimeError(interpreter, "%s() 的 stable 参数必须是布尔值", name);
+        return false;
+    }
+    *stable = args[position].as.boolean;
+    return true;
+}
+
+// 按排好序的排序项复制元素，生成结果数组
+static bool buildSortedArray(Interpreter *interpreter, Array *source, const SortEntry *entries, Value *result)
+{
+    Value sorted = createArray(source->elementType, source->count);
+    if (sorted.type != VAL_ARRAY)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return false;
+    }
+
+    Array *output = sorted.as.array;
+    for (int i = 0; i < source->count; i++)
+    {
+        output->elements[i] = copyValue(source->elements[entries[i].index]);
+    }
+    output->count = source->count;
+
+    *result = sorted;
+    return true;
+}
+
+// sort(array[, stable])：返回升序排列的新数组，元素须同为数字、字符串或布尔值
+NativeStatus sortNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    if (argCount != 1 && argCount != 2)
+    {
+        runtimeError(interpreter, "sort() 需要 1 或 2 个参数");
+        return NATIVE_ERROR;
+    }
+    if (args[0].type != VAL_ARRAY || args[0].as.array == NULL)
+    {
+        runtimeError(interpreter, "sort() 的第一个参数必须是数组");
+        return NATIVE_ERROR;
+    }
+
+    bool stable;
+    if (!readStableFlag(interpreter, "sort", argCount, 1, args, &stable))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    SortEntry *entries = (SortEntry *)malloc(sizeof(SortEntry) * (size_t)(source->count > 0 ? source->count : 1));
+    if (entries == NULL)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    // 排序键直接借用元素本身
+    for (int i = 0; i < source->count; i++)
+    {
+        entries[i].key = source->elements[i];
+        entries[i].index = i;
+    }
+
+    SortKeyKind kind = classifySortKeys(entries, source->count);
+    if (kind == SORT_KEYS_INVALID)
+    {
+        free(entries);
+        runtimeError(interpreter, "sort() 的数组元素必须同为数字、字符串或布尔值，结构体请使用 sortBy()");
+        return NATIVE_ERROR;
+    }
+
+    sortEntries(entries, source->count, kind, stable);
+    bool ok = buildSortedArray(interpreter, source, entries, result);
+    free(entries);
+    return ok ? NATIVE_OK : NATIVE_ERROR;
+}
+
+// 取结构体字段的值，找不到时返回 NULL
+static Value *findStructField(Value value, const char *fieldName)
+{
+    if (value.type != VAL_STRUCT || value.as.structValue == NULL)
+    {
+        return NULL;
+    }
+
+    StructValue *structValue = value.as.structValue;
+    for (int i = 0; i < structValue->fieldCount; i++)
+    {
+        if (structValue->fields[i].name != NULL && strcmp(structValue->fields[i].name, fieldName) == 0)
+        {
+            return structValue->fields[i].value;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * sortBy(array, key[, stable])：按排序键升序排列
+ *
+ * key 为字段名字符串时按结构体字段排序；为函数时先对每个元素调用一次求出排序键
+ * （装饰），对键排序后再按原位置取回元素（去装饰），回调次数恰好为元素个数。
+ */
+NativeStatus sortByNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    if (argCount != 2 && argCount != 3)
+    {
+        runtimeError(interpreter, "sortBy() 需要 2 或 3 个参数");
+        return NATIVE_ERROR;
+    }
+    if (args[0].type != VAL_ARRAY || args[0].as.array == NULL)
+    {
+        runtimeError(interpreter, "sortBy() 的第一个参数必须是数组");
+        return NATIVE_ERROR;
+    }
+
+    bool byField = args[1].type == VAL_STRING;
+    if (!byField && args[1].type != VAL_FUNCTION && args[1].type != VAL_NATIVE_FUNCTION)
+    {
+        runtimeError(interpreter, "sortBy() 的第二个参数必须是字段名或函数");
+        return NATIVE_ERROR;
+    }
+
+    bool stable;
+    if (!readStableFlag(interpreter, "sortBy", argCount, 2, args, &stable))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    SortEntry *entries = (SortEntry *)malloc(sizeof(SortEntry) * (size_t)(source->count > 0 ? source->count : 1));
+    if (entries == NULL)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    // 装饰：字段键借用结构体中的值，函数键由本函数持有
+    int keyCount = 0;
+    bool ok = true;
+    for (int i = 0; i < source->count && ok; i++)
+    {
+        entries[i].index = i;
+        if (byField)
+        {
+            Value *field = findStructField(source->elements[i], args[1].as.string);
+            if (field == NULL)
+            {
+                runtimeError(interpreter, "sortBy() 的第 %d 个元素没有字段 '%s'", i, args[1].as.string);
+                ok = false;
+                break;
+            }
+            entries[i].key = *field;
+        }
+        else
+        {
+            entries[i].key = callCallable(interpreter, args[1], &source->elements[i], 1);
+            keyCount++;
+            ok = !interpreter->hadError;
+        }
+    }
+
+    if (ok)
+    {
+        SortKeyKind kind = classifySortKeys(entries, source->count);
+        if (kind == SORT_KEYS_INVALID)
+        {
+            runtimeError(interpreter, "sortBy() 的排序键必须同为数字、字符串或布尔值");
+            ok = false;
+        }
+        else
+        {
+            sortEntries(entries, source->count, kind, stable);
+            ok = buildSortedArray(interpreter, source, entries, result);
+        }
+    }
+
+    // 排序打乱了顺序，按原位置找回并释放函数求出的键
+    if (!byField)
+    {
+        for (int i = 0; i < source->count; i++)
+        {
+            if (ok || entries[i].index < keyCount)
+            {
+                freeValue(entries[i].key);
+            }
+        }
+    }
+    free(entries);
+    return ok ? NATIVE_OK : NATIVE_ERROR;
+}
+
+// 在升序数组中查找第一个不小于 target 的位置
+static bool findLowerBound(Interpreter *interpreter, const char *name, const Value *args, int *position)
+{
+    if (args[0].type != VAL_ARRAY || args[0].as.array == NULL)
+    {
+        runtimeError(interpreter, "%s() 的第一个参数必须是数组", name);
+        return false;
+    }
+
+    Array *array = args[0].as.array;
+    Value target = args[1];
+    int low = 0;
+    int high = array->count;
+
+    while (low < high)
+    {
+        int middle = low + (high - low) / 2;
+        Value element = array->elements[middle];
+        if (!sortKeysComparable(element, target))
+        {
+            runtimeError(interpreter, "%s() 的目标值无法与数组元素比较", name);
+            return false;
+        }
+        if (compareSortKeys(element, target) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    *position = low;
+    return true;
+}
+
+// lowerBound(array, value)：升序数组中第一个不小于 value 的元素位置，都小于时返回数组长度
+NativeStatus lowerBoundNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    int position;
+    if (!findLowerBound(interpreter, "lowerBound", args, &position))
+    {
+        return NATIVE_ERROR;
+    }
+    *result = createInt(position);
+    return NATIVE_OK;
+}
+
+// binarySearch(array, value)：在升序数组中查找 value，返回其位置，找不到时返回 -1
+NativeStatus binarySearchNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    int position;
+    if (!findLowerBound(interpreter, "binarySearch", args, &position))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *array = args[0].as.array;
+    bool found = position < array->count && compareSortKeys(array->elements[position], args[1]) == 0;
+    *result = createInt(found ? position : -1);
+    return NATIVE_OK;
+}
+
+// partition(array, fn)：返回 [满足条件的元素, 不满足条件的元素]，两部分均保持原有顺序
+NativeStatus partitionNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayAndCallback(interpreter, "partition", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *source = args[0].as.array;
+    bool passIndex = callableArity(args[1]) == 2;
+
+    Value matched = createArray(source->elementType, source->count);
+    Value rest = createArray(source->elementType, source->count);
+    Value pair = createArray(TYPE_ANY, 2);
+    if (matched.type != VAL_ARRAY || rest.type != VAL_ARRAY || pair.type != VAL_ARRAY)
+    {
+        freeValue(matched);
+        freeValue(rest);
+        freeValue(pair);
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    for (int i = 0; i < source->count; i++)
+    {
+        Value test = callElementCallback(interpreter, args[1], passIndex, source->elements[i], i);
+        bool truthy = isTruthy(test);
+        freeValue(test);
+        if (interpreter->hadError)
+        {
+            freeValue(matched);
+            freeValue(rest);
+            freeValue(pair);
+            return NATIVE_ERROR;
+        }
+
+        Array *output = truthy ? matched.as.array : rest.as.array;
+        output->elements[output->count++] = copyValue(source->elements[i]);
+    }
+
+    pair.as.array->elements[0] = matched;
+    pair.as.array->elements[1] = rest;
+    pair.as.array->count = 2;
+    *result = pair;
+    return NATIVE_OK;
+}
+
+// 检查第一个参数是数组
+static bool checkArrayArgument(Interpreter *interpreter, const char *name, const Value *args)
+{
+    if (args[0].type != VAL_ARRAY || args[0].as.array == NULL)
+    {
+        runtimeError(interpreter, "%s() 的第一个参数必须是数组", name);
+        return false;
+    }
+    return true;
+}
+
+// 报告数组级数值运算的错误
+static NativeStatus numericError(Interpreter *interpreter, const char *name, NumericStatus status)
+{
+    switch (status)
+    {
+    case NUMERIC_EMPTY:
+        runtimeError(interpreter, "%s() 的数组不能为空", name);
+        break;
+    case NUMERIC_LENGTH_MISMATCH:
+        runtimeError(interpreter, "%s() 的两个数组长度必须相同", name);
+        break;
+    default:
+        runtimeError(interpreter, "%s() 的数组元素必须都是数字", name);
+        break;
+    }
+    return NATIVE_ERROR;
+}
+
+// sum(array)：数组元素之和
+NativeStatus sumNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayArgument(interpreter, "sum", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    NumericStatus status = arraySum(args[0].as.array, result);
+    return status == NUMERIC_OK ? NATIVE_OK : numericError(interpreter, "sum", status);
+}
+
+// mean(array)：数组元素的算术平均值
+NativeStatus meanNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayArgument(interpreter, "mean", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Array *array = args[0].as.array;
+    if (array->count == 0)
+    {
+        return numericError(interpreter, "mean", NUMERIC_EMPTY);
+    }
+
+    Value total;
+    NumericStatus status = arraySum(array, &total);
+    if (status != NUMERIC_OK)
+    {
+        return numericError(interpreter, "mean", status);
+    }
+    *result = createNumber(asDouble(total) / array->count);
+    return NATIVE_OK;
+}
+
+// min(array)：最小元素
+NativeStatus minNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayArgument(interpreter, "min", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Value max;
+    NumericStatus status = arrayMinMax(args[0].as.array, result, &max);
+    return status == NUMERIC_OK ? NATIVE_OK : numericError(interpreter, "min", status);
+}
+
+// max(array)：最大元素
+NativeStatus maxNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayArgument(interpreter, "max", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Value min;
+    NumericStatus status = arrayMinMax(args[0].as.array, &min, result);
+    return status == NUMERIC_OK ? NATIVE_OK : numericError(interpreter, "max", status);
+}
+
+// dot(a, b)：两个等长数字数组的点积
+NativeStatus dotNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayArgument(interpreter, "dot", args))
+    {
+        return NATIVE_ERROR;
+    }
+    if (args[1].type != VAL_ARRAY || args[1].as.array == NULL)
+    {
+        runtimeError(interpreter, "dot() 的第二个参数必须是数组");
+        return NATIVE_ERROR;
+    }
+
+    NumericStatus status = arrayDot(args[0].as.array, args[1].as.array, result);
+    return status == NUMERIC_OK ? NATIVE_OK : numericError(interpreter, "dot", status);
+}
+
+// indexOf(array, value)：第一个等于 value 的元素位置，找不到时返回 -1
+NativeStatus indexOfNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayArgument(interpreter, "indexOf", args))
+    {
+        return NATIVE_ERROR;
+    }
+    *result = createInt(arrayIndexOf(args[0].as.array, args[1], 0));
+    return NATIVE_OK;
+}
+
+// count(array, value)：等于 value 的元素个数
+NativeStatus countNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkArrayArgument(interpreter, "count", args))
+    {
+        return NATIVE_ERROR;
+    }
+    *result = createInt(arrayCount(args[0].as.array, args[1]));
+    return NATIVE_OK;
+}
+
+// 检查第一个参数是否为映射
+static bool checkMapArgument(Interpreter *interpreter, const char *name, const Value *args)
+{
+    if (args[0].type != VAL_MAP || args[0].as.map == NULL)
+    {
+        runtimeError(interpreter, "%s() 的第一个参数必须是映射", name);
+        return false;
+    }
+    return true;
+}
+
+// has(map, key)：映射中是否存在该键
+NativeStatus hasNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkMapArgument(interpreter, "has", args))
+    {
+        return NATIVE_ERROR;
+    }
+    *result = createBool(mapHas(args[0].as.map, args[1]));
+    return NATIVE_OK;
+}
+
+// 按插入顺序收集映射的键或值
+static NativeStatus collectMapEntries(Interpreter *interpreter, const Map *map, bool collectKeys, Value *result)
+{
+    Value collected = createArray(TYPE_ANY, map->count);
+    if (collected.type != VAL_ARRAY)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    Array *output = collected.as.array;
+    for (int i = 0; i < map->entryCount; i++)
+    {
+        const MapEntry *entry = &map->entries[i];
+        if (entry->key.type != VAL_NULL)
+        {
+            output->elements[output->count++] = copyValue(collectKeys ? entry->key : entry->value);
+        }
+    }
+
+    *result = collected;
+    return NATIVE_OK;
+}
+
+// keys(map)：按插入顺序返回所有键组成的数组
+NativeStatus keysNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkMapArgument(interpreter, "keys", args))
+    {
+        return NATIVE_ERROR;
+    }
+    return collectMapEntries(interpreter, args[0].as.map, true, result);
+}
+
+// values(map)：按插入顺序返回所有值组成的数组
+NativeStatus valuesNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkMapArgument(interpreter, "values", args))
+    {
+        return NATIVE_ERROR;
+    }
+    return collectMapEntries(interpreter, args[0].as.map, false, result);
+}
+
+// remove(map, key)：从映射变量中就地删除键，返回该键是否存在
+NativeStatus removeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkMapArgument(interpreter, "remove", args))
+    {
+        return NATIVE_ERROR;
+    }
+    *result = createBool(mapRemove(args[0].as.map, args[1]));
+    return NATIVE_OK;
+}
+
+// heap([order][, keyFn])：创建空堆，order 为 "min"（默认）或 "max"，keyFn 为元素求比较键
+NativeStatus heapNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    if (argCount > 2)
+    {
+        runtimeError(interpreter, "heap() 最多接受 2 个参数");
+        return NATIVE_ERROR;
+    }
+
+    bool isMax = false;
+    Value keyFn = createNull();
+    for (int i = 0; i < argCount; i++)
+    {
+        if (i == 0 && args[i].type == VAL_STRING)
+        {
+            if (strcmp(args[i].as.string, "max") == 0)
+            {
+                isMax = true;
+            }
+            else if (strcmp(args[i].as.string, "min") != 0)
+            {
+                runtimeError(interpreter, "heap() 的顺序只能是 \"min\" 或 \"max\"");
+                return NATIVE_ERROR;
+            }
+        }
+        else if (keyFn.type == VAL_NULL &&
+                 (args[i].type == VAL_FUNCTION || args[i].type == VAL_NATIVE_FUNCTION))
+        {
+            keyFn = args[i];
+        }
+        else
+        {
+            runtimeError(interpreter, "heap() 的参数应为顺序（\"min\" 或 \"max\"）和可选的键函数");
+            return NATIVE_ERROR;
+        }
+    }
+
+    *result = createHeap(isMax, keyFn);
+    if (result->type != VAL_HEAP)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+    return NATIVE_OK;
+}
+
+static bool checkHeapArgument(Interpreter *interpreter, const char *name, const Value *args)
+{
+    if (args[0].type != VAL_HEAP)
+    {
+        runtimeError(interpreter, "%s() 的第一个参数必须是堆", name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * heapPush(heap, item)：插入元素，返回插入后的元素个数
+ *
+ * 有键函数时先求键再修改堆。键函数是脚本代码，可能给持有该堆的变量重新赋值，
+ * 因此回调期间固定堆，回调返回后堆仍然有效（此时已不属于任何变量，插入对脚本不可见）。
+ */
+NativeStatus heapPushNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkHeapArgument(interpreter, "heapPush", args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Heap *heap = args[0].as.heap;
+    retainHeap(heap);
+
+    Value key = createNull();
+    if (heap->keyFn.type != VAL_NULL)
+    {
+        key = callCallable(interpreter, heap->keyFn, &args[1], 1);
+        if (interpreter->hadError)
+        {
+            freeValue(key);
+            releaseHeap(heap);
+            return NATIVE_ERROR;
+        }
+    }
+
+    // 所有键须能相互比较，与堆顶比较即可保证这一点
+    Value effectiveKey = key.type != VAL_NULL ? key : args[1];
+    const HeapEntry *top = heapTop(heap);
+    if (!sortKeysComparable(effectiveKey, top != NULL ? heapEntryKey(top) : effectiveKey))
+    {
+        freeValue(key);
+        releaseHeap(heap);
+        runtimeError(interpreter, "heapPush() 的键必须同为数字、字符串或布尔值");
+        return NATIVE_ERROR;
+    }
+
+    bool pushed = heapPush(heap, copyValue(args[1]), key);
+    *result = createInt(heap->count);
+    releaseHeap(heap);
+    if (!pushed)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+    return NATIVE_OK;
+}
+
+// heapPop(heap)：弹出并返回堆顶元素，堆为空时返回 null
+NativeStatus heapPopNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkHeapArgument(interpreter, "heapPop", args))
+    {
+        return NATIVE_ERROR;
+    }
+    if (!heapPop(args[0].as.heap, result))
+    {
+        *result = createNull();
+    }
+    return NATIVE_OK;
+}
+
+// heapPeek(heap)：返回堆顶元素，堆为空时返回 null
+NativeStatus heapPeekNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkHeapArgument(interpreter, "heapPeek", args))
+    {
+        return NATIVE_ERROR;
+    }
+    const HeapEntry *top = heapTop(args[0].as.heap);
+    *result = top != NULL ? copyValue(top->item) : createNull();
+    return NATIVE_OK;
+}
+
+// deque([array])：创建双端队列，可用数组中的元素初始化
+NativeStatus dequeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    if (argCount > 1 || (argCount == 1 && (args[0].type != VAL_ARRAY || args[0].as.array == NULL)))
+    {
+        runtimeError(interpreter, "deque() 只接受一个可选的数组参数");
+        return NATIVE_ERROR;
+    }
+
+    Array *source = argCount == 1 ? args[0].as.array : NULL;
+    *result = createDeque(source != NULL ? source->count : 0);
+    if (result->type != VAL_DEQUE)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+
+    for (int i = 0; source != NULL && i < source->count; i++)
+    {
+        dequePushBack(result->as.deque, copyValue(source->elements[i]));
+    }
+    return NATIVE_OK;
+}
+
+static bool checkDequeArgument(Interpreter *interpreter, const char *name, const Value *args)
+{
+    if (args[0].type != VAL_DEQUE)
+    {
+        runtimeError(interpreter, "%s() 的第一个参数必须是双端队列", name);
+        return false;
+    }
+    return true;
+}
+
+// pushFront(deque, item) / pushBack(deque, item)：在一端插入元素，返回插入后的元素个数
+static NativeStatus dequePushEnd(Interpreter *interpreter, const char *name, const Value *args, bool front, Value *result)
+{
+    if (!checkDequeArgument(interpreter, name, args))
+    {
+        return NATIVE_ERROR;
+    }
+
+    Deque *deque = args[0].as.deque;
+    Value item = copyValue(args[1]);
+    if (!(front ? dequePushFront(deque, item) : dequePushBack(deque, item)))
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+    *result = createInt(deque->count);
+    return NATIVE_OK;
+}
+
+NativeStatus pushFrontNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    return dequePushEnd(interpreter, "pushFront", args, true, result);
+}
+
+NativeStatus pushBackNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    return dequePushEnd(interpreter, "pushBack", args, false, result);
+}
+
+// popFront(deque) / popBack(deque)：从一端取出元素，队列为空时返回 null
+NativeStatus popFrontNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkDequeArgument(interpreter, "popFront", args))
+    {
+        return NATIVE_ERROR;
+    }
+    if (!dequePopFront(args[0].as.deque, result))
+    {
+        *result = createNull();
+    }
+    return NATIVE_OK;
+}
+
+NativeStatus popBackNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkDequeArgument(interpreter, "popBack", args))
+    {
+        return NATIVE_ERROR;
+    }
+    if (!dequePopBack(args[0].as.deque, result))
+    {
+        *result = createNull();
+    }
+    return NATIVE_OK;
+}
+
+// peekFront(deque) / peekBack(deque)：返回一端的元素，队列为空时返回 null
+NativeStatus peekFrontNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkDequeArgument(interpreter, "peekFront", args))
+    {
+        return NATIVE_ERROR;
+    }
+    Deque *deque = args[0].as.deque;
+    *result = deque->count > 0 ? copyValue(*dequeAt(deque, 0)) : createNull();
+    return NATIVE_OK;
+}
+
+NativeStatus peekBackNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (!checkDequeArgument(interpreter, "peekBack", args))
+    {
+        return NATIVE_ERROR;
+    }
+    Deque *deque = args[0].as.deque;
+    *result = deque->count > 0 ? copyValue(*dequeAt(deque, deque->count - 1)) : createNull();
+    return NATIVE_OK;
+}
+
+// toArray(container)：双端队列按队首到队尾，堆按出堆顺序，返回新数组
+NativeStatus toArrayNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    (void)argCount;
+    if (args[0].type == VAL_DEQUE)
+    {
+        *result = dequeToArray(args[0].as.deque);
+    }
+    else if (args[0].type == VAL_HEAP)
+    {
+        *result = heapToArray(args[0].as.heap);
+    }
+    else
+    {
+        runtimeError(interpreter, "toArray() 的参数必须是堆或双端队列");
+        return NATIVE_ERROR;
+    }
+
+    if (result->type != VAL_ARRAY)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+    return NATIVE_OK;
+}
+
+/**
+ * range(end) / range(start, end[, step])：创建整数区间 [start, end)
+ *
+ * 区间只保存端点和步长，for-in 遍历时逐个计算元素，不生成数组。
+ */
+NativeStatus rangeNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    if (argCount < 1 || argCount > 3)
+    {
+        runtimeError(interpreter, "range() 需要 1 到 3 个参数");
+        return NATIVE_ERROR;
+    }
+    for (int i = 0; i < argCount; i++)
+    {
+        if (args[i].type != VAL_INT)
+        {
+            runtimeError(interpreter, "range() 的参数必须是整数");
+            return NATIVE_ERROR;
+        }
+    }
+
+    int64_t start = argCount == 1 ? 0 : args[0].as.integer;
+    int64_t end = argCount == 1 ? args[0].as.integer : args[1].as.integer;
+    int64_t step = argCount == 3 ? args[2].as.integer : 1;
+    if (step == 0)
+    {
+        runtimeError(interpreter, "range() 的步长不能为 0");
+        return NATIVE_ERROR;
+    }
+
+    *result = createRange(start, end, step);
+    if (result->type != VAL_RANGE)
+    {
+        runtimeError(interpreter, "内存分配失败");
+        return NATIVE_ERROR;
+    }
+    return NATIVE_OK;
+}
+
+/**
+ * next(generator[, default])：恢复生成器，返回下一个产出的值
+ *
+ * 生成器已结束时返回 default（默认为 null）。
+ */
+NativeStatus nextNative(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    if (argCount < 1 || argCount > 2)
+    {
+        runtimeError(interpreter, "next() 需要 1 或 2 个参数");
+        return NATIVE_ERROR;
+    }
+    if (args[0].type != VAL_GENERATOR)
+    {
+        runtimeError(interpreter, "next() 的参数必须是生成器");
+        return NATIVE_ERROR;
+    }
+
+    switch (resumeGenerator(interpreter, args[0].as.generator, result))
+    {
+    case GENERATOR_YIELDED:
+        return NATIVE_OK;
+    case GENERATOR_FINISHED:
+        *result = argCount == 2 ? copyValue(args[1]) : createNull();
+        return NATIVE_OK;
+    default:
+        return NATIVE_ERROR;
+    }
+}
@@ -0,0 +1,472 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "numeric_conversion.h"
+
+// 可以精确表示为 double 的 10 的幂
+static const double exactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+#define MAX_EXACT_POWER 22
+
+// uint64 最多能无溢出地累加的十进制位数
+#define MAX_MANTISSA_DIGITS 19
+
+// 慢速路径交给 strtod 时使用的栈缓冲区大小
+#define PARSE_BUFFER_SIZE 128
+
+// 两位数字查找表，每次转换两位以减少除法次数
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static bool isDigitChar(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// 将无符号整数的十进制数字写入 buffer，返回位数（不写 '\0'）
+static int writeUnsigned(uint64_t value, char *buffer)
+{
+    char temp[24];
+    int pos = sizeof(temp);
+
+    while (value >= 100)
+    {
+        int pair = (int)(value % 100) * 2;
+        value /= 100;
+        temp[--pos] = digitPairs[pair + 1];
+        temp[--pos] = digitPairs[pair];
+    }
+    if (value >= 10)
+    {
+        int pair = (int)value * 2;
+        temp[--pos] = digitPairs[pair + 1];
+        temp[--pos] = digitPairs[pair];
+    }
+    else
+    {
+        temp[--pos] = (char)('0' + value);
+    }
+
+    int length = (int)sizeof(temp) - pos;
+    memcpy(buffer, temp + pos, (size_t)length);
+    return length;
+}
+
+int formatInt64(int64_t value, char *buffer)
+{
+    int length = 0;
+    uint64_t magnitude = (uint64_t)value;
+
+    if (value < 0)
+    {
+        buffer[length++] = '-';
+        magnitude = 0 - magnitude; // 对 INT64_MIN 同样正确
+    }
+
+    length += writeUnsigned(magnitude, buffer + length);
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * 将十进制数字串排版为最终文本
+ *
+ * 数值为 0.digits × 10^point，digits 不含前导零和尾随零。
+ */
+static int layoutDecimal(bool negative, const char *digits, int digitCount, int point, char *buffer)
+{
+    int length = 0;
+    int exponent = point - 1;
+
+    if (negative)
+    {
+        buffer[length++] = '-';
+    }
+
+    if (exponent < -4 || exponent >= 21)
+    {
+        // 科学计数法，指数格式与 printf 的 %g 一致（至少两位）
+        buffer[length++] = digits[0];
+        if (digitCount > 1)
+        {
+            buffer[length++] = '.';
+            memcpy(buffer + length, digits + 1, (size_t)(digitCount - 1));
+            length += digitCount - 1;
+        }
+        buffer[length++] = 'e';
+        buffer[length++] = exponent < 0 ? '-' : '+';
+        int absExponent = exponent < 0 ? -exponent : exponent;
+        if (absExponent < 10)
+        {
+            buffer[length++] = '0';
+        }
+        length += writeUnsigned((uint64_t)absExponent, buffer + length);
+    }
+    else if (point <= 0)
+    {
+        // 0.000ddd
+        buffer[length++] = '0';
+        buffer[length++] = '.';
+        memset(buffer + length, '0', (size_t)-point);
+        length += -point;
+        memcpy(buffer + length, digits, (size_t)digitCount);
+        length += digitCount;
+    }
+    else if (point >= digitCount)
+    {
+        // ddd000
+        memcpy(buffer + length, digits, (size_t)digitCount);
+        length += digitCount;
+        memset(buffer + length, '0', (size_t)(point - digitCount));
+        length += point - digitCount;
+    }
+    else
+    {
+        // ddd.ddd
+        memcpy(buffer + length, digits, (size_t)point);
+        length += point;
+        buffer[length++] = '.';
+        memcpy(buffer + length, digits + point, (size_t)(digitCount - point));
+        length += digitCount - point;
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * 快速路径：寻找最小的 k，使 round(x × 10^k) / 10^k 精确等于 x
+ *
+ * 限制 m < 2^50 保证 x × 10^k 的舍入误差远小于 0.5，此时找到的 k 就是
+ * 最少的小数位数，对应的 m 就是最短的十进制表示。报表中常见的金额、
+ * 百分比等短小数都由这里处理，无需 snprintf。
+ */
+static bool shortestByScaling(double magnitude, uint64_t *mantissa, int *scale)
+{
+    for (int k = 1; k <= MAX_EXACT_POWER; k++)
+    {
+        double scaled = magnitude * exactPowersOfTen[k];
+        if (scaled >= 1125899906842624.0) // 2^50
+        {
+            return false;
+        }
+
+        uint64_t m = (uint64_t)(scaled + 0.5);
+        if ((double)m / exactPowersOfTen[k] == magnitude)
+        {
+            *mantissa = m;
+            *scale = k;
+            return true;
+        }
+    }
+    return false;
+}
+
+int formatDouble(double value, char *buffer)
+{
+    if (value != value)
+    {
+        memcpy(buffer, "nan", 4);
+        return 3;
+    }
+    if (isinf(value))
+    {
+        if (value > 0)
+        {
+            memcpy(buffer, "inf", 4);
+            return 3;
+        }
+        memcpy(buffer, "-inf", 5);
+        return 4;
+    }
+
+    // 整数值（包括 -0）直接按整数输出
+    if (value > -9007199254740992.0 && value < 9007199254740992.0 && value == (double)(int64_t)value)
+    {
+        return formatInt64((int64_t)value, buffer);
+    }
+
+    bool negative = value < 0;
+    double magnitude = negative ? -value : value;
+    char digits[24];
+    int digitCount;
+    int point;
+
+    uint64_t mantissa;
+    int scale;
+    if (shortestByScaling(magnitude, &mantissa, &scale))
+    {
+        while (mantissa % 10 == 0)
+        {
+            mantissa /= 10;
+            scale--;
+        }
+        digitCount = writeUnsigned(mantissa, digits);
+        point = digitCount - scale;
+    }
+    else
+    {
+        // 慢速路径：依次尝试 15、16、17 位有效数字，取第一个能精确还原的结果。
+        // 任何不超过 15 位且能还原的表示必然等于 15 位的正确舍入，因此结果最短。
+        // 非规格化数的精度更低，需要从 1 位开始尝试。
+        char temp[40];
+        int precision = magnitude < 2.2250738585072014e-308 ? 1 : 15;
+        for (;; precision++)
+        {
+            snprintf(temp, sizeof(temp), "%.*e", precision - 1, magnitude);
+            if (precision == 17 || strtod(temp, NULL) == magnitude)
+            {
+                break;
+            }
+        }
+
+        // temp 形如 d.dddde+XX
+        digitCount = 0;
+        const char *p = temp;
+        for (; *p != 'e'; p++)
+        {
+            if (*p != '.')
+            {
+                digits[digitCount++] = *p;
+            }
+        }
+        point = atoi(p + 1) + 1;
+        while (digitCount > 1 && digits[digitCount - 1] == '0')
+        {
+            digitCount--;
+        }
+    }
+
+    return layoutDecimal(negative, digits, digitCount, point, buffer);
+}
+
+int formatNumberValue(Value value, char *buffer)
+{
+    if (value.type == VAL_INT)
+    {
+        return formatInt64(value.as.integer, buffer);
+    }
+    return formatDouble(value.as.number, buffer);
+}
+
+static NumberParseStatus parseFailed(ParsedNumber *result, NumberParseStatus status, size_t offset)
+{
+    result->isInteger = false;
+    result->integer = 0;
+    result->number = 0;
+    result->errorOffset = offset;
+    return status;
+}
+
+NumberParseStatus parseNumber(const char *text, size_t length, ParsedNumber *result)
+{
+    size_t start = 0;
+    size_t end = length;
+
+    while (start < end && isSpace(text[start]))
+    {
+        start++;
+    }
+    while (end > start && isSpace(text[end - 1]))
+    {
+        end--;
+    }
+    if (start == end)
+    {
+        return parseFailed(result, NUMBER_PARSE_EMPTY, start);
+    }
+
+    size_t pos = start;
+    bool negative = false;
+    if (text[pos] == '+' || text[pos] == '-')
+    {
+        negative = text[pos] == '-';
+        pos++;
+    }
+
+    // 最多累加 19 位有效数字，其余的位只影响指数和精度
+    uint64_t mantissa = 0;
+    int mantissaDigits = 0;
+    int exponent = 0;
+    bool truncated = false;
+    bool sawDigit = false;
+    bool isInteger = true;
+
+    while (pos < end && isDigitChar(text[pos]))
+    {
+        int digit = text[pos++] - '0';
+        sawDigit = true;
+        if (mantissaDigits < MAX_MANTISSA_DIGITS)
+        {
+            mantissa = mantissa * 10 + (uint64_t)digit;
+            if (mantissa != 0)
+            {
+                mantissaDigits++;
+            }
+        }
+        else
+        {
+            exponent++;
+            truncated = truncated || digit != 0;
+        }
+    }
+
+    if (pos < end && text[pos] == '.')
+    {
+        isInteger = false;
+        pos++;
+        while (pos < end && isDigitChar(text[pos]))
+        {
+            int digit = text[pos++] - '0';
+            sawDigit = true;
+            if (mantissaDigits < MAX_MANTISSA_DIGITS)
+            {
+                mantissa = mantissa * 10 + (uint64_t)digit;
+                exponent--;
+                if (mantissa != 0)
+                {
+                    mantissaDigits++;
+                }
+            }
+            else
+            {
+                truncated = truncated || digit != 0;
+            }
+        }
+    }
+
+    if (!sawDigit)
+    {
+        return parseFailed(result, NUMBER_PARSE_INVALID, pos);
+    }
+
+    if (pos < end && (text[pos] == 'e' || text[pos] == 'E'))
+    {
+        isInteger = false;
+        pos++;
+        bool negativeExponent = false;
+        if (pos < end && (text[pos] == '+' || text[pos] == '-'))
+        {
+            negativeExponent = text[pos] == '-';
+            pos++;
+        }
+        if (pos >= end || !isDigitChar(text[pos]))
+        {
+            return parseFailed(result, NUMBER_PARSE_INVALID, pos);
+        }
+
+        int explicitExponent = 0;
+        while (pos < end && isDigitChar(text[pos]))
+        {
+            // 远超 double 范围的指数只需要保持“足够大”
+            if (explicitExponent < 100000)
+            {
+                explicitExponent = explicitExponent * 10 + (text[pos] - '0');
+            }
+            pos++;
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    if (pos != end)
+    {
+        return parseFailed(result, NUMBER_PARSE_INVALID, pos);
+    }
+
+    result->errorOffset = 0;
+
+    if (isInteger && !truncated && exponent == 0)
+    {
+        if (mantissa <= (uint64_t)INT64_MAX)
+        {
+            int64_t integer = (int64_t)mantissa;
+            result->isInteger = true;
+            result->integer = negative ? -integer : integer;
+            result->number = (double)result->integer;
+            return NUMBER_PARSE_OK;
+        }
+        if (negative && mantissa == (uint64_t)INT64_MAX + 1)
+        {
+            result->isInteger = true;
+            result->integer = INT64_MIN;
+            result->number = (double)INT64_MIN;
+            return NUMBER_PARSE_OK;
+        }
+        // 超出 int64 范围，按浮点数处理
+    }
+
+    result->isInteger = false;
+    result->integer = 0;
+
+    // Clinger 快速路径：尾数和 10 的幂都能精确表示时，一次乘除即得到正确舍入的结果
+    if (!truncated && mantissa <= 9007199254740992ULL &&
+        exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER)
+    {
+        double number = (double)mantissa;
+        if (exponent >= 0)
+        {
+            number *= exactPowersOfTen[exponent];
+        }
+        else
+        {
+            number /= exactPowersOfTen[-exponent];
+        }
+        result->number = negative ? -number : number;
+        return NUMBER_PARSE_OK;
+    }
+
+    // 慢速路径：复制到栈缓冲区后交给 strtod，保证正确舍入
+    size_t textLength = end - start;
+    if (textLength >= PARSE_BUFFER_SIZE)
+    {
+        return parseFailed(result, NUMBER_PARSE_TOO_LONG, start);
+    }
+
+    char buffer[PARSE_BUFFER_SIZE];
+    memcpy(buffer, text + start, textLength);
+    buffer[textLength] = '\0';
+
+    double number = strtod(buffer, NULL);
+    if (isinf(number))
+    {
+        return parseFailed(result, NUMBER_PARSE_OUT_OF_RANGE, start);
+    }
+
+    result->number = number;
+    return NUMBER_PARSE_OK;
+}
+
+const char *numberParseStatusMessage(NumberParseStatus status)
+{
+    switch (status)
+    {
+    case NUMBER_PARSE_OK:
+        return "成功";
+    case NUMBER_PARSE_EMPTY:
+        return "空字符串";
+    case NUMBER_PARSE_INVALID:
+        return "不是有效的数字";
+    case NUMBER_PARSE_OUT_OF_RANGE:
+        return "数值超出范围";
+    case NUMBER_PARSE_TOO_LONG:
+        return "数字文本过长";
+    }
+    return "未知错误";
+}
@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "output_buffer.h"
+
+void initOutputBuffer(OutputBuffer *buffer, int fd, OutputMode mode)
+{
+    buffer->fd = fd;
+    buffer->mode = mode;
+    buffer->length = 0;
+    buffer->failed = false;
+
+    // 分配失败时容量为 0，所有输出直接写入 fd
+    buffer->data = (char *)malloc(OUTPUT_BUFFER_CAPACITY);
+    buffer->capacity = buffer->data != NULL ? OUTPUT_BUFFER_CAPACITY : 0;
+}
+
+void initOutputCapture(OutputBuffer *buffer)
+{
+    initOutputBuffer(buffer, -1, OUTPUT_FULLY_BUFFERED);
+}
+
+void freeOutputBuffer(OutputBuffer *buffer)
+{
+    flushOutput(buffer);
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->capacity = 0;
+}
+
+OutputMode defaultOutputMode(int fd)
+{
+    const char *setting = getenv("SPARROW_OUTPUT_BUFFERING");
+    if (setting != NULL)
+    {
+        if (strcmp(setting, "line") == 0)
+        {
+            return OUTPUT_LINE_BUFFERED;
+        }
+        if (strcmp(setting, "full") == 0)
+        {
+            return OUTPUT_FULLY_BUFFERED;
+        }
+    }
+
+    // 与 stdio 的默认行为一致：终端按行缓冲，其余全缓冲
+    return isatty(fd) ? OUTPUT_LINE_BUFFERED : OUTPUT_FULLY_BUFFERED;
+}
+
+void setOutputMode(OutputBuffer *buffer, OutputMode mode)
+{
+    buffer->mode = mode;
+    if (mode == OUTPUT_LINE_BUFFERED && buffer->length > 0 &&
+        memchr(buffer->data, '\n', buffer->length) != NULL)
+    {
+        flushOutput(buffer);
+    }
+}
+
+// 写出全部数据，处理部分写入和信号中断
+static bool writeAll(OutputBuffer *buffer, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(buffer->fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            buffer->failed = true;
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+bool flushOutput(OutputBuffer *buffer)
+{
+    // 先送出 stdio 中可能残留的诊断信息，保持输出顺序
+    if (buffer->fd == STDOUT_FILENO)
+    {
+        fflush(stdout);
+    }
+
+    // 捕获模式：输出留在缓冲区中
+    if (buffer->fd < 0)
+    {
+        return !buffer->failed;
+    }
+
+    if (buffer->length == 0 || buffer->failed)
+    {
+        buffer->length = 0;
+        return !buffer->failed;
+    }
+
+    bool ok = writeAll(buffer, buffer->data, buffer->length);
+    buffer->length = 0;
+    return ok;
+}
+
+// 捕获模式下扩大缓冲区以容纳 length 字节；失败时丢弃后续输出
+static bool growCapture(OutputBuffer *buffer, size_t length)
+{
+    size_t capacity = buffer->capacity > 0 ? buffer->capacity : OUTPUT_BUFFER_CAPACITY;
+    while (capacity - buffer->length < length)
+    {
+        capacity *= 2;
+    }
+    char *data = (char *)realloc(buffer->data, capacity);
+    if (data == NULL)
+    {
+        buffer->failed = true;
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+void outputWrite(OutputBuffer *buffer, const char *data, size_t length)
+{
+    if (length == 0 || buffer->failed)
+    {
+        return;
+    }
+
+    if (length > buffer->capacity - buffer->length && buffer->fd < 0)
+    {
+        if (!growCapture(buffer, length))
+        {
+            return;
+        }
+    }
+    else if (length > buffer->capacity - buffer->length)
+    {
+        flushOutput(buffer);
+
+        // 比缓冲区还大的数据不再复制，直接写出
+        if (length >= buffer->capacity)
+        {
+            writeAll(buffer, data, length);
+            return;
+        }
+    }
+
+    memcpy(buffer->data + buffer->length, data, length);
+    buffer->length += length;
+
+    if (buffer->mode == OUTPUT_LINE_BUFFERED && memchr(data, '\n', length) != NULL)
+    {
+        flushOutput(buffer);
+    }
+}
+
+void outputString(OutputBuffer *buffer, const char *str)
+{
+    outputWrite(buffer, str, strlen(str));
+}
+
+void outputChar(OutputBuffer *buffer, char c)
+{
+    if (buffer->length < buffer->capacity)
+    {
+        buffer->data[buffer->length++] = c;
+        if (c == '\n' && buffer->mode == OUTPUT_LINE_BUFFERED)
+        {
+            flushOutput(buffer);
+        }
+        return;
+    }
+    outputWrite(buffer, &c, 1);
+}
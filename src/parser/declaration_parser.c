@@ -187,6 +187,145 @@ Stmt *declaration(Parser *parser)
     return statement(parser);
 }
 
+/**
+ * 为 [start, current) 的标记创建延迟函数体
+ *
+ * 数组模式直接引用标记数组；流式模式或正在解析复制出的函数体时，
+ * 复制这段标记并在末尾加上 TOKEN_EOF，使之后的解析不会越界读取。
+ */
+static Stmt *createLazyBodyStmt(Parser *parser, int start, bool hasYield)
+{
+    static char eofLexeme[] = "";
+    int count = parser->current - start;
+    if (parser->lexer == NULL && !parser->copyFunctionBodies)
+    {
+        return createLazyBlockStmt(parser->tokens + start, count, hasYield);
+    }
+
+    Token *tokens = (Token *)malloc(sizeof(Token) * (size_t)(count + 1));
+    if (tokens == NULL)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        tokens[i] = *tokenAt(parser, start + i);
+    }
+    tokens[count] = tokens[count - 1];
+    tokens[count].type = TOKEN_EOF;
+    tokens[count].lexeme = eofLexeme;
+
+    Stmt *body = createLazyBlockStmt(tokens, count, hasYield);
+    if (body == NULL)
+    {
+        free(tokens);
+        return NULL;
+    }
+    body->as.block.lazy->ownsTokens = true;
+    return body;
+}
+
+/**
+ * 预解析函数体：从 '{' 之后找到匹配的 '}'，返回记录该标记范围的延迟函数体
+ *
+ * 花括号只出现在代码块、结构体声明和字面量、映射字面量中，总是成对出现。
+ * 同时记录函数体中是否含有 yield（不计嵌套的函数声明），使函数在解析之前就能确定是否为生成器。
+ * 找不到匹配的 '}' 时不前进并返回 NULL。
+ * 流式模式下扫描期间设置 mark 保留函数体的标记，找到后复制一份（见 copyBodyTokens）。
+ */
+static Stmt *skipFunctionBody(Parser *parser)
+{
+    int start = parser->current;
+    int savedMark = parser->mark;
+    if (parser->mark < 0)
+    {
+        parser->mark = start;
+    }
+    int depth = 1;
+    int nestedDepth = 0;         // 嵌套函数体开始处的深度，0 表示不在嵌套函数体中
+    bool pendingFunction = false; // 遇到 function，下一个 '{' 开始嵌套的函数体
+    bool hasYield = false;
+
+    while (!isAtEnd(parser))
+    {
+        TokenType type = tokenAt(parser, parser->current++)->type;
+        if (type == TOKEN_LBRACE)
+        {
+            depth++;
+            if (pendingFunction)
+            {
+                nestedDepth = depth;
+                pendingFunction = false;
+            }
+        }
+        else if (type == TOKEN_RBRACE)
+        {
+            if (depth == nestedDepth)
+            {
+                nestedDepth = 0;
+            }
+            if (--depth == 0)
+            {
+                Stmt *body = createLazyBodyStmt(parser, start, hasYield);
+                parser->mark = savedMark;
+                if (body != NULL)
+                {
+                    return body;
+                }
+                parser->current = start;
+                return NULL;
+            }
+        }
+        else if (type == TOKEN_FUNCTION && nestedDepth == 0)
+        {
+            pendingFunction = true;
+        }
+        else if (type == TOKEN_YIELD && nestedDepth == 0)
+        {
+            hasYield = true;
+        }
+    }
+
+    parser->mark = savedMark;
+    parser->current = start;
+    return NULL;
+}
+
+/**
+ * 解析延迟的函数体
+ *
+ * 在记录的标记范围上解析代码块（其中的函数声明同样延迟），把语句移入 body 并重新标记 yield。
+ * 函数体持有的标记在解析后释放，其中嵌套的函数体因此各自复制标记。
+ */
+bool parseLazyBody(Stmt *body, char *error, size_t errorSize)
+{
+    LazyBody *lazy = body->as.block.lazy;
+    Parser parser;
+    initParser(&parser, lazy->tokens, lazy->tokenCount);
+    parser.lazyFunctions = true;
+    parser.copyFunctionBodies = lazy->ownsTokens;
+
+    Stmt *block = blockStatement(&parser);
+    if (block == NULL || hadParseError(&parser))
+    {
+        snprintf(error, errorSize, "Parse error: %s", getParseErrorMsg(&parser));
+        freeStmt(block);
+        return false;
+    }
+
+    body->as.block.statements = block->as.block.statements;
+    body->as.block.count = block->as.block.count;
+    body->as.block.lazy = NULL;
+    free(block);
+    if (lazy->ownsTokens)
+    {
+        free(lazy->tokens);
+    }
+    free(lazy);
+    markYieldStatements(body);
+    return true;
+}
+
 /**
  * 解析函数声明语句
  *
@@ -387,7 +526,13 @@ Stmt *functionDeclaration(Parser *parser)
         return NULL;
     }
 
-    Stmt *body = blockStatement(parser);
+    // 预解析模式下只匹配花括号；找不到匹配的 '}' 时照常解析以报告错误
+    Stmt *body = parser->lazyFunctions ? skipFunctionBody(parser) : NULL;
+    if (body == NULL && enterNesting(parser))
+    {
+        body = blockStatement(parser);
+        leaveNesting(parser);
+    }
     if (parser->hadError)
     {
         if (parameters)
@@ -404,9 +549,11 @@ Stmt *functionDeclaration(Parser *parser)
     // 现在传递正确的类型
     Stmt *result = createFunctionStmt(name, parameters, paramHasVarFlags, paramTypes, paramCount, returnTypeAnnotation, body);
 
-    // 清理临时的Token类型数组
+    // 清理临时的Token类型数组；参数类型已由 createFunctionStmt 复制
     if (paramTokenTypes)
         free(paramTokenTypes);
+    if (paramTypes)
+        free(paramTypes);
 
     return result;
 }
@@ -692,7 +839,7 @@ Stmt *enumDeclaration(Parser *parser)
                 // 如果是数字字面量，更新当前值
                 if (value->type == EXPR_LITERAL && value->as.literal.value.type == TOKEN_INTEGER)
                 {
-                    currentValue = value->as.literal.value.value.intValue;
+                    currentValue = (int)value->as.literal.value.value.intValue;
                 }
             }
 
@@ -4,24 +4,111 @@
 #include <stdlib.h>
 #include "../include/parser/expression_parser.h"
 
+/**
+ * 表达式解析：优先级爬升（Pratt）
+ *
+ * 二元运算符的优先级和结合性由 binaryPrecedence 表给出，binary() 在一层循环中处理所有二元运算符，
+ * 每个操作数只经过 unary → call → primary，不再逐级经过 logicalOr、logicalAnd、……、factor。
+ * 运算符都按标记类型分派，只读取当前标记的类型，不复制 Token。
+ * 得到的语法树与逐级递归下降相同（见 bench/expressions.spw 和 bench/expressions.ast）。
+ */
+
+// 二元运算符的优先级，数值越大结合越紧；全部左结合
+typedef enum
+{
+    PREC_NONE,       // 不是二元运算符
+    PREC_OR,         // ||
+    PREC_AND,        // &&
+    PREC_EQUALITY,   // == !=
+    PREC_COMPARISON, // < <= > >= in
+    PREC_TERM,       // + -
+    PREC_FACTOR      // * / %
+} Precedence;
+
+static const unsigned char binaryPrecedence[TOKEN_ERROR + 1] = {
+    [TOKEN_OR] = PREC_OR,
+    [TOKEN_AND] = PREC_AND,
+    [TOKEN_EQ] = PREC_EQUALITY,
+    [TOKEN_NE] = PREC_EQUALITY,
+    [TOKEN_LT] = PREC_COMPARISON,
+    [TOKEN_LE] = PREC_COMPARISON,
+    [TOKEN_GT] = PREC_COMPARISON,
+    [TOKEN_GE] = PREC_COMPARISON,
+    [TOKEN_IN] = PREC_COMPARISON,
+    [TOKEN_PLUS] = PREC_TERM,
+    [TOKEN_MINUS] = PREC_TERM,
+    [TOKEN_MULTIPLY] = PREC_FACTOR,
+    [TOKEN_DIVIDE] = PREC_FACTOR,
+    [TOKEN_MODULO] = PREC_FACTOR,
+};
+
+// 当前标记的类型
+static TokenType peekType(Parser *parser)
+{
+    return tokenAt(parser, parser->current)->type;
+}
+
 // 解析表达式
 Expr *expression(Parser *parser)
 {
     return assignment(parser);
 }
 
-// 解析赋值表达式
+// 解析优先级不低于 minPrecedence 的二元运算，右操作数只接受更高的优先级，从而左结合
+static Expr *binary(Parser *parser, int minPrecedence)
+{
+    Expr *expr = unary(parser);
+    int depth = parser->depth;
+
+    while (true)
+    {
+        TokenType operator = peekType(parser);
+        int precedence = binaryPrecedence[operator];
+        if (precedence == PREC_NONE || precedence < minPrecedence)
+        {
+            parser->depth = depth;
+            return expr;
+        }
+        // 左结合的运算链每多一个运算符，语法树加深一层
+        if (!enterNesting(parser))
+        {
+            parser->depth = depth;
+            freeExpr(expr);
+            return NULL;
+        }
+        parser->current++;
+        Expr *right = binary(parser, precedence + 1);
+        expr = createBinaryExpr(expr, operator, right);
+    }
+}
+
+static Expr *assignmentBody(Parser *parser);
+
+// 解析赋值表达式；每个子表达式和右结合的赋值链每层加深一层
 Expr *assignment(Parser *parser)
 {
-    Expr *expr = logicalOr(parser);
+    if (!enterNesting(parser))
+    {
+        return NULL;
+    }
+    Expr *expr = assignmentBody(parser);
+    leaveNesting(parser);
+    return expr;
+}
+
+static Expr *assignmentBody(Parser *parser)
+{
+    Expr *expr = binary(parser, PREC_OR);
 
     if (expr == NULL)
     {
         return NULL; // 直接返回NULL，不设置错误消息
     }
 
-    if (match(parser, TOKEN_ASSIGN))
+    TokenType operator = peekType(parser);
+    if (operator == TOKEN_ASSIGN)
     {
+        parser->current++;
         Expr *value = assignment(parser);
         if (value == NULL)
         {
@@ -54,177 +141,91 @@ Expr *assignment(Parser *parser)
         return NULL;
     }
 
-    return expr;
-}
-
-Expr *logicalOr(Parser *parser)
-{
-    Expr *expr = logicalAnd(parser);
-
-    while (match(parser, TOKEN_OR))
+    if (operator == TOKEN_PLUS_ASSIGN || operator == TOKEN_MINUS_ASSIGN ||
+        operator == TOKEN_MULTIPLY_ASSIGN || operator == TOKEN_DIVIDE_ASSIGN ||
+        operator == TOKEN_MODULO_ASSIGN)
     {
-        TokenType operator = previous(parser).type;
-        Expr *right = logicalAnd(parser);
-        expr = createBinaryExpr(expr, operator, right);
-    }
-
-    return expr;
-}
-
-Expr *logicalAnd(Parser *parser)
-{
-    Expr *expr = equality(parser);
-
-    while (match(parser, TOKEN_AND))
-    {
-        TokenType operator = previous(parser).type;
-        Expr *right = equality(parser);
-        expr = createBinaryExpr(expr, operator, right);
-    }
-
-    return expr;
-}
-
-// 解析相等性表达式
-Expr *equality(Parser *parser)
-{
-    Expr *expr = comparison(parser);
-
-    while (match(parser, TOKEN_EQ) || match(parser, TOKEN_NE))
-    {
-        TokenType operator = previous(parser).type;
-        Expr *right = comparison(parser);
-        expr = createBinaryExpr(expr, operator, right);
-    }
-
-    return expr;
-}
+        parser->current++;
+        Expr *value = assignment(parser);
+        if (value == NULL)
+        {
+            freeExpr(expr);
+            return NULL;
+        }
 
-// 解析比较表达式
-Expr *comparison(Parser *parser)
-{
-    Expr *expr = term(parser);
+        // 复合赋值保留完整的访问表达式，由解释器原地更新目标
+        if (expr->type == EXPR_VARIABLE || expr->type == EXPR_ARRAY_ACCESS ||
+            expr->type == EXPR_DOT_ACCESS)
+        {
+            return createCompoundAssignExpr(expr, operator, value);
+        }
 
-    while (match(parser, TOKEN_LT) || match(parser, TOKEN_LE) ||
-           match(parser, TOKEN_GT) || match(parser, TOKEN_GE) ||
-           match(parser, TOKEN_IN))
-    {
-        TokenType operator = previous(parser).type;
-        Expr *right = term(parser);
-        expr = createBinaryExpr(expr, operator, right);
+        error(parser, "Invalid compound assignment target.");
+        freeExpr(expr);
+        freeExpr(value);
+        return NULL;
     }
 
     return expr;
 }
 
-// 解析加减表达式
-Expr *term(Parser *parser)
+// 类型转换 (type) 中类型关键字对应的类型，不是类型关键字时为 TYPE_ANY
+static BaseType castType(TokenType type)
 {
-    Expr *expr = factor(parser);
-
-    while (match(parser, TOKEN_PLUS) || match(parser, TOKEN_MINUS))
+    switch (type)
     {
-        TokenType operator = previous(parser).type;
-        Expr *right = factor(parser);
-        expr = createBinaryExpr(expr, operator, right);
+    case TOKEN_INT:
+        return TYPE_INT;
+    case TOKEN_FLOAT_TYPE:
+        return TYPE_FLOAT;
+    case TOKEN_DOUBLE:
+        return TYPE_DOUBLE;
+    case TOKEN_STRING_TYPE:
+        return TYPE_STRING;
+    case TOKEN_BOOL:
+        return TYPE_BOOL;
+    default:
+        return TYPE_ANY;
     }
-
-    return expr;
 }
 
-// 解析乘除表达式
-Expr *factor(Parser *parser)
-{
-    Expr *expr = unary(parser);
-
-    while (match(parser, TOKEN_MULTIPLY) || match(parser, TOKEN_DIVIDE) || match(parser, TOKEN_MODULO))
-    {
-        TokenType operator = previous(parser).type;
-        Expr *right = unary(parser);
-        expr = createBinaryExpr(expr, operator, right);
-    }
-
-    return expr;
-}
+static Expr *prefixOperand(Parser *parser);
 
 // 解析一元表达式
 Expr *unary(Parser *parser)
 {
-    // 检查类型转换：(type)expression
-    if (match(parser, TOKEN_LPAREN))
+    TokenType operator = peekType(parser);
+    switch (operator)
     {
-        // 检查是否为类型转换
-        BaseType castType = TYPE_ANY;
-        bool isCast = false;
-
-        if (check(parser, TOKEN_INT))
-        {
-            castType = TYPE_INT;
-            isCast = true;
-        }
-        else if (check(parser, TOKEN_FLOAT_TYPE))
-        {
-            castType = TYPE_FLOAT;
-            isCast = true;
-        }
-        else if (check(parser, TOKEN_DOUBLE))
-        {
-            castType = TYPE_DOUBLE;
-            isCast = true;
-        }
-        else if (check(parser, TOKEN_STRING_TYPE))
-        {
-            castType = TYPE_STRING;
-            isCast = true;
-        }
-        else if (check(parser, TOKEN_BOOL))
+    case TOKEN_LPAREN:
+    {
+        // 类型转换：(type)expression；'(' 之后不是类型关键字时按分组表达式处理
+        BaseType targetType = castType(tokenAt(parser, parser->current + 1)->type);
+        if (targetType == TYPE_ANY)
         {
-            castType = TYPE_BOOL;
-            isCast = true;
+            break;
         }
+        parser->current += 2; // 消费 '(' 和类型 token
+        consume(parser, TOKEN_RPAREN, "Expect ')' after cast type.");
+        if (parser->hadError)
+            return NULL;
 
-        if (isCast)
+        Expr *expression = prefixOperand(parser);
+        if (parser->hadError)
         {
-            advance(parser); // 消费类型 token
-            consume(parser, TOKEN_RPAREN, "Expect ')' after cast type.");
-            if (parser->hadError)
-                return NULL;
-
-            Expr *expression = unary(parser);
-            if (parser->hadError)
-            {
-                if (expression)
-                    freeExpr(expression);
-                return NULL;
-            }
-
-            return createCastExpr(castType, expression);
+            if (expression)
+                freeExpr(expression);
+            return NULL;
         }
-        else
-        {
-            // 不是类型转换，退回并按分组表达式处理
-            parser->current--; // 退回 '('
 
-            // 继续处理其他一元表达式
-            if (match(parser, TOKEN_NOT) || match(parser, TOKEN_MINUS) || match(parser, TOKEN_PLUS))
-            {
-                TokenType operator = previous(parser).type;
-                Expr *right = unary(parser);
-                if (parser->hadError)
-                {
-                    if (right)
-                        freeExpr(right);
-                    return NULL;
-                }
-                return createUnaryExpr(operator, right);
-            }
-        }
+        return createCastExpr(targetType, expression);
     }
-
-    if (match(parser, TOKEN_NOT) || match(parser, TOKEN_MINUS) || match(parser, TOKEN_PLUS))
+    case TOKEN_NOT:
+    case TOKEN_MINUS:
+    case TOKEN_PLUS:
     {
-        TokenType operator = previous(parser).type;
-        Expr *right = unary(parser);
+        parser->current++;
+        Expr *right = prefixOperand(parser);
         if (parser->hadError)
         {
             if (right)
@@ -233,12 +234,12 @@ Expr *unary(Parser *parser)
         }
         return createUnaryExpr(operator, right);
     }
-
-    // 处理前缀运算符
-    if (match(parser, TOKEN_PLUS_PLUS) || match(parser, TOKEN_MINUS_MINUS))
+    case TOKEN_PLUS_PLUS:
+    case TOKEN_MINUS_MINUS:
     {
-        TokenType operator = previous(parser).type;
-        Expr *right = unary(parser);
+        // 前缀运算符
+        parser->current++;
+        Expr *right = prefixOperand(parser);
         if (parser->hadError)
         {
             if (right)
@@ -257,24 +258,144 @@ Expr *unary(Parser *parser)
 
         return createPrefixExpr(right, operator);
     }
+    default:
+        break;
+    }
 
     return call(parser);
 }
 
-// 解析调用表达式
+// 前缀运算符和类型转换的操作数，每个前缀运算符加深一层
+static Expr *prefixOperand(Parser *parser)
+{
+    if (!enterNesting(parser))
+    {
+        return NULL;
+    }
+    Expr *expr = unary(parser);
+    leaveNesting(parser);
+    return expr;
+}
+
+// 解析结构体字面量：StructName { field1: value1, field2: value2 }，'{' 已被消费
+static Expr *structLiteral(Parser *parser, Expr *expr)
+{
+    if (expr->type != EXPR_VARIABLE)
+    {
+        error(parser, "Expected struct name before '{'.");
+        freeExpr(expr);
+        return NULL;
+    }
+
+    Token structName = expr->as.variable.name;
+    freeExpr(expr); // 释放变量表达式，因为我们要创建结构体字面量
+
+    // 解析字段初始化列表
+    StructFieldInit *fields = NULL;
+    int fieldCount = 0;
+    int capacity = 0;
+
+    if (!check(parser, TOKEN_RBRACE))
+    {
+        do
+        {
+            // 扩展容量
+            if (fieldCount >= capacity)
+            {
+                capacity = capacity == 0 ? 4 : capacity * 2;
+                fields = (StructFieldInit *)realloc(fields, capacity * sizeof(StructFieldInit));
+                if (fields == NULL)
+                {
+                    error(parser, "Memory allocation failed.");
+                    return NULL;
+                }
+            }
+
+            // 解析字段名
+            Token fieldName = consume(parser, TOKEN_IDENTIFIER, "Expect field name.");
+            if (parser->hadError)
+            {
+                if (fields) free(fields);
+                return NULL;
+            }
+
+            // 期望冒号
+            consume(parser, TOKEN_COLON, "Expect ':' after field name.");
+            if (parser->hadError)
+            {
+                if (fields) free(fields);
+                return NULL;
+            }
+
+            // 解析字段值
+            Expr *fieldValue = expression(parser);
+            if (parser->hadError)
+            {
+                if (fields) free(fields);
+                return NULL;
+            }
+
+            // 添加字段
+            fields[fieldCount].name = fieldName;
+            fields[fieldCount].value = fieldValue;
+            fieldCount++;
+
+        } while (match(parser, TOKEN_COMMA));
+    }
+
+    consume(parser, TOKEN_RBRACE, "Expect '}' after struct fields.");
+    if (parser->hadError)
+    {
+        // 清理内存
+        for (int i = 0; i < fieldCount; i++)
+        {
+            freeExpr(fields[i].value);
+        }
+        if (fields) free(fields);
+        return NULL;
+    }
+
+    return createStructLiteralExpr(structName, fields, fieldCount);
+}
+
+static Expr *callChain(Parser *parser, Expr *expr);
+
+// 解析调用表达式：primary 之后的调用、下标、成员访问、结构体字面量和后缀运算符
 Expr *call(Parser *parser)
 {
-    Expr *expr = primary(parser);
+    int depth = parser->depth;
+    Expr *expr = callChain(parser, primary(parser));
+    parser->depth = depth;
+    return expr;
+}
 
+// 调用、下标和成员访问链每多一环，语法树加深一层
+static Expr *callChain(Parser *parser, Expr *expr)
+{
     while (true)
     {
-        if (match(parser, TOKEN_LPAREN))
+        TokenType type = peekType(parser);
+        if (type != TOKEN_LPAREN && type != TOKEN_LBRACKET && type != TOKEN_DOT && type != TOKEN_LBRACE &&
+            type != TOKEN_PLUS_PLUS && type != TOKEN_MINUS_MINUS)
         {
-            expr = finishCall(parser, expr);
+            return expr;
+        }
+        if (!enterNesting(parser))
+        {
+            freeExpr(expr);
+            return NULL;
         }
-        else if (match(parser, TOKEN_LBRACKET))
+
+        switch (type)
+        {
+        case TOKEN_LPAREN:
+            parser->current++;
+            expr = finishCall(parser, expr);
+            break;
+        case TOKEN_LBRACKET:
         {
             // 数组索引访问
+            parser->current++;
             Expr *index = expression(parser);
             consume(parser, TOKEN_RBRACKET, "Expect ']' after array index.");
             if (parser->hadError)
@@ -284,10 +405,12 @@ Expr *call(Parser *parser)
                 return NULL;
             }
             expr = createArrayAccessExpr(expr, index);
+            break;
         }
-        else if (match(parser, TOKEN_DOT))
+        case TOKEN_DOT:
         {
             // 点访问（如枚举成员访问）
+            parser->current++;
             Token member = consume(parser, TOKEN_IDENTIFIER, "Expect member name after '.'.");
             if (parser->hadError)
             {
@@ -295,90 +418,26 @@ Expr *call(Parser *parser)
                 return NULL;
             }
             expr = createDotAccessExpr(expr, member);
+            break;
         }
-        else if (match(parser, TOKEN_LBRACE))
-        {
-            // 结构体字面量语法：StructName { field1: value1, field2: value2 }
-            if (expr->type != EXPR_VARIABLE)
+        case TOKEN_LBRACE:
+        case TOKEN_PLUS_PLUS:
+        case TOKEN_MINUS_MINUS:
+            // 左侧已解析失败（错误已报告）时不再继续
+            if (expr == NULL)
             {
-                error(parser, "Expected struct name before '{'.");
-                freeExpr(expr);
                 return NULL;
             }
-            
-            Token structName = expr->as.variable.name;
-            freeExpr(expr); // 释放变量表达式，因为我们要创建结构体字面量
-            
-            // 解析字段初始化列表
-            StructFieldInit *fields = NULL;
-            int fieldCount = 0;
-            int capacity = 0;
-            
-            if (!check(parser, TOKEN_RBRACE))
+            parser->current++;
+            if (type == TOKEN_LBRACE)
             {
-                do
+                expr = structLiteral(parser, expr);
+                if (expr == NULL)
                 {
-                    // 扩展容量
-                    if (fieldCount >= capacity)
-                    {
-                        capacity = capacity == 0 ? 4 : capacity * 2;
-                        fields = (StructFieldInit *)realloc(fields, capacity * sizeof(StructFieldInit));
-                        if (fields == NULL)
-                        {
-                            error(parser, "Memory allocation failed.");
-                            return NULL;
-                        }
-                    }
-                    
-                    // 解析字段名
-                    Token fieldName = consume(parser, TOKEN_IDENTIFIER, "Expect field name.");
-                    if (parser->hadError)
-                    {
-                        if (fields) free(fields);
-                        return NULL;
-                    }
-                    
-                    // 期望冒号
-                    consume(parser, TOKEN_COLON, "Expect ':' after field name.");
-                    if (parser->hadError)
-                    {
-                        if (fields) free(fields);
-                        return NULL;
-                    }
-                    
-                    // 解析字段值
-                    Expr *fieldValue = expression(parser);
-                    if (parser->hadError)
-                    {
-                        if (fields) free(fields);
-                        return NULL;
-                    }
-                    
-                    // 添加字段
-                    fields[fieldCount].name = fieldName;
-                    fields[fieldCount].value = fieldValue;
-                    fieldCount++;
-                    
-                } while (match(parser, TOKEN_COMMA));
-            }
-            
-            consume(parser, TOKEN_RBRACE, "Expect '}' after struct fields.");
-            if (parser->hadError)
-            {
-                // 清理内存
-                for (int i = 0; i < fieldCount; i++)
-                {
-                    freeExpr(fields[i].value);
+                    return NULL;
                 }
-                if (fields) free(fields);
-                return NULL;
+                break;
             }
-            
-            expr = createStructLiteralExpr(structName, fields, fieldCount);
-        }
-        else if (match(parser, TOKEN_PLUS_PLUS) || match(parser, TOKEN_MINUS_MINUS))
-        {
-            TokenType op = previous(parser).type;
 
             // 检查左操作数是否是变量
             if (expr->type != EXPR_VARIABLE)
@@ -388,20 +447,17 @@ Expr *call(Parser *parser)
                 return NULL;
             }
 
-            expr = createPostfixExpr(expr, op);
+            expr = createPostfixExpr(expr, type);
             // 检查 createPostfixExpr 是否返回 NULL
             if (expr == NULL)
             {
                 return NULL;
             }
-        }
-        else
-        {
             break;
+        default:
+            return expr;
         }
     }
-
-    return expr;
 }
 
 // 完成函数调用的解析
@@ -486,41 +542,77 @@ Expr *arrayLiteral(Parser *parser)
     return createArrayLiteralExpr(elements, count);
 }
 
-// 解析基本表达式
-Expr *primary(Parser *parser)
+// 解析映射字面量：{键: 值, ...}，键可以是任意表达式
+Expr *mapLiteral(Parser *parser)
 {
-    if (match(parser, TOKEN_INTEGER) || match(parser, TOKEN_FLOAT))
-    {
-        return createLiteralExpr(previous(parser));
-    }
+    Expr **keys = NULL;
+    Expr **values = NULL;
+    int count = 0;
+    int capacity = 0;
 
-    if (match(parser, TOKEN_STRING))
+    if (!check(parser, TOKEN_RBRACE))
     {
-        return createLiteralExpr(previous(parser));
-    }
+        do
+        {
+            if (count >= capacity)
+            {
+                capacity = capacity == 0 ? 8 : capacity * 2;
+                keys = (Expr **)realloc(keys, capacity * sizeof(Expr *));
+                values = (Expr **)realloc(values, capacity * sizeof(Expr *));
+            }
 
-    if (match(parser, TOKEN_IDENTIFIER))
-    {
-        return createVariableExpr(previous(parser));
-    }
+            keys[count] = expression(parser);
+            consume(parser, TOKEN_COLON, "Expect ':' after map key.");
+            values[count] = parser->hadError ? NULL : expression(parser);
+            count++;
 
-    if (match(parser, TOKEN_TRUE) || match(parser, TOKEN_FALSE))
-    {
-        return createLiteralExpr(previous(parser));
+        } while (!parser->hadError && match(parser, TOKEN_COMMA));
     }
 
-    if (match(parser, TOKEN_NULL))
+    consume(parser, TOKEN_RBRACE, "Expect '}' after map entries.");
+    if (parser->hadError)
     {
-        return createLiteralExpr(previous(parser));
+        for (int i = 0; i < count; i++)
+        {
+            if (keys[i] != NULL)
+                freeExpr(keys[i]);
+            if (values[i] != NULL)
+                freeExpr(values[i]);
+        }
+        free(keys);
+        free(values);
+        return NULL;
     }
 
-    if (match(parser, TOKEN_LBRACKET))
+    return createMapLiteralExpr(keys, values, count);
+}
+
+// 解析基本表达式
+Expr *primary(Parser *parser)
+{
+    const Token *token = tokenAt(parser, parser->current);
+    switch (token->type)
     {
+    case TOKEN_INTEGER:
+    case TOKEN_FLOAT:
+    case TOKEN_STRING:
+    case TOKEN_TRUE:
+    case TOKEN_FALSE:
+    case TOKEN_NULL:
+        parser->current++;
+        return createLiteralExpr(*token);
+    case TOKEN_IDENTIFIER:
+        parser->current++;
+        return createVariableExpr(*token);
+    case TOKEN_LBRACKET:
+        parser->current++;
         return arrayLiteral(parser);
-    }
-
-    if (match(parser, TOKEN_LPAREN))
+    case TOKEN_LBRACE:
+        parser->current++;
+        return mapLiteral(parser);
+    case TOKEN_LPAREN:
     {
+        parser->current++;
         Expr *expr = expression(parser);
         consume(parser, TOKEN_RPAREN, "Expect ')' after expression.");
         if (parser->hadError)
@@ -530,6 +622,9 @@ Expr *primary(Parser *parser)
         }
         return createGroupingExpr(expr);
     }
+    default:
+        break;
+    }
 
     if (parser->hadError)
     {
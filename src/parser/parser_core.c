@@ -12,7 +12,90 @@ void initParser(Parser *parser, Token *tokens, int count)
     parser->count = count;
     parser->current = 0;
     parser->hadError = 0;
+    parser->errorCount = 0;
     parser->errorMsg[0] = '\0';
+    parser->lazyFunctions = false;
+    parser->copyFunctionBodies = false;
+    parser->lexer = NULL;
+    parser->capacity = 0;
+    parser->mark = -1;
+    parser->depth = 0;
+}
+
+// 初始化流式解析器；内存分配失败时返回 false
+bool initStreamingParser(Parser *parser, Lexer *lexer)
+{
+    Token *window = (Token *)malloc(sizeof(Token) * PARSER_WINDOW);
+    if (window == NULL)
+    {
+        return false;
+    }
+    initParser(parser, window, 0);
+    parser->lexer = lexer;
+    parser->capacity = PARSER_WINDOW;
+    return true;
+}
+
+void freeParser(Parser *parser)
+{
+    if (parser->lexer != NULL)
+    {
+        free(parser->tokens);
+        parser->tokens = NULL;
+    }
+}
+
+// 流式模式：环形缓冲区扩大一倍，已保留的标记放到新容量下对应的位置
+static void growWindow(Parser *parser)
+{
+    int capacity = parser->capacity * 2;
+    Token *tokens = (Token *)malloc(sizeof(Token) * (size_t)capacity);
+    if (tokens == NULL)
+    {
+        fprintf(stderr, "内存分配失败\n");
+        exit(1);
+    }
+    for (int i = parser->count - parser->capacity; i < parser->count; i++)
+    {
+        if (i >= 0)
+        {
+            tokens[i & (capacity - 1)] = parser->tokens[i & (parser->capacity - 1)];
+        }
+    }
+    free(parser->tokens);
+    parser->tokens = tokens;
+    parser->capacity = capacity;
+}
+
+// 流式模式：从词法分析器读取下一个标记；将被覆盖的标记仍需保留时先扩大缓冲区
+static void fetchToken(Parser *parser)
+{
+    // previous 需要上一个标记
+    int keep = parser->current - 1;
+    if (parser->mark >= 0 && parser->mark < keep)
+    {
+        keep = parser->mark;
+    }
+    int evicted = parser->count - parser->capacity; // 新标记将覆盖的标记序号
+    if (evicted >= 0 && evicted >= keep)
+    {
+        growWindow(parser);
+    }
+    parser->tokens[parser->count & (parser->capacity - 1)] = nextToken(parser->lexer);
+    parser->count++;
+}
+
+Token *tokenAt(Parser *parser, int index)
+{
+    if (parser->lexer == NULL)
+    {
+        return &parser->tokens[index];
+    }
+    while (parser->count <= index)
+    {
+        fetchToken(parser);
+    }
+    return &parser->tokens[index & (parser->capacity - 1)];
 }
 
 // 解析整个程序，返回语句列表
@@ -62,10 +145,10 @@ Stmt **parse(Parser *parser, int *stmtCount)
     return statements;
 }
 
-// 检查是否有语法错误
+// 检查是否有语法错误；错误恢复后继续解析的部分不会掩盖之前的错误
 int hadParseError(Parser *parser)
 {
-    return parser->hadError;
+    return parser->errorCount > 0;
 }
 
 // 获取错误信息
@@ -104,13 +187,13 @@ Token advance(Parser *parser)
 // 获取当前标记
 Token peek(Parser *parser)
 {
-    return parser->tokens[parser->current];
+    return *tokenAt(parser, parser->current);
 }
 
 // 获取上一个标记
 Token previous(Parser *parser)
 {
-    return parser->tokens[parser->current - 1];
+    return *tokenAt(parser, parser->current - 1);
 }
 
 // 检查是否到达标记流末尾
@@ -173,10 +256,37 @@ void synchronize(Parser *parser)
     }
 }
 
-// 记录错误
+// 记录错误；只保留第一个错误的信息，之后的错误多由错误恢复引起
 void error(Parser *parser, const char *message)
 {
     parser->hadError = 1;
-    snprintf(parser->errorMsg, sizeof(parser->errorMsg), "Line %d: Error: %s",
-             peek(parser).line, message);
+    if (parser->errorCount++ == 0)
+    {
+        snprintf(parser->errorMsg, sizeof(parser->errorMsg), "Line %d: Error: %s",
+                 peek(parser).line, message);
+    }
+}
+
+/**
+ * 进入一层嵌套的语句或表达式
+ *
+ * 嵌套过深的脚本（上万层括号、很长的运算链）会在递归解析、求值或释放语法树时耗尽 C 栈，
+ * 因此在解析时限制语法树的深度，超出时报告错误并停止深入。
+ */
+bool enterNesting(Parser *parser)
+{
+    if (parser->depth >= MAX_NESTING_DEPTH)
+    {
+        char message[64];
+        snprintf(message, sizeof(message), "Nesting too deep (more than %d levels).", MAX_NESTING_DEPTH);
+        error(parser, message);
+        return false;
+    }
+    parser->depth++;
+    return true;
+}
+
+void leaveNesting(Parser *parser)
+{
+    parser->depth--;
 }
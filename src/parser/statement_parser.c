@@ -6,8 +6,21 @@
 #include "../include/parser/declaration_parser.h"
 #include "../include/parser/expression_parser.h"
 
-// 解析语句
+static Stmt *statementBody(Parser *parser);
+
+// 解析语句；每层嵌套的语句加深一层
 Stmt *statement(Parser *parser)
+{
+    if (!enterNesting(parser))
+    {
+        return NULL;
+    }
+    Stmt *stmt = statementBody(parser);
+    leaveNesting(parser);
+    return stmt;
+}
+
+static Stmt *statementBody(Parser *parser)
 {
     if (match(parser, TOKEN_IF))
     {
@@ -32,6 +45,11 @@ Stmt *statement(Parser *parser)
         return returnStatement(parser);
     }
 
+    if (match(parser, TOKEN_YIELD))
+    {
+        return yieldStatement(parser);
+    }
+
     if (match(parser, TOKEN_SWITCH))
     {
         return switchStatement(parser);
@@ -174,12 +192,51 @@ Stmt *whileStatement(Parser *parser)
 }
 
 // 解析for循环
+// 当前位置是否为 for-in 的头部：[var] 标识符 in
+static bool isForInHeader(Parser *parser)
+{
+    int position = parser->current;
+    if (tokenAt(parser, position)->type == TOKEN_VAR)
+    {
+        position++;
+    }
+    return tokenAt(parser, position)->type == TOKEN_IDENTIFIER &&
+           tokenAt(parser, position + 1)->type == TOKEN_IN;
+}
+
+// 解析for-in循环：for ([var] name in iterable) body
+static Stmt *forInStatement(Parser *parser)
+{
+    match(parser, TOKEN_VAR);
+    Token name = consume(parser, TOKEN_IDENTIFIER, "Expect loop variable name.");
+    consume(parser, TOKEN_IN, "Expect 'in' after loop variable.");
+    if (parser->hadError)
+        return NULL;
+
+    Expr *iterable = expression(parser);
+    consume(parser, TOKEN_RPAREN, "Expect ')' after for-in clause.");
+    if (parser->hadError)
+    {
+        if (iterable)
+            freeExpr(iterable);
+        return NULL;
+    }
+
+    Stmt *body = statement(parser);
+    return createForInStmt(name, iterable, body);
+}
+
 Stmt *forStatement(Parser *parser)
 {
     consume(parser, TOKEN_LPAREN, "Expect '(' after 'for'.");
     if (parser->hadError)
         return NULL;
 
+    if (isForInHeader(parser))
+    {
+        return forInStatement(parser);
+    }
+
     // 初始化部分
     Stmt *initializer = NULL;
     if (match(parser, TOKEN_SEMICOLON))
@@ -268,6 +325,29 @@ Stmt *returnStatement(Parser *parser)
     return createReturnStmt(keyword, value);
 }
 
+// 解析yield语句：yield 值; 或 yield* 值;
+Stmt *yieldStatement(Parser *parser)
+{
+    Token keyword = previous(parser);
+    bool delegate = match(parser, TOKEN_MULTIPLY);
+    Expr *value = NULL;
+
+    if (delegate || !check(parser, TOKEN_SEMICOLON))
+    {
+        value = expression(parser);
+    }
+
+    consume(parser, TOKEN_SEMICOLON, "Expect ';' after yield value.");
+    if (parser->hadError)
+    {
+        if (value)
+            freeExpr(value);
+        return NULL;
+    }
+
+    return createYieldStmt(keyword, value, delegate);
+}
+
 // 解析 switch 语句
 Stmt *switchStatement(Parser *parser)
 {
@@ -0,0 +1,1316 @@
+#define _XOPEN_SOURCE 700
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "program_cache.h"
+#include "parser.h"
+#include "file_utils.h"
+
+// 文件头；字符串区和节点区依次紧随其后
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t layout;       // 字节序和各枚举的取值范围，见 layoutTag
+    uint32_t stmtCount;
+    uint64_t sourceHash;
+    uint64_t sourceLength;
+    uint64_t stringsSize;
+    uint64_t nodesSize;
+    uint64_t bodyTokenCount; // 延迟函数体的标记总数（每个函数体另加一个 TOKEN_EOF）
+    uint64_t contentHash;    // 字符串区和节点区的哈希：文件损坏时不会重建出不同的程序
+} CacheHeader;
+
+static const char CACHE_MAGIC[4] = {'S', 'P', 'W', 'C'};
+
+// 标记类型、节点类型或基本类型的数量变化后，旧文件中的枚举值不再可信；字节序不同时该值也读不出原样
+static uint32_t layoutTag(void)
+{
+    return (uint32_t)TOKEN_ERROR | (uint32_t)EXPR_MAP_LITERAL << 8 | (uint32_t)STMT_YIELD << 16 |
+           (uint32_t)TYPE_STRUCT << 24;
+}
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+
+// FNV-1a 64 位哈希，从 hash 继续累加
+static uint64_t hashBytes(uint64_t hash, const void *bytes, size_t length)
+{
+    const unsigned char *data = (const unsigned char *)bytes;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static uint64_t hashSource(const char *source, size_t length)
+{
+    return hashBytes(FNV_OFFSET_BASIS, source, length);
+}
+
+// 目录已存在时同样视为成功
+static bool ensureDirectory(const char *path)
+{
+    return mkdir(path, 0700) == 0 || errno == EEXIST;
+}
+
+char *programCachePath(const char *path)
+{
+    char *resolved = realpath(path, NULL);
+    if (resolved == NULL)
+    {
+        return NULL;
+    }
+    uint64_t key = hashBytes(FNV_OFFSET_BASIS, resolved, strlen(resolved));
+    free(resolved);
+
+    // XDG 基础目录规范：XDG_CACHE_HOME 未设置或不是绝对路径时使用 ~/.cache
+    const char *xdg = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    bool useXdg = xdg != NULL && xdg[0] == '/';
+    if (!useXdg && (home == NULL || home[0] != '/'))
+    {
+        return NULL;
+    }
+    const char *root = useXdg ? xdg : home;
+    const char *rootSuffix = useXdg ? "" : "/.cache";
+    size_t length = strlen(root) + strlen(rootSuffix) + strlen("/sparrow/") + 16 + strlen(".spwc") + 1;
+    char *cachePath = (char *)malloc(length);
+    if (cachePath == NULL)
+    {
+        return NULL;
+    }
+    snprintf(cachePath, length, "%s%s", root, rootSuffix);
+    if (!ensureDirectory(cachePath))
+    {
+        free(cachePath);
+        return NULL;
+    }
+    strcat(cachePath, "/sparrow");
+    if (!ensureDirectory(cachePath))
+    {
+        free(cachePath);
+        return NULL;
+    }
+    size_t used = strlen(cachePath);
+    snprintf(cachePath + used, length - used, "/%016llx.spwc", (unsigned long long)key);
+    return cachePath;
+}
+
+// ---------------------------------------------------------------------------
+// 写入
+// ---------------------------------------------------------------------------
+
+typedef struct
+{
+    unsigned char *data;
+    size_t length;
+    size_t capacity;
+    bool failed;
+} ByteBuffer;
+
+// 字符串驻留表的槽位，offset 为字符串在字符串区中的偏移
+typedef struct
+{
+    const char *key;
+    uint64_t hash;
+    uint64_t offset;
+} InternSlot;
+
+typedef struct
+{
+    ByteBuffer nodes;
+    ByteBuffer strings;
+    InternSlot *slots;
+    size_t slotCapacity; // 2 的幂
+    size_t slotCount;
+    uint64_t bodyTokenCount;
+} CacheWriter;
+
+static void putBytes(ByteBuffer *buffer, const void *bytes, size_t length)
+{
+    if (buffer->failed)
+    {
+        return;
+    }
+    if (length > buffer->capacity - buffer->length)
+    {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : 4096;
+        while (length > capacity - buffer->length)
+        {
+            capacity *= 2;
+        }
+        unsigned char *data = (unsigned char *)realloc(buffer->data, capacity);
+        if (data == NULL)
+        {
+            buffer->failed = true;
+            return;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, bytes, length);
+    buffer->length += length;
+}
+
+// 无符号变长整数：每字节 7 位，最高位表示后面还有字节
+static void putVarint(ByteBuffer *buffer, uint64_t value)
+{
+    unsigned char bytes[10];
+    int count = 0;
+    while (value >= 0x80)
+    {
+        bytes[count++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[count++] = (unsigned char)value;
+    putBytes(buffer, bytes, (size_t)count);
+}
+
+// 有符号整数先做 zigzag 映射，使绝对值小的负数也只占少量字节
+static void putSigned(ByteBuffer *buffer, int64_t value)
+{
+    putVarint(buffer, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void putDouble(ByteBuffer *buffer, double value)
+{
+    putBytes(buffer, &value, sizeof(value));
+}
+
+static bool growInternTable(CacheWriter *writer)
+{
+    size_t capacity = writer->slotCapacity > 0 ? writer->slotCapacity * 2 : 1024;
+    InternSlot *slots = (InternSlot *)calloc(capacity, sizeof(InternSlot));
+    if (slots == NULL)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < writer->slotCapacity; i++)
+    {
+        InternSlot *slot = &writer->slots[i];
+        if (slot->key == NULL)
+        {
+            continue;
+        }
+        size_t index = (size_t)slot->hash & (capacity - 1);
+        while (slots[index].key != NULL)
+        {
+            index = (index + 1) & (capacity - 1);
+        }
+        slots[index] = *slot;
+    }
+    free(writer->slots);
+    writer->slots = slots;
+    writer->slotCapacity = capacity;
+    return true;
+}
+
+// 驻留字符串，返回“偏移 + 1”；NULL 记为 0
+static uint64_t internString(CacheWriter *writer, const char *text)
+{
+    if (text == NULL)
+    {
+        return 0;
+    }
+    if (writer->slotCount * 2 >= writer->slotCapacity && !growInternTable(writer))
+    {
+        writer->strings.failed = true;
+        return 0;
+    }
+
+    size_t length = strlen(text);
+    uint64_t hash = hashSource(text, length);
+    size_t index = (size_t)hash & (writer->slotCapacity - 1);
+    while (writer->slots[index].key != NULL)
+    {
+        InternSlot *slot = &writer->slots[index];
+        if (slot->hash == hash && strcmp(slot->key, text) == 0)
+        {
+            return slot->offset + 1;
+        }
+        index = (index + 1) & (writer->slotCapacity - 1);
+    }
+
+    InternSlot *slot = &writer->slots[index];
+    slot->key = text;
+    slot->hash = hash;
+    slot->offset = writer->strings.length;
+    writer->slotCount++;
+    putBytes(&writer->strings, text, length + 1);
+    return slot->offset + 1;
+}
+
+static void writeToken(CacheWriter *writer, const Token *token)
+{
+    putVarint(&writer->nodes, (uint64_t)token->type);
+    putVarint(&writer->nodes, internString(writer, token->lexeme));
+    putVarint(&writer->nodes, (uint32_t)token->line);
+    switch (token->type)
+    {
+    case TOKEN_INTEGER:
+        putSigned(&writer->nodes, token->value.intValue);
+        break;
+    case TOKEN_FLOAT:
+        putDouble(&writer->nodes, token->value.floatValue);
+        break;
+    case TOKEN_STRING:
+        putVarint(&writer->nodes, internString(writer, token->value.stringValue));
+        break;
+    default:
+        break;
+    }
+}
+
+static void writeExpr(CacheWriter *writer, const Expr *expr);
+
+static void writeType(CacheWriter *writer, const TypeAnnotation *type)
+{
+    putVarint(&writer->nodes, (uint64_t)type->kind);
+    if (type->kind == TYPE_ARRAY)
+    {
+        putVarint(&writer->nodes, (uint64_t)type->as.array.elementType);
+        writeExpr(writer, type->as.array.size);
+    }
+    else
+    {
+        putVarint(&writer->nodes, (uint64_t)type->as.simple);
+    }
+}
+
+// 节点以“类型 + 1”开头，0 表示 NULL
+static void writeExpr(CacheWriter *writer, const Expr *expr)
+{
+    ByteBuffer *out = &writer->nodes;
+    if (expr == NULL)
+    {
+        putVarint(out, 0);
+        return;
+    }
+    putVarint(out, (uint64_t)expr->type + 1);
+
+    switch (expr->type)
+    {
+    case EXPR_BINARY:
+        putVarint(out, (uint64_t)expr->as.binary.op);
+        writeExpr(writer, expr->as.binary.left);
+        writeExpr(writer, expr->as.binary.right);
+        break;
+    case EXPR_UNARY:
+        putVarint(out, (uint64_t)expr->as.unary.op);
+        writeExpr(writer, expr->as.unary.right);
+        break;
+    case EXPR_POSTFIX:
+        putVarint(out, (uint64_t)expr->as.postfix.op);
+        writeExpr(writer, expr->as.postfix.operand);
+        break;
+    case EXPR_PREFIX:
+        putVarint(out, (uint64_t)expr->as.prefix.op);
+        writeExpr(writer, expr->as.prefix.operand);
+        break;
+    case EXPR_LITERAL:
+        writeToken(writer, &expr->as.literal.value);
+        break;
+    case EXPR_GROUPING:
+        writeExpr(writer, expr->as.grouping.expression);
+        break;
+    case EXPR_VARIABLE:
+        writeToken(writer, &expr->as.variable.name);
+        break;
+    case EXPR_ASSIGN:
+        writeToken(writer, &expr->as.assign.name);
+        writeExpr(writer, expr->as.assign.value);
+        break;
+    case EXPR_CALL:
+        writeExpr(writer, expr->as.call.callee);
+        writeToken(writer, &expr->as.call.paren);
+        putVarint(out, (uint64_t)expr->as.call.argCount);
+        for (int i = 0; i < expr->as.call.argCount; i++)
+        {
+            writeExpr(writer, expr->as.call.arguments[i]);
+        }
+        break;
+    case EXPR_ARRAY_LITERAL:
+        putVarint(out, (uint64_t)expr->as.arrayLiteral.elementCount);
+        for (int i = 0; i < expr->as.arrayLiteral.elementCount; i++)
+        {
+            writeExpr(writer, expr->as.arrayLiteral.elements[i]);
+        }
+        break;
+    case EXPR_ARRAY_ACCESS:
+        writeExpr(writer, expr->as.arrayAccess.array);
+        writeExpr(writer, expr->as.arrayAccess.index);
+        break;
+    case EXPR_ARRAY_ASSIGN:
+        writeExpr(writer, expr->as.arrayAssign.array);
+        writeExpr(writer, expr->as.arrayAssign.index);
+        writeExpr(writer, expr->as.arrayAssign.value);
+        break;
+    case EXPR_CAST:
+        putVarint(out, (uint64_t)expr->as.cast.targetType);
+        writeExpr(writer, expr->as.cast.expression);
+        break;
+    case EXPR_DOT_ACCESS:
+        writeExpr(writer, expr->as.dotAccess.object);
+        writeToken(writer, &expr->as.dotAccess.member);
+        break;
+    case EXPR_STRUCT_LITERAL:
+        writeToken(writer, &expr->as.structLiteral.structName);
+        putVarint(out, (uint64_t)expr->as.structLiteral.fieldCount);
+        for (int i = 0; i < expr->as.structLiteral.fieldCount; i++)
+        {
+            writeToken(writer, &expr->as.structLiteral.fields[i].name);
+            writeExpr(writer, expr->as.structLiteral.fields[i].value);
+        }
+        break;
+    case EXPR_STRUCT_ASSIGN:
+        writeExpr(writer, expr->as.structAssign.object);
+        writeToken(writer, &expr->as.structAssign.field);
+        writeExpr(writer, expr->as.structAssign.value);
+        break;
+    case EXPR_COMPOUND_ASSIGN:
+        putVarint(out, (uint64_t)expr->as.compoundAssign.op);
+        writeExpr(writer, expr->as.compoundAssign.target);
+        writeExpr(writer, expr->as.compoundAssign.value);
+        break;
+    case EXPR_MAP_LITERAL:
+        putVarint(out, (uint64_t)expr->as.mapLiteral.count);
+        for (int i = 0; i < expr->as.mapLiteral.count; i++)
+        {
+            writeExpr(writer, expr->as.mapLiteral.keys[i]);
+            writeExpr(writer, expr->as.mapLiteral.values[i]);
+        }
+        break;
+    }
+}
+
+static void writeStmt(CacheWriter *writer, const Stmt *stmt)
+{
+    ByteBuffer *out = &writer->nodes;
+    if (stmt == NULL)
+    {
+        putVarint(out, 0);
+        return;
+    }
+    putVarint(out, (uint64_t)stmt->type + 1);
+    putVarint(out, stmt->containsYield ? 1 : 0);
+
+    switch (stmt->type)
+    {
+    case STMT_EXPRESSION:
+        writeExpr(writer, stmt->as.expression.expression);
+        break;
+    case STMT_VAR:
+        writeToken(writer, &stmt->as.var.name);
+        writeType(writer, &stmt->as.var.type);
+        writeExpr(writer, stmt->as.var.initializer);
+        putVarint(out, stmt->as.var.isStatic ? 1 : 0);
+        break;
+    case STMT_CONST:
+        writeToken(writer, &stmt->as.constStmt.name);
+        writeType(writer, &stmt->as.constStmt.type);
+        writeExpr(writer, stmt->as.constStmt.initializer);
+        putVarint(out, stmt->as.constStmt.isStatic ? 1 : 0);
+        break;
+    case STMT_MULTI_VAR:
+        putVarint(out, (uint64_t)stmt->as.multiVar.count);
+        for (int i = 0; i < stmt->as.multiVar.count; i++)
+        {
+            writeToken(writer, &stmt->as.multiVar.names[i]);
+        }
+        writeType(writer, &stmt->as.multiVar.type);
+        writeExpr(writer, stmt->as.multiVar.initializer);
+        putVarint(out, stmt->as.multiVar.isStatic ? 1 : 0);
+        break;
+    case STMT_MULTI_CONST:
+        putVarint(out, (uint64_t)stmt->as.multiConst.count);
+        for (int i = 0; i < stmt->as.multiConst.count; i++)
+        {
+            writeToken(writer, &stmt->as.multiConst.names[i]);
+        }
+        writeType(writer, &stmt->as.multiConst.type);
+        putVarint(out, (uint64_t)stmt->as.multiConst.initializerCount);
+        for (int i = 0; i < stmt->as.multiConst.initializerCount; i++)
+        {
+            writeExpr(writer, stmt->as.multiConst.initializers[i]);
+        }
+        putVarint(out, stmt->as.multiConst.isStatic ? 1 : 0);
+        break;
+    case STMT_BLOCK:
+        // 尚未解析的函数体原样保存标记，加载后同样在首次调用时解析
+        putVarint(out, stmt->as.block.lazy != NULL ? 1 : 0);
+        if (stmt->as.block.lazy != NULL)
+        {
+            const LazyBody *lazy = stmt->as.block.lazy;
+            putVarint(out, lazy->hasYield ? 1 : 0);
+            putVarint(out, (uint64_t)lazy->tokenCount);
+            for (int i = 0; i < lazy->tokenCount; i++)
+            {
+                writeToken(writer, &lazy->tokens[i]);
+            }
+            writer->bodyTokenCount += (uint64_t)lazy->tokenCount + 1;
+            break;
+        }
+        putVarint(out, (uint64_t)stmt->as.block.count);
+        for (int i = 0; i < stmt->as.block.count; i++)
+        {
+            writeStmt(writer, stmt->as.block.statements[i]);
+        }
+        break;
+    case STMT_IF:
+        writeExpr(writer, stmt->as.ifStmt.condition);
+        writeStmt(writer, stmt->as.ifStmt.thenBranch);
+        writeStmt(writer, stmt->as.ifStmt.elseBranch);
+        break;
+    case STMT_WHILE:
+        writeExpr(writer, stmt->as.whileLoop.condition);
+        writeStmt(writer, stmt->as.whileLoop.body);
+        break;
+    case STMT_FOR:
+        writeStmt(writer, stmt->as.forLoop.initializer);
+        writeExpr(writer, stmt->as.forLoop.condition);
+        writeExpr(writer, stmt->as.forLoop.increment);
+        writeStmt(writer, stmt->as.forLoop.body);
+        break;
+    case STMT_FUNCTION:
+        writeToken(writer, &stmt->as.function.name);
+        putVarint(out, (uint64_t)stmt->as.function.paramCount);
+        for (int i = 0; i < stmt->as.function.paramCount; i++)
+        {
+            writeToken(writer, &stmt->as.function.params[i]);
+            putVarint(out, stmt->as.function.paramHasVar != NULL && stmt->as.function.paramHasVar[i] ? 1 : 0);
+            writeType(writer, &stmt->as.function.paramTypes[i]);
+        }
+        writeType(writer, &stmt->as.function.returnType);
+        writeStmt(writer, stmt->as.function.body);
+        putVarint(out, (stmt->as.function.isStatic ? 1 : 0) | (stmt->as.function.isGenerator ? 2 : 0));
+        break;
+    case STMT_RETURN:
+        writeToken(writer, &stmt->as.returnStmt.keyword);
+        writeExpr(writer, stmt->as.returnStmt.value);
+        break;
+    case STMT_SWITCH:
+        writeExpr(writer, stmt->as.switchStmt.discriminant);
+        putVarint(out, (uint64_t)stmt->as.switchStmt.caseCount);
+        for (int i = 0; i < stmt->as.switchStmt.caseCount; i++)
+        {
+            writeExpr(writer, stmt->as.switchStmt.cases[i].value);
+            writeStmt(writer, stmt->as.switchStmt.cases[i].body);
+        }
+        break;
+    case STMT_BREAK:
+        writeToken(writer, &stmt->as.breakStmt.keyword);
+        break;
+    case STMT_DO_WHILE:
+        writeStmt(writer, stmt->as.doWhile.body);
+        writeExpr(writer, stmt->as.doWhile.condition);
+        break;
+    case STMT_ENUM:
+        writeToken(writer, &stmt->as.enumStmt.name);
+        putVarint(out, (uint64_t)stmt->as.enumStmt.memberCount);
+        for (int i = 0; i < stmt->as.enumStmt.memberCount; i++)
+        {
+            writeToken(writer, &stmt->as.enumStmt.members[i].name);
+            writeExpr(writer, stmt->as.enumStmt.members[i].value);
+        }
+        break;
+    case STMT_STRUCT:
+        writeToken(writer, &stmt->as.structStmt.name);
+        putVarint(out, (uint64_t)stmt->as.structStmt.fieldCount);
+        for (int i = 0; i < stmt->as.structStmt.fieldCount; i++)
+        {
+            writeToken(writer, &stmt->as.structStmt.fields[i].name);
+            writeType(writer, &stmt->as.structStmt.fields[i].type);
+        }
+        break;
+    case STMT_FOR_IN:
+        writeToken(writer, &stmt->as.forIn.name);
+        writeExpr(writer, stmt->as.forIn.iterable);
+        writeStmt(writer, stmt->as.forIn.body);
+        break;
+    case STMT_YIELD:
+        writeToken(writer, &stmt->as.yieldStmt.keyword);
+        writeExpr(writer, stmt->as.yieldStmt.value);
+        putVarint(out, stmt->as.yieldStmt.delegate ? 1 : 0);
+        break;
+    }
+}
+
+bool saveProgramCache(const char *cachePath, const char *source, size_t sourceLength,
+                      Stmt **statements, int stmtCount)
+{
+    CacheWriter writer;
+    memset(&writer, 0, sizeof(writer));
+    for (int i = 0; i < stmtCount; i++)
+    {
+        writeStmt(&writer, statements[i]);
+    }
+    // 字符串区至少有一个字节，读取时据此检查最后一个字符串以 '\0' 结尾
+    putBytes(&writer.strings, "", 1);
+
+    bool saved = false;
+    char *tempPath = (char *)malloc(strlen(cachePath) + 32);
+    if (!writer.nodes.failed && !writer.strings.failed && tempPath != NULL)
+    {
+        sprintf(tempPath, "%s.%ld.tmp", cachePath, (long)getpid());
+
+        CacheHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+        header.version = PROGRAM_CACHE_VERSION;
+        header.layout = layoutTag();
+        header.stmtCount = (uint32_t)stmtCount;
+        header.sourceHash = hashSource(source, sourceLength);
+        header.sourceLength = sourceLength;
+        header.stringsSize = writer.strings.length;
+        header.nodesSize = writer.nodes.length;
+        header.bodyTokenCount = writer.bodyTokenCount;
+        header.contentHash = hashBytes(hashBytes(FNV_OFFSET_BASIS, writer.strings.data, writer.strings.length),
+                                       writer.nodes.data, writer.nodes.length);
+
+        FILE *file = fopen(tempPath, "wb");
+        if (file != NULL)
+        {
+            bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                           fwrite(writer.strings.data, 1, writer.strings.length, file) == writer.strings.length &&
+                           (writer.nodes.length == 0 ||
+                            fwrite(writer.nodes.data, 1, writer.nodes.length, file) == writer.nodes.length);
+            written = fclose(file) == 0 && written;
+            // 改名是原子的：正在映射旧文件的进程不受影响，也不会读到写了一半的文件
+            saved = written && rename(tempPath, cachePath) == 0;
+            if (!saved)
+            {
+                unlink(tempPath);
+            }
+        }
+    }
+
+    free(tempPath);
+    free(writer.nodes.data);
+    free(writer.strings.data);
+    free(writer.slots);
+    return saved;
+}
+
+// ---------------------------------------------------------------------------
+// 读取
+// ---------------------------------------------------------------------------
+
+// 读取时任何越界或非法值都只置 failed，已经建立的部分节点照常挂在树上，最后统一释放
+typedef struct
+{
+    const unsigned char *cursor;
+    const unsigned char *end;
+    char *strings; // 映射的字符串区
+    uint64_t stringsSize;
+    Token *bodyTokens; // 所有延迟函数体共用的标记数组
+    uint64_t bodyTokenCount;
+    uint64_t bodyTokensUsed;
+    bool failed;
+} CacheReader;
+
+static uint64_t getVarint(CacheReader *reader)
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (reader->cursor >= reader->end)
+        {
+            break;
+        }
+        unsigned char byte = *reader->cursor++;
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    reader->failed = true;
+    return 0;
+}
+
+static int64_t getSigned(CacheReader *reader)
+{
+    uint64_t value = getVarint(reader);
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static double getDouble(CacheReader *reader)
+{
+    double value = 0;
+    if ((size_t)(reader->end - reader->cursor) < sizeof(value))
+    {
+        reader->failed = true;
+        return 0;
+    }
+    memcpy(&value, reader->cursor, sizeof(value));
+    reader->cursor += sizeof(value);
+    return value;
+}
+
+// 读取不超过 limit 的枚举值或标志
+static int getEnum(CacheReader *reader, uint64_t limit)
+{
+    uint64_t value = getVarint(reader);
+    if (value > limit)
+    {
+        reader->failed = true;
+        return 0;
+    }
+    return (int)value;
+}
+
+// 元素个数：每个元素至少占一个字节，超过剩余字节数即为损坏
+static int getCount(CacheReader *reader)
+{
+    uint64_t count = getVarint(reader);
+    if (count > (uint64_t)(reader->end - reader->cursor) || count > INT32_MAX)
+    {
+        reader->failed = true;
+        return 0;
+    }
+    return (int)count;
+}
+
+static char *getString(CacheReader *reader)
+{
+    uint64_t offset = getVarint(reader);
+    if (offset == 0)
+    {
+        return NULL;
+    }
+    if (offset > reader->stringsSize)
+    {
+        reader->failed = true;
+        return NULL;
+    }
+    return reader->strings + offset - 1;
+}
+
+static Token getToken(CacheReader *reader)
+{
+    Token token;
+    token.type = (TokenType)getEnum(reader, TOKEN_ERROR);
+    token.lexeme = getString(reader);
+    token.line = (int)getVarint(reader);
+    token.value.intValue = 0;
+    switch (token.type)
+    {
+    case TOKEN_INTEGER:
+        token.value.intValue = getSigned(reader);
+        break;
+    case TOKEN_FLOAT:
+        token.value.floatValue = getDouble(reader);
+        break;
+    case TOKEN_STRING:
+        token.value.stringValue = getString(reader);
+        break;
+    default:
+        break;
+    }
+    return token;
+}
+
+// 分配 count 个清零的元素；count 为 0 时返回 NULL
+static void *allocateArray(CacheReader *reader, int count, size_t size)
+{
+    if (count == 0 || reader->failed)
+    {
+        return NULL;
+    }
+    void *items = calloc((size_t)count, size);
+    if (items == NULL)
+    {
+        reader->failed = true;
+    }
+    return items;
+}
+
+static Expr *readExpr(CacheReader *reader);
+static Stmt *readStmt(CacheReader *reader);
+
+static TypeAnnotation readType(CacheReader *reader)
+{
+    TypeAnnotation type;
+    memset(&type, 0, sizeof(type));
+    type.kind = getEnum(reader, TYPE_ARRAY);
+    if (type.kind == TYPE_ARRAY)
+    {
+        type.as.array.elementType = (BaseType)getEnum(reader, TYPE_STRUCT);
+        type.as.array.size = readExpr(reader);
+    }
+    else
+    {
+        type.as.simple = (BaseType)getEnum(reader, TYPE_STRUCT);
+    }
+    return type;
+}
+
+// 读取表达式数组：数组先分配并记下长度，读取中途失败时已读的元素仍可由 freeExpr 释放
+static Expr **readExprArray(CacheReader *reader, int *count)
+{
+    *count = getCount(reader);
+    Expr **items = (Expr **)allocateArray(reader, *count, sizeof(Expr *));
+    if (items == NULL)
+    {
+        *count = 0;
+        return NULL;
+    }
+    for (int i = 0; i < *count && !reader->failed; i++)
+    {
+        items[i] = readExpr(reader);
+    }
+    return items;
+}
+
+static Token *readTokenArray(CacheReader *reader, int *count)
+{
+    *count = getCount(reader);
+    Token *items = (Token *)allocateArray(reader, *count, sizeof(Token));
+    if (items == NULL)
+    {
+        *count = 0;
+        return NULL;
+    }
+    for (int i = 0; i < *count && !reader->failed; i++)
+    {
+        items[i] = getToken(reader);
+    }
+    return items;
+}
+
+// 延迟函数体的标记放入共用数组，其后补一个 TOKEN_EOF，保证解析时不会读出范围
+static void readLazyBody(CacheReader *reader, Stmt *stmt)
+{
+    bool hasYield = getEnum(reader, 1) != 0;
+    int count = getCount(reader);
+    if (reader->failed || count == 0 || (uint64_t)count + 1 > reader->bodyTokenCount - reader->bodyTokensUsed)
+    {
+        reader->failed = true;
+        return;
+    }
+    Token *tokens = reader->bodyTokens + reader->bodyTokensUsed;
+    for (int i = 0; i < count && !reader->failed; i++)
+    {
+        tokens[i] = getToken(reader);
+    }
+    tokens[count] = tokens[count - 1];
+    tokens[count].type = TOKEN_EOF;
+    tokens[count].lexeme = reader->strings + reader->stringsSize - 1;
+    reader->bodyTokensUsed += (uint64_t)count + 1;
+
+    LazyBody *lazy = (LazyBody *)malloc(sizeof(LazyBody));
+    if (lazy == NULL)
+    {
+        reader->failed = true;
+        return;
+    }
+    lazy->tokens = tokens;
+    lazy->tokenCount = count;
+    lazy->hasYield = hasYield;
+    lazy->ownsTokens = false;
+    stmt->as.block.lazy = lazy;
+}
+
+static Expr *readExpr(CacheReader *reader)
+{
+    int tag = getEnum(reader, (uint64_t)EXPR_MAP_LITERAL + 1);
+    if (tag == 0 || reader->failed)
+    {
+        return NULL;
+    }
+    Expr *expr = (Expr *)calloc(1, sizeof(Expr));
+    if (expr == NULL)
+    {
+        reader->failed = true;
+        return NULL;
+    }
+    // 先设为没有子节点的类型，分配失败时 freeExpr 不会访问未初始化的字段
+    expr->type = EXPR_LITERAL;
+    ExprType type = (ExprType)(tag - 1);
+
+    switch (type)
+    {
+    case EXPR_BINARY:
+        expr->as.binary.op = (TokenType)getEnum(reader, TOKEN_ERROR);
+        expr->type = type;
+        expr->as.binary.left = readExpr(reader);
+        expr->as.binary.right = readExpr(reader);
+        break;
+    case EXPR_UNARY:
+        expr->as.unary.op = (TokenType)getEnum(reader, TOKEN_ERROR);
+        expr->type = type;
+        expr->as.unary.right = readExpr(reader);
+        break;
+    case EXPR_POSTFIX:
+        expr->as.postfix.op = (TokenType)getEnum(reader, TOKEN_ERROR);
+        expr->type = type;
+        expr->as.postfix.operand = readExpr(reader);
+        break;
+    case EXPR_PREFIX:
+        expr->as.prefix.op = (TokenType)getEnum(reader, TOKEN_ERROR);
+        expr->type = type;
+        expr->as.prefix.operand = readExpr(reader);
+        break;
+    case EXPR_LITERAL:
+        expr->as.literal.value = getToken(reader);
+        break;
+    case EXPR_GROUPING:
+        expr->type = type;
+        expr->as.grouping.expression = readExpr(reader);
+        break;
+    case EXPR_VARIABLE:
+        expr->type = type;
+        expr->as.variable.name = getToken(reader);
+        break;
+    case EXPR_ASSIGN:
+        expr->type = type;
+        expr->as.assign.name = getToken(reader);
+        expr->as.assign.value = readExpr(reader);
+        break;
+    case EXPR_CALL:
+        expr->type = type;
+        expr->as.call.callee = readExpr(reader);
+        expr->as.call.paren = getToken(reader);
+        expr->as.call.arguments = readExprArray(reader, &expr->as.call.argCount);
+        break;
+    case EXPR_ARRAY_LITERAL:
+        expr->type = type;
+        expr->as.arrayLiteral.elements = readExprArray(reader, &expr->as.arrayLiteral.elementCount);
+        break;
+    case EXPR_ARRAY_ACCESS:
+        expr->type = type;
+        expr->as.arrayAccess.array = readExpr(reader);
+        expr->as.arrayAccess.index = readExpr(reader);
+        break;
+    case EXPR_ARRAY_ASSIGN:
+        expr->type = type;
+        expr->as.arrayAssign.array = readExpr(reader);
+        expr->as.arrayAssign.index = readExpr(reader);
+        expr->as.arrayAssign.value = readExpr(reader);
+        break;
+    case EXPR_CAST:
+        expr->type = type;
+        expr->as.cast.targetType = (BaseType)getEnum(reader, TYPE_STRUCT);
+        expr->as.cast.expression = readExpr(reader);
+        break;
+    case EXPR_DOT_ACCESS:
+        expr->type = type;
+        expr->as.dotAccess.object = readExpr(reader);
+        expr->as.dotAccess.member = getToken(reader);
+        break;
+    case EXPR_STRUCT_LITERAL:
+    {
+        expr->type = type;
+        expr->as.structLiteral.structName = getToken(reader);
+        int count = getCount(reader);
+        expr->as.structLiteral.fields = (StructFieldInit *)allocateArray(reader, count, sizeof(StructFieldInit));
+        if (expr->as.structLiteral.fields == NULL)
+        {
+            break;
+        }
+        expr->as.structLiteral.fieldCount = count;
+        for (int i = 0; i < count && !reader->failed; i++)
+        {
+            expr->as.structLiteral.fields[i].name = getToken(reader);
+            expr->as.structLiteral.fields[i].value = readExpr(reader);
+        }
+        break;
+    }
+    case EXPR_STRUCT_ASSIGN:
+        expr->type = type;
+        expr->as.structAssign.object = readExpr(reader);
+        expr->as.structAssign.field = getToken(reader);
+        expr->as.structAssign.value = readExpr(reader);
+        break;
+    case EXPR_COMPOUND_ASSIGN:
+        expr->as.compoundAssign.op = (TokenType)getEnum(reader, TOKEN_ERROR);
+        expr->type = type;
+        expr->as.compoundAssign.target = readExpr(reader);
+        expr->as.compoundAssign.value = readExpr(reader);
+        break;
+    case EXPR_MAP_LITERAL:
+    {
+        expr->type = type;
+        int count = getCount(reader);
+        Expr **keys = (Expr **)allocateArray(reader, count, sizeof(Expr *));
+        Expr **values = (Expr **)allocateArray(reader, count, sizeof(Expr *));
+        if (keys == NULL || values == NULL)
+        {
+            free(keys);
+            free(values);
+            break;
+        }
+        expr->as.mapLiteral.keys = keys;
+        expr->as.mapLiteral.values = values;
+        expr->as.mapLiteral.count = count;
+        for (int i = 0; i < count && !reader->failed; i++)
+        {
+            keys[i] = readExpr(reader);
+            values[i] = readExpr(reader);
+        }
+        break;
+    }
+    }
+    return expr;
+}
+
+static Stmt *readStmt(CacheReader *reader)
+{
+    int tag = getEnum(reader, (uint64_t)STMT_YIELD + 1);
+    if (tag == 0 || reader->failed)
+    {
+        return NULL;
+    }
+    Stmt *stmt = (Stmt *)calloc(1, sizeof(Stmt));
+    if (stmt == NULL)
+    {
+        reader->failed = true;
+        return NULL;
+    }
+    stmt->type = (StmtType)(tag - 1);
+    stmt->containsYield = getEnum(reader, 1) != 0;
+
+    // calloc 清零后各节点的指针和计数均为空，中途失败时 freeStmt 可以直接释放
+    switch (stmt->type)
+    {
+    case STMT_EXPRESSION:
+        stmt->as.expression.expression = readExpr(reader);
+        break;
+    case STMT_VAR:
+        stmt->as.var.name = getToken(reader);
+        stmt->as.var.type = readType(reader);
+        stmt->as.var.initializer = readExpr(reader);
+        stmt->as.var.isStatic = getEnum(reader, 1) != 0;
+        break;
+    case STMT_CONST:
+        stmt->as.constStmt.name = getToken(reader);
+        stmt->as.constStmt.type = readType(reader);
+        stmt->as.constStmt.initializer = readExpr(reader);
+        stmt->as.constStmt.isStatic = getEnum(reader, 1) != 0;
+        break;
+    case STMT_MULTI_VAR:
+        stmt->as.multiVar.names = readTokenArray(reader, &stmt->as.multiVar.count);
+        stmt->as.multiVar.type = readType(reader);
+        stmt->as.multiVar.initializer = readExpr(reader);
+        stmt->as.multiVar.isStatic = getEnum(reader, 1) != 0;
+        break;
+    case STMT_MULTI_CONST:
+        stmt->as.multiConst.names = readTokenArray(reader, &stmt->as.multiConst.count);
+        stmt->as.multiConst.type = readType(reader);
+        stmt->as.multiConst.initializers = readExprArray(reader, &stmt->as.multiConst.initializerCount);
+        stmt->as.multiConst.isStatic = getEnum(reader, 1) != 0;
+        break;
+    case STMT_BLOCK:
+    {
+        if (getEnum(reader, 1) != 0)
+        {
+            readLazyBody(reader, stmt);
+            break;
+        }
+        int count = getCount(reader);
+        stmt->as.block.statements = (Stmt **)allocateArray(reader, count, sizeof(Stmt *));
+        if (stmt->as.block.statements == NULL)
+        {
+            break;
+        }
+        stmt->as.block.count = count;
+        for (int i = 0; i < count && !reader->failed; i++)
+        {
+            stmt->as.block.statements[i] = readStmt(reader);
+        }
+        break;
+    }
+    case STMT_IF:
+        stmt->as.ifStmt.condition = readExpr(reader);
+        stmt->as.ifStmt.thenBranch = readStmt(reader);
+        stmt->as.ifStmt.elseBranch = readStmt(reader);
+        break;
+    case STMT_WHILE:
+        stmt->as.whileLoop.condition = readExpr(reader);
+        stmt->as.whileLoop.body = readStmt(reader);
+        break;
+    case STMT_FOR:
+        stmt->as.forLoop.initializer = readStmt(reader);
+        stmt->as.forLoop.condition = readExpr(reader);
+        stmt->as.forLoop.increment = readExpr(reader);
+        stmt->as.forLoop.body = readStmt(reader);
+        break;
+    case STMT_FUNCTION:
+    {
+        FunctionStmt *function = &stmt->as.function;
+        function->name = getToken(reader);
+        int count = getCount(reader);
+        function->params = (Token *)allocateArray(reader, count, sizeof(Token));
+        function->paramHasVar = (bool *)allocateArray(reader, count, sizeof(bool));
+        function->paramTypes = (TypeAnnotation *)allocateArray(reader, count, sizeof(TypeAnnotation));
+        if (count > 0 && (function->params == NULL || function->paramHasVar == NULL || function->paramTypes == NULL))
+        {
+            reader->failed = true;
+            break;
+        }
+        function->paramCount = count;
+        for (int i = 0; i < count && !reader->failed; i++)
+        {
+            function->params[i] = getToken(reader);
+            function->paramHasVar[i] = getEnum(reader, 1) != 0;
+            function->paramTypes[i] = readType(reader);
+        }
+        function->returnType = readType(reader);
+        function->body = readStmt(reader);
+        if (function->body == NULL || function->body->type != STMT_BLOCK)
+        {
+            reader->failed = true;
+        }
+        int flags = getEnum(reader, 3);
+        function->isStatic = (flags & 1) != 0;
+        function->isGenerator = (flags & 2) != 0;
+        break;
+    }
+    case STMT_RETURN:
+        stmt->as.returnStmt.keyword = getToken(reader);
+        stmt->as.returnStmt.value = readExpr(reader);
+        break;
+    case STMT_SWITCH:
+    {
+        stmt->as.switchStmt.discriminant = readExpr(reader);
+        int count = getCount(reader);
+        stmt->as.switchStmt.cases = (CaseStmt *)allocateArray(reader, count, sizeof(CaseStmt));
+        if (stmt->as.switchStmt.cases == NULL)
+        {
+            break;
+        }
+        stmt->as.switchStmt.caseCount = count;
+        for (int i = 0; i < count && !reader->failed; i++)
+        {
+            stmt->as.switchStmt.cases[i].value = readExpr(reader);
+            stmt->as.switchStmt.cases[i].body = readStmt(reader);
+        }
+        break;
+    }
+    case STMT_BREAK:
+        stmt->as.breakStmt.keyword = getToken(reader);
+        break;
+    case STMT_DO_WHILE:
+        stmt->as.doWhile.body = readStmt(reader);
+        stmt->as.doWhile.condition = readExpr(reader);
+        break;
+    case STMT_ENUM:
+    {
+        stmt->as.enumStmt.name = getToken(reader);
+        int count = getCount(reader);
+        stmt->as.enumStmt.members = (EnumMember *)allocateArray(reader, count, sizeof(EnumMember));
+        if (stmt->as.enumStmt.members == NULL)
+        {
+            break;
+        }
+        stmt->as.enumStmt.memberCount = count;
+        for (int i = 0; i < count && !reader->failed; i++)
+        {
+            stmt->as.enumStmt.members[i].name = getToken(reader);
+            stmt->as.enumStmt.members[i].value = readExpr(reader);
+        }
+        break;
+    }
+    case STMT_STRUCT:
+    {
+        stmt->as.structStmt.name = getToken(reader);
+        int count = getCount(reader);
+        stmt->as.structStmt.fields = (StructField *)allocateArray(reader, count, sizeof(StructField));
+        if (stmt->as.structStmt.fields == NULL)
+        {
+            break;
+        }
+        stmt->as.structStmt.fieldCount = count;
+        for (int i = 0; i < count && !reader->failed; i++)
+        {
+            stmt->as.structStmt.fields[i].name = getToken(reader);
+            stmt->as.structStmt.fields[i].type = readType(reader);
+        }
+        break;
+    }
+    case STMT_FOR_IN:
+        stmt->as.forIn.name = getToken(reader);
+        stmt->as.forIn.iterable = readExpr(reader);
+        stmt->as.forIn.body = readStmt(reader);
+        break;
+    case STMT_YIELD:
+        stmt->as.yieldStmt.keyword = getToken(reader);
+        stmt->as.yieldStmt.value = readExpr(reader);
+        stmt->as.yieldStmt.delegate = getEnum(reader, 1) != 0;
+        break;
+    }
+    return stmt;
+}
+
+bool loadProgramCache(const char *cachePath, const char *source, size_t sourceLength, bool lazyFunctions,
+                      LoadedProgram *program)
+{
+    int fd = open(cachePath, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CacheHeader))
+    {
+        close(fd);
+        return false;
+    }
+    size_t imageSize = (size_t)info.st_size;
+    void *image = mmap(NULL, imageSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED)
+    {
+        return false;
+    }
+
+    CacheHeader header;
+    memcpy(&header, image, sizeof(header));
+    char *strings = (char *)image + sizeof(header);
+    bool valid = memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == PROGRAM_CACHE_VERSION && header.layout == layoutTag() &&
+                 header.sourceLength == sourceLength && (lazyFunctions || header.bodyTokenCount == 0) &&
+                 header.stringsSize > 0 && header.stringsSize <= imageSize - sizeof(header) &&
+                 header.nodesSize == imageSize - sizeof(header) - header.stringsSize &&
+                 strings[header.stringsSize - 1] == '\0' &&
+                 header.sourceHash == hashSource(source, sourceLength) &&
+                 header.contentHash == hashBytes(FNV_OFFSET_BASIS, strings, imageSize - sizeof(header));
+    if (!valid)
+    {
+        munmap(image, imageSize);
+        return false;
+    }
+
+    CacheReader reader;
+    reader.strings = strings;
+    reader.stringsSize = header.stringsSize;
+    reader.cursor = (const unsigned char *)strings + header.stringsSize;
+    reader.end = reader.cursor + header.nodesSize;
+    reader.failed = header.stmtCount > header.nodesSize || header.bodyTokenCount > header.nodesSize;
+    reader.bodyTokenCount = reader.failed ? 0 : header.bodyTokenCount;
+    reader.bodyTokensUsed = 0;
+    reader.bodyTokens = NULL;
+    if (reader.bodyTokenCount > 0)
+    {
+        reader.bodyTokens = (Token *)calloc((size_t)reader.bodyTokenCount, sizeof(Token));
+        reader.failed = reader.bodyTokens == NULL;
+    }
+
+    int stmtCount = reader.failed ? 0 : (int)header.stmtCount;
+    Stmt **statements = (Stmt **)malloc(sizeof(Stmt *) * (size_t)(stmtCount > 0 ? stmtCount : 1));
+    int count = 0;
+    if (statements == NULL)
+    {
+        reader.failed = true;
+    }
+    while (!reader.failed && count < stmtCount)
+    {
+        Stmt *stmt = readStmt(&reader);
+        if (stmt != NULL)
+        {
+            statements[count++] = stmt;
+        }
+        else
+        {
+            reader.failed = true;
+        }
+    }
+
+    if (reader.failed || reader.cursor != reader.end || reader.bodyTokensUsed != reader.bodyTokenCount)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            freeStmt(statements[i]);
+        }
+        free(statements);
+        free(reader.bodyTokens);
+        munmap(image, imageSize);
+        return false;
+    }
+
+    program->image = image;
+    program->imageSize = imageSize;
+    program->bodyTokens = reader.bodyTokens;
+    program->statements = statements;
+    program->stmtCount = count;
+    program->fromCache = true;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 加载程序
+// ---------------------------------------------------------------------------
+
+ProgramStatus loadProgram(LoadedProgram *program, const char *path, bool useCache, bool lazyFunctions)
+{
+    memset(program, 0, sizeof(*program));
+
+    program->source = readFile(path);
+    if (program->source == NULL)
+    {
+        snprintf(program->error, sizeof(program->error), "Could not read file '%s'\n", path);
+        return PROGRAM_READ_ERROR;
+    }
+    size_t sourceLength = strlen(program->source);
+
+    char *cachePath = useCache ? programCachePath(path) : NULL;
+    if (cachePath != NULL && loadProgramCache(cachePath, program->source, sourceLength, lazyFunctions, program))
+    {
+        free(cachePath);
+        return PROGRAM_OK;
+    }
+
+    // 流式解析：不生成完整的标记数组；延迟解析时函数体复制自己的标记
+    Lexer lexer;
+    initLexer(&lexer, program->source);
+    Parser parser;
+    if (!initStreamingParser(&parser, &lexer))
+    {
+        snprintf(program->error, sizeof(program->error), "Lexical analysis failed\n");
+        free(cachePath);
+        return PROGRAM_LEX_ERROR;
+    }
+    parser.lazyFunctions = lazyFunctions;
+    program->statements = parse(&parser, &program->stmtCount);
+    program->text = lexer.text;
+    freeParser(&parser);
+    if (hadParseError(&parser))
+    {
+        snprintf(program->error, sizeof(program->error), "Parse error: %s\n", getParseErrorMsg(&parser));
+        free(cachePath);
+        return PROGRAM_PARSE_ERROR;
+    }
+
+    // 写缓存失败（如目录不可写）不影响本次运行
+    if (cachePath != NULL)
+    {
+        saveProgramCache(cachePath, program->source, sourceLength, program->statements, program->stmtCount);
+        free(cachePath);
+    }
+    return PROGRAM_OK;
+}
+
+void freeLoadedProgram(LoadedProgram *program)
+{
+    for (int i = 0; i < program->stmtCount; i++)
+    {
+        freeStmt(program->statements[i]);
+    }
+    free(program->statements);
+    freeLexemeBlocks(program->text);
+    free(program->bodyTokens);
+    if (program->image != NULL)
+    {
+        munmap(program->image, program->imageSize);
+    }
+    free(program->source);
+    memset(program, 0, sizeof(*program));
+}
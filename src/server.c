@@ -0,0 +1,320 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "interpreter.h"
+#include "program_cache.h"
+#include "server.h"
+#include "server_protocol.h"
+
+// 最多缓存的程序数，超出时淘汰最久未使用的
+#define SERVER_CACHE_CAPACITY 64
+
+// 连接上收发一次数据的最长等待时间：请求逐个处理，不发送或只发送半个请求的客户端
+// 超时后被断开，不会一直挡住其他客户端
+#define SERVER_IDLE_TIMEOUT_SECONDS 10
+
+// 缓存的程序：语法树在文件变化或被淘汰之前一直保留
+typedef struct CachedProgram
+{
+    char *path;
+    struct timespec mtime;
+    off_t size;
+    ProgramStatus status;
+    LoadedProgram program; // 读取或解析失败时 program.error 为错误信息，同样缓存到文件下次变化
+    struct CachedProgram *next;
+} CachedProgram;
+
+typedef struct
+{
+    const ServerOptions *options;
+    CachedProgram *programs; // 按最近使用排序
+    int programCount;
+} Server;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void handleStopSignal(int signal)
+{
+    (void)signal;
+    stopRequested = 1;
+}
+
+static void freeProgram(CachedProgram *program)
+{
+    freeLoadedProgram(&program->program);
+    free(program->path);
+    free(program);
+}
+
+static CachedProgram *newCachedProgram(const char *path, const struct stat *info, const ServerOptions *options)
+{
+    CachedProgram *program = (CachedProgram *)calloc(1, sizeof(CachedProgram));
+    if (program == NULL)
+    {
+        return NULL;
+    }
+    program->path = (char *)malloc(strlen(path) + 1);
+    if (program->path == NULL)
+    {
+        free(program);
+        return NULL;
+    }
+    strcpy(program->path, path);
+    program->mtime = info->st_mtim;
+    program->size = info->st_size;
+    program->status = loadProgram(&program->program, path, options->useCache, options->lazyFunctions);
+    return program;
+}
+
+// 取得脚本的缓存程序：未缓存或文件已变化时重新解析
+static CachedProgram *findProgram(Server *server, const char *path, char *error, size_t errorSize)
+{
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        snprintf(error, errorSize, "Could not read file '%s'\n", path);
+        return NULL;
+    }
+
+    CachedProgram **link = &server->programs;
+    while (*link != NULL && strcmp((*link)->path, path) != 0)
+    {
+        link = &(*link)->next;
+    }
+
+    CachedProgram *program = *link;
+    if (program != NULL)
+    {
+        *link = program->next;
+        if (program->mtime.tv_sec == info.st_mtim.tv_sec && program->mtime.tv_nsec == info.st_mtim.tv_nsec &&
+            program->size == info.st_size)
+        {
+            program->next = server->programs;
+            server->programs = program;
+            return program;
+        }
+        freeProgram(program);
+        server->programCount--;
+    }
+
+    program = newCachedProgram(path, &info, server->options);
+    if (program == NULL)
+    {
+        snprintf(error, errorSize, "内存分配失败\n");
+        return NULL;
+    }
+
+    // 淘汰链表末尾最久未使用的程序
+    if (server->programCount >= SERVER_CACHE_CAPACITY)
+    {
+        CachedProgram **last = &server->programs;
+        while ((*last)->next != NULL)
+        {
+            last = &(*last)->next;
+        }
+        freeProgram(*last);
+        *last = NULL;
+        server->programCount--;
+    }
+
+    program->next = server->programs;
+    server->programs = program;
+    server->programCount++;
+    return program;
+}
+
+static bool sendResponse(int client, uint32_t status, const char *output, size_t outputLength, const char *error)
+{
+    return sendUint32(client, status) && sendFrame(client, output, outputLength) &&
+           sendFrame(client, error, strlen(error));
+}
+
+// 在新的解释器中执行一个请求；args[0] 为脚本路径。返回响应是否发送成功
+static bool runRequest(Server *server, int client, char **args, int argCount)
+{
+    char error[320];
+    CachedProgram *program = findProgram(server, args[0], error, sizeof(error));
+    if (program == NULL)
+    {
+        return sendResponse(client, 1, "", 0, error);
+    }
+    if (program->status != PROGRAM_OK)
+    {
+        return sendResponse(client, 1, "", 0, program->program.error);
+    }
+
+    Interpreter interpreter;
+    initInterpreter(&interpreter);
+    interpreter.explicitStack = server->options->explicitStack;
+    interpreter.maxCallDepth = server->options->maxCallDepth;
+    interpreter.scriptArgs = args + 1;
+    interpreter.scriptArgCount = argCount - 1;
+    interpreter.inputDisabled = true;
+    setTimeLimit(&interpreter, server->options->timeLimit * 1000);
+
+    // 输出留在内存中，执行结束后一次发回
+    freeOutputBuffer(&interpreter.output);
+    initOutputCapture(&interpreter.output);
+
+    interpret(&interpreter, program->program.statements, program->program.stmtCount);
+
+    uint32_t status = 0;
+    error[0] = '\0';
+    if (hadInterpreterError(&interpreter))
+    {
+        status = 1;
+        snprintf(error, sizeof(error), "Runtime error: %s\n", getInterpreterError(&interpreter));
+    }
+
+    bool sent = sendResponse(client, status, interpreter.output.data, interpreter.output.length, error);
+    freeInterpreter(&interpreter);
+    return sent;
+}
+
+// 依次处理一个连接上的请求，直到客户端关闭连接或请求格式错误
+static void serveConnection(Server *server, int client)
+{
+    while (!stopRequested)
+    {
+        uint32_t argCount;
+        if (!receiveUint32(client, &argCount) || argCount == 0 || argCount > SERVER_MAX_ARGS)
+        {
+            return;
+        }
+
+        char **args = (char **)calloc(argCount, sizeof(char *));
+        if (args == NULL)
+        {
+            return;
+        }
+        bool complete = true;
+        for (uint32_t i = 0; i < argCount && complete; i++)
+        {
+            args[i] = receiveFrame(client, NULL);
+            complete = args[i] != NULL;
+        }
+
+        bool sent = complete && runRequest(server, client, args, (int)argCount);
+        for (uint32_t i = 0; i < argCount; i++)
+        {
+            free(args[i]);
+        }
+        free(args);
+        if (!sent)
+        {
+            return;
+        }
+    }
+}
+
+// 为接受的连接设置收发超时，超时后 read/write 失败，serveConnection 随即断开连接
+static bool setConnectionTimeout(int client)
+{
+    struct timeval timeout = {SERVER_IDLE_TIMEOUT_SECONDS, 0};
+    return setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+           setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == 0;
+}
+
+// 创建并监听套接字；路径上残留的套接字文件在无人监听时删除
+static int openSocket(const char *socketPath)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+    {
+        fprintf(stderr, "Socket path too long '%s'\n", socketPath);
+        return -1;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        perror("socket");
+        return -1;
+    }
+
+    struct stat info;
+    if (lstat(socketPath, &info) == 0 && S_ISSOCK(info.st_mode))
+    {
+        if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0)
+        {
+            fprintf(stderr, "Another server is listening on '%s'\n", socketPath);
+            close(fd);
+            return -1;
+        }
+        unlink(socketPath);
+    }
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+    {
+        fprintf(stderr, "Could not listen on '%s': %s\n", socketPath, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int runServer(const char *socketPath, const ServerOptions *options)
+{
+    // 客户端提前断开时 write 返回错误而不是终止进程
+    signal(SIGPIPE, SIG_IGN);
+
+    // 不设置 SA_RESTART，使阻塞中的 accept 被信号打断后退出循环
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    int listener = openSocket(socketPath);
+    if (listener < 0)
+    {
+        return 1;
+    }
+    fprintf(stderr, "Serving on %s\n", socketPath);
+
+    Server server = {options, NULL, 0};
+    while (!stopRequested)
+    {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            perror("accept");
+            break;
+        }
+        if (setConnectionTimeout(client))
+        {
+            serveConnection(&server, client);
+        }
+        else
+        {
+            perror("setsockopt");
+        }
+        close(client);
+    }
+
+    close(listener);
+    unlink(socketPath);
+    while (server.programs != NULL)
+    {
+        CachedProgram *next = server.programs->next;
+        freeProgram(server.programs);
+        server.programs = next;
+    }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <stdlib.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "server_protocol.h"
+
+// 写出全部数据，处理部分写入和信号中断
+static bool writeAll(int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fd, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return true;
+}
+
+// 读满 length 字节，对端提前关闭时返回 false
+static bool readAll(int fd, char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t received = read(fd, data, length);
+        if (received < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        if (received == 0)
+        {
+            return false;
+        }
+        data += received;
+        length -= (size_t)received;
+    }
+    return true;
+}
+
+bool sendUint32(int fd, uint32_t value)
+{
+    uint32_t encoded = htonl(value);
+    return writeAll(fd, (const char *)&encoded, sizeof(encoded));
+}
+
+bool receiveUint32(int fd, uint32_t *value)
+{
+    uint32_t encoded;
+    if (!readAll(fd, (char *)&encoded, sizeof(encoded)))
+    {
+        return false;
+    }
+    *value = ntohl(encoded);
+    return true;
+}
+
+bool sendFrame(int fd, const char *data, size_t length)
+{
+    if (length > SERVER_MAX_FRAME)
+    {
+        return false;
+    }
+    return sendUint32(fd, (uint32_t)length) && writeAll(fd, data, length);
+}
+
+char *receiveFrame(int fd, size_t *length)
+{
+    uint32_t size;
+    if (!receiveUint32(fd, &size) || size > SERVER_MAX_FRAME)
+    {
+        return NULL;
+    }
+
+    char *data = (char *)malloc((size_t)size + 1);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+    if (!readAll(fd, data, size))
+    {
+        free(data);
+        return NULL;
+    }
+    data[size] = '\0';
+    if (length != NULL)
+    {
+        *length = size;
+    }
+    return data;
+}
@@ -0,0 +1,1514 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "simd_kernels.h"
+#include "array_sort.h"
+
+// 向量实现只用于 x86-64：i386 上 int64/double 在结构体内只按 4 字节对齐，Value 只有 12 字节
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SPARROW_X86_SIMD 1
+#include <immintrin.h>
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+// 向量核函数按 16 字节一个 Value 成对载入，并从偏移 8 处取载荷、从低 32 位取类型标签。
+// 这是整数常量表达式，布局不符时编译器直接折叠掉向量分支，始终使用标量实现
+#define VALUE_LAYOUT_FITS_SIMD (sizeof(Value) == 16 && offsetof(Value, as) == 8)
+
+// 数组级操作每次交给核函数的最大元素个数，使按类型分段的扫描与随后的运算都命中 L1 缓存
+#define KERNEL_BLOCK_SIZE 512
+
+typedef struct
+{
+    size_t (*typeRun)(const Value *, size_t, ValueType);
+    double (*sumNumbers)(const Value *, size_t);
+    bool (*sumIntegers)(const Value *, size_t, int64_t *);
+    void (*minMaxNumbers)(const Value *, size_t, double *, double *);
+    void (*minMaxIntegers)(const Value *, size_t, int64_t *, int64_t *);
+    double (*dotNumbers)(const Value *, const Value *, size_t);
+    size_t (*indexOfNumber)(const Value *, size_t, double);
+    size_t (*indexOfInteger)(const Value *, size_t, int64_t);
+    size_t (*countNumber)(const Value *, size_t, double);
+    size_t (*countInteger)(const Value *, size_t, int64_t);
+    void (*arithmeticNumbers)(ArithmeticOp, ArithmeticOperand, ArithmeticOperand, Value *, size_t);
+    size_t (*identifierRun)(const char *, size_t);
+    size_t (*whitespaceRun)(const char *, size_t, int *);
+    size_t (*findEitherByte)(const char *, size_t, char, char);
+} KernelTable;
+
+// ---------------------------------------------------------------------------
+// 标量实现
+// ---------------------------------------------------------------------------
+
+static size_t scalarTypeRun(const Value *values, size_t count, ValueType type)
+{
+    size_t i = 0;
+    while (i < count && values[i].type == type)
+    {
+        i++;
+    }
+    return i;
+}
+
+static double scalarSumNumbers(const Value *values, size_t count)
+{
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        s0 += values[i].as.number;
+        s1 += values[i + 1].as.number;
+        s2 += values[i + 2].as.number;
+        s3 += values[i + 3].as.number;
+    }
+
+    double sum = (s0 + s1) + (s2 + s3);
+    for (; i < count; i++)
+    {
+        sum += values[i].as.number;
+    }
+    return sum;
+}
+
+static bool scalarSumIntegers(const Value *values, size_t count, int64_t *sum)
+{
+    int64_t total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (__builtin_add_overflow(total, values[i].as.integer, &total))
+        {
+            return false;
+        }
+    }
+    *sum = total;
+    return true;
+}
+
+static void scalarMinMaxNumbers(const Value *values, size_t count, double *min, double *max)
+{
+    double low = values[0].as.number;
+    double high = low;
+    bool hasNaN = false;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        double x = values[i].as.number;
+        hasNaN = hasNaN || isnan(x);
+        low = x < low ? x : low;
+        high = x > high ? x : high;
+    }
+
+    *min = hasNaN ? NAN : low;
+    *max = hasNaN ? NAN : high;
+}
+
+static void scalarMinMaxIntegers(const Value *values, size_t count, int64_t *min, int64_t *max)
+{
+    int64_t low = values[0].as.integer;
+    int64_t high = low;
+    for (size_t i = 1; i < count; i++)
+    {
+        int64_t x = values[i].as.integer;
+        low = x < low ? x : low;
+        high = x > high ? x : high;
+    }
+    *min = low;
+    *max = high;
+}
+
+static double scalarDotNumbers(const Value *a, const Value *b, size_t count)
+{
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        s0 += a[i].as.number * b[i].as.number;
+        s1 += a[i + 1].as.number * b[i + 1].as.number;
+        s2 += a[i + 2].as.number * b[i + 2].as.number;
+        s3 += a[i + 3].as.number * b[i + 3].as.number;
+    }
+
+    double sum = (s0 + s1) + (s2 + s3);
+    for (; i < count; i++)
+    {
+        sum += a[i].as.number * b[i].as.number;
+    }
+    return sum;
+}
+
+static size_t scalarIndexOfNumber(const Value *values, size_t count, double target)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (values[i].as.number == target)
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+static size_t scalarIndexOfInteger(const Value *values, size_t count, int64_t target)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (values[i].as.integer == target)
+        {
+            return i;
+        }
+    }
+    return count;
+}
+
+static size_t scalarCountNumber(const Value *values, size_t count, double target)
+{
+    size_t matches = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        matches += values[i].as.number == target;
+    }
+    return matches;
+}
+
+static size_t scalarCountInteger(const Value *values, size_t count, int64_t target)
+{
+    size_t matches = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        matches += values[i].as.integer == target;
+    }
+    return matches;
+}
+
+static inline double operandNumber(const ArithmeticOperand *operand, size_t index)
+{
+    return operand->values != NULL ? operand->values[index].as.number : operand->number;
+}
+
+static inline double applyArithmetic(ArithmeticOp op, double x, double y)
+{
+    switch (op)
+    {
+    case ARITH_ADD:
+        return x + y;
+    case ARITH_SUB:
+        return x - y;
+    case ARITH_MUL:
+        return x * y;
+    default:
+        return x / y;
+    }
+}
+
+static void scalarArithmeticNumbers(ArithmeticOp op, ArithmeticOperand a, ArithmeticOperand b, Value *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        double result = applyArithmetic(op, operandNumber(&a, i), operandNumber(&b, i));
+        out[i].type = VAL_NUMBER;
+        out[i].as.number = result;
+    }
+}
+
+// 操作数从第 offset 个元素开始的部分，用于向量循环之后的尾部
+static ArithmeticOperand operandFrom(ArithmeticOperand operand, size_t offset)
+{
+    if (operand.values != NULL)
+    {
+        operand.values += offset;
+    }
+    return operand;
+}
+
+// 文本扫描
+
+static bool isIdentifierByte(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static size_t scalarIdentifierRun(const char *text, size_t length)
+{
+    size_t i = 0;
+    while (i < length && isIdentifierByte(text[i]))
+    {
+        i++;
+    }
+    return i;
+}
+
+static size_t scalarWhitespaceRun(const char *text, size_t length, int *newlines)
+{
+    size_t i = 0;
+    for (; i < length; i++)
+    {
+        char c = text[i];
+        if (c == '\n')
+        {
+            (*newlines)++;
+        }
+        else if (c != ' ' && c != '\t' && c != '\r')
+        {
+            break;
+        }
+    }
+    return i;
+}
+
+static size_t scalarFindEitherByte(const char *text, size_t length, char a, char b)
+{
+    size_t i = 0;
+    while (i < length && text[i] != a && text[i] != b)
+    {
+        i++;
+    }
+    return i;
+}
+
+static const KernelTable scalarKernels = {
+    scalarTypeRun,
+    scalarSumNumbers,
+    scalarSumIntegers,
+    scalarMinMaxNumbers,
+    scalarMinMaxIntegers,
+    scalarDotNumbers,
+    scalarIndexOfNumber,
+    scalarIndexOfInteger,
+    scalarCountNumber,
+    scalarCountInteger,
+    scalarArithmeticNumbers,
+    scalarIdentifierRun,
+    scalarWhitespaceRun,
+    scalarFindEitherByte,
+};
+
+#ifdef SPARROW_X86_SIMD
+
+// ---------------------------------------------------------------------------
+// SSE2 实现：每个 Value 装入一个 128 位寄存器 [类型, 负载]，两两合并出负载向量
+// ---------------------------------------------------------------------------
+
+// 取 values[0..1] 的负载
+TARGET_SSE2 static inline __m128d sse2LoadNumbers(const Value *values)
+{
+    return _mm_unpackhi_pd(_mm_loadu_pd((const double *)&values[0]),
+                           _mm_loadu_pd((const double *)&values[1]));
+}
+
+TARGET_SSE2 static inline __m128i sse2LoadIntegers(const Value *values)
+{
+    return _mm_unpackhi_epi64(_mm_loadu_si128((const __m128i *)&values[0]),
+                              _mm_loadu_si128((const __m128i *)&values[1]));
+}
+
+// 64 位整数相等比较（SSE2 只有 32 位比较，两半都相等才算相等）
+TARGET_SSE2 static inline __m128i sse2EqualIntegers(__m128i a, __m128i b)
+{
+    __m128i halves = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+TARGET_SSE2 static size_t sse2TypeRun(const Value *values, size_t count, ValueType type)
+{
+    const __m128i expected = _mm_set1_epi32((int)type);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // 类型位于每个 Value 的低 32 位，收集 4 个元素的类型后一次比较
+        __m128i a = _mm_loadu_si128((const __m128i *)&values[i]);
+        __m128i b = _mm_loadu_si128((const __m128i *)&values[i + 1]);
+        __m128i c = _mm_loadu_si128((const __m128i *)&values[i + 2]);
+        __m128i d = _mm_loadu_si128((const __m128i *)&values[i + 3]);
+        __m128i types = _mm_unpacklo_epi64(_mm_unpacklo_epi32(a, b), _mm_unpacklo_epi32(c, d));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(types, expected)) != 0xFFFF)
+        {
+            break;
+        }
+    }
+    return i + scalarTypeRun(values + i, count - i, type);
+}
+
+TARGET_SSE2 static double sse2SumNumbers(const Value *values, size_t count)
+{
+    __m128d low = _mm_setzero_pd();  // 下标模 4 余 0、1
+    __m128d high = _mm_setzero_pd(); // 下标模 4 余 2、3
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        low = _mm_add_pd(low, sse2LoadNumbers(&values[i]));
+        high = _mm_add_pd(high, sse2LoadNumbers(&values[i + 2]));
+    }
+
+    double lanes[4];
+    _mm_storeu_pd(&lanes[0], low);
+    _mm_storeu_pd(&lanes[2], high);
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; i++)
+    {
+        sum += values[i].as.number;
+    }
+    return sum;
+}
+
+TARGET_SSE2 static bool sse2SumIntegers(const Value *values, size_t count, int64_t *sum)
+{
+    __m128i low = _mm_setzero_si128();
+    __m128i high = _mm_setzero_si128();
+    __m128i overflow = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        // 有符号加法溢出当且仅当结果的符号与两个加数都不同
+        __m128i x = sse2LoadIntegers(&values[i]);
+        __m128i r = _mm_add_epi64(low, x);
+        overflow = _mm_or_si128(overflow, _mm_and_si128(_mm_xor_si128(low, r), _mm_xor_si128(x, r)));
+        low = r;
+
+        x = sse2LoadIntegers(&values[i + 2]);
+        r = _mm_add_epi64(high, x);
+        overflow = _mm_or_si128(overflow, _mm_and_si128(_mm_xor_si128(high, r), _mm_xor_si128(x, r)));
+        high = r;
+    }
+    if (_mm_movemask_pd(_mm_castsi128_pd(overflow)) != 0)
+    {
+        return false;
+    }
+
+    int64_t lanes[4];
+    _mm_storeu_si128((__m128i *)&lanes[0], low);
+    _mm_storeu_si128((__m128i *)&lanes[2], high);
+    int64_t total = 0;
+    for (int lane = 0; lane < 4; lane++)
+    {
+        if (__builtin_add_overflow(total, lanes[lane], &total))
+        {
+            return false;
+        }
+    }
+
+    int64_t tail;
+    if (!scalarSumIntegers(values + i, count - i, &tail) || __builtin_add_overflow(total, tail, &total))
+    {
+        return false;
+    }
+    *sum = total;
+    return true;
+}
+
+TARGET_SSE2 static void sse2MinMaxNumbers(const Value *values, size_t count, double *min, double *max)
+{
+    __m128d low = _mm_set1_pd(values[0].as.number);
+    __m128d high = low;
+    __m128d nan = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d x = sse2LoadNumbers(&values[i]);
+        nan = _mm_or_pd(nan, _mm_cmpunord_pd(x, x));
+        low = _mm_min_pd(low, x);
+        high = _mm_max_pd(high, x);
+    }
+
+    double lows[2], highs[2];
+    _mm_storeu_pd(lows, low);
+    _mm_storeu_pd(highs, high);
+    double tailMin = lows[0] < lows[1] ? lows[0] : lows[1];
+    double tailMax = highs[0] > highs[1] ? highs[0] : highs[1];
+    bool hasNaN = _mm_movemask_pd(nan) != 0;
+
+    if (i < count)
+    {
+        double x = values[i].as.number;
+        hasNaN = hasNaN || isnan(x);
+        tailMin = x < tailMin ? x : tailMin;
+        tailMax = x > tailMax ? x : tailMax;
+    }
+
+    *min = hasNaN ? NAN : tailMin;
+    *max = hasNaN ? NAN : tailMax;
+}
+
+TARGET_SSE2 static double sse2DotNumbers(const Value *a, const Value *b, size_t count)
+{
+    __m128d low = _mm_setzero_pd();
+    __m128d high = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        low = _mm_add_pd(low, _mm_mul_pd(sse2LoadNumbers(&a[i]), sse2LoadNumbers(&b[i])));
+        high = _mm_add_pd(high, _mm_mul_pd(sse2LoadNumbers(&a[i + 2]), sse2LoadNumbers(&b[i + 2])));
+    }
+
+    double lanes[4];
+    _mm_storeu_pd(&lanes[0], low);
+    _mm_storeu_pd(&lanes[2], high);
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; i++)
+    {
+        sum += a[i].as.number * b[i].as.number;
+    }
+    return sum;
+}
+
+TARGET_SSE2 static size_t sse2IndexOfNumber(const Value *values, size_t count, double target)
+{
+    const __m128d expected = _mm_set1_pd(target);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int mask = _mm_movemask_pd(_mm_cmpeq_pd(sse2LoadNumbers(&values[i]), expected)) |
+                   _mm_movemask_pd(_mm_cmpeq_pd(sse2LoadNumbers(&values[i + 2]), expected)) << 2;
+        if (mask != 0)
+        {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+    }
+    return i + scalarIndexOfNumber(values + i, count - i, target);
+}
+
+TARGET_SSE2 static size_t sse2IndexOfInteger(const Value *values, size_t count, int64_t target)
+{
+    const __m128i expected = _mm_set1_epi64x(target);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i low = sse2EqualIntegers(sse2LoadIntegers(&values[i]), expected);
+        __m128i high = sse2EqualIntegers(sse2LoadIntegers(&values[i + 2]), expected);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(low)) | _mm_movemask_pd(_mm_castsi128_pd(high)) << 2;
+        if (mask != 0)
+        {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+    }
+    return i + scalarIndexOfInteger(values + i, count - i, target);
+}
+
+TARGET_SSE2 static size_t sse2CountNumber(const Value *values, size_t count, double target)
+{
+    const __m128d expected = _mm_set1_pd(target);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int mask = _mm_movemask_pd(_mm_cmpeq_pd(sse2LoadNumbers(&values[i]), expected)) |
+                   _mm_movemask_pd(_mm_cmpeq_pd(sse2LoadNumbers(&values[i + 2]), expected)) << 2;
+        matches += (size_t)__builtin_popcount((unsigned)mask);
+    }
+    return matches + scalarCountNumber(values + i, count - i, target);
+}
+
+TARGET_SSE2 static size_t sse2CountInteger(const Value *values, size_t count, int64_t target)
+{
+    const __m128i expected = _mm_set1_epi64x(target);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i low = sse2EqualIntegers(sse2LoadIntegers(&values[i]), expected);
+        __m128i high = sse2EqualIntegers(sse2LoadIntegers(&values[i + 2]), expected);
+        int mask = _mm_movemask_pd(_mm_castsi128_pd(low)) | _mm_movemask_pd(_mm_castsi128_pd(high)) << 2;
+        matches += (size_t)__builtin_popcount((unsigned)mask);
+    }
+    return matches + scalarCountInteger(values + i, count - i, target);
+}
+
+TARGET_SSE2 static inline __m128d sse2LoadOperand(const ArithmeticOperand *operand, size_t index)
+{
+    return operand->values != NULL ? sse2LoadNumbers(&operand->values[index]) : _mm_set1_pd(operand->number);
+}
+
+TARGET_SSE2 static inline __m128d sse2ApplyArithmetic(ArithmeticOp op, __m128d x, __m128d y)
+{
+    switch (op)
+    {
+    case ARITH_ADD:
+        return _mm_add_pd(x, y);
+    case ARITH_SUB:
+        return _mm_sub_pd(x, y);
+    case ARITH_MUL:
+        return _mm_mul_pd(x, y);
+    default:
+        return _mm_div_pd(x, y);
+    }
+}
+
+TARGET_SSE2 static void sse2ArithmeticNumbers(ArithmeticOp op, ArithmeticOperand a, ArithmeticOperand b, Value *out, size_t count)
+{
+    // 结果与类型字段交错写回：[类型, r0] [类型, r1]
+    const __m128d tag = _mm_castsi128_pd(_mm_set1_epi64x(VAL_NUMBER));
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d result = sse2ApplyArithmetic(op, sse2LoadOperand(&a, i), sse2LoadOperand(&b, i));
+        _mm_storeu_pd((double *)&out[i], _mm_unpacklo_pd(tag, result));
+        _mm_storeu_pd((double *)&out[i + 1], _mm_unpackhi_pd(tag, result));
+    }
+    scalarArithmeticNumbers(op, operandFrom(a, i), operandFrom(b, i), out + i, count - i);
+}
+
+// 文本扫描：一次比较 16 个字节，得到逐字节的命中掩码
+
+// lo <= 字节 <= hi；高位为 1 的字节按有符号数比较为负数，不落在任何 ASCII 区间内
+TARGET_SSE2 static inline __m128i sse2ByteRange(__m128i bytes, char lo, char hi)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8((char)(lo - 1))),
+                         _mm_cmpgt_epi8(_mm_set1_epi8((char)(hi + 1)), bytes));
+}
+
+TARGET_SSE2 static size_t sse2IdentifierRun(const char *text, size_t length)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(text + i));
+        // 与 0x20 按位或把大写字母转为小写
+        __m128i letter = sse2ByteRange(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), 'a', 'z');
+        __m128i digit = sse2ByteRange(bytes, '0', '9');
+        __m128i underscore = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_'));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(letter, digit), underscore));
+        if (mask != 0xFFFF)
+        {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return i + scalarIdentifierRun(text + i, length - i);
+}
+
+TARGET_SSE2 static size_t sse2WhitespaceRun(const char *text, size_t length, int *newlines)
+{
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(text + i));
+        __m128i newline = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'));
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')),
+                                                  _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))),
+                                     _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+        unsigned newlineMask = (unsigned)_mm_movemask_epi8(newline);
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(newline, blank));
+        if (mask != 0xFFFF)
+        {
+            unsigned run = (unsigned)__builtin_ctz(~mask);
+            *newlines += __builtin_popcount(newlineMask & ((1u << run) - 1));
+            return i + run;
+        }
+        *newlines += __builtin_popcount(newlineMask);
+    }
+    return i + scalarWhitespaceRun(text + i, length - i, newlines);
+}
+
+TARGET_SSE2 static size_t sse2FindEitherByte(const char *text, size_t length, char a, char b)
+{
+    const __m128i first = _mm_set1_epi8(a);
+    const __m128i second = _mm_set1_epi8(b);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(text + i));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, first), _mm_cmpeq_epi8(bytes, second)));
+        if (mask != 0)
+        {
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+        }
+    }
+    return i + scalarFindEitherByte(text + i, length - i, a, b);
+}
+
+static const KernelTable sse2Kernels = {
+    sse2TypeRun,
+    sse2SumNumbers,
+    sse2SumIntegers,
+    sse2MinMaxNumbers,
+    scalarMinMaxIntegers, // SSE2 没有 64 位整数大小比较
+    sse2DotNumbers,
+    sse2IndexOfNumber,
+    sse2IndexOfInteger,
+    sse2CountNumber,
+    sse2CountInteger,
+    sse2ArithmeticNumbers,
+    sse2IdentifierRun,
+    sse2WhitespaceRun,
+    sse2FindEitherByte,
+};
+
+// ---------------------------------------------------------------------------
+// AVX2 实现：一个 256 位寄存器装入两个 Value，两次装入合并出 4 个负载，
+// 负载在寄存器中的顺序为元素 [0, 2, 1, 3]
+// ---------------------------------------------------------------------------
+
+// 对应寄存器各通道的元素偏移
+static const int avx2LaneElement[4] = {0, 2, 1, 3};
+
+TARGET_AVX2 static inline __m256d avx2LoadNumbers(const Value *values)
+{
+    return _mm256_unpackhi_pd(_mm256_loadu_pd((const double *)&values[0]),
+                              _mm256_loadu_pd((const double *)&values[2]));
+}
+
+TARGET_AVX2 static inline __m256i avx2LoadIntegers(const Value *values)
+{
+    return _mm256_unpackhi_epi64(_mm256_loadu_si256((const __m256i *)&values[0]),
+                                 _mm256_loadu_si256((const __m256i *)&values[2]));
+}
+
+// 寄存器通道掩码中第一个命中的元素偏移
+static size_t firstLaneMatch(int mask)
+{
+    for (size_t element = 0; element < 4; element++)
+    {
+        for (int lane = 0; lane < 4; lane++)
+        {
+            if ((size_t)avx2LaneElement[lane] == element && (mask & (1 << lane)))
+            {
+                return element;
+            }
+        }
+    }
+    return 4;
+}
+
+TARGET_AVX2 static size_t avx2TypeRun(const Value *values, size_t count, ValueType type)
+{
+    const __m256i expected = _mm256_set1_epi64x((int64_t)(uint32_t)type);
+    const __m256i typeMask = _mm256_set1_epi64x(0xFFFFFFFF); // 只比较类型字段，忽略其后的填充字节
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i types = _mm256_unpacklo_epi64(_mm256_loadu_si256((const __m256i *)&values[i]),
+                                              _mm256_loadu_si256((const __m256i *)&values[i + 2]));
+        __m256i equal = _mm256_cmpeq_epi64(_mm256_and_si256(types, typeMask), expected);
+        if (_mm256_movemask_pd(_mm256_castsi256_pd(equal)) != 0xF)
+        {
+            break;
+        }
+    }
+    return i + scalarTypeRun(values + i, count - i, type);
+}
+
+// 按通道顺序 [0, 2, 1, 3] 取出 4 路部分和，按固定顺序合并
+TARGET_AVX2 static double avx2CombineLanes(__m256d sums)
+{
+    double lanes[4];
+    _mm256_storeu_pd(lanes, sums);
+    return (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+}
+
+TARGET_AVX2 static double avx2SumNumbers(const Value *values, size_t count)
+{
+    __m256d sums = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        sums = _mm256_add_pd(sums, avx2LoadNumbers(&values[i]));
+    }
+
+    double sum = avx2CombineLanes(sums);
+    for (; i < count; i++)
+    {
+        sum += values[i].as.number;
+    }
+    return sum;
+}
+
+TARGET_AVX2 static bool avx2SumIntegers(const Value *values, size_t count, int64_t *sum)
+{
+    __m256i sums = _mm256_setzero_si256();
+    __m256i overflow = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i x = avx2LoadIntegers(&values[i]);
+        __m256i r = _mm256_add_epi64(sums, x);
+        overflow = _mm256_or_si256(overflow, _mm256_and_si256(_mm256_xor_si256(sums, r), _mm256_xor_si256(x, r)));
+        sums = r;
+    }
+    if (_mm256_movemask_pd(_mm256_castsi256_pd(overflow)) != 0)
+    {
+        return false;
+    }
+
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, sums);
+    int64_t total = 0;
+    for (int lane = 0; lane < 4; lane++)
+    {
+        if (__builtin_add_overflow(total, lanes[lane], &total))
+        {
+            return false;
+        }
+    }
+
+    int64_t tail;
+    if (!scalarSumIntegers(values + i, count - i, &tail) || __builtin_add_overflow(total, tail, &total))
+    {
+        return false;
+    }
+    *sum = total;
+    return true;
+}
+
+TARGET_AVX2 static void avx2MinMaxNumbers(const Value *values, size_t count, double *min, double *max)
+{
+    __m256d low = _mm256_set1_pd(values[0].as.number);
+    __m256d high = low;
+    __m256d nan = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d x = avx2LoadNumbers(&values[i]);
+        nan = _mm256_or_pd(nan, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+        low = _mm256_min_pd(low, x);
+        high = _mm256_max_pd(high, x);
+    }
+
+    double lows[4], highs[4];
+    _mm256_storeu_pd(lows, low);
+    _mm256_storeu_pd(highs, high);
+    double resultMin = lows[0];
+    double resultMax = highs[0];
+    for (int lane = 1; lane < 4; lane++)
+    {
+        resultMin = lows[lane] < resultMin ? lows[lane] : resultMin;
+        resultMax = highs[lane] > resultMax ? highs[lane] : resultMax;
+    }
+    bool hasNaN = _mm256_movemask_pd(nan) != 0;
+
+    for (; i < count; i++)
+    {
+        double x = values[i].as.number;
+        hasNaN = hasNaN || isnan(x);
+        resultMin = x < resultMin ? x : resultMin;
+        resultMax = x > resultMax ? x : resultMax;
+    }
+
+    *min = hasNaN ? NAN : resultMin;
+    *max = hasNaN ? NAN : resultMax;
+}
+
+TARGET_AVX2 static void avx2MinMaxIntegers(const Value *values, size_t count, int64_t *min, int64_t *max)
+{
+    __m256i low = _mm256_set1_epi64x(values[0].as.integer);
+    __m256i high = low;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i x = avx2LoadIntegers(&values[i]);
+        low = _mm256_blendv_epi8(low, x, _mm256_cmpgt_epi64(low, x));
+        high = _mm256_blendv_epi8(high, x, _mm256_cmpgt_epi64(x, high));
+    }
+
+    int64_t lows[4], highs[4];
+    _mm256_storeu_si256((__m256i *)lows, low);
+    _mm256_storeu_si256((__m256i *)highs, high);
+    int64_t resultMin = lows[0];
+    int64_t resultMax = highs[0];
+    for (int lane = 1; lane < 4; lane++)
+    {
+        resultMin = lows[lane] < resultMin ? lows[lane] : resultMin;
+        resultMax = highs[lane] > resultMax ? highs[lane] : resultMax;
+    }
+    for (; i < count; i++)
+    {
+        int64_t x = values[i].as.integer;
+        resultMin = x < resultMin ? x : resultMin;
+        resultMax = x > resultMax ? x : resultMax;
+    }
+
+    *min = resultMin;
+    *max = resultMax;
+}
+
+TARGET_AVX2 static double avx2DotNumbers(const Value *a, const Value *b, size_t count)
+{
+    __m256d sums = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        sums = _mm256_add_pd(sums, _mm256_mul_pd(avx2LoadNumbers(&a[i]), avx2LoadNumbers(&b[i])));
+    }
+
+    double sum = avx2CombineLanes(sums);
+    for (; i < count; i++)
+    {
+        sum += a[i].as.number * b[i].as.number;
+    }
+    return sum;
+}
+
+TARGET_AVX2 static size_t avx2IndexOfNumber(const Value *values, size_t count, double target)
+{
+    const __m256d expected = _mm256_set1_pd(target);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(avx2LoadNumbers(&values[i]), expected, _CMP_EQ_OQ));
+        if (mask != 0)
+        {
+            return i + firstLaneMatch(mask);
+        }
+    }
+    return i + scalarIndexOfNumber(values + i, count - i, target);
+}
+
+TARGET_AVX2 static size_t avx2IndexOfInteger(const Value *values, size_t count, int64_t target)
+{
+    const __m256i expected = _mm256_set1_epi64x(target);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i equal = _mm256_cmpeq_epi64(avx2LoadIntegers(&values[i]), expected);
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(equal));
+        if (mask != 0)
+        {
+            return i + firstLaneMatch(mask);
+        }
+    }
+    return i + scalarIndexOfInteger(values + i, count - i, target);
+}
+
+TARGET_AVX2 static size_t avx2CountNumber(const Value *values, size_t count, double target)
+{
+    const __m256d expected = _mm256_set1_pd(target);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        int mask = _mm256_movemask_pd(_mm256_cmp_pd(avx2LoadNumbers(&values[i]), expected, _CMP_EQ_OQ));
+        matches += (size_t)__builtin_popcount((unsigned)mask);
+    }
+    return matches + scalarCountNumber(values + i, count - i, target);
+}
+
+TARGET_AVX2 static size_t avx2CountInteger(const Value *values, size_t count, int64_t target)
+{
+    const __m256i expected = _mm256_set1_epi64x(target);
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i equal = _mm256_cmpeq_epi64(avx2LoadIntegers(&values[i]), expected);
+        matches += (size_t)__builtin_popcount((unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(equal)));
+    }
+    return matches + scalarCountInteger(values + i, count - i, target);
+}
+
+TARGET_AVX2 static inline __m256d avx2LoadOperand(const ArithmeticOperand *operand, size_t index)
+{
+    return operand->values != NULL ? avx2LoadNumbers(&operand->values[index]) : _mm256_set1_pd(operand->number);
+}
+
+TARGET_AVX2 static inline __m256d avx2ApplyArithmetic(ArithmeticOp op, __m256d x, __m256d y)
+{
+    switch (op)
+    {
+    case ARITH_ADD:
+        return _mm256_add_pd(x, y);
+    case ARITH_SUB:
+        return _mm256_sub_pd(x, y);
+    case ARITH_MUL:
+        return _mm256_mul_pd(x, y);
+    default:
+        return _mm256_div_pd(x, y);
+    }
+}
+
+TARGET_AVX2 static void avx2ArithmeticNumbers(ArithmeticOp op, ArithmeticOperand a, ArithmeticOperand b, Value *out, size_t count)
+{
+    // 结果通道顺序为元素 [0, 2, 1, 3]，与类型字段交错后恰好是 [0, 1] 和 [2, 3] 两对 Value
+    const __m256d tag = _mm256_castsi256_pd(_mm256_set1_epi64x(VAL_NUMBER));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d result = avx2ApplyArithmetic(op, avx2LoadOperand(&a, i), avx2LoadOperand(&b, i));
+        _mm256_storeu_pd((double *)&out[i], _mm256_unpacklo_pd(tag, result));
+        _mm256_storeu_pd((double *)&out[i + 2], _mm256_unpackhi_pd(tag, result));
+    }
+    scalarArithmeticNumbers(op, operandFrom(a, i), operandFrom(b, i), out + i, count - i);
+}
+
+// 文本扫描：一次比较 32 个字节
+
+TARGET_AVX2 static inline __m256i avx2ByteRange(__m256i bytes, char lo, char hi)
+{
+    return _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8((char)(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(hi + 1)), bytes));
+}
+
+TARGET_AVX2 static size_t avx2IdentifierRun(const char *text, size_t length)
+{
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *)(text + i));
+        __m256i letter = avx2ByteRange(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), 'a', 'z');
+        __m256i digit = avx2ByteRange(bytes, '0', '9');
+        __m256i underscore = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('_'));
+        unsigned mask =
+            (unsigned)_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(letter, digit), underscore));
+        if (mask != 0xFFFFFFFFu)
+        {
+            return i + (size_t)__builtin_ctz(~mask);
+        }
+    }
+    return i + sse2IdentifierRun(text + i, length - i);
+}
+
+TARGET_AVX2 static size_t avx2WhitespaceRun(const char *text, size_t length, int *newlines)
+{
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *)(text + i));
+        __m256i newline = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'));
+        __m256i blank = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')),
+                                                        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t'))),
+                                        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r')));
+        unsigned newlineMask = (unsigned)_mm256_movemask_epi8(newline);
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(newline, blank));
+        if (mask != 0xFFFFFFFFu)
+        {
+            unsigned run = (unsigned)__builtin_ctz(~mask);
+            *newlines += __builtin_popcount(newlineMask & ((1u << run) - 1));
+            return i + run;
+        }
+        *newlines += __builtin_popcount(newlineMask);
+    }
+    return i + sse2WhitespaceRun(text + i, length - i, newlines);
+}
+
+TARGET_AVX2 static size_t avx2FindEitherByte(const char *text, size_t length, char a, char b)
+{
+    const __m256i first = _mm256_set1_epi8(a);
+    const __m256i second = _mm256_set1_epi8(b);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32)
+    {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *)(text + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, first), _mm256_cmpeq_epi8(bytes, second)));
+        if (mask != 0)
+        {
+            return i + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return i + sse2FindEitherByte(text + i, length - i, a, b);
+}
+
+static const KernelTable avx2Kernels = {
+    avx2TypeRun,
+    avx2SumNumbers,
+    avx2SumIntegers,
+    avx2MinMaxNumbers,
+    avx2MinMaxIntegers,
+    avx2DotNumbers,
+    avx2IndexOfNumber,
+    avx2IndexOfInteger,
+    avx2CountNumber,
+    avx2CountInteger,
+    avx2ArithmeticNumbers,
+    avx2IdentifierRun,
+    avx2WhitespaceRun,
+    avx2FindEitherByte,
+};
+
+#endif // SPARROW_X86_SIMD
+
+// ---------------------------------------------------------------------------
+// 运行时分派
+// ---------------------------------------------------------------------------
+
+// 首次使用时检测。多个解释器线程可能同时进入检测，结果相同；
+// levelDetected 以 release 写入、acquire 读取，读到 true 时另外两项一定已写好
+static bool levelDetected = false;
+static SimdLevel currentLevel = SIMD_SCALAR;
+static const KernelTable *currentKernels = &scalarKernels;
+
+static SimdLevel detectSimdLevel(void)
+{
+#ifdef SPARROW_X86_SIMD
+    if (!VALUE_LAYOUT_FITS_SIMD)
+    {
+        return SIMD_SCALAR;
+    }
+    // __builtin_cpu_supports 读取 cpuid，并确认操作系统保存了 AVX 寄存器状态
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return SIMD_SSE2;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+SimdLevel simdLevel(void)
+{
+    if (__atomic_load_n(&levelDetected, __ATOMIC_ACQUIRE))
+    {
+        return __atomic_load_n(&currentLevel, __ATOMIC_RELAXED);
+    }
+
+    SimdLevel level = detectSimdLevel();
+    const char *setting = getenv("SPARROW_SIMD");
+    if (setting != NULL)
+    {
+        SimdLevel requested = level;
+        if (strcmp(setting, "scalar") == 0)
+            requested = SIMD_SCALAR;
+        else if (strcmp(setting, "sse2") == 0)
+            requested = SIMD_SSE2;
+        else if (strcmp(setting, "avx2") == 0)
+            requested = SIMD_AVX2;
+        level = requested < level ? requested : level;
+    }
+
+    const KernelTable *table = &scalarKernels;
+#ifdef SPARROW_X86_SIMD
+    if (level == SIMD_AVX2)
+        table = &avx2Kernels;
+    else if (level == SIMD_SSE2)
+        table = &sse2Kernels;
+#endif
+    __atomic_store_n(&currentKernels, table, __ATOMIC_RELAXED);
+    __atomic_store_n(&currentLevel, level, __ATOMIC_RELAXED);
+    __atomic_store_n(&levelDetected, true, __ATOMIC_RELEASE);
+    return level;
+}
+
+const char *simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SIMD_AVX2:
+        return "avx2";
+    case SIMD_SSE2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
+
+static const KernelTable *kernels(void)
+{
+    simdLevel();
+    return __atomic_load_n(&currentKernels, __ATOMIC_RELAXED);
+}
+
+size_t valueTypeRun(const Value *values, size_t count, ValueType type)
+{
+    return kernels()->typeRun(values, count, type);
+}
+
+double sumNumbers(const Value *values, size_t count)
+{
+    return kernels()->sumNumbers(values, count);
+}
+
+bool sumIntegers(const Value *values, size_t count, int64_t *sum)
+{
+    return kernels()->sumIntegers(values, count, sum);
+}
+
+void minMaxNumbers(const Value *values, size_t count, double *min, double *max)
+{
+    kernels()->minMaxNumbers(values, count, min, max);
+}
+
+void minMaxIntegers(const Value *values, size_t count, int64_t *min, int64_t *max)
+{
+    kernels()->minMaxIntegers(values, count, min, max);
+}
+
+double dotNumbers(const Value *a, const Value *b, size_t count)
+{
+    return kernels()->dotNumbers(a, b, count);
+}
+
+size_t indexOfNumber(const Value *values, size_t count, double target)
+{
+    return kernels()->indexOfNumber(values, count, target);
+}
+
+size_t indexOfInteger(const Value *values, size_t count, int64_t target)
+{
+    return kernels()->indexOfInteger(values, count, target);
+}
+
+size_t countNumber(const Value *values, size_t count, double target)
+{
+    return kernels()->countNumber(values, count, target);
+}
+
+size_t countInteger(const Value *values, size_t count, int64_t target)
+{
+    return kernels()->countInteger(values, count, target);
+}
+
+void arithmeticNumbers(ArithmeticOp op, ArithmeticOperand a, ArithmeticOperand b, Value *out, size_t count)
+{
+    kernels()->arithmeticNumbers(op, a, b, out, count);
+}
+
+size_t identifierRun(const char *text, size_t length)
+{
+    return kernels()->identifierRun(text, length);
+}
+
+size_t whitespaceRun(const char *text, size_t length, int *newlines)
+{
+    return kernels()->whitespaceRun(text, length, newlines);
+}
+
+size_t findEitherByte(const char *text, size_t length, char a, char b)
+{
+    return kernels()->findEitherByte(text, length, a, b);
+}
+
+// 整数运算需要逐个检查溢出，各级别共用一个实现
+bool arithmeticIntegers(ArithmeticOp op, ArithmeticOperand a, ArithmeticOperand b, Value *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int64_t x = a.values != NULL ? a.values[i].as.integer : a.integer;
+        int64_t y = b.values != NULL ? b.values[i].as.integer : b.integer;
+        int64_t result;
+        bool ok;
+
+        switch (op)
+        {
+        case ARITH_ADD:
+            ok = !__builtin_add_overflow(x, y, &result);
+            break;
+        case ARITH_SUB:
+            ok = !__builtin_sub_overflow(x, y, &result);
+            break;
+        case ARITH_MUL:
+            ok = !__builtin_mul_overflow(x, y, &result);
+            break;
+        default:
+            // 与 / 运算符一致：只有能整除时结果才是整数
+            ok = y != 0 && !(x == INT64_MIN && y == -1) && x % y == 0;
+            result = ok ? x / y : 0;
+            break;
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+        out[i].type = VAL_INT;
+        out[i].as.integer = result;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 数组级操作
+// ---------------------------------------------------------------------------
+
+// 数字查找目标在两种元素类型下的等价形式，与 valuesEqual 的整数/浮点数比较规则一致
+typedef struct
+{
+    bool numeric;        // 目标是否为数字
+    bool matchesNumbers; // 是否可能等于某个浮点数元素
+    bool matchesInts;    // 是否可能等于某个整数元素
+    double asNumber;
+    int64_t asInt;
+} NumericTarget;
+
+static NumericTarget numericTarget(Value target)
+{
+    NumericTarget result = {false, false, false, 0, 0};
+    if (target.type == VAL_INT)
+    {
+        // 只有能被 double 精确表示的整数才可能等于浮点数元素
+        double number = (double)target.as.integer;
+        result.numeric = true;
+        result.matchesInts = true;
+        result.asInt = target.as.integer;
+        result.matchesNumbers = number >= -9223372036854775808.0 && number < 9223372036854775808.0 &&
+                                (int64_t)number == target.as.integer;
+        result.asNumber = number;
+    }
+    else if (target.type == VAL_NUMBER)
+    {
+        // 只有落在 int64 范围内的整数值才可能等于整数元素
+        double number = target.as.number;
+        result.numeric = true;
+        result.matchesNumbers = true;
+        result.asNumber = number;
+        result.matchesInts = number >= -9223372036854775808.0 && number < 9223372036854775808.0 &&
+                             (double)(int64_t)number == number;
+        result.asInt = result.matchesInts ? (int64_t)number : 0;
+    }
+    return result;
+}
+
+// 从 values 开始、不超过 limit 个的同类数字段长度；不是数字时返回 0
+static size_t numericRun(const KernelTable *table, const Value *values, size_t limit)
+{
+    if (values->type != VAL_NUMBER && values->type != VAL_INT)
+    {
+        return 0;
+    }
+    return table->typeRun(values, limit, values->type);
+}
+
+int arrayIndexOf(const Array *array, Value target, int start)
+{
+    if (array == NULL)
+    {
+        return -1;
+    }
+
+    const KernelTable *table = kernels();
+    NumericTarget numeric = numericTarget(target);
+    size_t count = (size_t)array->count;
+    size_t i = start > 0 ? (size_t)start : 0;
+
+    while (i < count)
+    {
+        const Value *values = &array->elements[i];
+        size_t limit = count - i < KERNEL_BLOCK_SIZE ? count - i : KERNEL_BLOCK_SIZE;
+        size_t run = numeric.numeric ? numericRun(table, values, limit) : 0;
+
+        if (run == 0)
+        {
+            if (valuesEqual(target, *values))
+            {
+                return (int)i;
+            }
+            i++;
+            continue;
+        }
+
+        size_t found = run;
+        if (values->type == VAL_NUMBER && numeric.matchesNumbers)
+        {
+            found = table->indexOfNumber(values, run, numeric.asNumber);
+        }
+        else if (values->type == VAL_INT && numeric.matchesInts)
+        {
+            found = table->indexOfInteger(values, run, numeric.asInt);
+        }
+        if (found < run)
+        {
+            return (int)(i + found);
+        }
+        i += run;
+    }
+    return -1;
+}
+
+int arrayCount(const Array *array, Value target)
+{
+    if (array == NULL)
+    {
+        return 0;
+    }
+
+    const KernelTable *table = kernels();
+    NumericTarget numeric = numericTarget(target);
+    size_t count = (size_t)array->count;
+    size_t matches = 0;
+    size_t i = 0;
+
+    while (i < count)
+    {
+        const Value *values = &array->elements[i];
+        size_t run = numeric.numeric ? numericRun(table, values, count - i) : 0;
+
+        if (run == 0)
+        {
+            matches += valuesEqual(target, *values);
+            i++;
+            continue;
+        }
+
+        if (values->type == VAL_NUMBER && numeric.matchesNumbers)
+        {
+            matches += table->countNumber(values, run, numeric.asNumber);
+        }
+        else if (values->type == VAL_INT && numeric.matchesInts)
+        {
+            matches += table->countInteger(values, run, numeric.asInt);
+        }
+        i += run;
+    }
+    return (int)matches;
+}
+
+// 带进位的整数累加：真实的和为 low + carry * 2^64
+static void addWithCarry(int64_t *low, int *carry, int64_t value)
+{
+    if (__builtin_add_overflow(*low, value, low))
+    {
+        *carry += value > 0 ? 1 : -1;
+    }
+}
+
+NumericStatus arraySum(const Array *array, Value *result)
+{
+    const KernelTable *table = kernels();
+    size_t count = array != NULL ? (size_t)array->count : 0;
+    double floatSum = 0;
+    bool hasFloat = false;
+    int64_t intLow = 0;
+    int intCarry = 0;
+    size_t i = 0;
+
+    while (i < count)
+    {
+        const Value *values = &array->elements[i];
+        size_t run = numericRun(table, values, count - i);
+        if (run == 0)
+        {
+            return NUMERIC_NOT_A_NUMBER;
+        }
+
+        if (values->type == VAL_NUMBER)
+        {
+            floatSum += table->sumNumbers(values, run);
+            hasFloat = true;
+        }
+        else
+        {
+            int64_t part;
+            if (table->sumIntegers(values, run, &part))
+            {
+                addWithCarry(&intLow, &intCarry, part);
+            }
+            else
+            {
+                for (size_t j = 0; j < run; j++)
+                {
+                    addWithCarry(&intLow, &intCarry, values[j].as.integer);
+                }
+            }
+        }
+        i += run;
+    }
+
+    // 整数部分的和超出 int64 时与 + 运算符一致，提升为浮点数
+    double intSum = (double)intLow + (double)intCarry * 18446744073709551616.0;
+    if (hasFloat)
+    {
+        *result = createNumber(floatSum + intSum);
+    }
+    else
+    {
+        *result = intCarry == 0 ? createInt(intLow) : createNumber(intSum);
+    }
+    return NUMERIC_OK;
+}
+
+NumericStatus arrayMinMax(const Array *array, Value *min, Value *max)
+{
+    if (array == NULL || array->count == 0)
+    {
+        return NUMERIC_EMPTY;
+    }
+
+    const KernelTable *table = kernels();
+    size_t count = (size_t)array->count;
+    Value low = createNull();
+    Value high = createNull();
+    bool hasNaN = false;
+    size_t i = 0;
+
+    while (i < count)
+    {
+        const Value *values = &array->elements[i];
+        size_t run = numericRun(table, values, count - i);
+        if (run == 0)
+        {
+            return NUMERIC_NOT_A_NUMBER;
+        }
+
+        Value runLow, runHigh;
+        if (values->type == VAL_NUMBER)
+        {
+            double a, b;
+            table->minMaxNumbers(values, run, &a, &b);
+            hasNaN = hasNaN || isnan(a);
+            runLow = createNumber(a);
+            runHigh = createNumber(b);
+        }
+        else
+        {
+            int64_t a, b;
+            table->minMaxIntegers(values, run, &a, &b);
+            runLow = createInt(a);
+            runHigh = createInt(b);
+        }
+
+        // 整数与浮点数之间精确比较，相等时保留先出现的值
+        if (low.type == VAL_NULL || compareSortKeys(runLow, low) < 0)
+        {
+            low = runLow;
+        }
+        if (high.type == VAL_NULL || compareSortKeys(runHigh, high) > 0)
+        {
+            high = runHigh;
+        }
+        i += run;
+    }
+
+    *min = hasNaN ? createNumber(NAN) : low;
+    *max = hasNaN ? createNumber(NAN) : high;
+    return NUMERIC_OK;
+}
+
+NumericStatus arrayDot(const Array *a, const Array *b, Value *result)
+{
+    if (a == NULL || b == NULL || a->count != b->count)
+    {
+        return NUMERIC_LENGTH_MISMATCH;
+    }
+
+    const KernelTable *table = kernels();
+    size_t count = (size_t)a->count;
+
+    // 两边都是浮点数时整段交给核函数
+    if (table->typeRun(a->elements, count, VAL_NUMBER) == count &&
+        table->typeRun(b->elements, count, VAL_NUMBER) == count)
+    {
+        *result = createNumber(table->dotNumbers(a->elements, b->elements, count));
+        return NUMERIC_OK;
+    }
+
+    // 其余情况逐个计算：全是整数且不溢出时结果为整数
+    int64_t intDot = 0;
+    bool exact = true;
+    double floatDot = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        Value x = a->elements[i];
+        Value y = b->elements[i];
+        if (!isNumeric(x) || !isNumeric(y))
+        {
+            return NUMERIC_NOT_A_NUMBER;
+        }
+
+        int64_t product;
+        if (exact && x.type == VAL_INT && y.type == VAL_INT &&
+            !__builtin_mul_overflow(x.as.integer, y.as.integer, &product) &&
+            !__builtin_add_overflow(intDot, product, &product))
+        {
+            intDot = product;
+        }
+        else
+        {
+            exact = false;
+        }
+        floatDot += asDouble(x) * asDouble(y);
+    }
+
+    *result = exact ? createInt(intDot) : createNumber(floatDot);
+    return NUMERIC_OK;
+}
@@ -0,0 +1,614 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sparrow.h"
+#include "lexer.h"
+#include "parser.h"
+#include "interpreter.h"
+#include "file_utils.h"
+
+// 一次加载的源代码：函数值引用其中的语法树，须保留到虚拟机释放
+typedef struct Program
+{
+    char *source;
+    LexemeBlock *text; // 语法树中的名称指向的标记文本
+    Stmt **statements;
+    int stmtCount;
+    struct Program *next;
+} Program;
+
+// 宿主注册的原生函数；native 必须是第一个成员，调用时由 activeNative 转换回来
+typedef struct HostNative
+{
+    NativeFunction native;
+    SparrowNativeFn function;
+    void *userData;
+    struct HostNative *next;
+} HostNative;
+
+// interpreter 必须是第一个成员：宿主原生函数由解释器指针取得虚拟机
+struct SparrowVM
+{
+    Interpreter interpreter;
+    Program *programs;
+    HostNative *natives;
+    Value lastResult; // 最近一次 sparrowCall 返回的字符串，借给宿主
+    bool lazyFunctions;
+};
+
+// owned 为 false 时借用 target 指向的值（原生函数的参数），只在调用期间有效
+struct SparrowHandle
+{
+    Value value;
+    const Value *target;
+    bool owned;
+};
+
+// 原生函数的参数通常很少，先使用栈上的缓冲区
+#define ARGUMENT_BUFFER_SIZE 8
+
+void sparrowDefaultConfig(SparrowConfig *config)
+{
+    config->explicitStack = false;
+    config->maxCallDepth = DEFAULT_MAX_CALL_DEPTH;
+    config->outputFd = STDOUT_FILENO;
+    config->stackLimit = 0;
+    config->lazyFunctions = false;
+}
+
+SparrowVM *sparrowNewVM(const SparrowConfig *config)
+{
+    SparrowConfig defaults;
+    if (config == NULL)
+    {
+        sparrowDefaultConfig(&defaults);
+        config = &defaults;
+    }
+
+    SparrowVM *vm = (SparrowVM *)malloc(sizeof(SparrowVM));
+    if (vm == NULL)
+    {
+        return NULL;
+    }
+
+    initInterpreter(&vm->interpreter);
+    vm->interpreter.explicitStack = config->explicitStack;
+    vm->interpreter.maxCallDepth = config->maxCallDepth;
+    if (config->stackLimit != 0)
+    {
+        vm->interpreter.stackLimit = config->stackLimit;
+    }
+    if (config->outputFd != STDOUT_FILENO)
+    {
+        freeOutputBuffer(&vm->interpreter.output);
+        initOutputBuffer(&vm->interpreter.output, config->outputFd, defaultOutputMode(config->outputFd));
+    }
+
+    vm->programs = NULL;
+    vm->natives = NULL;
+    vm->lastResult = createNull();
+    vm->lazyFunctions = config->lazyFunctions;
+    return vm;
+}
+
+static void freeProgram(Program *program)
+{
+    for (int i = 0; i < program->stmtCount; i++)
+    {
+        freeStmt(program->statements[i]);
+    }
+    free(program->statements);
+    freeLexemeBlocks(program->text);
+    free(program->source);
+    free(program);
+}
+
+void sparrowFreeVM(SparrowVM *vm)
+{
+    if (vm == NULL)
+    {
+        return;
+    }
+
+    freeValue(vm->lastResult);
+    freeInterpreter(&vm->interpreter);
+
+    // 解释器中的函数值引用语法树，原生函数值引用 HostNative，须在解释器之后释放
+    while (vm->programs != NULL)
+    {
+        Program *next = vm->programs->next;
+        freeProgram(vm->programs);
+        vm->programs = next;
+    }
+    while (vm->natives != NULL)
+    {
+        HostNative *next = vm->natives->next;
+        free(vm->natives->native.name);
+        free(vm->natives);
+        vm->natives = next;
+    }
+    free(vm);
+}
+
+static void clearError(SparrowVM *vm)
+{
+    vm->interpreter.hadError = false;
+    vm->interpreter.errorMessage[0] = '\0';
+}
+
+static SparrowResult compileError(SparrowVM *vm, const char *format, const char *detail)
+{
+    snprintf(vm->interpreter.errorMessage, sizeof(vm->interpreter.errorMessage), format, detail);
+    return SPARROW_COMPILE_ERROR;
+}
+
+// 接管 source：成功或失败都由虚拟机负责释放
+static SparrowResult loadOwnedSource(SparrowVM *vm, char *source)
+{
+    clearError(vm);
+
+    Program *program = (Program *)calloc(1, sizeof(Program));
+    if (program == NULL)
+    {
+        free(source);
+        return compileError(vm, "%s", "内存分配失败");
+    }
+    program->source = source;
+
+    Lexer lexer;
+    initLexer(&lexer, source);
+    Parser parser;
+    if (!initStreamingParser(&parser, &lexer))
+    {
+        freeProgram(program);
+        return compileError(vm, "%s", "Lexical analysis failed");
+    }
+    parser.lazyFunctions = vm->lazyFunctions;
+    program->statements = parse(&parser, &program->stmtCount);
+    program->text = lexer.text;
+    freeParser(&parser);
+    if (hadParseError(&parser))
+    {
+        SparrowResult result = compileError(vm, "Parse error: %s", getParseErrorMsg(&parser));
+        freeProgram(program);
+        return result;
+    }
+
+    program->next = vm->programs;
+    vm->programs = program;
+
+    // 只调用本次加载中定义的 main
+    vm->interpreter.hasMainFunction = false;
+    vm->interpreter.mainFunction = NULL;
+    interpret(&vm->interpreter, program->statements, program->stmtCount);
+    return vm->interpreter.hadError ? SPARROW_RUNTIME_ERROR : SPARROW_OK;
+}
+
+SparrowResult sparrowLoad(SparrowVM *vm, const char *source)
+{
+    size_t length = strlen(source);
+    char *copy = (char *)malloc(length + 1);
+    if (copy == NULL)
+    {
+        return compileError(vm, "%s", "内存分配失败");
+    }
+    memcpy(copy, source, length + 1);
+    return loadOwnedSource(vm, copy);
+}
+
+SparrowResult sparrowLoadFile(SparrowVM *vm, const char *path)
+{
+    char *source = readFile(path);
+    if (source == NULL)
+    {
+        return compileError(vm, "Could not read file '%s'", path);
+    }
+    return loadOwnedSource(vm, source);
+}
+
+const char *sparrowError(const SparrowVM *vm)
+{
+    return vm->interpreter.errorMessage;
+}
+
+// ---------------------------------------------------------------------------
+// 值转换
+// ---------------------------------------------------------------------------
+
+// 宿主值转为解释器值；字符串复制，句柄只做浅拷贝（借用，调用方不得释放）
+static Value borrowHostValue(SparrowValue value)
+{
+    switch (value.type)
+    {
+    case SPARROW_BOOL:
+        return createBool(value.as.boolean);
+    case SPARROW_INT:
+        return createInt(value.as.integer);
+    case SPARROW_NUMBER:
+        return createNumber(value.as.number);
+    case SPARROW_STRING:
+        return createStringWithLength(value.as.string.chars, value.as.string.length);
+    case SPARROW_HANDLE:
+        return value.as.handle != NULL ? *value.as.handle->target : createNull();
+    default:
+        return createNull();
+    }
+}
+
+// 释放 borrowHostValue 的结果：只有字符串是新分配的
+static void releaseHostValue(SparrowValue host, Value value)
+{
+    if (host.type == SPARROW_STRING)
+    {
+        freeValue(value);
+    }
+}
+
+// 宿主值转为解释器值，得到独立的副本
+static Value copyHostValue(SparrowValue value)
+{
+    Value borrowed = borrowHostValue(value);
+    return value.type == SPARROW_HANDLE ? copyValue(borrowed) : borrowed;
+}
+
+static SparrowHandle *newHandle(Value value)
+{
+    SparrowHandle *handle = (SparrowHandle *)malloc(sizeof(SparrowHandle));
+    if (handle == NULL)
+    {
+        freeValue(value);
+        return NULL;
+    }
+    handle->value = value;
+    handle->target = &handle->value;
+    handle->owned = true;
+    return handle;
+}
+
+// 标量和字符串直接转换（字符串借用 value 中的数据）；其他值返回 false
+static bool scalarToHost(const Value *value, SparrowValue *host)
+{
+    switch (value->type)
+    {
+    case VAL_NULL:
+        *host = sparrowNull();
+        return true;
+    case VAL_BOOL:
+        *host = sparrowBool(value->as.boolean);
+        return true;
+    case VAL_INT:
+        *host = sparrowInt(value->as.integer);
+        return true;
+    case VAL_NUMBER:
+        *host = sparrowNumber(value->as.number);
+        return true;
+    case VAL_STRING:
+        *host = sparrowStringWithLength(value->as.string, stringLength(value->as.string));
+        return true;
+    default:
+        return false;
+    }
+}
+
+// 解释器值交给宿主：复合值移入新的句柄，value 随之清空
+static SparrowValue moveToHost(Value *value)
+{
+    SparrowValue host;
+    if (scalarToHost(value, &host))
+    {
+        return host;
+    }
+    SparrowHandle *handle = newHandle(*value);
+    *value = createNull();
+    return handle != NULL ? sparrowHandleValue(handle) : sparrowNull();
+}
+
+// ---------------------------------------------------------------------------
+// 原生函数
+// ---------------------------------------------------------------------------
+
+static NativeStatus hostNativeTrampoline(Interpreter *interpreter, int argCount, const Value *args, Value *result)
+{
+    HostNative *host = (HostNative *)interpreter->activeNative;
+    SparrowVM *vm = (SparrowVM *)interpreter;
+
+    SparrowValue argBuffer[ARGUMENT_BUFFER_SIZE];
+    SparrowHandle handleBuffer[ARGUMENT_BUFFER_SIZE];
+    SparrowValue *hostArgs = argBuffer;
+    SparrowHandle *handles = handleBuffer;
+    if (argCount > ARGUMENT_BUFFER_SIZE)
+    {
+        hostArgs = (SparrowValue *)malloc(sizeof(SparrowValue) * argCount);
+        handles = (SparrowHandle *)malloc(sizeof(SparrowHandle) * argCount);
+        if (hostArgs == NULL || handles == NULL)
+        {
+            free(hostArgs);
+            free(handles);
+            runtimeError(interpreter, "内存分配失败");
+            return NATIVE_ERROR;
+        }
+    }
+
+    // 复合值参数以借用句柄传入
+    for (int i = 0; i < argCount; i++)
+    {
+        if (!scalarToHost(&args[i], &hostArgs[i]))
+        {
+            handles[i].value = createNull();
+            handles[i].target = &args[i];
+            handles[i].owned = false;
+            hostArgs[i] = sparrowHandleValue(&handles[i]);
+        }
+    }
+
+    SparrowValue hostResult = sparrowNull();
+    bool ok = host->function(vm, argCount, hostArgs, &hostResult, host->userData);
+    if (ok)
+    {
+        *result = copyHostValue(hostResult);
+    }
+    else if (!interpreter->hadError)
+    {
+        runtimeError(interpreter, "%s() 执行失败", host->native.name);
+    }
+
+    if (hostArgs != argBuffer)
+    {
+        free(hostArgs);
+        free(handles);
+    }
+    return ok ? NATIVE_OK : NATIVE_ERROR;
+}
+
+bool sparrowRegister(SparrowVM *vm, const char *name, int arity, SparrowNativeFn function, void *userData)
+{
+    HostNative *host = (HostNative *)malloc(sizeof(HostNative));
+    if (host == NULL)
+    {
+        return false;
+    }
+    size_t length = strlen(name) + 1;
+    host->native.name = (char *)malloc(length);
+    if (host->native.name == NULL)
+    {
+        free(host);
+        return false;
+    }
+    memcpy(host->native.name, name, length);
+
+    // 由虚拟机持有：脚本中复制和释放原生函数值时只传递指针
+    host->native.arity = arity;
+    host->native.function = NULL;
+    host->native.native = hostNativeTrampoline;
+    host->native.flags = 0;
+    host->native.isStatic = true;
+    host->function = function;
+    host->userData = userData;
+    host->next = vm->natives;
+    vm->natives = host;
+
+    defineVariable(vm->interpreter.globals, name, createNativeFunction(&host->native));
+    return true;
+}
+
+void sparrowNativeError(SparrowVM *vm, const char *message)
+{
+    runtimeError(&vm->interpreter, "%s", message);
+}
+
+// ---------------------------------------------------------------------------
+// 调用
+// ---------------------------------------------------------------------------
+
+SparrowHandle *sparrowGetGlobal(SparrowVM *vm, const char *name)
+{
+    bool isConst;
+    Value *slot = getVariableSlot(vm->interpreter.globals, name, &isConst);
+    if (slot == NULL)
+    {
+        slot = getStaticVariableSlot(vm->interpreter.staticStorage, name, &isConst);
+    }
+    return slot != NULL ? newHandle(copyValue(*slot)) : NULL;
+}
+
+SparrowResult sparrowCall(SparrowVM *vm, SparrowHandle *function, int argCount,
+                          const SparrowValue *args, SparrowValue *result)
+{
+    Interpreter *interpreter = &vm->interpreter;
+    clearError(vm);
+    freeValue(vm->lastResult);
+    vm->lastResult = createNull();
+    if (result != NULL)
+    {
+        *result = sparrowNull();
+    }
+
+    if (function == NULL)
+    {
+        runtimeError(interpreter, "只能调用函数。");
+        return SPARROW_RUNTIME_ERROR;
+    }
+
+    Value argBuffer[ARGUMENT_BUFFER_SIZE];
+    Value *arguments = argBuffer;
+    if (argCount > ARGUMENT_BUFFER_SIZE)
+    {
+        arguments = (Value *)malloc(sizeof(Value) * argCount);
+        if (arguments == NULL)
+        {
+            runtimeError(interpreter, "内存分配失败");
+            return SPARROW_RUNTIME_ERROR;
+        }
+    }
+    for (int i = 0; i < argCount; i++)
+    {
+        arguments[i] = borrowHostValue(args[i]);
+    }
+
+    // 从宿主进入（而不是原生函数回调）时，以此处为递归求值的 C 栈起点
+    char stackMarker;
+    if (interpreter->callDepth == 0)
+    {
+        interpreter->stackBase = (uintptr_t)&stackMarker;
+    }
+
+    Value value = callCallable(interpreter, *function->target, arguments, argCount);
+
+    for (int i = 0; i < argCount; i++)
+    {
+        releaseHostValue(args[i], arguments[i]);
+    }
+    if (arguments != argBuffer)
+    {
+        free(arguments);
+    }
+
+    if (interpreter->hadError)
+    {
+        freeValue(value);
+        return SPARROW_RUNTIME_ERROR;
+    }
+
+    // 字符串留在虚拟机中借给宿主，复合值移入句柄
+    vm->lastResult = value;
+    if (result != NULL)
+    {
+        *result = moveToHost(&vm->lastResult);
+    }
+    else
+    {
+        freeValue(vm->lastResult);
+        vm->lastResult = createNull();
+    }
+    return SPARROW_OK;
+}
+
+void sparrowFlush(SparrowVM *vm)
+{
+    flushOutput(&vm->interpreter.output);
+}
+
+// ---------------------------------------------------------------------------
+// 句柄
+// ---------------------------------------------------------------------------
+
+void sparrowReleaseHandle(SparrowHandle *handle)
+{
+    if (handle == NULL || !handle->owned)
+    {
+        return;
+    }
+    freeValue(handle->value);
+    free(handle);
+}
+
+const char *sparrowHandleTypeName(const SparrowHandle *handle)
+{
+    return handle != NULL ? valueTypeName(*handle->target) : "null";
+}
+
+SparrowHandle *sparrowNewArray(void)
+{
+    return newHandle(createArray(TYPE_ANY, 0));
+}
+
+bool sparrowArrayPush(SparrowHandle *array, SparrowValue value)
+{
+    if (array == NULL || !array->owned || array->value.type != VAL_ARRAY)
+    {
+        return false;
+    }
+    // arrayPush 复制元素
+    Value element = borrowHostValue(value);
+    arrayPush(array->value.as.array, element);
+    releaseHostValue(value, element);
+    return true;
+}
+
+int sparrowArrayLength(const SparrowHandle *array)
+{
+    if (array == NULL || array->target->type != VAL_ARRAY)
+    {
+        return -1;
+    }
+    return array->target->as.array != NULL ? array->target->as.array->count : 0;
+}
+
+bool sparrowArrayGet(const SparrowHandle *array, int index, SparrowValue *value)
+{
+    if (index < 0 || index >= sparrowArrayLength(array))
+    {
+        return false;
+    }
+    const Value *element = &array->target->as.array->elements[index];
+    if (!scalarToHost(element, value))
+    {
+        SparrowHandle *handle = newHandle(copyValue(*element));
+        if (handle == NULL)
+        {
+            return false;
+        }
+        *value = sparrowHandleValue(handle);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// SparrowValue 构造
+// ---------------------------------------------------------------------------
+
+SparrowValue sparrowNull(void)
+{
+    SparrowValue value;
+    value.type = SPARROW_NULL;
+    value.as.integer = 0;
+    return value;
+}
+
+SparrowValue sparrowBool(bool boolean)
+{
+    SparrowValue value;
+    value.type = SPARROW_BOOL;
+    value.as.boolean = boolean;
+    return value;
+}
+
+SparrowValue sparrowInt(int64_t integer)
+{
+    SparrowValue value;
+    value.type = SPARROW_INT;
+    value.as.integer = integer;
+    return value;
+}
+
+SparrowValue sparrowNumber(double number)
+{
+    SparrowValue value;
+    value.type = SPARROW_NUMBER;
+    value.as.number = number;
+    return value;
+}
+
+SparrowValue sparrowString(const char *chars)
+{
+    return sparrowStringWithLength(chars, strlen(chars));
+}
+
+SparrowValue sparrowStringWithLength(const char *chars, size_t length)
+{
+    SparrowValue value;
+    value.type = SPARROW_STRING;
+    value.as.string.chars = chars;
+    value.as.string.length = length;
+    return value;
+}
+
+SparrowValue sparrowHandleValue(SparrowHandle *handle)
+{
+    SparrowValue value;
+    value.type = SPARROW_HANDLE;
+    value.as.handle = handle;
+    return value;
+}
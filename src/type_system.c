@@ -3,17 +3,14 @@
 #include "value.h"
 
 static const char *baseTypeToString(BaseType type);
+static const char *baseTypeToArrayString(BaseType type);
 
-// 类型注解转字符串
+// 类型注解转字符串，返回静态字符串常量（不使用共享缓冲区，可在多个线程中同时调用）
 const char *annotationToString(TypeAnnotation type)
 {
-    static char buffer[64];
-
     if (type.kind == TYPE_ARRAY)
     {
-        snprintf(buffer, sizeof(buffer), "%s[]",
-                 baseTypeToString(type.as.array.elementType));
-        return buffer;
+        return baseTypeToArrayString(type.as.array.elementType);
     }
 
     // 简单类型
@@ -49,6 +46,35 @@ static const char *baseTypeToString(BaseType type)
     }
 }
 
+static const char *baseTypeToArrayString(BaseType type)
+{
+    switch (type)
+    {
+    case TYPE_ANY:
+        return "any[]";
+    case TYPE_VOID:
+        return "void[]";
+    case TYPE_INT:
+        return "int[]";
+    case TYPE_FLOAT:
+        return "float[]";
+    case TYPE_DOUBLE:
+        return "double[]";
+    case TYPE_STRING:
+        return "string[]";
+    case TYPE_BOOL:
+        return "bool[]";
+    case TYPE_FUNCTION:
+        return "function[]";
+    case TYPE_ENUM:
+        return "enum[]";
+    case TYPE_STRUCT:
+        return "struct[]";
+    default:
+        return "unknown[]";
+    }
+}
+
 // 从词法标记转换为类型注解
 TypeAnnotation tokenToTypeAnnotation(int tokenType)
 {
@@ -1,8 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "value.h"
 #include "environment.h" // 确保包含这个
+#include "numeric_conversion.h"
+#include "map.h"
+#include "containers.h"
+#include "interpreter/generator.h"
 
 // 创建空值
 Value createNull()
@@ -30,6 +35,88 @@ Value createNumber(double value)
     return val;
 }
 
+// 创建64位整数值
+Value createInt(int64_t value)
+{
+    Value val;
+    val.type = VAL_INT;
+    val.as.integer = value;
+    return val;
+}
+
+// 判断值是否为数字（整数或浮点数）
+bool isNumeric(Value value)
+{
+    return value.type == VAL_INT || value.type == VAL_NUMBER;
+}
+
+// 将数字值转换为 double，调用者需确保 isNumeric(value) 为真
+double asDouble(Value value)
+{
+    return value.type == VAL_INT ? (double)value.as.integer : value.as.number;
+}
+
+/**
+ * 精确比较整数与浮点数，返回 -1、0 或 1
+ *
+ * 不能简单地把整数转换为 double 再比较，否则超过 2^53 的整数会因精度丢失
+ * 与相邻的整数"相等"。NaN 视为大于所有整数，调用者需要 NaN 比较为 false 时应先行判断。
+ */
+int compareIntDouble(int64_t integer, double number)
+{
+    if (number != number || number >= 9223372036854775808.0)
+    {
+        return -1;
+    }
+    if (number < -9223372036854775808.0)
+    {
+        return 1;
+    }
+
+    int64_t whole = (int64_t)number; // 向零截断，trunc(number) 可精确表示
+    if (integer != whole)
+    {
+        return integer < whole ? -1 : 1;
+    }
+
+    double fraction = number - (double)whole;
+    return (fraction < 0) - (fraction > 0);
+}
+
+// 比较整数与浮点数是否相等，与 compareIntDouble 的顺序一致
+static bool intEqualsDouble(int64_t integer, double number)
+{
+    return number == number && compareIntDouble(integer, number) == 0;
+}
+
+/**
+ * 分配一个带头部的字符串缓冲区
+ *
+ * 字符串在内存中的布局为 [StringHeader][字符数据...]['\0']，Value 中保存的
+ * 指针指向字符数据本身，因此仍可直接当作以 null 结尾的 C 字符串使用。
+ *
+ * @param length 字符串的实际长度（不含结尾的 '\0'）
+ * @param capacity 可容纳的字符数，必须不小于 length
+ * @return char* 指向字符数据的指针，内存分配失败时返回 NULL
+ *
+ * @note 返回的缓冲区只能通过 freeValue 释放，不能直接调用 free
+ */
+static char *allocateString(size_t length, size_t capacity)
+{
+    StringHeader *header = (StringHeader *)malloc(sizeof(StringHeader) + capacity + 1);
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    header->length = length;
+    header->capacity = capacity;
+
+    char *chars = (char *)(header + 1);
+    chars[length] = '\0';
+    return chars;
+}
+
 /**
  * 创建字符串类型的Value对象
  *
@@ -44,36 +131,105 @@ Value createNumber(double value)
  * @warning 如果内存分配失败，返回的Value类型将被设置为VAL_NULL
  */
 Value createString(const char *value)
+{
+    return createStringWithLength(value, value != NULL ? strlen(value) : 0);
+}
+
+/**
+ * 使用给定长度创建字符串类型的Value对象
+ *
+ * 与 createString 相同，但长度由调用者提供，避免重复调用 strlen。
+ *
+ * @param chars 字符数据，length 为 0 时可以为 NULL
+ * @param length 要复制的字符数
+ * @return Value 新的字符串值；内存分配失败时返回VAL_NULL类型的Value
+ */
+Value createStringWithLength(const char *chars, size_t length)
 {
     Value val;
     val.type = VAL_STRING;
 
-    // 处理NULL输入
-    if (value == NULL)
+    val.as.string = allocateString(length, length);
+    if (val.as.string == NULL)
     {
-        val.as.string = malloc(1);
-        if (val.as.string == NULL)
-        {
-            val.type = VAL_NULL;
-            return val;
-        }
-        val.as.string[0] = '\0';
+        val.type = VAL_NULL;
         return val;
     }
 
-    // 计算字符串长度并检查有效性
-    size_t len = strlen(value);
+    if (length > 0)
+    {
+        memcpy(val.as.string, chars, length);
+    }
 
-    val.as.string = (char *)malloc(len + 1);
-    if (val.as.string == NULL)
+    return val;
+}
+
+// 获取字符串长度，直接读取头部记录的长度，时间复杂度 O(1)
+size_t stringLength(const char *string)
+{
+    if (string == NULL)
     {
-        val.type = VAL_NULL;
-        return val;
+        return 0;
     }
+    return STRING_HEADER(string)->length;
+}
 
-    strcpy(val.as.string, value);
+/**
+ * 在字符串值末尾原地追加内容
+ *
+ * 当缓冲区剩余容量不足时按 1.5 倍以上扩容，使得在循环中反复追加的
+ * 摊销代价为 O(1)，而不是每次都重新分配并复制整个字符串。
+ *
+ * @param target 指向要修改的字符串值的指针，类型必须为 VAL_STRING
+ * @param suffix 要追加的字符数据
+ * @param suffixLength 要追加的字符数
+ * @return bool 成功返回 true；目标不是字符串或内存分配失败时返回 false，此时原字符串保持不变
+ */
+bool appendToString(Value *target, const char *suffix, size_t suffixLength)
+{
+    if (target == NULL || target->type != VAL_STRING || target->as.string == NULL)
+    {
+        return false;
+    }
 
-    return val;
+    StringHeader *header = STRING_HEADER(target->as.string);
+    size_t newLength = header->length + suffixLength;
+
+    // suffix 可能指向目标自身（如 s += s），扩容前先记下它在缓冲区中的偏移
+    bool selfAppend = suffix >= target->as.string && suffix <= target->as.string + header->length;
+    size_t selfOffset = selfAppend ? (size_t)(suffix - target->as.string) : 0;
+
+    if (newLength > header->capacity)
+    {
+        size_t newCapacity = header->capacity + header->capacity / 2;
+        if (newCapacity < newLength)
+        {
+            newCapacity = newLength;
+        }
+        if (newCapacity < 16)
+        {
+            newCapacity = 16;
+        }
+
+        StringHeader *newHeader = (StringHeader *)realloc(header, sizeof(StringHeader) + newCapacity + 1);
+        if (newHeader == NULL)
+        {
+            return false;
+        }
+
+        newHeader->capacity = newCapacity;
+        header = newHeader;
+        target->as.string = (char *)(header + 1);
+        if (selfAppend)
+        {
+            suffix = target->as.string + selfOffset;
+        }
+    }
+
+    memmove(target->as.string + header->length, suffix, suffixLength);
+    header->length = newLength;
+    target->as.string[newLength] = '\0';
+    return true;
 }
 
 /**
@@ -102,9 +258,55 @@ Value createNativeFunction(NativeFunction *function)
     return val;
 }
 
+// 值的类型名称，与 type() 的返回值相同
+const char *valueTypeName(Value value)
+{
+    switch (value.type)
+    {
+    case VAL_INT:
+        return "int";
+    case VAL_NUMBER:
+        return "float";
+    case VAL_STRING:
+        return "string";
+    case VAL_BOOL:
+        return "bool";
+    case VAL_NULL:
+        return "null";
+    case VAL_ARRAY:
+        return "array";
+    case VAL_FUNCTION:
+        return "function";
+    case VAL_NATIVE_FUNCTION:
+        return "native_function";
+    case VAL_ENUM_VALUE:
+        return "enum";
+    case VAL_STRUCT:
+        return "struct";
+    case VAL_MAP:
+        return "map";
+    case VAL_HEAP:
+        return "heap";
+    case VAL_DEQUE:
+        return "deque";
+    case VAL_RANGE:
+        return "range";
+    case VAL_GENERATOR:
+        return "generator";
+    default:
+        return "unknown";
+    }
+}
+
 // 值比较
 bool valuesEqual(Value a, Value b)
 {
+    // 整数与浮点数按数值比较
+    if (a.type == VAL_INT && b.type == VAL_NUMBER)
+        return intEqualsDouble(a.as.integer, b.as.number);
+    if (a.type == VAL_NUMBER && b.type == VAL_INT)
+        return intEqualsDouble(b.as.integer, a.as.number);
+
     if (a.type != b.type)
         return false;
 
@@ -116,6 +318,8 @@ bool valuesEqual(Value a, Value b)
         return a.as.boolean == b.as.boolean;
     case VAL_NUMBER:
         return a.as.number == b.as.number;
+    case VAL_INT:
+        return a.as.integer == b.as.integer;
     case VAL_STRING:
         return strcmp(a.as.string, b.as.string) == 0;
     case VAL_FUNCTION:
@@ -202,123 +406,146 @@ bool valuesEqual(Value a, Value b)
             }
         }
         return true;
+    case VAL_MAP:
+        if (a.as.map == NULL || b.as.map == NULL)
+        {
+            return a.as.map == b.as.map;
+        }
+        return mapsEqual(a.as.map, b.as.map);
+    case VAL_HEAP:
+        return heapsEqual(a.as.heap, b.as.heap);
+    case VAL_DEQUE:
+        return dequesEqual(a.as.deque, b.as.deque);
+    case VAL_RANGE:
+        return a.as.range->start == b.as.range->start && a.as.range->end == b.as.range->end &&
+               a.as.range->step == b.as.range->step;
+    case VAL_GENERATOR:
+        return a.as.generator == b.as.generator;
     }
 
     return false;
 }
 
 /**
- * 打印值的内容到标准输出
+ * 将值的文本形式写入输出缓冲区
  *
- * 根据值的类型格式化并打印相应的内容：
+ * 根据值的类型格式化并写入相应的内容：
  * - VAL_NULL: 打印 "null"
  * - VAL_BOOL: 打印 "true" 或 "false"
  * - VAL_NUMBER: 如果是整数则打印整数格式，否则打印浮点数格式
+ * - VAL_INT: 打印64位整数
  * - VAL_STRING: 打印字符串内容，如果为空则打印 "(null string)"
  * - VAL_FUNCTION: 打印函数信息，格式为 "[Function: 函数名]" 或 "[Function: anonymous]"
  * - VAL_NATIVE_FUNCTION: 打印原生函数信息，格式为 "[Native Function: 函数名]" 或 "[Native Function: anonymous]"
  * - VAL_ARRAY: 打印数组内容，格式为 "[元素1, 元素2, ...]"，递归打印每个元素
+ * - VAL_MAP: 按插入顺序打印键值对，格式为 "{键1: 值1, 键2: 值2, ...}"
+ * - VAL_HEAP: 格式为 "heap[堆顶, ...]"，堆顶之后按内部存储顺序
+ * - VAL_DEQUE: 从队首到队尾打印，格式为 "deque[元素1, 元素2, ...]"
+ * - VAL_RANGE: 格式为 "range(起点, 终点)"，步长不为 1 时为 "range(起点, 终点, 步长)"
  * - 其他类型: 打印 "(unknown value type)"
  *
+ * @param out 输出缓冲区
  * @param value 要打印的值对象
  *
  * @note 对于数组类型，函数会递归调用自身来打印每个元素
  * @note 包含空指针检查以防止访问无效内存
- * @note 对于数值类型，会自动判断是否为整数并选择合适的打印格式
  */
-void printValue(Value value)
+void writeValue(OutputBuffer *out, Value value)
 {
     switch (value.type)
     {
     case VAL_NULL:
-        printf("null");
+        outputString(out, "null");
         break;
     case VAL_BOOL:
-        printf(value.as.boolean ? "true" : "false");
+        outputString(out, value.as.boolean ? "true" : "false");
         break;
     case VAL_NUMBER:
-        // 检查是否为整数
-        if (value.as.number == (int)value.as.number)
-        {
-            printf("%d", (int)value.as.number);
-        }
-        else
-        {
-            printf("%g", value.as.number);
-        }
+    case VAL_INT:
+    {
+        char buffer[NUMBER_BUFFER_SIZE];
+        int length = formatNumberValue(value, buffer);
+        outputWrite(out, buffer, (size_t)length);
         break;
+    }
     case VAL_STRING:
         if (value.as.string != NULL)
         {
-            printf("%s", value.as.string);
+            outputWrite(out, value.as.string, stringLength(value.as.string));
         }
         else
         {
-            printf("(null string)");
+            outputString(out, "(null string)");
         }
         break;
     case VAL_FUNCTION:
         if (value.as.function != NULL && value.as.function->name != NULL)
         {
-            printf("[Function: %s]", value.as.function->name);
+            outputString(out, "[Function: ");
+            outputString(out, value.as.function->name);
+            outputChar(out, ']');
         }
         else
         {
-            printf("[Function: anonymous]");
+            outputString(out, "[Function: anonymous]");
         }
         break;
     case VAL_NATIVE_FUNCTION:
         if (value.as.nativeFunction != NULL && value.as.nativeFunction->name != NULL)
         {
-            printf("[Native Function: %s]", value.as.nativeFunction->name);
+            outputString(out, "[Native Function: ");
+            outputString(out, value.as.nativeFunction->name);
+            outputChar(out, ']');
         }
         else
         {
-            printf("[Native Function: anonymous]");
+            outputString(out, "[Native Function: anonymous]");
         }
         break;
     case VAL_ARRAY:
         if (value.as.array == NULL)
         {
-            printf("[]");
+            outputString(out, "[]");
             break;
         }
 
-        printf("[");
+        outputChar(out, '[');
         for (int i = 0; i < value.as.array->count; i++)
         {
             // 递归调用前添加安全检查
             if (i < value.as.array->capacity && value.as.array->elements != NULL)
             {
-                printValue(value.as.array->elements[i]);
+                writeValue(out, value.as.array->elements[i]);
             }
             else
             {
-                printf("(invalid element)");
+                outputString(out, "(invalid element)");
             }
 
             if (i < value.as.array->count - 1)
             {
-                printf(", ");
+                outputString(out, ", ");
             }
         }
-        printf("]");
+        outputChar(out, ']');
         break;
     case VAL_ENUM_VALUE:
         if (value.as.enumValue != NULL)
         {
             if (value.as.enumValue->enumName != NULL && value.as.enumValue->memberName != NULL)
             {
-                printf("%s::%s", value.as.enumValue->enumName, value.as.enumValue->memberName);
+                outputString(out, value.as.enumValue->enumName);
+                outputString(out, "::");
+                outputString(out, value.as.enumValue->memberName);
             }
             else
             {
-                printf("(invalid enum value)");
+                outputString(out, "(invalid enum value)");
             }
         }
         else
         {
-            printf("(null enum value)");
+            outputString(out, "(null enum value)");
         }
         break;
     case VAL_STRUCT:
@@ -326,50 +553,132 @@ void printValue(Value value)
         {
             if (value.as.structValue->structName != NULL)
             {
-                printf("%s{", value.as.structValue->structName);
+                outputString(out, value.as.structValue->structName);
+                outputChar(out, '{');
             }
             else
             {
-                printf("{");
+                outputChar(out, '{');
             }
             
             for (int i = 0; i < value.as.structValue->fieldCount; i++)
             {
                 if (value.as.structValue->fields[i].name != NULL)
                 {
-                    printf("%s: ", value.as.structValue->fields[i].name);
+                    outputString(out, value.as.structValue->fields[i].name);
+                    outputString(out, ": ");
                     if (value.as.structValue->fields[i].value != NULL)
                     {
-                        printValue(*value.as.structValue->fields[i].value);
+                        writeValue(out, *value.as.structValue->fields[i].value);
                     }
                     else
                     {
-                        printf("null");
+                        outputString(out, "null");
                     }
                 }
                 else
                 {
-                    printf("(invalid field)");
+                    outputString(out, "(invalid field)");
                 }
                 
                 if (i < value.as.structValue->fieldCount - 1)
                 {
-                    printf(", ");
+                    outputString(out, ", ");
                 }
             }
-            printf("}");
+            outputChar(out, '}');
         }
         else
         {
-            printf("(null struct value)");
+            outputString(out, "(null struct value)");
         }
         break;
+    case VAL_MAP:
+    {
+        outputChar(out, '{');
+        bool first = true;
+        for (int i = 0; value.as.map != NULL && i < value.as.map->entryCount; i++)
+        {
+            const MapEntry *entry = &value.as.map->entries[i];
+            if (entry->key.type == VAL_NULL)
+            {
+                continue;
+            }
+
+            if (!first)
+            {
+                outputString(out, ", ");
+            }
+            first = false;
+            writeValue(out, entry->key);
+            outputString(out, ": ");
+            writeValue(out, entry->value);
+        }
+        outputChar(out, '}');
+        break;
+    }
+    case VAL_HEAP:
+        outputString(out, "heap[");
+        for (int i = 0; i < value.as.heap->count; i++)
+        {
+            if (i > 0)
+            {
+                outputString(out, ", ");
+            }
+            writeValue(out, value.as.heap->entries[i].item);
+        }
+        outputChar(out, ']');
+        break;
+    case VAL_DEQUE:
+        outputString(out, "deque[");
+        for (int i = 0; i < value.as.deque->count; i++)
+        {
+            if (i > 0)
+            {
+                outputString(out, ", ");
+            }
+            writeValue(out, *dequeAt(value.as.deque, i));
+        }
+        outputChar(out, ']');
+        break;
+    case VAL_RANGE:
+    {
+        char buffer[96];
+        int length;
+        if (value.as.range->step == 1)
+        {
+            length = snprintf(buffer, sizeof(buffer), "range(%lld, %lld)",
+                              (long long)value.as.range->start, (long long)value.as.range->end);
+        }
+        else
+        {
+            length = snprintf(buffer, sizeof(buffer), "range(%lld, %lld, %lld)",
+                              (long long)value.as.range->start, (long long)value.as.range->end,
+                              (long long)value.as.range->step);
+        }
+        outputWrite(out, buffer, (size_t)length);
+        break;
+    }
+    case VAL_GENERATOR:
+        outputString(out, "[Generator: ");
+        outputString(out, value.as.generator->name != NULL ? value.as.generator->name : "anonymous");
+        outputChar(out, ']');
+        break;
     default:
-        printf("(unknown value type)");
+        outputString(out, "(unknown value type)");
         break;
     }
 }
 
+// 将值直接打印到标准输出（调试用）；解释器中的输出应通过其 OutputBuffer 调用 writeValue
+void printValue(Value value)
+{
+    OutputBuffer buffer;
+    initOutputBuffer(&buffer, STDOUT_FILENO, OUTPUT_FULLY_BUFFERED);
+    writeValue(&buffer, value);
+    freeOutputBuffer(&buffer);
+}
+
 Value createEnumValue(const char *enumName, const char *memberName, int value)
 {
     Value val;
@@ -614,7 +923,7 @@ Value copyValue(Value value)
     case VAL_STRING:
         if (value.as.string != NULL)
         {
-            return createString(value.as.string); // 创建新的字符串副本
+            return createStringWithLength(value.as.string, stringLength(value.as.string)); // 创建新的字符串副本
         }
         else
         {
@@ -734,6 +1043,7 @@ Value copyValue(Value value)
         // 对于body和closure保持引用，不进行深度复制
         newFunction->body = original->body;
         newFunction->closure = original->closure;
+        newFunction->isGenerator = original->isGenerator;
 
         // 创建新的函数值并返回
         Value newValue;
@@ -752,6 +1062,12 @@ Value copyValue(Value value)
             return createNull();
         }
 
+        // 静态注册表中的原生函数在整个进程内有效，直接共享
+        if (original->isStatic)
+        {
+            return value;
+        }
+
         // 分配新的原生函数结构
         NativeFunction *newNativeFunction = (NativeFunction *)malloc(sizeof(NativeFunction));
         if (newNativeFunction == NULL)
@@ -762,6 +1078,9 @@ Value copyValue(Value value)
 
         // 复制函数指针和参数数量
         newNativeFunction->function = original->function;
+        newNativeFunction->native = original->native;
+        newNativeFunction->flags = original->flags;
+        newNativeFunction->isStatic = false;
         newNativeFunction->arity = original->arity;
         newNativeFunction->name = NULL;
 
@@ -886,80 +1205,43 @@ Value copyValue(Value value)
     case VAL_STRUCT:
         if (value.as.structValue != NULL)
         {
-            // 复制字段数组
-            StructFieldValue *fieldsCopy = NULL;
-            if (value.as.structValue->fieldCount > 0)
-            {
-                fieldsCopy = (StructFieldValue *)malloc(sizeof(StructFieldValue) * value.as.structValue->fieldCount);
-                if (fieldsCopy == NULL)
-                {
-                    return createNull();
-                }
-                
-                for (int i = 0; i < value.as.structValue->fieldCount; i++)
-                {
-                    // 复制字段名称
-                    if (value.as.structValue->fields[i].name != NULL)
-                    {
-                        size_t nameLen = strlen(value.as.structValue->fields[i].name);
-                        fieldsCopy[i].name = (char *)malloc(nameLen + 1);
-                        if (fieldsCopy[i].name == NULL)
-                        {
-                            // 清理已分配的内存
-                            for (int j = 0; j < i; j++)
-                            {
-                                free(fieldsCopy[j].name);
-                                if (fieldsCopy[j].value != NULL)
-                                {
-                                    freeValue(*fieldsCopy[j].value);
-                                    free(fieldsCopy[j].value);
-                                }
-                            }
-                            free(fieldsCopy);
-                            return createNull();
-                        }
-                        strcpy(fieldsCopy[i].name, value.as.structValue->fields[i].name);
-                    }
-                    else
-                    {
-                        fieldsCopy[i].name = NULL;
-                    }
-                    
-                    // 递归复制字段值
-                    if (value.as.structValue->fields[i].value != NULL)
-                    {
-                        fieldsCopy[i].value = (Value *)malloc(sizeof(Value));
-                        if (fieldsCopy[i].value == NULL)
-                        {
-                            // 清理已分配的内存
-                            for (int j = 0; j < i; j++)
-                            {
-                                free(fieldsCopy[j].name);
-                                if (fieldsCopy[j].value != NULL)
-                                {
-                                    freeValue(*fieldsCopy[j].value);
-                                    free(fieldsCopy[j].value);
-                                }
-                            }
-                            free(fieldsCopy[i].name);
-                            free(fieldsCopy);
-                            return createNull();
-                        }
-                        *fieldsCopy[i].value = copyValue(*value.as.structValue->fields[i].value);
-                    }
-                    else
-                    {
-                        fieldsCopy[i].value = NULL;
-                    }
-                }
-            }
-            
-            return createStruct(value.as.structValue->structName, fieldsCopy, value.as.structValue->fieldCount);
+            // createStruct 会逐个复制字段名和字段值
+            return createStruct(value.as.structValue->structName, value.as.structValue->fields,
+                                value.as.structValue->fieldCount);
         }
         else
         {
             return createNull();
         }
+    case VAL_MAP:
+        if (value.as.map != NULL)
+        {
+            Value mapCopy;
+            mapCopy.type = VAL_MAP;
+            mapCopy.as.map = copyMap(value.as.map);
+            return mapCopy.as.map != NULL ? mapCopy : createNull();
+        }
+        return createNull();
+    case VAL_HEAP:
+    {
+        Value heapCopy;
+        heapCopy.type = VAL_HEAP;
+        heapCopy.as.heap = copyHeap(value.as.heap);
+        return heapCopy.as.heap != NULL ? heapCopy : createNull();
+    }
+    case VAL_DEQUE:
+    {
+        Value dequeCopy;
+        dequeCopy.type = VAL_DEQUE;
+        dequeCopy.as.deque = copyDeque(value.as.deque);
+        return dequeCopy.as.deque != NULL ? dequeCopy : createNull();
+    }
+    case VAL_RANGE:
+        return createRange(value.as.range->start, value.as.range->end, value.as.range->step);
+    case VAL_GENERATOR:
+        // 生成器保存执行状态，副本共享同一个生成器
+        retainGenerator(value.as.generator);
+        return value;
     default:
         // 对于简单值类型，直接复制
         return value;
@@ -974,7 +1256,7 @@ void freeValue(Value value)
     case VAL_STRING:
         if (value.as.string != NULL)
         {
-            free(value.as.string);
+            free(STRING_HEADER(value.as.string));
         }
         break;
 
@@ -1007,8 +1289,8 @@ void freeValue(Value value)
 
     // 释放原生函数资源
     case VAL_NATIVE_FUNCTION:
-        // 原生函数需要释放结构体，但不释放函数指针
-        if (value.as.nativeFunction != NULL)
+        // 原生函数需要释放结构体，但不释放函数指针；静态注册表中的原生函数不释放
+        if (value.as.nativeFunction != NULL && !value.as.nativeFunction->isStatic)
         {
 
             // 安全释放原生函数名称
@@ -1073,6 +1355,21 @@ void freeValue(Value value)
             freeStructValue(value.as.structValue);
         }
         break;
+    case VAL_MAP:
+        freeMap(value.as.map);
+        break;
+    case VAL_HEAP:
+        releaseHeap(value.as.heap);
+        break;
+    case VAL_DEQUE:
+        freeDeque(value.as.deque);
+        break;
+    case VAL_RANGE:
+        free(value.as.range);
+        break;
+    case VAL_GENERATOR:
+        releaseGenerator(value.as.generator);
+        break;
     default:
         // 其他类型不需要释放
         break;
@@ -1107,7 +1404,8 @@ Value createArray(BaseType elementType, int initialCapacity)
     array->capacity = initialCapacity > 0 ? initialCapacity : 8;
     array->count = 0;
     array->elementType = elementType;
-    array->elements = (Value *)calloc(array->capacity, sizeof(Value)); // 使用 calloc 初始化为0
+    // calloc 清零后每个元素即为 NULL（VAL_NULL 为 0），无需再逐个初始化
+    array->elements = (Value *)calloc(array->capacity, sizeof(Value));
 
     if (array->elements == NULL)
     {
@@ -1116,12 +1414,6 @@ Value createArray(BaseType elementType, int initialCapacity)
         return val;
     }
 
-    // 显式初始化所有元素为 NULL
-    for (int i = 0; i < array->capacity; i++)
-    {
-        array->elements[i] = createNull();
-    }
-
     val.as.array = array;
     return val;
 }
@@ -1242,3 +1534,89 @@ int arrayLength(Array *array)
 {
     return array ? array->count : 0;
 }
+
+// 创建区间；调用方保证 step 不为 0
+Value createRange(int64_t start, int64_t end, int64_t step)
+{
+    Range *range = (Range *)malloc(sizeof(Range));
+    if (range == NULL)
+    {
+        return createNull();
+    }
+    range->start = start;
+    range->end = end;
+    range->step = step;
+
+    Value val;
+    val.type = VAL_RANGE;
+    val.as.range = range;
+    return val;
+}
+
+// 区间中的元素个数；用无符号运算避免端点相距超过 INT64_MAX 时溢出
+int64_t rangeLength(const Range *range)
+{
+    uint64_t distance;
+    uint64_t stride;
+    if (range->step > 0)
+    {
+        if (range->start >= range->end)
+            return 0;
+        distance = (uint64_t)range->end - (uint64_t)range->start;
+        stride = (uint64_t)range->step;
+    }
+    else
+    {
+        if (range->start <= range->end)
+            return 0;
+        distance = (uint64_t)range->start - (uint64_t)range->end;
+        stride = (uint64_t)0 - (uint64_t)range->step;
+    }
+
+    uint64_t count = (distance - 1) / stride + 1;
+    return count > (uint64_t)INT64_MAX ? INT64_MAX : (int64_t)count;
+}
+
+// 第 index 个元素（0 <= index < rangeLength），结果一定落在区间内，回绕运算是精确的
+int64_t rangeAt(const Range *range, int64_t index)
+{
+    return (int64_t)((uint64_t)range->start + (uint64_t)index * (uint64_t)range->step);
+}
+
+// 值是否为区间中的元素：须为整数（或整数值的浮点数），在区间内且与起点相差步长的整数倍
+bool rangeContains(const Range *range, Value value)
+{
+    int64_t integer;
+    if (value.type == VAL_INT)
+    {
+        integer = value.as.integer;
+    }
+    else if (value.type == VAL_NUMBER && value.as.number >= -9223372036854775808.0 &&
+             value.as.number < 9223372036854775808.0 &&
+             (double)(int64_t)value.as.number == value.as.number)
+    {
+        integer = (int64_t)value.as.number;
+    }
+    else
+    {
+        return false;
+    }
+
+    uint64_t offset;
+    uint64_t stride;
+    if (range->step > 0)
+    {
+        if (integer < range->start || integer >= range->end)
+            return false;
+        offset = (uint64_t)integer - (uint64_t)range->start;
+        stride = (uint64_t)range->step;
+    }
+    else
+    {
+        if (integer > range->start || integer <= range->end)
+            return false;
+        offset = (uint64_t)range->start - (uint64_t)integer;
+        stride = (uint64_t)0 - (uint64_t)range->step;
+    }
+    return offset % stride == 0;
+}